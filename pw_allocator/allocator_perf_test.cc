@@ -0,0 +1,125 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares the allocators in this module on the same randomized workload of
+// allocations and frees. Most requests are small, with an occasional large
+// one, and the live allocations fragment the region over time.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/block.h"
+#include "pw_allocator/freelist_heap.h"
+#include "pw_allocator/split_free_list_allocator.h"
+#include "pw_allocator/tlsf_allocator.h"
+#include "pw_assert/check.h"
+#include "pw_bytes/span.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t kBufferSize = 64 * 1024;
+constexpr size_t kSlots = 256;
+constexpr int kSteps = 10000;
+constexpr size_t kThreshold = 128;
+
+alignas(16) std::array<std::byte, kBufferSize> buffer;
+
+// Runs the workload, using `allocate(size)` and `deallocate(ptr, size)`.
+// Returns the number of successful allocations.
+template <typename Allocate, typename Deallocate>
+size_t RunSteps(Allocate&& allocate, Deallocate&& deallocate) {
+  std::array<void*, kSlots> ptrs{};
+  std::array<size_t, kSlots> sizes{};
+  size_t allocations = 0;
+
+  uint32_t random = 1;
+  auto next_random = [&random]() {
+    random = random * 1103515245u + 12345u;
+    return random >> 8;
+  };
+
+  for (int step = 0; step < kSteps; ++step) {
+    const size_t index = next_random() % kSlots;
+    if (ptrs[index] == nullptr) {
+      size_t size = next_random() % 64 + 1;
+      if (next_random() % 16 == 0) {
+        size = next_random() % 2048 + 1;
+      }
+      ptrs[index] = allocate(size);
+      sizes[index] = size;
+      if (ptrs[index] != nullptr) {
+        ++allocations;
+      }
+    } else {
+      deallocate(ptrs[index], sizes[index]);
+      ptrs[index] = nullptr;
+    }
+  }
+
+  for (size_t i = 0; i < kSlots; ++i) {
+    if (ptrs[i] != nullptr) {
+      deallocate(ptrs[i], sizes[i]);
+    }
+  }
+  return allocations;
+}
+
+// Runs the workload against an implementation of `Allocator`.
+void RunWorkload(perf_test::State& state, Allocator& allocator) {
+  size_t allocations = 0;
+  while (state.KeepRunning()) {
+    allocations += RunSteps(
+        [&allocator](size_t size) {
+          return allocator.Allocate(Layout(size, alignof(std::max_align_t)));
+        },
+        [&allocator](void* ptr, size_t size) {
+          allocator.Deallocate(ptr, Layout(size, alignof(std::max_align_t)));
+        });
+  }
+  PW_CHECK_UINT_NE(allocations, 0);
+}
+
+void TlsfAllocatorWorkload(perf_test::State& state) {
+  TlsfAllocator<> allocator;
+  PW_CHECK_OK(allocator.Init(ByteSpan(buffer)));
+  RunWorkload(state, allocator);
+}
+
+void SplitFreeListAllocatorWorkload(perf_test::State& state) {
+  SplitFreeListAllocator<> allocator;
+  PW_CHECK_OK(allocator.Init(ByteSpan(buffer), kThreshold));
+  RunWorkload(state, allocator);
+}
+
+void FreeListHeapWorkload(perf_test::State& state) {
+  FreeListHeapBuffer heap(buffer);
+  size_t allocations = 0;
+  while (state.KeepRunning()) {
+    allocations += RunSteps(
+        [&heap](size_t size) { return heap.Allocate(size); },
+        [&heap](void* ptr, size_t) { heap.Free(ptr); });
+  }
+  PW_CHECK_UINT_NE(allocations, 0);
+}
+
+PW_PERF_TEST(TlsfAllocator10kSteps, TlsfAllocatorWorkload);
+PW_PERF_TEST(SplitFreeListAllocator10kSteps, SplitFreeListAllocatorWorkload);
+PW_PERF_TEST(FreeListHeap10kSteps, FreeListHeapWorkload);
+
+}  // namespace
+}  // namespace pw::allocator
@@ -0,0 +1,469 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/block.h"
+#include "pw_bytes/alignment.h"
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw::allocator {
+
+/// Block-independent base class of TlsfAllocator.
+///
+/// This class contains static methods which do not depend on the template
+/// parameters of ``TlsfAllocator`` that are used to determine block type. This
+/// allows the methods to be defined in a separate source file and use macros
+/// that cannot be used in headers, e.g. PW_CHECK.
+///
+/// This class should not be used directly. Instead, see ``TlsfAllocator``.
+class BaseTlsfAllocator : public Allocator {
+ protected:
+  constexpr BaseTlsfAllocator() = default;
+
+  /// Crashes with an informational method that the given block is allocated.
+  ///
+  /// This method is meant to be called by ``TlsfAllocator``s destructor. There
+  /// must not be any outstanding allocations from an allocator when it is
+  /// destroyed.
+  static void CrashOnAllocated(void* allocated);
+};
+
+/// This memory allocator uses a two-level segregated fit (TLSF) to track
+/// unallocated blocks. Allocating and deallocating memory take constant time,
+/// regardless of how many blocks there are or how fragmented the memory is.
+///
+/// Free blocks are kept in lists of blocks of similar sizes. The first level
+/// divides sizes by powers of two, and the second level divides each power of
+/// two into `2^kSecondLevelBits` equal ranges. Bitmaps record which lists are
+/// not empty, so that the smallest list with blocks large enough for a request
+/// is found with a few bit operations. Any block in that list is a good fit:
+/// it is larger than the request by less than `1/2^kSecondLevelBits` of its
+/// size. Free blocks are merged with their neighbors, as with other allocators
+/// that use ``Block``.
+///
+/// The lists use one pointer per size class. The number of size classes
+/// depends on the capacity of `BlockType`, so blocks with a smaller capacity
+/// reduce the size of this allocator.
+///
+/// NOTE!! Do NOT use memory returned from this allocator as the backing for
+/// another allocator. If this is done, the `Query` method will incorrectly
+/// think pointers returned by that alloator were created by this one, and
+/// report that this allocator can de/reallocate them.
+///
+/// @tparam   BlockType         The type of block used to track memory.
+/// @tparam   kSecondLevelBits  Log2 of the number of lists that each power of
+///                             two of sizes is divided into.
+template <typename BlockType = Block<>, size_t kSecondLevelBits = 4>
+class TlsfAllocator : public BaseTlsfAllocator {
+ public:
+  using Range = typename BlockType::Range;
+
+  constexpr TlsfAllocator() = default;
+  ~TlsfAllocator() override;
+
+  // Not copyable.
+  TlsfAllocator(const TlsfAllocator&) = delete;
+  TlsfAllocator& operator=(const TlsfAllocator&) = delete;
+
+  /// Sets the memory region to be used by this allocator.
+  ///
+  /// @param[in]  region              The memory region for this allocator.
+  /// @retval     OK                  The allocator is initialized.
+  /// @retval     INVALID_ARGUMENT    The memory region is null.
+  /// @retval     RESOURCE_EXHAUSTED  The region is too small for `BlockType`.
+  /// @retval     OUT_OF_RANGE        The region too large for `BlockType`.
+  Status Init(ByteSpan region);
+
+  /// Returns an iterable range of blocks tracking the memory of this allocator.
+  Range blocks() const;
+
+ private:
+  static_assert(kSecondLevelBits > 0 && kSecondLevelBits <= 5,
+                "The second level bitmaps have at most 32 bits");
+
+  // Free blocks store the links of their free list in their usable space.
+  // Blocks too small to hold the links are not kept in any list; they are
+  // merged with their neighbors when those are freed.
+  struct FreeLinks {
+    BlockType* prev;
+    BlockType* next;
+  };
+
+  static constexpr size_t kMinInnerSize =
+      AlignUp(sizeof(FreeLinks), BlockType::kAlignment);
+
+  static constexpr size_t kSecondLevelCount = size_t(1) << kSecondLevelBits;
+  static constexpr size_t kAlignmentBits =
+      static_cast<size_t>(cpp20::countr_zero(BlockType::kAlignment));
+
+  // Sizes below this are divided evenly into the lists of the first level.
+  static constexpr size_t kFirstLevelShift = kSecondLevelBits + kAlignmentBits;
+
+  static constexpr size_t kMaxInnerSize =
+      std::min(BlockType::kCapacity, std::numeric_limits<size_t>::max() / 2);
+  static constexpr size_t kFirstLevelCount =
+      std::max(static_cast<size_t>(cpp20::bit_width(kMaxInnerSize)),
+               kFirstLevelShift) -
+      kFirstLevelShift + 1;
+
+  static_assert(kFirstLevelCount <= 64,
+                "The first level bitmap has at most 64 bits");
+
+  // Returns the index of the list for blocks with the given inner size.
+  static size_t ListIndex(size_t inner_size);
+
+  // Returns the index of the first list whose blocks all have an inner size of
+  // at least the given size. The index may be past the last list.
+  static size_t ListIndexForRequest(size_t inner_size);
+
+  static FreeLinks GetLinks(BlockType* block);
+  static void SetLinks(BlockType* block, const FreeLinks& links);
+
+  /// @copydoc Allocator::Query
+  Status DoQuery(const void* ptr, Layout layout) const override;
+
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override;
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr, Layout layout) override;
+
+  /// @copydoc Allocator::Resize
+  bool DoResize(void* ptr, Layout layout, size_t new_size) override;
+
+  // Returns a free block with an inner size of at least the given size, or
+  // null if there is none.
+  BlockType* FindFreeBlock(size_t inner_size) const;
+
+  // Adds a free block to the list for its size.
+  void InsertFreeBlock(BlockType* block);
+
+  // Removes a free block from the list for its size.
+  void RemoveFreeBlock(BlockType* block);
+
+  // Adds the free blocks before and after a block to the lists.
+  void InsertFreeNeighbors(BlockType* block);
+
+  // Removes the free blocks before and after a block from the lists.
+  void RemoveFreeNeighbors(BlockType* block);
+
+  // Represents the entire memory region for this allocator.
+  void* begin_ = nullptr;
+  void* end_ = nullptr;
+
+  // One bit per first level, set if any of its lists are not empty.
+  uint64_t first_level_bitmap_ = 0;
+
+  // One bit per list of each first level, set if the list is not empty.
+  std::array<uint32_t, kFirstLevelCount> second_level_bitmaps_{};
+
+  // The first free block of each list.
+  std::array<BlockType*, kFirstLevelCount * kSecondLevelCount> free_lists_{};
+};
+
+// Template method implementations
+
+template <typename BlockType, size_t kSecondLevelBits>
+TlsfAllocator<BlockType, kSecondLevelBits>::~TlsfAllocator() {
+  if (begin_ == nullptr) {
+    return;
+  }
+  for (auto* block : blocks()) {
+    if (block->Used()) {
+      CrashOnAllocated(block);
+    }
+  }
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+typename BlockType::Range TlsfAllocator<BlockType, kSecondLevelBits>::blocks()
+    const {
+  auto* begin = BlockType::FromUsableSpace(static_cast<std::byte*>(begin_));
+  return Range(begin);
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+Status TlsfAllocator<BlockType, kSecondLevelBits>::Init(ByteSpan region) {
+  if (region.data() == nullptr) {
+    return Status::InvalidArgument();
+  }
+  if (BlockType::kCapacity < region.size()) {
+    return Status::OutOfRange();
+  }
+
+  // Blocks need to be aligned. Find the first aligned address, and use as much
+  // of the memory region as possible.
+  auto addr = reinterpret_cast<uintptr_t>(region.data());
+  auto aligned = AlignUp(addr, BlockType::kAlignment);
+  Result<BlockType*> result = BlockType::Init(region.subspan(aligned - addr));
+  if (!result.ok()) {
+    return result.status();
+  }
+
+  // Initially, the lists hold a single free block.
+  BlockType* block = *result;
+  begin_ = block->UsableSpace();
+  end_ = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(begin_) +
+                                 block->InnerSize());
+  first_level_bitmap_ = 0;
+  second_level_bitmaps_.fill(0);
+  free_lists_.fill(nullptr);
+  InsertFreeBlock(block);
+  return OkStatus();
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+size_t TlsfAllocator<BlockType, kSecondLevelBits>::ListIndex(
+    size_t inner_size) {
+  if (inner_size < (size_t(1) << kFirstLevelShift)) {
+    return inner_size >> kAlignmentBits;
+  }
+  const auto msb = static_cast<size_t>(cpp20::bit_width(inner_size)) - 1;
+  const size_t first_level = msb - kFirstLevelShift + 1;
+  const size_t second_level =
+      (inner_size >> (msb - kSecondLevelBits)) ^ kSecondLevelCount;
+  return first_level * kSecondLevelCount + second_level;
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+size_t TlsfAllocator<BlockType, kSecondLevelBits>::ListIndexForRequest(
+    size_t inner_size) {
+  // Blocks in the list for this size may be smaller than the request, unless
+  // the request is the smallest size of the list.
+  const size_t index = ListIndex(inner_size);
+  return ListIndex(inner_size - 1) == index ? index + 1 : index;
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+typename TlsfAllocator<BlockType, kSecondLevelBits>::FreeLinks
+TlsfAllocator<BlockType, kSecondLevelBits>::GetLinks(BlockType* block) {
+  // The usable space may be less aligned than a pointer.
+  FreeLinks links;
+  std::memcpy(&links, block->UsableSpace(), sizeof(links));
+  return links;
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+void TlsfAllocator<BlockType, kSecondLevelBits>::SetLinks(
+    BlockType* block, const FreeLinks& links) {
+  std::memcpy(block->UsableSpace(), &links, sizeof(links));
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+Status TlsfAllocator<BlockType, kSecondLevelBits>::DoQuery(const void* ptr,
+                                                           Layout) const {
+  return (ptr < begin_ || end_ <= ptr) ? Status::OutOfRange() : OkStatus();
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+void* TlsfAllocator<BlockType, kSecondLevelBits>::DoAllocate(Layout layout) {
+  if (begin_ == nullptr || layout.size() == 0 ||
+      layout.size() > kMaxInnerSize) {
+    return nullptr;
+  }
+  size_t alignment = std::max(layout.alignment(), BlockType::kAlignment);
+  size_t inner_size =
+      std::max(AlignUp(layout.size(), BlockType::kAlignment), kMinInnerSize);
+
+  // Leave room to split off a block to pad the usable space to the alignment.
+  size_t search_size = inner_size;
+  if (alignment > BlockType::kAlignment) {
+    search_size += alignment + BlockType::kBlockOverhead;
+  }
+  if (search_size > kMaxInnerSize) {
+    return nullptr;
+  }
+
+  BlockType* block = FindFreeBlock(search_size);
+  if (block == nullptr) {
+    return nullptr;
+  }
+  RemoveFreeBlock(block);
+  if (!BlockType::AllocFirst(block, inner_size, alignment).ok()) {
+    InsertFreeBlock(block);
+    return nullptr;
+  }
+
+  // Return any padding and trailing space that was split off to the lists.
+  InsertFreeNeighbors(block);
+  return block->UsableSpace();
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+void TlsfAllocator<BlockType, kSecondLevelBits>::DoDeallocate(void* ptr,
+                                                              Layout) {
+  // Do nothing if uninitialized or no memory block pointer.
+  if (begin_ == nullptr || ptr < begin_ || end_ <= ptr) {
+    return;
+  }
+  auto* block = BlockType::FromUsableSpace(static_cast<std::byte*>(ptr));
+  block->CrashIfInvalid();
+
+  // Free the block and merge it with its neighbors, if possible.
+  RemoveFreeNeighbors(block);
+  BlockType::Free(block);
+  InsertFreeBlock(block);
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+bool TlsfAllocator<BlockType, kSecondLevelBits>::DoResize(void* ptr,
+                                                          Layout layout,
+                                                          size_t new_size) {
+  // Fail to resize is uninitialized or invalid parameters.
+  if (begin_ == nullptr || !DoQuery(ptr, layout).ok()) {
+    return false;
+  }
+
+  // Ensure that this allocation came from this object.
+  auto* block = BlockType::FromUsableSpace(static_cast<std::byte*>(ptr));
+  block->CrashIfInvalid();
+
+  // The block after this one may grow or shrink, so take it out of its list
+  // until the resize is done.
+  if (!block->Last() && !block->Next()->Used()) {
+    RemoveFreeBlock(block->Next());
+  }
+  bool resized =
+      BlockType::Resize(block, std::max(new_size, kMinInnerSize)).ok();
+  if (!block->Last() && !block->Next()->Used()) {
+    InsertFreeBlock(block->Next());
+  }
+  return resized;
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+BlockType* TlsfAllocator<BlockType, kSecondLevelBits>::FindFreeBlock(
+    size_t inner_size) const {
+  // Look for the first non-empty list at or after the one that is guaranteed
+  // to fit the request.
+  const size_t index = ListIndexForRequest(inner_size);
+  size_t first_level = index / kSecondLevelCount;
+  if (first_level < kFirstLevelCount) {
+    uint32_t bitmap = second_level_bitmaps_[first_level] &
+                      (~uint32_t(0) << (index % kSecondLevelCount));
+    if (bitmap == 0) {
+      const uint64_t first_level_bitmap =
+          first_level + 1 < 64
+              ? first_level_bitmap_ & (~uint64_t(0) << (first_level + 1))
+              : 0;
+      if (first_level_bitmap != 0) {
+        first_level =
+            static_cast<size_t>(cpp20::countr_zero(first_level_bitmap));
+        bitmap = second_level_bitmaps_[first_level];
+      }
+    }
+    if (bitmap != 0) {
+      const auto second_level = static_cast<size_t>(cpp20::countr_zero(bitmap));
+      return free_lists_[first_level * kSecondLevelCount + second_level];
+    }
+  }
+
+  // Otherwise, the first block of the list for the request's size may still
+  // be large enough.
+  BlockType* block = free_lists_[ListIndex(inner_size)];
+  if (block != nullptr && block->InnerSize() >= inner_size) {
+    return block;
+  }
+  return nullptr;
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+void TlsfAllocator<BlockType, kSecondLevelBits>::InsertFreeBlock(
+    BlockType* block) {
+  if (block->InnerSize() < kMinInnerSize) {
+    return;
+  }
+  const size_t index = ListIndex(block->InnerSize());
+  BlockType* next = free_lists_[index];
+  SetLinks(block, FreeLinks{nullptr, next});
+  if (next != nullptr) {
+    FreeLinks next_links = GetLinks(next);
+    next_links.prev = block;
+    SetLinks(next, next_links);
+  }
+  free_lists_[index] = block;
+
+  const size_t first_level = index / kSecondLevelCount;
+  second_level_bitmaps_[first_level] |= uint32_t(1)
+                                        << (index % kSecondLevelCount);
+  first_level_bitmap_ |= uint64_t(1) << first_level;
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+void TlsfAllocator<BlockType, kSecondLevelBits>::RemoveFreeBlock(
+    BlockType* block) {
+  if (block->InnerSize() < kMinInnerSize) {
+    return;
+  }
+  const size_t index = ListIndex(block->InnerSize());
+  const FreeLinks links = GetLinks(block);
+  if (links.prev != nullptr) {
+    FreeLinks prev_links = GetLinks(links.prev);
+    prev_links.next = links.next;
+    SetLinks(links.prev, prev_links);
+  } else {
+    free_lists_[index] = links.next;
+  }
+  if (links.next != nullptr) {
+    FreeLinks next_links = GetLinks(links.next);
+    next_links.prev = links.prev;
+    SetLinks(links.next, next_links);
+  }
+
+  if (free_lists_[index] == nullptr) {
+    const size_t first_level = index / kSecondLevelCount;
+    second_level_bitmaps_[first_level] &=
+        ~(uint32_t(1) << (index % kSecondLevelCount));
+    if (second_level_bitmaps_[first_level] == 0) {
+      first_level_bitmap_ &= ~(uint64_t(1) << first_level);
+    }
+  }
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+void TlsfAllocator<BlockType, kSecondLevelBits>::InsertFreeNeighbors(
+    BlockType* block) {
+  BlockType* prev = block->Prev();
+  if (prev != nullptr && !prev->Used()) {
+    InsertFreeBlock(prev);
+  }
+  if (!block->Last() && !block->Next()->Used()) {
+    InsertFreeBlock(block->Next());
+  }
+}
+
+template <typename BlockType, size_t kSecondLevelBits>
+void TlsfAllocator<BlockType, kSecondLevelBits>::RemoveFreeNeighbors(
+    BlockType* block) {
+  BlockType* prev = block->Prev();
+  if (prev != nullptr && !prev->Used()) {
+    RemoveFreeBlock(prev);
+  }
+  if (!block->Last() && !block->Next()->Used()) {
+    RemoveFreeBlock(block->Next());
+  }
+}
+
+}  // namespace pw::allocator
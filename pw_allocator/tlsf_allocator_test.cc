@@ -0,0 +1,433 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_allocator.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_allocator/allocator_metric_proxy.h"
+#include "pw_allocator/allocator_testing.h"
+#include "pw_allocator/block.h"
+#include "pw_bytes/alignment.h"
+#include "pw_bytes/span.h"
+
+namespace pw::allocator {
+namespace {
+
+// Test fixtures.
+
+// Size of the memory region to use in the tests below.
+static constexpr size_t kCapacity = 256;
+
+// An `TlsfAllocator` that is automatically initialized on construction.
+using BlockType = Block<uint16_t, kCapacity>;
+class TlsfAllocatorWithBuffer
+    : public test::WithBuffer<TlsfAllocator<BlockType>, kCapacity, BlockType> {
+ public:
+  TlsfAllocatorWithBuffer() {
+    EXPECT_EQ((*this)->Init(ByteSpan(this->data(), this->size())), OkStatus());
+  }
+};
+
+// Test case fixture that allows individual tests to cache allocations and
+// release them automatically on tear-down.
+class TlsfAllocatorTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kMaxSize = kCapacity - BlockType::kBlockOverhead;
+  static constexpr size_t kNumPtrs = 16;
+
+  void SetUp() override {
+    for (size_t i = 0; i < kNumPtrs; ++i) {
+      ptrs_[i] = nullptr;
+    }
+  }
+
+  // This method simply ensures the memory is usable by writing to it.
+  void UseMemory(void* ptr, size_t size) { memset(ptr, 0x5a, size); }
+
+  void TearDown() override {
+    for (size_t i = 0; i < kNumPtrs; ++i) {
+      if (ptrs_[i] != nullptr) {
+        // `TlsfAllocator::Deallocate` doesn't actually use the layout, as the
+        // information it needs is encoded in the blocks.
+        allocator_->Deallocate(ptrs_[i], Layout::Of<void*>());
+      }
+    }
+  }
+
+  TlsfAllocatorWithBuffer allocator_;
+
+  // Tests can store allocations in this array to have them automatically
+  // freed in `TearDown`, including on ASSERT failure. If pointers are manually
+  // deallocated, they should be set to null in the array.
+  void* ptrs_[kNumPtrs];
+};
+
+// Unit tests.
+
+TEST_F(TlsfAllocatorTest, InitUnaligned) {
+  // The test fixture uses aligned memory to make it easier to reason about
+  // allocations, but that isn't strictly required.
+  TlsfAllocator<Block<>> unaligned;
+  ByteSpan bytes(allocator_.data(), allocator_.size());
+  EXPECT_EQ(unaligned.Init(bytes.subspan(1)), OkStatus());
+}
+
+TEST_F(TlsfAllocatorTest, Allocate) {
+  constexpr Layout layout = Layout::Of<std::byte[64]>();
+  ptrs_[0] = allocator_->Allocate(layout);
+  ASSERT_NE(ptrs_[0], nullptr);
+  EXPECT_GE(ptrs_[0], allocator_.data());
+  EXPECT_LT(ptrs_[0], allocator_.data() + allocator_.size());
+  UseMemory(ptrs_[0], layout.size());
+}
+
+TEST_F(TlsfAllocatorTest, AllocateSmall) {
+  constexpr Layout layout = Layout::Of<uint8_t>();
+  ptrs_[0] = allocator_->Allocate(layout);
+  ASSERT_NE(ptrs_[0], nullptr);
+  UseMemory(ptrs_[0], layout.size());
+}
+
+TEST_F(TlsfAllocatorTest, AllocateAll) {
+  constexpr Layout layout = Layout::Of<std::byte[kMaxSize]>();
+  ptrs_[0] = allocator_->Allocate(layout);
+  ASSERT_NE(ptrs_[0], nullptr);
+  UseMemory(ptrs_[0], layout.size());
+  EXPECT_EQ(allocator_->Allocate(Layout::Of<uint8_t>()), nullptr);
+}
+
+TEST_F(TlsfAllocatorTest, AllocateTooLarge) {
+  ptrs_[0] = allocator_->Allocate(Layout::Of<std::byte[kCapacity * 2]>());
+  EXPECT_EQ(ptrs_[0], nullptr);
+}
+
+TEST_F(TlsfAllocatorTest, AllocateLargeAlignment) {
+  constexpr size_t kSize = sizeof(uint32_t);
+  constexpr size_t kAlignment = 64;
+  ptrs_[0] = allocator_->Allocate(Layout(kSize, kAlignment));
+  ASSERT_NE(ptrs_[0], nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptrs_[0]) % kAlignment, 0U);
+  UseMemory(ptrs_[0], kSize);
+
+  ptrs_[1] = allocator_->Allocate(Layout(kSize, kAlignment));
+  ASSERT_NE(ptrs_[1], nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptrs_[1]) % kAlignment, 0U);
+  UseMemory(ptrs_[1], kSize);
+}
+
+TEST_F(TlsfAllocatorTest, AllocateFromUnaligned) {
+  TlsfAllocator<Block<>> unaligned;
+  ByteSpan bytes(allocator_.data(), allocator_.size());
+  ASSERT_EQ(unaligned.Init(bytes.subspan(1)), OkStatus());
+
+  constexpr Layout layout = Layout::Of<std::byte[72]>();
+  void* ptr = unaligned.Allocate(layout);
+  ASSERT_NE(ptr, nullptr);
+  UseMemory(ptr, layout.size());
+  unaligned.Deallocate(ptr, layout);
+}
+
+TEST_F(TlsfAllocatorTest, ReusesFreedMemory) {
+  constexpr Layout layout = Layout::Of<std::byte[32]>();
+  size_t count = 0;
+  for (; count < kNumPtrs; ++count) {
+    ptrs_[count] = allocator_->Allocate(layout);
+    if (ptrs_[count] == nullptr) {
+      break;
+    }
+  }
+  ASSERT_GT(count, 2U);
+
+  // A freed block in the middle of the region is found again.
+  void* freed = ptrs_[1];
+  allocator_->Deallocate(freed, layout);
+  ptrs_[1] = allocator_->Allocate(layout);
+  EXPECT_EQ(ptrs_[1], freed);
+}
+
+TEST_F(TlsfAllocatorTest, DeallocateNull) {
+  constexpr Layout layout = Layout::Of<uint8_t>();
+  allocator_->Deallocate(nullptr, layout);
+}
+
+TEST_F(TlsfAllocatorTest, DeallocateShuffled) {
+  constexpr Layout layout = Layout::Of<std::byte[32]>();
+  // Allocate until the pool is exhausted.
+  for (size_t i = 0; i < kNumPtrs; ++i) {
+    ptrs_[i] = allocator_->Allocate(layout);
+    if (ptrs_[i] == nullptr) {
+      break;
+    }
+  }
+  // Mix up the order of allocations.
+  for (size_t i = 0; i < kNumPtrs; ++i) {
+    if (i % 2 == 0 && i + 1 < kNumPtrs) {
+      std::swap(ptrs_[i], ptrs_[i + 1]);
+    }
+    if (i % 3 == 0 && i + 2 < kNumPtrs) {
+      std::swap(ptrs_[i], ptrs_[i + 2]);
+    }
+  }
+  // Deallocate everything.
+  for (size_t i = 0; i < kNumPtrs; ++i) {
+    allocator_->Deallocate(ptrs_[i], layout);
+    ptrs_[i] = nullptr;
+  }
+
+  // All of the blocks were merged back together.
+  ptrs_[0] = allocator_->Allocate(Layout::Of<std::byte[kMaxSize]>());
+  EXPECT_NE(ptrs_[0], nullptr);
+}
+
+TEST_F(TlsfAllocatorTest, IterateOverBlocks) {
+  // Pick sizes small enough that blocks fit, even with poisoning.
+  constexpr Layout layout1 = Layout::Of<std::byte[16]>();
+  constexpr Layout layout2 = Layout::Of<std::byte[8]>();
+
+  // Allocate six blocks of alternating sizes. After this, the will also be a
+  // seventh, unallocated block of the remaining memory.
+  for (size_t i = 0; i < 3; ++i) {
+    ptrs_[i] = allocator_->Allocate(layout1);
+    ASSERT_NE(ptrs_[i], nullptr);
+    ptrs_[i + 3] = allocator_->Allocate(layout2);
+    ASSERT_NE(ptrs_[i + 3], nullptr);
+  }
+
+  // Deallocate every other block. After this there will be three more
+  // unallocated blocks, for a total of four.
+  for (size_t i = 0; i < 3; ++i) {
+    allocator_->Deallocate(ptrs_[i], layout1);
+    ptrs_[i] = nullptr;
+  }
+
+  // Count the blocks. The unallocated ones vary in size, but the allocated ones
+  // should all be the same.
+  size_t free_count = 0;
+  size_t used_count = 0;
+  for (auto* block : allocator_->blocks()) {
+    if (block->Used()) {
+      EXPECT_GE(block->InnerSize(), layout2.size());
+      ++used_count;
+    } else {
+      ++free_count;
+    }
+  }
+  EXPECT_EQ(used_count, 3U);
+  EXPECT_EQ(free_count, 4U);
+}
+
+TEST_F(TlsfAllocatorTest, QueryValid) {
+  constexpr Layout layout = Layout::Of<std::byte[32]>();
+  ptrs_[0] = allocator_->Allocate(layout);
+  EXPECT_EQ(allocator_->Query(ptrs_[0], layout), OkStatus());
+}
+
+TEST_F(TlsfAllocatorTest, QueryInvalidPtr) {
+  constexpr Layout layout = Layout::Of<TlsfAllocatorTest>();
+  EXPECT_EQ(allocator_->Query(this, layout), Status::OutOfRange());
+}
+
+TEST_F(TlsfAllocatorTest, ResizeNull) {
+  constexpr Layout old_layout = Layout::Of<uint8_t>();
+  size_t new_size = 1;
+  EXPECT_FALSE(allocator_->Resize(nullptr, old_layout, new_size));
+}
+
+TEST_F(TlsfAllocatorTest, ResizeSame) {
+  constexpr Layout old_layout = Layout::Of<uint32_t>();
+  ptrs_[0] = allocator_->Allocate(old_layout);
+  ASSERT_NE(ptrs_[0], nullptr);
+
+  constexpr Layout new_layout = Layout::Of<uint32_t>();
+  EXPECT_TRUE(allocator_->Resize(ptrs_[0], old_layout, new_layout.size()));
+  ASSERT_NE(ptrs_[0], nullptr);
+  UseMemory(ptrs_[0], new_layout.size());
+}
+
+TEST_F(TlsfAllocatorTest, ResizeSmaller) {
+  constexpr Layout old_layout = Layout::Of<std::byte[kMaxSize]>();
+  ptrs_[0] = allocator_->Allocate(old_layout);
+  ASSERT_NE(ptrs_[0], nullptr);
+
+  // Shrinking always succeeds, and the released memory can be allocated.
+  constexpr Layout new_layout = Layout::Of<std::byte[64]>();
+  EXPECT_TRUE(allocator_->Resize(ptrs_[0], old_layout, new_layout.size()));
+  UseMemory(ptrs_[0], new_layout.size());
+
+  ptrs_[1] = allocator_->Allocate(new_layout);
+  ASSERT_NE(ptrs_[1], nullptr);
+  UseMemory(ptrs_[1], new_layout.size());
+}
+
+TEST_F(TlsfAllocatorTest, ResizeLarger) {
+  constexpr Layout old_layout = Layout::Of<std::byte[64]>();
+  ptrs_[0] = allocator_->Allocate(old_layout);
+  ASSERT_NE(ptrs_[0], nullptr);
+
+  // Nothing after ptr, so `Resize` should succeed.
+  constexpr Layout new_layout = Layout::Of<std::byte[kMaxSize]>();
+  EXPECT_TRUE(allocator_->Resize(ptrs_[0], old_layout, new_layout.size()));
+  ASSERT_NE(ptrs_[0], nullptr);
+  UseMemory(ptrs_[0], new_layout.size());
+
+  // The space after the block was taken out of the free lists.
+  EXPECT_EQ(allocator_->Allocate(Layout::Of<uint8_t>()), nullptr);
+}
+
+TEST_F(TlsfAllocatorTest, ResizeLargerFailure) {
+  constexpr Layout old_layout = Layout::Of<std::byte[64]>();
+  ptrs_[0] = allocator_->Allocate(old_layout);
+  ASSERT_NE(ptrs_[0], nullptr);
+
+  ptrs_[1] = allocator_->Allocate(old_layout);
+  ASSERT_NE(ptrs_[1], nullptr);
+
+  // Memory after ptr is already allocated, so `Resize` should fail.
+  EXPECT_FALSE(allocator_->Resize(ptrs_[0], old_layout, kMaxSize));
+}
+
+TEST_F(TlsfAllocatorTest, ResizeLargerIntoFreedBlock) {
+  constexpr Layout layout = Layout::Of<std::byte[32]>();
+  ptrs_[0] = allocator_->Allocate(layout);
+  ASSERT_NE(ptrs_[0], nullptr);
+  ptrs_[1] = allocator_->Allocate(layout);
+  ASSERT_NE(ptrs_[1], nullptr);
+  ptrs_[2] = allocator_->Allocate(layout);
+  ASSERT_NE(ptrs_[2], nullptr);
+
+  // Free the block after the first, so that it can grow into it.
+  allocator_->Deallocate(ptrs_[1], layout);
+  ptrs_[1] = nullptr;
+
+  constexpr Layout new_layout = Layout::Of<std::byte[48]>();
+  EXPECT_TRUE(allocator_->Resize(ptrs_[0], layout, new_layout.size()));
+  UseMemory(ptrs_[0], new_layout.size());
+
+  // The rest of the freed block is the best fit for a small allocation.
+  ptrs_[1] = allocator_->Allocate(Layout::Of<std::byte[16]>());
+  ASSERT_NE(ptrs_[1], nullptr);
+  EXPECT_GT(ptrs_[1], ptrs_[0]);
+  EXPECT_LT(ptrs_[1], ptrs_[2]);
+}
+
+TEST_F(TlsfAllocatorTest, WorksWithMetricProxy) {
+  AllocatorMetricProxy proxy(0);
+  proxy.Initialize(*allocator_);
+
+  constexpr Layout layout = Layout::Of<std::byte[32]>();
+  void* ptr = proxy.Allocate(layout);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(proxy.used(), layout.size());
+  EXPECT_EQ(proxy.count(), 1U);
+
+  constexpr size_t kNewSize = 48;
+  EXPECT_TRUE(proxy.Resize(ptr, layout, kNewSize));
+  EXPECT_EQ(proxy.used(), kNewSize);
+
+  proxy.Deallocate(ptr, Layout(kNewSize, layout.alignment()));
+  EXPECT_EQ(proxy.used(), 0U);
+  EXPECT_EQ(proxy.peak(), kNewSize);
+  EXPECT_EQ(proxy.count(), 0U);
+}
+
+// Allocates, resizes, and frees random sizes, and checks that allocations do
+// not overlap and that all of the memory is recovered.
+TEST(TlsfAllocatorRandomTest, RandomAllocations) {
+  constexpr size_t kBufferSize = 8192;
+  constexpr size_t kAllocations = 64;
+  using RandomBlockType = Block<uint32_t, kBufferSize>;
+  test::WithBuffer<TlsfAllocator<RandomBlockType>, kBufferSize> allocator;
+  ASSERT_EQ(allocator->Init(ByteSpan(allocator.data(), allocator.size())),
+            OkStatus());
+
+  struct Allocation {
+    std::byte* ptr = nullptr;
+    Layout layout = Layout(0);
+  };
+  std::array<Allocation, kAllocations> allocations{};
+
+  uint32_t random = 1;
+  auto next_random = [&random]() {
+    random = random * 1103515245u + 12345u;
+    return random >> 8;
+  };
+
+  // Fills each allocation with its index, to detect overlaps.
+  auto fill = [&allocations](size_t index) {
+    Allocation& a = allocations[index];
+    std::memset(a.ptr, static_cast<int>(index), a.layout.size());
+  };
+  auto check = [&allocations](size_t index) {
+    Allocation& a = allocations[index];
+    for (size_t i = 0; i < a.layout.size(); ++i) {
+      if (a.ptr[i] != static_cast<std::byte>(index)) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (int step = 0; step < 20000; ++step) {
+    const size_t index = next_random() % kAllocations;
+    Allocation& a = allocations[index];
+    if (a.ptr == nullptr) {
+      // Mostly small allocations, with some large and some aligned ones.
+      size_t size = next_random() % 64 + 1;
+      if (next_random() % 8 == 0) {
+        size = next_random() % 1024 + 1;
+      }
+      const size_t alignment = size_t(1) << (next_random() % 8);
+      a.layout = Layout(size, alignment);
+      a.ptr = static_cast<std::byte*>(allocator->Allocate(a.layout));
+      if (a.ptr != nullptr) {
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(a.ptr) % alignment, 0U);
+        fill(index);
+      }
+    } else if (next_random() % 4 == 0) {
+      ASSERT_TRUE(check(index)) << "step " << step;
+      const size_t new_size = next_random() % 256 + 1;
+      if (allocator->Resize(a.ptr, a.layout, new_size)) {
+        a.layout = Layout(new_size, a.layout.alignment());
+        fill(index);
+      }
+    } else {
+      ASSERT_TRUE(check(index)) << "step " << step;
+      allocator->Deallocate(a.ptr, a.layout);
+      a.ptr = nullptr;
+    }
+  }
+
+  for (size_t i = 0; i < kAllocations; ++i) {
+    Allocation& a = allocations[i];
+    if (a.ptr != nullptr) {
+      ASSERT_TRUE(check(i));
+      allocator->Deallocate(a.ptr, a.layout);
+    }
+  }
+
+  // All of the blocks were merged back together.
+  size_t blocks = 0;
+  for (auto* block : allocator->blocks()) {
+    EXPECT_FALSE(block->Used());
+    ++blocks;
+  }
+  EXPECT_EQ(blocks, 1U);
+}
+
+}  // namespace
+}  // namespace pw::allocator
@@ -14,6 +14,7 @@
 #include "pw_async_basic/dispatcher.h"
 
 #include <mutex>
+#include <optional>
 
 #include "pw_chrono/system_clock.h"
 
@@ -64,33 +65,32 @@ void BasicDispatcher::RunFor(chrono::SystemClock::duration duration) {
 }
 
 void BasicDispatcher::MaybeSleep() {
-  if (task_queue_.empty() || task_queue_.front().due_time_ > now()) {
-    // Sleep until a notification is received or until the due time of the
-    // next task. Notifications are sent when tasks are posted or 'stop' is
-    // requested.
-    std::optional<chrono::SystemClock::time_point> wake_time = std::nullopt;
-    if (!task_queue_.empty()) {
-      wake_time = task_queue_.front().due_time_;
-    }
-    lock_.unlock();
-    if (wake_time.has_value()) {
-      timed_notification_.try_acquire_until(*wake_time);
-    } else {
-      timed_notification_.acquire();
-    }
-    lock_.lock();
+  // Sleep until a notification is received or until the due time of the next
+  // task. Notifications are sent when tasks are posted or 'stop' is requested.
+  const std::optional<chrono::SystemClock::time_point> wake_time =
+      task_queue_.NextWakeTime();
+  if (wake_time.has_value() && *wake_time <= now()) {
+    return;
+  }
+  lock_.unlock();
+  if (wake_time.has_value()) {
+    timed_notification_.try_acquire_until(*wake_time);
+  } else {
+    timed_notification_.acquire();
   }
+  lock_.lock();
 }
 
 void BasicDispatcher::ExecuteDueTasks() {
-  while (!task_queue_.empty() && task_queue_.front().due_time_ <= now() &&
-         !stop_requested_) {
-    backend::NativeTask& task = task_queue_.front();
-    task_queue_.pop_front();
+  while (!stop_requested_) {
+    backend::NativeTask* task = task_queue_.PopDue(now());
+    if (task == nullptr) {
+      break;
+    }
 
     lock_.unlock();
-    Context ctx{this, &task.task_};
-    task(ctx, OkStatus());
+    Context ctx{this, &task->task_};
+    (*task)(ctx, OkStatus());
     lock_.lock();
   }
 }
@@ -104,13 +104,11 @@ void BasicDispatcher::RequestStop() {
 }
 
 void BasicDispatcher::DrainTaskQueue() {
-  while (!task_queue_.empty()) {
-    backend::NativeTask& task = task_queue_.front();
-    task_queue_.pop_front();
-
+  backend::NativeTask* task;
+  while ((task = task_queue_.PopFront()) != nullptr) {
     lock_.unlock();
-    Context ctx{this, &task.task_};
-    task(ctx, Status::Cancelled());
+    Context ctx{this, &task->task_};
+    (*task)(ctx, Status::Cancelled());
     lock_.lock();
   }
 }
@@ -121,20 +119,13 @@ void BasicDispatcher::PostAt(Task& task, chrono::SystemClock::time_point time) {
 
 bool BasicDispatcher::Cancel(Task& task) {
   std::lock_guard lock(lock_);
-  return task_queue_.remove(task.native_type());
+  return task_queue_.Cancel(task.native_type());
 }
 
 void BasicDispatcher::PostTaskInternal(
     backend::NativeTask& task, chrono::SystemClock::time_point time_due) {
   lock_.lock();
-  task.due_time_ = time_due;
-  auto it_front = task_queue_.begin();
-  auto it_behind = task_queue_.before_begin();
-  while (it_front != task_queue_.end() && time_due > it_front->due_time_) {
-    ++it_front;
-    ++it_behind;
-  }
-  task_queue_.insert_after(it_behind, task);
+  task_queue_.Post(task, time_due);
   lock_.unlock();
   timed_notification_.release();
 }
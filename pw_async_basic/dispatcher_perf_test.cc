@@ -0,0 +1,71 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures posting and then cancelling 100k timers on a BasicDispatcher, such
+// as the retry and keepalive timeouts of a busy host service. The timers are
+// due at random times within a minute or within a day.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/check.h"
+#include "pw_async/task.h"
+#include "pw_async_basic/dispatcher.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::async {
+namespace {
+
+constexpr size_t kTimers = 100000;
+
+std::array<Task, kTimers>& Timers() {
+  static std::array<Task, kTimers> timers;
+  return timers;
+}
+
+void PostAndCancel(perf_test::State& state,
+                   chrono::SystemClock::duration spread) {
+  std::array<Task, kTimers>& timers = Timers();
+  BasicDispatcher dispatcher;
+  const chrono::SystemClock::time_point start = dispatcher.now();
+  const auto spread_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             spread)
+                             .count();
+
+  while (state.KeepRunning()) {
+    uint32_t random = 1;
+    for (Task& timer : timers) {
+      random = random * 1103515245u + 12345u;
+      dispatcher.PostAt(timer,
+                        start + chrono::SystemClock::for_at_least(
+                                    std::chrono::milliseconds(
+                                        (random >> 8) % spread_ms + 1)));
+    }
+    for (Task& timer : timers) {
+      PW_CHECK(dispatcher.Cancel(timer));
+    }
+  }
+}
+
+constexpr auto kMinute = std::chrono::minutes(1);
+constexpr auto kDay = std::chrono::hours(24);
+
+PW_PERF_TEST(PostAndCancel100kTimersWithinAMinute, PostAndCancel, kMinute);
+PW_PERF_TEST(PostAndCancel100kTimersWithinADay, PostAndCancel, kDay);
+
+}  // namespace
+}  // namespace pw::async
@@ -198,4 +198,60 @@ TEST(DispatcherBasic, TasksCancelledByRunFor) {
   ASSERT_EQ(count, 3);
 }
 
+struct TaskOrder {
+  Task* tasks[5] = {};
+  int count = 0;
+};
+
+TEST(DispatcherBasic, TasksRunInDueTimeOrder) {
+  BasicDispatcher dispatcher;
+  const chrono::SystemClock::time_point now = dispatcher.now();
+
+  TaskOrder order;
+  auto record = [&order](Context& c, Status status) {
+    ASSERT_OK(status);
+    order.tasks[order.count++] = c.task;
+  };
+  Task task0(record), task1(record), task2(record), task3(record),
+      task4(record);
+
+  // Tasks due at the same time run in the order they were posted.
+  dispatcher.PostAt(task0, now - 1ms);
+  dispatcher.PostAt(task1, now - 5s);
+  dispatcher.PostAt(task2, now - 1ms);
+  dispatcher.PostAt(task3, now - 1h);
+  dispatcher.PostAt(task4, now - 1ms);
+
+  dispatcher.RunUntilIdle();
+  ASSERT_EQ(order.count, 5);
+  EXPECT_EQ(order.tasks[0], &task3);
+  EXPECT_EQ(order.tasks[1], &task1);
+  EXPECT_EQ(order.tasks[2], &task0);
+  EXPECT_EQ(order.tasks[3], &task2);
+  EXPECT_EQ(order.tasks[4], &task4);
+}
+
+TEST(DispatcherBasic, CancelPendingTasks) {
+  int count = 0;
+  auto inc_count = [&count]([[maybe_unused]] Context& c, Status status) {
+    ASSERT_OK(status);
+    ++count;
+  };
+  Task task0(inc_count), task1(inc_count), task2(inc_count);
+
+  BasicDispatcher dispatcher;
+  EXPECT_FALSE(dispatcher.Cancel(task0));
+
+  dispatcher.PostAfter(task0, 10s);
+  dispatcher.PostAfter(task1, 100h);
+  dispatcher.Post(task2);
+  EXPECT_TRUE(dispatcher.Cancel(task0));
+  EXPECT_TRUE(dispatcher.Cancel(task1));
+  EXPECT_FALSE(dispatcher.Cancel(task1));
+
+  dispatcher.RunUntilIdle();
+  EXPECT_EQ(count, 1);
+  EXPECT_FALSE(dispatcher.Cancel(task2));
+}
+
 }  // namespace pw::async
@@ -15,6 +15,7 @@
 
 #include "pw_async/dispatcher.h"
 #include "pw_async/task.h"
+#include "pw_async_basic/internal/timer_wheel.h"
 #include "pw_sync/interrupt_spin_lock.h"
 #include "pw_sync/lock_annotations.h"
 #include "pw_sync/timed_thread_notification.h"
@@ -23,9 +24,14 @@
 namespace pw::async {
 
 /// BasicDispatcher is a generic implementation of Dispatcher.
+///
+/// Posting and cancelling a task take constant time, regardless of how many
+/// tasks are pending. Tasks due at the same time run in the order they were
+/// posted. Posting a task that is already pending only changes its due time if
+/// the new due time is earlier.
 class BasicDispatcher final : public Dispatcher, public thread::ThreadCore {
  public:
-  explicit BasicDispatcher() = default;
+  explicit BasicDispatcher() : task_queue_(chrono::SystemClock::now()) {}
   ~BasicDispatcher() override;
 
   /// Execute all runnable tasks and return without waiting.
@@ -62,8 +68,7 @@ class BasicDispatcher final : public Dispatcher, public thread::ThreadCore {
   }
 
  private:
-  // Insert |task| into task_queue_ maintaining its min-heap property, keyed by
-  // |time_due|.
+  // Insert |task| into task_queue_, keyed by |time_due|.
   void PostTaskInternal(backend::NativeTask& task,
                         chrono::SystemClock::time_point time_due)
       PW_LOCKS_EXCLUDED(lock_);
@@ -83,7 +88,7 @@ class BasicDispatcher final : public Dispatcher, public thread::ThreadCore {
   sync::TimedThreadNotification timed_notification_;
   bool stop_requested_ PW_GUARDED_BY(lock_) = false;
   // A priority queue of scheduled Tasks sorted by earliest due times first.
-  IntrusiveList<backend::NativeTask> task_queue_ PW_GUARDED_BY(lock_);
+  internal::TimerWheel task_queue_ PW_GUARDED_BY(lock_);
 };
 
 }  // namespace pw::async
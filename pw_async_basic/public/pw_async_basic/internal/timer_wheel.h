@@ -0,0 +1,154 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_async_basic/task.h"
+#include "pw_chrono/system_clock.h"
+
+namespace pw::async::internal {
+
+// A queue of tasks ordered by due time, with O(1) Post() and Cancel().
+//
+// Tasks are kept in a hierarchical timer wheel. The wheel divides time into
+// ticks of kResolution. Each level has 64 slots, and each slot of a level spans
+// 64 slots of the level below it. A task is stored in the lowest level at which
+// its due tick and the current tick differ. When the current tick reaches a
+// slot, its tasks move down a level, until they reach the ready list. Tasks due
+// too far in the future for the wheel are kept in an overflow list, which is
+// checked each time the wheel wraps around.
+//
+// The ready list holds the tasks whose due tick has been reached, sorted by
+// due time. Tasks with the same due time are run in the order they were posted.
+//
+// This class is not thread safe.
+class TimerWheel {
+ public:
+  using time_point = chrono::SystemClock::time_point;
+
+  static constexpr chrono::SystemClock::duration kResolution =
+      chrono::SystemClock::for_at_least(std::chrono::milliseconds(1));
+
+  static constexpr size_t kLevels = 4;
+  static constexpr size_t kSlotsPerLevel = 64;
+
+  // Starts the wheel at the given time. Tasks may be due before it.
+  explicit TimerWheel(time_point now) : current_tick_(ToTick(now)) {}
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Adds a task to the queue. If the task is already queued, it is only moved
+  // if the new due time is earlier.
+  void Post(backend::NativeTask& task, time_point due_time);
+
+  // Removes a task from the queue. Returns false if the task was not queued.
+  bool Cancel(backend::NativeTask& task);
+
+  // Removes and returns the earliest task that is due at or before now, or
+  // nullptr if there is none.
+  backend::NativeTask* PopDue(time_point now);
+
+  // Removes and returns the earliest task, regardless of its due time, or
+  // nullptr if the queue is empty.
+  backend::NativeTask* PopFront();
+
+  // Returns a time at or before the earliest due time of the queued tasks, at
+  // which PopDue() should be called again. Returns std::nullopt if the queue is
+  // empty.
+  std::optional<time_point> NextWakeTime() const;
+
+  bool empty() const {
+    return ready_.empty() && overflow_.empty() && NextSlotTick() == kNoTick;
+  }
+
+ private:
+  // A circular doubly-linked list of tasks. head_->queue_prev_ is the tail.
+  class TaskList {
+   public:
+    constexpr TaskList() = default;
+
+    bool empty() const { return head_ == nullptr; }
+    backend::NativeTask& front() const { return *head_; }
+
+    void push_back(backend::NativeTask& task);
+    void insert_sorted(backend::NativeTask& task);
+    void remove(backend::NativeTask& task);
+    backend::NativeTask& pop_front();
+
+    // Moves all of the tasks into a new list.
+    TaskList take() {
+      TaskList list;
+      list.head_ = head_;
+      head_ = nullptr;
+      return list;
+    }
+
+   private:
+    void insert_before(backend::NativeTask& next, backend::NativeTask& task);
+
+    backend::NativeTask* head_ = nullptr;
+  };
+
+  // Values for NativeTask::queue_slot_, in addition to the wheel slots.
+  static constexpr uint16_t kReadySlot = kLevels * kSlotsPerLevel;
+  static constexpr uint16_t kOverflowSlot = kReadySlot + 1;
+
+  static constexpr unsigned kBitsPerLevel = 6;
+  static constexpr unsigned kWheelBits = kLevels * kBitsPerLevel;
+  static constexpr uint64_t kNoTick = ~uint64_t{0};
+
+  static_assert(kSlotsPerLevel == uint64_t{1} << kBitsPerLevel);
+
+  static uint64_t ToTick(time_point time);
+  static time_point FromTick(uint64_t tick);
+
+  // Adds an unqueued task to the list for its due time.
+  void Insert(backend::NativeTask& task);
+
+  // Removes a queued task from its list.
+  void Remove(backend::NativeTask& task);
+
+  // Advances the current tick to the given tick, moving the tasks whose due
+  // tick is reached to the ready list.
+  void AdvanceTo(uint64_t tick);
+
+  // Advances the current tick to the next tick at which a slot is reached, or
+  // at which the overflow list must be checked.
+  void AdvanceToNextEvent(uint64_t next_event);
+
+  // Returns the tick at which the next occupied slot is reached, or kNoTick.
+  uint64_t NextSlotTick() const;
+
+  // Returns the tick at which the next slot is reached or the overflow list
+  // must be checked, or kNoTick.
+  uint64_t NextEventTick() const;
+
+  std::array<TaskList, kLevels * kSlotsPerLevel> slots_;
+
+  // One bit per slot of each level, set if the slot is not empty. Only slots
+  // after the current tick's slot are ever occupied.
+  std::array<uint64_t, kLevels> occupied_{};
+
+  TaskList ready_;
+  TaskList overflow_;
+  uint64_t current_tick_;
+};
+
+}  // namespace pw::async::internal
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 #include "pw_async/context.h"
 #include "pw_async/task_function.h"
 #include "pw_chrono/system_clock.h"
@@ -20,6 +22,9 @@
 
 namespace pw::async {
 class BasicDispatcher;
+namespace internal {
+class TimerWheel;
+}
 namespace test::backend {
 class NativeFakeDispatcher;
 }
@@ -32,6 +37,7 @@ class NativeTask final : public IntrusiveList<NativeTask>::Item {
  private:
   friend class ::pw::async::Task;
   friend class ::pw::async::BasicDispatcher;
+  friend class ::pw::async::internal::TimerWheel;
   friend class ::pw::async::test::backend::NativeFakeDispatcher;
 
   NativeTask(::pw::async::Task& task) : task_(task) {}
@@ -45,6 +51,12 @@ class NativeTask final : public IntrusiveList<NativeTask>::Item {
     due_time_ = due_time;
   }
 
+  static constexpr uint16_t kNotQueued = 0xffff;
+
+  // The BasicDispatcher queue slot that holds this task. queue_slot_ is placed
+  // first to use the padding before func_, which has an alignment of 8 on
+  // 32-bit systems.
+  uint16_t queue_slot_ = kNotQueued;
   TaskFunction func_ = nullptr;
   // task_ is placed after func_ to take advantage of the padding that would
   // otherwise be added here. On 32-bit systems, func_ and due_time_ have an
@@ -52,6 +64,9 @@ class NativeTask final : public IntrusiveList<NativeTask>::Item {
   // padding would be added here, which is just enough for a pointer.
   Task& task_;
   pw::chrono::SystemClock::time_point due_time_;
+  // Links for the BasicDispatcher queue slot.
+  NativeTask* queue_prev_ = nullptr;
+  NativeTask* queue_next_ = nullptr;
 };
 
 using NativeTaskHandle = NativeTask&;
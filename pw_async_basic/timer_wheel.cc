@@ -0,0 +1,259 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async_basic/internal/timer_wheel.h"
+
+#include <algorithm>
+
+#include "lib/stdcompat/bit.h"
+
+namespace pw::async::internal {
+
+using backend::NativeTask;
+
+void TimerWheel::TaskList::insert_before(NativeTask& next, NativeTask& task) {
+  NativeTask& prev = *next.queue_prev_;
+  task.queue_prev_ = &prev;
+  task.queue_next_ = &next;
+  prev.queue_next_ = &task;
+  next.queue_prev_ = &task;
+}
+
+void TimerWheel::TaskList::push_back(NativeTask& task) {
+  if (head_ == nullptr) {
+    task.queue_prev_ = &task;
+    task.queue_next_ = &task;
+    head_ = &task;
+    return;
+  }
+  insert_before(*head_, task);
+}
+
+void TimerWheel::TaskList::insert_sorted(NativeTask& task) {
+  if (head_ == nullptr) {
+    push_back(task);
+    return;
+  }
+
+  // Search from the back, since tasks are usually posted in due time order.
+  // Tasks go after any tasks that are due at the same time.
+  NativeTask* next = head_;
+  do {
+    NativeTask* prev = next->queue_prev_;
+    if (prev->due_time_ <= task.due_time_) {
+      insert_before(*next, task);
+      return;
+    }
+    next = prev;
+  } while (next != head_);
+
+  // The task is due before all others.
+  insert_before(*head_, task);
+  head_ = &task;
+}
+
+void TimerWheel::TaskList::remove(NativeTask& task) {
+  if (task.queue_next_ == &task) {
+    head_ = nullptr;
+  } else {
+    task.queue_prev_->queue_next_ = task.queue_next_;
+    task.queue_next_->queue_prev_ = task.queue_prev_;
+    if (head_ == &task) {
+      head_ = task.queue_next_;
+    }
+  }
+  task.queue_prev_ = nullptr;
+  task.queue_next_ = nullptr;
+}
+
+NativeTask& TimerWheel::TaskList::pop_front() {
+  NativeTask& task = *head_;
+  remove(task);
+  return task;
+}
+
+uint64_t TimerWheel::ToTick(time_point time) {
+  const auto ticks = time.time_since_epoch().count();
+  if (ticks <= 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(ticks) /
+         static_cast<uint64_t>(kResolution.count());
+}
+
+TimerWheel::time_point TimerWheel::FromTick(uint64_t tick) {
+  return time_point(kResolution * static_cast<int64_t>(tick));
+}
+
+void TimerWheel::Post(NativeTask& task, time_point due_time) {
+  if (task.queue_slot_ != NativeTask::kNotQueued) {
+    if (task.due_time_ <= due_time) {
+      // No need to repost a task that was already queued to run.
+      return;
+    }
+    Remove(task);
+  }
+  task.due_time_ = due_time;
+  Insert(task);
+}
+
+bool TimerWheel::Cancel(NativeTask& task) {
+  if (task.queue_slot_ == NativeTask::kNotQueued) {
+    return false;
+  }
+  Remove(task);
+  return true;
+}
+
+NativeTask* TimerWheel::PopDue(time_point now) {
+  AdvanceTo(ToTick(now));
+  if (ready_.empty() || ready_.front().due_time_ > now) {
+    return nullptr;
+  }
+  NativeTask& task = ready_.pop_front();
+  task.queue_slot_ = NativeTask::kNotQueued;
+  return &task;
+}
+
+NativeTask* TimerWheel::PopFront() {
+  while (ready_.empty()) {
+    const uint64_t next_event = NextEventTick();
+    if (next_event == kNoTick) {
+      return nullptr;
+    }
+    AdvanceToNextEvent(next_event);
+  }
+  NativeTask& task = ready_.pop_front();
+  task.queue_slot_ = NativeTask::kNotQueued;
+  return &task;
+}
+
+std::optional<TimerWheel::time_point> TimerWheel::NextWakeTime() const {
+  if (!ready_.empty()) {
+    return ready_.front().due_time_;
+  }
+  const uint64_t next_event = NextEventTick();
+  if (next_event == kNoTick) {
+    return std::nullopt;
+  }
+  return FromTick(next_event);
+}
+
+void TimerWheel::Insert(NativeTask& task) {
+  const uint64_t tick = ToTick(task.due_time_);
+  if (tick <= current_tick_) {
+    task.queue_slot_ = kReadySlot;
+    ready_.insert_sorted(task);
+    return;
+  }
+
+  // Use the lowest level above which the due tick and current tick match.
+  const unsigned highest_different_bit =
+      static_cast<unsigned>(cpp20::bit_width(tick ^ current_tick_)) - 1;
+  const unsigned level = highest_different_bit / kBitsPerLevel;
+  if (level >= kLevels) {
+    task.queue_slot_ = kOverflowSlot;
+    overflow_.push_back(task);
+    return;
+  }
+
+  const unsigned index =
+      static_cast<unsigned>(tick >> (level * kBitsPerLevel)) % kSlotsPerLevel;
+  task.queue_slot_ = static_cast<uint16_t>(level * kSlotsPerLevel + index);
+  slots_[task.queue_slot_].push_back(task);
+  occupied_[level] |= uint64_t{1} << index;
+}
+
+void TimerWheel::Remove(NativeTask& task) {
+  const uint16_t slot = task.queue_slot_;
+  task.queue_slot_ = NativeTask::kNotQueued;
+
+  if (slot == kReadySlot) {
+    ready_.remove(task);
+  } else if (slot == kOverflowSlot) {
+    overflow_.remove(task);
+  } else {
+    slots_[slot].remove(task);
+    if (slots_[slot].empty()) {
+      occupied_[slot / kSlotsPerLevel] &=
+          ~(uint64_t{1} << (slot % kSlotsPerLevel));
+    }
+  }
+}
+
+void TimerWheel::AdvanceTo(uint64_t tick) {
+  for (uint64_t next_event = NextEventTick(); next_event <= tick;
+       next_event = NextEventTick()) {
+    AdvanceToNextEvent(next_event);
+  }
+  current_tick_ = std::max(current_tick_, tick);
+}
+
+void TimerWheel::AdvanceToNextEvent(uint64_t next_event) {
+  current_tick_ = next_event;
+
+  // Tasks in the overflow list may now fit in the wheel.
+  if (current_tick_ % (uint64_t{1} << kWheelBits) == 0) {
+    TaskList overflow = overflow_.take();
+    while (!overflow.empty()) {
+      Insert(overflow.pop_front());
+    }
+  }
+
+  // Move the tasks in the slots that were reached down a level, or to the
+  // ready list from the lowest level. Start at the top, since its tasks may
+  // move into slots of lower levels that were reached at the same time.
+  for (size_t level = kLevels; level-- > 0;) {
+    const unsigned index =
+        static_cast<unsigned>(current_tick_ >> (level * kBitsPerLevel)) %
+        kSlotsPerLevel;
+    const uint64_t bit = uint64_t{1} << index;
+    if ((occupied_[level] & bit) == 0u) {
+      continue;
+    }
+    occupied_[level] &= ~bit;
+    TaskList reached = slots_[level * kSlotsPerLevel + index].take();
+    while (!reached.empty()) {
+      Insert(reached.pop_front());
+    }
+  }
+}
+
+uint64_t TimerWheel::NextSlotTick() const {
+  uint64_t next = kNoTick;
+  for (size_t level = 0; level < kLevels; ++level) {
+    if (occupied_[level] == 0u) {
+      continue;
+    }
+    // All occupied slots are after the current tick's slot, and share the
+    // current tick's bits above this level.
+    const unsigned shift = static_cast<unsigned>(level) * kBitsPerLevel;
+    const uint64_t base =
+        current_tick_ >> (shift + kBitsPerLevel) << (shift + kBitsPerLevel);
+    const auto index =
+        static_cast<uint64_t>(cpp20::countr_zero(occupied_[level]));
+    next = std::min(next, base | (index << shift));
+  }
+  return next;
+}
+
+uint64_t TimerWheel::NextEventTick() const {
+  uint64_t next = NextSlotTick();
+  if (!overflow_.empty()) {
+    next = std::min(next, ((current_tick_ >> kWheelBits) + 1) << kWheelBits);
+  }
+  return next;
+}
+
+}  // namespace pw::async::internal
@@ -0,0 +1,300 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async_basic/internal/timer_wheel.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_async/task.h"
+
+using namespace std::chrono_literals;
+
+namespace pw::async::internal {
+namespace {
+
+using time_point = chrono::SystemClock::time_point;
+
+constexpr time_point kStart =
+    time_point(chrono::SystemClock::for_at_least(123456789ms));
+
+time_point At(chrono::SystemClock::duration offset) { return kStart + offset; }
+
+class TimerWheelTest : public ::testing::Test {
+ protected:
+  TimerWheelTest() : wheel_(kStart) {}
+
+  backend::NativeTask& task(size_t index) {
+    return tasks_[index].native_type();
+  }
+
+  // Returns the index of the next due task, or -1 if none is due.
+  int PopDue(time_point now) { return IndexOf(wheel_.PopDue(now)); }
+
+  int PopFront() { return IndexOf(wheel_.PopFront()); }
+
+  TimerWheel wheel_;
+
+ private:
+  int IndexOf(backend::NativeTask* native_task) {
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+      if (native_task == &tasks_[i].native_type()) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  std::array<Task, 8> tasks_;
+};
+
+TEST_F(TimerWheelTest, Empty) {
+  EXPECT_TRUE(wheel_.empty());
+  EXPECT_EQ(wheel_.NextWakeTime(), std::nullopt);
+  EXPECT_EQ(PopDue(At(1h)), -1);
+  EXPECT_EQ(PopFront(), -1);
+}
+
+TEST_F(TimerWheelTest, PopsTasksInDueTimeOrder) {
+  wheel_.Post(task(0), At(30s));
+  wheel_.Post(task(1), At(5ms));
+  wheel_.Post(task(2), At(-1s));
+  wheel_.Post(task(3), At(72h));
+  wheel_.Post(task(4), At(100ms));
+  EXPECT_FALSE(wheel_.empty());
+
+  EXPECT_EQ(PopDue(kStart), 2);
+  EXPECT_EQ(PopDue(kStart), -1);
+  EXPECT_EQ(PopDue(At(99ms)), 1);
+  EXPECT_EQ(PopDue(At(99ms)), -1);
+  EXPECT_EQ(PopDue(At(1h)), 4);
+  EXPECT_EQ(PopDue(At(1h)), 0);
+  EXPECT_EQ(PopDue(At(1h)), -1);
+  EXPECT_EQ(PopDue(At(72h)), 3);
+  EXPECT_TRUE(wheel_.empty());
+}
+
+TEST_F(TimerWheelTest, TaskIsNotDueBeforeItsDueTime) {
+  const auto due = At(std::chrono::microseconds(2500));
+  wheel_.Post(task(0), due);
+
+  EXPECT_EQ(PopDue(due - std::chrono::microseconds(1)), -1);
+  ASSERT_TRUE(wheel_.NextWakeTime().has_value());
+  EXPECT_LE(*wheel_.NextWakeTime(), due);
+  EXPECT_EQ(PopDue(due), 0);
+}
+
+TEST_F(TimerWheelTest, NextWakeTimeIsNeverAfterNextTask) {
+  const auto due = At(5h + 123ms);
+  wheel_.Post(task(0), due);
+
+  // Following the wake times must reach the task.
+  time_point now = kStart;
+  for (int wakes = 0; wakes < 100; ++wakes) {
+    ASSERT_TRUE(wheel_.NextWakeTime().has_value());
+    ASSERT_LE(*wheel_.NextWakeTime(), due);
+    ASSERT_GE(*wheel_.NextWakeTime(), now);
+    now = *wheel_.NextWakeTime();
+    if (PopDue(now) == 0) {
+      EXPECT_EQ(now, due);
+      return;
+    }
+  }
+  FAIL() << "Task was never due";
+}
+
+TEST_F(TimerWheelTest, SameDueTimeRunsInPostOrder) {
+  const auto due = At(10s);
+  wheel_.Post(task(0), due);
+  wheel_.Post(task(1), due);
+
+  // Tasks posted later are stored lower in the wheel, since they are closer
+  // to the current time.
+  EXPECT_EQ(PopDue(At(9s)), -1);
+  wheel_.Post(task(2), due);
+  EXPECT_EQ(PopDue(At(10s) - 1ms), -1);
+  wheel_.Post(task(3), due);
+  EXPECT_EQ(PopDue(due), 0);
+  wheel_.Post(task(4), due);
+
+  EXPECT_EQ(PopDue(due), 1);
+  EXPECT_EQ(PopDue(due), 2);
+  EXPECT_EQ(PopDue(due), 3);
+  EXPECT_EQ(PopDue(due), 4);
+  EXPECT_EQ(PopDue(due), -1);
+}
+
+TEST_F(TimerWheelTest, Cancel) {
+  EXPECT_FALSE(wheel_.Cancel(task(0)));
+
+  wheel_.Post(task(0), At(1ms));
+  wheel_.Post(task(1), At(1s));
+  wheel_.Post(task(2), At(1000h));
+  wheel_.Post(task(3), kStart);
+
+  EXPECT_TRUE(wheel_.Cancel(task(1)));
+  EXPECT_FALSE(wheel_.Cancel(task(1)));
+  EXPECT_TRUE(wheel_.Cancel(task(2)));
+  EXPECT_TRUE(wheel_.Cancel(task(3)));
+
+  EXPECT_EQ(PopFront(), 0);
+  EXPECT_EQ(PopFront(), -1);
+  EXPECT_TRUE(wheel_.empty());
+  EXPECT_FALSE(wheel_.Cancel(task(0)));
+}
+
+TEST_F(TimerWheelTest, RepostEarlierMovesTask) {
+  wheel_.Post(task(0), At(1s));
+  wheel_.Post(task(1), At(2s));
+  wheel_.Post(task(1), At(500ms));
+
+  EXPECT_EQ(PopDue(At(500ms)), 1);
+  EXPECT_EQ(PopDue(At(500ms)), -1);
+  EXPECT_EQ(PopDue(At(2s)), 0);
+  EXPECT_EQ(PopDue(At(2s)), -1);
+}
+
+TEST_F(TimerWheelTest, RepostLaterDoesNotMoveTask) {
+  wheel_.Post(task(0), At(1s));
+  wheel_.Post(task(0), At(2s));
+
+  EXPECT_EQ(PopDue(At(1s)), 0);
+  EXPECT_EQ(PopDue(At(2s)), -1);
+}
+
+TEST_F(TimerWheelTest, PopFrontDrainsInDueTimeOrder) {
+  wheel_.Post(task(0), At(20h));
+  wheel_.Post(task(1), At(3ms));
+  wheel_.Post(task(2), At(-5ms));
+  wheel_.Post(task(3), At(3ms));
+  wheel_.Post(task(4), At(40s));
+
+  EXPECT_EQ(PopFront(), 2);
+  EXPECT_EQ(PopFront(), 1);
+  EXPECT_EQ(PopFront(), 3);
+  EXPECT_EQ(PopFront(), 4);
+  EXPECT_EQ(PopFront(), 0);
+  EXPECT_EQ(PopFront(), -1);
+}
+
+// Checks random operations against a simple model of the queue.
+TEST(TimerWheel, MatchesModel) {
+  constexpr size_t kTasks = 64;
+  std::array<Task, kTasks> tasks;
+
+  struct Expected {
+    bool queued = false;
+    time_point due;
+    uint64_t sequence = 0;
+  };
+  std::array<Expected, kTasks> expected;
+  uint64_t sequence = 0;
+
+  TimerWheel wheel(kStart);
+  time_point now = kStart;
+
+  // Returns the index of the first task in the model that is due at or before
+  // the given time.
+  auto first_due = [&expected](std::optional<time_point> time) -> size_t {
+    size_t first = kTasks;
+    for (size_t i = 0; i < kTasks; ++i) {
+      const Expected& e = expected[i];
+      if (!e.queued || (time.has_value() && e.due > *time)) {
+        continue;
+      }
+      if (first == kTasks || e.due < expected[first].due ||
+          (e.due == expected[first].due &&
+           e.sequence < expected[first].sequence)) {
+        first = i;
+      }
+    }
+    return first;
+  };
+
+  auto index_of = [&tasks](backend::NativeTask* task) -> size_t {
+    for (size_t i = 0; i < kTasks; ++i) {
+      if (task == &tasks[i].native_type()) {
+        return i;
+      }
+    }
+    return kTasks;
+  };
+
+  // Delays are spread evenly over orders of magnitude from microseconds to
+  // about 100 days, so that every level and the overflow list are used.
+  uint32_t random = 1;
+  auto next_random = [&random]() {
+    random = random * 1103515245u + 12345u;
+    return random >> 8;
+  };
+  auto random_delay = [&next_random]() -> chrono::SystemClock::duration {
+    const uint32_t scale = next_random() % 34;
+    return chrono::SystemClock::for_at_least(std::chrono::microseconds(
+        static_cast<int64_t>(next_random() % 1000) << scale));
+  };
+
+  for (int step = 0; step < 20000; ++step) {
+    const uint32_t action = next_random() % 8;
+    const size_t index = next_random() % kTasks;
+
+    if (action < 3) {
+      time_point due = now + std::chrono::seconds(next_random() % 4);
+      if (action == 0) {
+        due = now - random_delay();
+      } else if (action == 1) {
+        due = now + random_delay();
+      }
+      Expected& e = expected[index];
+      if (!e.queued || due < e.due) {
+        e.queued = true;
+        e.due = due;
+        e.sequence = sequence++;
+      }
+      wheel.Post(tasks[index].native_type(), due);
+    } else if (action == 3) {
+      ASSERT_EQ(wheel.Cancel(tasks[index].native_type()),
+                expected[index].queued);
+      expected[index].queued = false;
+    } else if (action == 4) {
+      const size_t first = first_due(std::nullopt);
+      const size_t popped = index_of(wheel.PopFront());
+      ASSERT_EQ(popped, first) << "step " << step;
+      if (first != kTasks) {
+        expected[first].queued = false;
+      }
+    } else {
+      now += random_delay() / 4;
+      const size_t first = first_due(now);
+      const size_t popped = index_of(wheel.PopDue(now));
+      ASSERT_EQ(popped, first) << "step " << step;
+      if (first != kTasks) {
+        expected[first].queued = false;
+      }
+    }
+
+    const size_t next = first_due(std::nullopt);
+    ASSERT_EQ(wheel.empty(), next == kTasks);
+    if (next != kTasks) {
+      ASSERT_TRUE(wheel.NextWakeTime().has_value());
+      ASSERT_LE(*wheel.NextWakeTime(), expected[next].due) << "step " << step;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace pw::async::internal
@@ -0,0 +1,91 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures Base64 encoding, validation, and decoding of 4 KiB of binary data,
+// split into messages of different sizes. 12-byte messages are typical of
+// tokenized logs.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_assert/check.h"
+#include "pw_base64/base64.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+
+namespace pw::base64 {
+namespace {
+
+constexpr size_t kBinarySize = 4096;
+
+const std::array<std::byte, kBinarySize>& Binary() {
+  static std::array<std::byte, kBinarySize> binary = [] {
+    std::array<std::byte, kBinarySize> bytes;
+    uint32_t value = 1;
+    for (std::byte& b : bytes) {
+      value = value * 1103515245u + 12345u;
+      b = static_cast<std::byte>(value >> 24);
+    }
+    return bytes;
+  }();
+  return binary;
+}
+
+void EncodeMessages(perf_test::State& state, size_t message_size) {
+  static std::array<char, EncodedSize(kBinarySize)> output;
+  const span<const std::byte> binary = Binary();
+
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i + message_size <= binary.size(); i += message_size) {
+      Encode(binary.subspan(i, message_size), output.data());
+    }
+  }
+}
+
+void DecodeMessages(perf_test::State& state, size_t message_size) {
+  static std::array<char, EncodedSize(kBinarySize)> encoded;
+  static std::array<std::byte, MaxDecodedSize(EncodedSize(kBinarySize))>
+      output;
+  const span<const std::byte> binary = Binary();
+
+  const size_t encoded_size = EncodedSize(message_size);
+  size_t messages = 0;
+  for (size_t i = 0; i + message_size <= binary.size(); i += message_size) {
+    Encode(binary.subspan(i, message_size), &encoded[messages * encoded_size]);
+    messages += 1;
+  }
+
+  size_t decoded = 0;
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < messages; ++i) {
+      // Decode validates the message before decoding it.
+      decoded += Decode(
+          std::string_view(&encoded[i * encoded_size], encoded_size), output);
+    }
+  }
+  PW_CHECK_UINT_NE(decoded, 0);
+}
+
+PW_PERF_TEST(Encode12ByteMessages, EncodeMessages, 12);
+PW_PERF_TEST(Encode48ByteMessages, EncodeMessages, 48);
+PW_PERF_TEST(Encode4KiB, EncodeMessages, kBinarySize);
+
+PW_PERF_TEST(Decode12ByteMessages, DecodeMessages, 12);
+PW_PERF_TEST(Decode48ByteMessages, DecodeMessages, 48);
+PW_PERF_TEST(Decode4KiB, DecodeMessages, kBinarySize);
+
+}  // namespace
+}  // namespace pw::base64
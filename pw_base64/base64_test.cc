@@ -14,9 +14,12 @@
 
 #include "pw_base64/base64.h"
 
+#include <array>
+#include <cstdint>
 #include <cstring>
 
 #include "gtest/gtest.h"
+#include "pw_fuzzer/fuzztest.h"
 
 namespace pw::base64 {
 namespace {
@@ -449,5 +452,133 @@ TEST(Base64CLinkage, Decode) {
   EXPECT_STREQ("fo", output);
 }
 
+// Base64 implemented a bit at a time, to check the block-at-a-time encoding,
+// decoding, and validation against.
+constexpr std::string_view kAlphabet =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+size_t ReferenceEncode(span<const std::byte> binary, char* output) {
+  size_t size = 0;
+  uint32_t bits = 0;
+  int bit_count = 0;
+  for (std::byte b : binary) {
+    bits = (bits << 8) | static_cast<uint8_t>(b);
+    bit_count += 8;
+    while (bit_count >= 6) {
+      bit_count -= 6;
+      output[size++] = kAlphabet[(bits >> bit_count) & 0x3f];
+    }
+  }
+  if (bit_count > 0) {
+    output[size++] = kAlphabet[(bits << (6 - bit_count)) & 0x3f];
+  }
+  while (size % 4 != 0) {
+    output[size++] = '=';
+  }
+  return size;
+}
+
+bool ReferenceIsValidChar(char ch) {
+  return kAlphabet.find(ch) != std::string_view::npos || ch == '-' ||
+         ch == '_' || ch == '=';
+}
+
+constexpr size_t kMaxBinarySize = 512;
+
+void EncodeDecodeMatchesReference(span<const std::byte> binary) {
+  std::array<char, EncodedSize(kMaxBinarySize)> expected;
+  std::array<char, EncodedSize(kMaxBinarySize)> encoded;
+  const size_t size = ReferenceEncode(binary, expected.data());
+
+  ASSERT_EQ(Encode(binary, encoded), size);
+  ASSERT_EQ(std::string_view(encoded.data(), size),
+            std::string_view(expected.data(), size));
+  ASSERT_TRUE(IsValid(std::string_view(encoded.data(), size)));
+
+  std::array<std::byte, MaxDecodedSize(EncodedSize(kMaxBinarySize))> decoded;
+  ASSERT_EQ(Decode(std::string_view(encoded.data(), size), decoded),
+            binary.size());
+  ASSERT_EQ(std::memcmp(decoded.data(), binary.data(), binary.size()), 0);
+
+  // The URL-safe alphabet decodes to the same data.
+  for (size_t i = 0; i < size; ++i) {
+    if (encoded[i] == '+') {
+      encoded[i] = '-';
+    } else if (encoded[i] == '/') {
+      encoded[i] = '_';
+    }
+  }
+  ASSERT_EQ(Decode(std::string_view(encoded.data(), size), decoded),
+            binary.size());
+  ASSERT_EQ(std::memcmp(decoded.data(), binary.data(), binary.size()), 0);
+
+  // Decoding in place writes each byte after the characters it came from.
+  ASSERT_EQ(Decode(std::string_view(encoded.data(), size), encoded.data()),
+            binary.size());
+  ASSERT_EQ(std::memcmp(encoded.data(), binary.data(), binary.size()), 0);
+}
+
+TEST(Base64, LongData_MatchesReference) {
+  std::array<std::byte, kMaxBinarySize> binary;
+  uint32_t value = 1;
+  for (std::byte& b : binary) {
+    value = value * 1103515245u + 12345u;
+    b = static_cast<std::byte>(value >> 24);
+  }
+
+  for (size_t size = 0; size <= binary.size(); ++size) {
+    EncodeDecodeMatchesReference(span(binary).first(size));
+  }
+}
+
+TEST(Base64, LongData_EveryCharacter) {
+  // Group i encodes to four copies of character i of the alphabet.
+  std::array<std::byte, 64 * 3> binary;
+  for (size_t i = 0; i < 64; ++i) {
+    binary[3 * i] = static_cast<std::byte>(i << 2 | i >> 4);
+    binary[3 * i + 1] = static_cast<std::byte>((i & 0xf) << 4 | i >> 2);
+    binary[3 * i + 2] = static_cast<std::byte>((i & 0x3) << 6 | i);
+  }
+  EncodeDecodeMatchesReference(binary);
+
+  std::array<char, 64 * 4> encoded;
+  ASSERT_EQ(Encode(binary, encoded), encoded.size());
+  for (size_t i = 0; i < encoded.size(); ++i) {
+    ASSERT_EQ(encoded[i], kAlphabet[i / 4]);
+  }
+}
+
+FUZZ_TEST(Base64, EncodeDecodeMatchesReference)
+    .WithDomains(fuzzer::VectorOf<kMaxBinarySize>(
+        fuzzer::Arbitrary<std::byte>()));
+
+void IsValidMatchesReference(span<const char> base64) {
+  bool valid = base64.size() % 4 == 0;
+  for (char ch : base64) {
+    valid = valid && ReferenceIsValidChar(ch);
+  }
+  EXPECT_EQ(IsValid(std::string_view(base64.data(), base64.size())), valid);
+}
+
+TEST(Base64, IsValid_InvalidCharacterInLongData) {
+  std::array<char, 96> base64;
+  for (size_t i = 0; i < base64.size(); ++i) {
+    base64[i] = kAlphabet[i % kAlphabet.size()];
+  }
+
+  for (int ch = -128; ch < 128; ++ch) {
+    for (size_t i = 0; i < base64.size(); ++i) {
+      const char original = base64[i];
+      base64[i] = static_cast<char>(ch);
+      ASSERT_EQ(IsValid(std::string_view(base64.data(), base64.size())),
+                ReferenceIsValidChar(static_cast<char>(ch)));
+      base64[i] = original;
+    }
+  }
+}
+
+FUZZ_TEST(Base64, IsValidMatchesReference)
+    .WithDomains(fuzzer::VectorOf<256>(fuzzer::Arbitrary<char>()));
+
 }  // namespace
 }  // namespace pw::base64
@@ -14,10 +14,14 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
+
+#include "pw_checksum/internal/config.h"
+
 namespace pw::checksum {
 namespace {
 
-constexpr uint16_t kCrc16CcittTable[256]{
+constexpr std::array<uint16_t, 256> kCrc16CcittTable{
     0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
     0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
     0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
@@ -52,12 +56,28 @@ constexpr uint16_t kCrc16CcittTable[256]{
     0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0,  // 256
 };
 
+// Table k holds the CRC of each byte value followed by k zero bytes, so 8
+// bytes are folded into the CRC with independent lookups.
+constexpr std::array<std::array<uint16_t, 256>, 8> kCrc16CcittSlicingTables =
+    [] {
+      std::array<std::array<uint16_t, 256>, 8> tables{};
+      tables[0] = kCrc16CcittTable;
+      for (size_t k = 1; k < tables.size(); ++k) {
+        for (size_t i = 0; i < 256; ++i) {
+          const uint16_t previous = tables[k - 1][i];
+          tables[k][i] = kCrc16CcittTable[previous >> 8u] ^
+                         static_cast<uint16_t>(previous << 8u);
+        }
+      }
+      return tables;
+    }();
+
 }  // namespace
 
-extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
-                                           size_t size_bytes,
-                                           uint16_t value) {
-  const uint8_t* const array = static_cast<const uint8_t*>(data);
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittEightBit(const void* data,
+                                                            size_t size_bytes,
+                                                            uint16_t value) {
+  const uint8_t* array = static_cast<const uint8_t*>(data);
 
   for (size_t i = 0; i < size_bytes; ++i) {
     value = kCrc16CcittTable[((value >> 8u) ^ array[i]) & 0xffu] ^
@@ -67,4 +87,30 @@ extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
   return value;
 }
 
+extern "C" uint16_t _pw_checksum_InternalCrc16CcittSlicingBy8(
+    const void* data, size_t size_bytes, uint16_t value) {
+  const uint8_t* array = static_cast<const uint8_t*>(data);
+
+  const auto& tables = kCrc16CcittSlicingTables;
+  for (; size_bytes >= 8; size_bytes -= 8, array += 8) {
+    value = tables[7][(value >> 8u) ^ array[0]] ^
+            tables[6][(value & 0xffu) ^ array[1]] ^ tables[5][array[2]] ^
+            tables[4][array[3]] ^ tables[3][array[4]] ^ tables[2][array[5]] ^
+            tables[1][array[6]] ^ tables[0][array[7]];
+  }
+
+  // Finish the remaining bytes one at a time.
+  return _pw_checksum_InternalCrc16CcittEightBit(array, size_bytes, value);
+}
+
+extern "C" uint16_t pw_checksum_Crc16Ccitt(const void* data,
+                                           size_t size_bytes,
+                                           uint16_t value) {
+#if PW_CHECKSUM_CRC16_CCITT_SLICING_BY_8
+  return _pw_checksum_InternalCrc16CcittSlicingBy8(data, size_bytes, value);
+#else
+  return _pw_checksum_InternalCrc16CcittEightBit(data, size_bytes, value);
+#endif  // PW_CHECKSUM_CRC16_CCITT_SLICING_BY_8
+}
+
 }  // namespace pw::checksum
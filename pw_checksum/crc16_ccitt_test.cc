@@ -14,6 +14,7 @@
 
 #include "pw_checksum/crc16_ccitt.h"
 
+#include <array>
 #include <string_view>
 
 #include "gtest/gtest.h"
@@ -67,6 +68,49 @@ TEST(Crc16Class, String) {
   EXPECT_EQ(crc16.value(), kStringCrc);
 }
 
+// Calculates the CRC a bit at a time for comparison with the table-based
+// implementation.
+uint16_t BitwiseCrc16Ccitt(span<const std::byte> data) {
+  uint16_t value = Crc16Ccitt::kInitialValue;
+  for (std::byte b : data) {
+    value ^= static_cast<uint16_t>(static_cast<uint16_t>(b) << 8);
+    for (int bit = 0; bit < 8; ++bit) {
+      value = static_cast<uint16_t>((value & 0x8000u) != 0u
+                                        ? (value << 1) ^ 0x1021u
+                                        : value << 1);
+    }
+  }
+  return value;
+}
+
+using Crc16Function = uint16_t (*)(const void*, size_t, uint16_t);
+
+void ExpectMatchesBitwise(Crc16Function crc16) {
+  std::array<std::byte, 256 + 8> data;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<std::byte>((i * 131 + (i >> 3)) & 0xFF);
+  }
+
+  for (size_t offset = 0; offset < 8; offset += 3) {
+    for (size_t size = 0; size <= 256; ++size) {
+      const auto chunk = span(data).subspan(offset, size);
+      ASSERT_EQ(crc16(chunk.data(), chunk.size(), Crc16Ccitt::kInitialValue),
+                BitwiseCrc16Ccitt(chunk))
+          << "offset " << offset << ", size " << size;
+    }
+  }
+}
+
+TEST(Crc16, MatchesBitwise) { ExpectMatchesBitwise(pw_checksum_Crc16Ccitt); }
+
+TEST(Crc16, EightBitMatchesBitwise) {
+  ExpectMatchesBitwise(_pw_checksum_InternalCrc16CcittEightBit);
+}
+
+TEST(Crc16, SlicingBy8MatchesBitwise) {
+  ExpectMatchesBitwise(_pw_checksum_InternalCrc16CcittSlicingBy8);
+}
+
 extern "C" uint16_t CallChecksumCrc16Ccitt(const void* data, size_t size_bytes);
 
 TEST(Crc16FromC, Buffer) {
@@ -14,6 +14,18 @@
 
 #include "pw_checksum/crc32.h"
 
+#include <array>
+#include <cstring>
+
+#if defined(__ARM_FEATURE_CRC32) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#include <arm_acle.h>
+#define _PW_CHECKSUM_CRC32_ARM_CRC32 1
+#elif defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define _PW_CHECKSUM_CRC32_X86_PCLMUL 1
+#endif
+
 namespace pw::checksum {
 namespace {
 
@@ -47,10 +59,167 @@ constexpr std::array<uint32_t, (1 << kBits)> GenerateCrc32Table() {
   return table;
 }
 
+// Generates the lookup tables for a slicing-by-kSlices CRC32 implementation.
+// Table 0 is the regular 256-entry table. Table k holds the CRC of each byte
+// value followed by k zero bytes, so kSlices bytes can be folded into the CRC
+// with independent lookups instead of a dependent chain of kSlices lookups.
+//
+// See "A Systematic Approach to Building High Performance, Software-based, CRC
+// Generators" (Kounavis and Berry, 2005).
+template <size_t kSlices, uint32_t kPolynomial>
+constexpr std::array<std::array<uint32_t, 256>, kSlices>
+GenerateCrc32SlicingTables() {
+  std::array<std::array<uint32_t, 256>, kSlices> tables{};
+  tables[0] = GenerateCrc32Table<8, kPolynomial>();
+  for (size_t k = 1; k < kSlices; ++k) {
+    for (size_t i = 0; i < 256; ++i) {
+      const uint32_t previous = tables[k - 1][i];
+      tables[k][i] = (previous >> 8) ^ tables[0][previous & 0xFFu];
+    }
+  }
+  return tables;
+}
+
+// Processes kSlices bytes per iteration with the tables from
+// GenerateCrc32SlicingTables, then finishes the remainder a byte at a time.
+template <size_t kSlices>
+uint32_t Crc32Slicing(
+    const std::array<std::array<uint32_t, 256>, kSlices>& tables,
+    const uint8_t* data,
+    size_t size_bytes,
+    uint32_t state) {
+  static_assert(kSlices >= 4);
+
+  for (; size_bytes >= kSlices; size_bytes -= kSlices, data += kSlices) {
+    state ^= static_cast<uint32_t>(data[0]) |
+             static_cast<uint32_t>(data[1]) << 8 |
+             static_cast<uint32_t>(data[2]) << 16 |
+             static_cast<uint32_t>(data[3]) << 24;
+
+    uint32_t next = 0;
+    for (size_t i = 0; i < 4; ++i) {
+      next ^= tables[kSlices - 1 - i][(state >> (8 * i)) & 0xFFu];
+    }
+    for (size_t i = 4; i < kSlices; ++i) {
+      next ^= tables[kSlices - 1 - i][data[i]];
+    }
+    state = next;
+  }
+
+  for (size_t i = 0; i < size_bytes; ++i) {
+    state = tables[0][(state ^ data[i]) & 0xFFu] ^ (state >> 8);
+  }
+
+  return state;
+}
+
 // Reversed polynomial for the commonly used CRC32 variant. See:
 // https://en.wikipedia.org/wiki/Cyclic_redundancy_check#Polynomial_representations_of_cyclic_redundancy_checks
 constexpr uint32_t kCrc32Polynomial = 0xEDB88320;
 
+#if defined(_PW_CHECKSUM_CRC32_ARM_CRC32)
+
+// ARMv8 provides the CRC32X/CRC32B instructions for this polynomial.
+uint32_t Crc32Hardware(const uint8_t* data, size_t size_bytes, uint32_t state) {
+  for (; size_bytes >= sizeof(uint64_t); size_bytes -= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    state = __crc32d(state, word);
+    data += sizeof(word);
+  }
+
+  for (size_t i = 0; i < size_bytes; ++i) {
+    state = __crc32b(state, data[i]);
+  }
+
+  return state;
+}
+
+#elif defined(_PW_CHECKSUM_CRC32_X86_PCLMUL)
+
+// The x86 CRC32 instruction uses the Castagnoli polynomial, so this polynomial
+// is calculated by folding 128-bit blocks with carry-less multiplication, then
+// reducing the final block with Barrett reduction. See "Fast CRC Computation
+// for Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009). The
+// constants are powers of x modulo the bit-reflected polynomial.
+//
+#define _PW_CHECKSUM_CRC32_PCLMUL_TARGET \
+  __attribute__((target("pclmul,sse4.1")))
+
+_PW_CHECKSUM_CRC32_PCLMUL_TARGET __m128i Load(const uint8_t* data) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+// Folds a block forward by the distance encoded in k and adds the next block.
+_PW_CHECKSUM_CRC32_PCLMUL_TARGET __m128i Fold(__m128i block,
+                                              __m128i k,
+                                              __m128i next) {
+  const __m128i low = _mm_clmulepi64_si128(block, k, 0x00);
+  const __m128i high = _mm_clmulepi64_si128(block, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(high, next), low);
+}
+
+// Processes a multiple of 16 bytes, which must be at least 64.
+_PW_CHECKSUM_CRC32_PCLMUL_TARGET uint32_t Crc32Pclmul(const uint8_t* data,
+                                                      size_t size_bytes,
+                                                      uint32_t state) {
+  alignas(16) static constexpr uint64_t kFold512[] = {0x0154442bd4,
+                                                      0x01c6e41596};
+  alignas(16) static constexpr uint64_t kFold128[] = {0x01751997d0,
+                                                      0x00ccaa009e};
+  alignas(16) static constexpr uint64_t kFold64[] = {0x0163cd6124, 0};
+  alignas(16) static constexpr uint64_t kBarrett[] = {0x01db710641,
+                                                      0x01f7011641};
+
+  // Fold four blocks at a time to keep several multiplications in flight.
+  __m128i x1 = _mm_xor_si128(Load(data),
+                             _mm_cvtsi32_si128(static_cast<int>(state)));
+  __m128i x2 = Load(data + 16);
+  __m128i x3 = Load(data + 32);
+  __m128i x4 = Load(data + 48);
+  data += 64;
+  size_bytes -= 64;
+
+  __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(kFold512));
+  for (; size_bytes >= 64; size_bytes -= 64, data += 64) {
+    x1 = Fold(x1, k, Load(data));
+    x2 = Fold(x2, k, Load(data + 16));
+    x3 = Fold(x3, k, Load(data + 32));
+    x4 = Fold(x4, k, Load(data + 48));
+  }
+
+  // Fold the four blocks and any remaining blocks into one.
+  k = _mm_load_si128(reinterpret_cast<const __m128i*>(kFold128));
+  x1 = Fold(x1, k, x2);
+  x1 = Fold(x1, k, x3);
+  x1 = Fold(x1, k, x4);
+  for (; size_bytes >= 16; size_bytes -= 16, data += 16) {
+    x1 = Fold(x1, k, Load(data));
+  }
+
+  // Fold 128 bits to 64 bits.
+  const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+  k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(kFold64));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits.
+  k = _mm_load_si128(reinterpret_cast<const __m128i*>(kBarrett));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+#undef _PW_CHECKSUM_CRC32_PCLMUL_TARGET
+
+#endif  // _PW_CHECKSUM_CRC32_ARM_CRC32
+
 }  // namespace
 
 extern "C" uint32_t _pw_checksum_InternalCrc32EightBit(const void* data,
@@ -95,4 +264,42 @@ extern "C" uint32_t _pw_checksum_InternalCrc32OneBit(const void* data,
   return state;
 }
 
+extern "C" uint32_t _pw_checksum_InternalCrc32SlicingBy8(const void* data,
+                                                         size_t size_bytes,
+                                                         uint32_t state) {
+  static constexpr std::array<std::array<uint32_t, 256>, 8> kCrc32Tables =
+      GenerateCrc32SlicingTables<8, kCrc32Polynomial>();
+  return Crc32Slicing(
+      kCrc32Tables, static_cast<const uint8_t*>(data), size_bytes, state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32SlicingBy16(const void* data,
+                                                          size_t size_bytes,
+                                                          uint32_t state) {
+  static constexpr std::array<std::array<uint32_t, 256>, 16> kCrc32Tables =
+      GenerateCrc32SlicingTables<16, kCrc32Polynomial>();
+  return Crc32Slicing(
+      kCrc32Tables, static_cast<const uint8_t*>(data), size_bytes, state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32Accelerated(const void* data,
+                                                          size_t size_bytes,
+                                                          uint32_t state) {
+#if defined(_PW_CHECKSUM_CRC32_ARM_CRC32)
+  return Crc32Hardware(static_cast<const uint8_t*>(data), size_bytes, state);
+#else
+#if defined(_PW_CHECKSUM_CRC32_X86_PCLMUL)
+  // Folding has a fixed setup cost, so short buffers use tables.
+  if (size_bytes >= 64 && __builtin_cpu_supports("pclmul") &&
+      __builtin_cpu_supports("sse4.1")) {
+    const size_t folded_bytes = size_bytes & ~size_t{15};
+    state = Crc32Pclmul(static_cast<const uint8_t*>(data), folded_bytes, state);
+    data = static_cast<const uint8_t*>(data) + folded_bytes;
+    size_bytes -= folded_bytes;
+  }
+#endif  // _PW_CHECKSUM_CRC32_X86_PCLMUL
+  return _pw_checksum_InternalCrc32SlicingBy8(data, size_bytes, state);
+#endif  // _PW_CHECKSUM_CRC32_ARM_CRC32
+}
+
 }  // namespace pw::checksum
@@ -13,6 +13,7 @@
 // the License.
 #include "pw_checksum/crc32.h"
 
+#include <array>
 #include <string_view>
 
 #include "gtest/gtest.h"
@@ -46,6 +47,12 @@ TEST(Crc32, Empty) {
   EXPECT_EQ(Crc32FourBit::Calculate(span<std::byte>()),
             PW_CHECKSUM_EMPTY_CRC32);
   EXPECT_EQ(Crc32OneBit::Calculate(span<std::byte>()), PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32SlicingBy8::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32SlicingBy16::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32Accelerated::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
 }
 
 TEST(Crc32, Buffer) {
@@ -53,6 +60,9 @@ TEST(Crc32, Buffer) {
   EXPECT_EQ(Crc32EightBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
   EXPECT_EQ(Crc32FourBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
   EXPECT_EQ(Crc32OneBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32SlicingBy8::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32SlicingBy16::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32Accelerated::Calculate(as_bytes(span(kBytes))), kBufferCrc);
 }
 
 TEST(Crc32, String) {
@@ -60,6 +70,9 @@ TEST(Crc32, String) {
   EXPECT_EQ(Crc32EightBit::Calculate(as_bytes(span(kString))), kStringCrc);
   EXPECT_EQ(Crc32FourBit::Calculate(as_bytes(span(kString))), kStringCrc);
   EXPECT_EQ(Crc32OneBit::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32SlicingBy8::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32SlicingBy16::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32Accelerated::Calculate(as_bytes(span(kString))), kStringCrc);
 }
 
 template <typename CrcVariant>
@@ -76,6 +89,9 @@ TEST(Crc32Class, ByteByByte) {
   TestByByte<Crc32EightBit>();
   TestByByte<Crc32FourBit>();
   TestByByte<Crc32OneBit>();
+  TestByByte<Crc32SlicingBy8>();
+  TestByByte<Crc32SlicingBy16>();
+  TestByByte<Crc32Accelerated>();
 }
 
 template <typename CrcVariant>
@@ -90,6 +106,9 @@ TEST(Crc32Class, Buffer) {
   TestBuffer<Crc32EightBit>();
   TestBuffer<Crc32FourBit>();
   TestBuffer<Crc32OneBit>();
+  TestBuffer<Crc32SlicingBy8>();
+  TestBuffer<Crc32SlicingBy16>();
+  TestBuffer<Crc32Accelerated>();
 }
 
 template <typename CrcVariant>
@@ -105,6 +124,9 @@ TEST(Crc32Class, BufferAppend) {
   TestBufferAppend<Crc32EightBit>();
   TestBufferAppend<Crc32FourBit>();
   TestBufferAppend<Crc32OneBit>();
+  TestBufferAppend<Crc32SlicingBy8>();
+  TestBufferAppend<Crc32SlicingBy16>();
+  TestBufferAppend<Crc32Accelerated>();
 }
 
 template <typename CrcVariant>
@@ -119,6 +141,35 @@ TEST(Crc32Class, String) {
   TestString<Crc32EightBit>();
   TestString<Crc32FourBit>();
   TestString<Crc32OneBit>();
+  TestString<Crc32SlicingBy8>();
+  TestString<Crc32SlicingBy16>();
+  TestString<Crc32Accelerated>();
+}
+
+// Checks the multi-byte kernels against the bitwise implementation for sizes
+// and alignments that exercise both their main loops and their tails.
+template <typename CrcVariant>
+void TestMatchesOneBit() {
+  std::array<std::byte, 1024 + 16> data;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<std::byte>((i * 131 + (i >> 3)) & 0xFF);
+  }
+
+  for (size_t offset = 0; offset < 16; offset += 5) {
+    for (size_t size = 0; size <= 1024; size += (size < 160 ? 1 : 97)) {
+      const auto chunk = span(data).subspan(offset, size);
+      ASSERT_EQ(CrcVariant::Calculate(chunk), Crc32OneBit::Calculate(chunk))
+          << "offset " << offset << ", size " << size;
+    }
+  }
+}
+
+TEST(Crc32Class, MatchesOneBit) {
+  TestMatchesOneBit<Crc32EightBit>();
+  TestMatchesOneBit<Crc32FourBit>();
+  TestMatchesOneBit<Crc32SlicingBy8>();
+  TestMatchesOneBit<Crc32SlicingBy16>();
+  TestMatchesOneBit<Crc32Accelerated>();
 }
 
 extern "C" uint32_t CallChecksumCrc32(const void* data, size_t size_bytes);
@@ -0,0 +1,88 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures CRC throughput for buffers from 16 B to 1 MiB. Each iteration
+// processes kBytesPerIteration bytes in total, so the reported times are
+// directly comparable between buffer sizes. The 1 MiB buffer makes this a
+// host-only test.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_checksum/crc16_ccitt.h"
+#include "pw_checksum/crc32.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+
+namespace pw::checksum {
+namespace {
+
+constexpr size_t kBytesPerIteration = size_t{1} << 20;
+
+const std::array<std::byte, kBytesPerIteration>& Data() {
+  static std::array<std::byte, kBytesPerIteration> data = [] {
+    std::array<std::byte, kBytesPerIteration> bytes;
+    uint32_t value = 1;
+    for (std::byte& b : bytes) {
+      value = value * 1103515245u + 12345u;
+      b = static_cast<std::byte>(value >> 24);
+    }
+    return bytes;
+  }();
+  return data;
+}
+
+// Keeps the results live so the checksums are not optimized out.
+volatile uint32_t result_sink;
+
+template <typename Crc>
+void Checksum(perf_test::State& state, size_t size) {
+  const span<const std::byte> data = span(Data()).first(size);
+
+  uint32_t result = 0;
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kBytesPerIteration / size; ++i) {
+      result ^= Crc::Calculate(data);
+    }
+  }
+  result_sink = result;
+}
+
+constexpr size_t k16B = 16;
+constexpr size_t k1KiB = 1024;
+constexpr size_t k1MiB = kBytesPerIteration;
+
+PW_PERF_TEST(Crc32EightBit_16B, Checksum<Crc32EightBit>, k16B);
+PW_PERF_TEST(Crc32EightBit_1KiB, Checksum<Crc32EightBit>, k1KiB);
+PW_PERF_TEST(Crc32EightBit_1MiB, Checksum<Crc32EightBit>, k1MiB);
+
+PW_PERF_TEST(Crc32SlicingBy8_16B, Checksum<Crc32SlicingBy8>, k16B);
+PW_PERF_TEST(Crc32SlicingBy8_1KiB, Checksum<Crc32SlicingBy8>, k1KiB);
+PW_PERF_TEST(Crc32SlicingBy8_1MiB, Checksum<Crc32SlicingBy8>, k1MiB);
+
+PW_PERF_TEST(Crc32SlicingBy16_16B, Checksum<Crc32SlicingBy16>, k16B);
+PW_PERF_TEST(Crc32SlicingBy16_1KiB, Checksum<Crc32SlicingBy16>, k1KiB);
+PW_PERF_TEST(Crc32SlicingBy16_1MiB, Checksum<Crc32SlicingBy16>, k1MiB);
+
+PW_PERF_TEST(Crc32Accelerated_16B, Checksum<Crc32Accelerated>, k16B);
+PW_PERF_TEST(Crc32Accelerated_1KiB, Checksum<Crc32Accelerated>, k1KiB);
+PW_PERF_TEST(Crc32Accelerated_1MiB, Checksum<Crc32Accelerated>, k1MiB);
+
+PW_PERF_TEST(Crc16Ccitt_16B, Checksum<Crc16Ccitt>, k16B);
+PW_PERF_TEST(Crc16Ccitt_1KiB, Checksum<Crc16Ccitt>, k1KiB);
+PW_PERF_TEST(Crc16Ccitt_1MiB, Checksum<Crc16Ccitt>, k1MiB);
+
+}  // namespace
+}  // namespace pw::checksum
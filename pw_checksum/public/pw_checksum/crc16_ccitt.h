@@ -32,6 +32,15 @@ uint16_t pw_checksum_Crc16Ccitt(const void* data,
                                 size_t size_bytes,
                                 uint16_t initial_value);
 
+// Internal implementations of pw_checksum_Crc16Ccitt, which calls the one
+// selected by PW_CHECKSUM_CRC16_CCITT_SLICING_BY_8. Exposed for testing.
+uint16_t _pw_checksum_InternalCrc16CcittEightBit(const void* data,
+                                                 size_t size_bytes,
+                                                 uint16_t initial_value);
+uint16_t _pw_checksum_InternalCrc16CcittSlicingBy8(const void* data,
+                                                   size_t size_bytes,
+                                                   uint16_t initial_value);
+
 #ifdef __cplusplus
 }  // extern "C"
 
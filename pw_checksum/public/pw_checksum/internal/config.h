@@ -17,6 +17,12 @@
 #define PW_CHECKSUM_CRC32_8BITS 8
 #define PW_CHECKSUM_CRC32_4BITS 4
 #define PW_CHECKSUM_CRC32_1BITS 1
+#define PW_CHECKSUM_CRC32_SLICING_BY_8 64
+#define PW_CHECKSUM_CRC32_SLICING_BY_16 128
+
+// Uses CRC32 instructions (ARMv8) or carry-less multiplication (x86-64 with
+// PCLMULQDQ) when the target supports them, and slicing-by-8 otherwise.
+#define PW_CHECKSUM_CRC32_ACCELERATED 1024
 
 #ifndef PW_CHECKSUM_CRC32_DEFAULT_IMPL
 #define PW_CHECKSUM_CRC32_DEFAULT_IMPL PW_CHECKSUM_CRC32_8BITS
@@ -25,5 +31,16 @@
 #ifdef __cplusplus
 static_assert(PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_8BITS ||
               PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_4BITS ||
-              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS);
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC32_SLICING_BY_8 ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC32_SLICING_BY_16 ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_ACCELERATED);
 #endif  // __cplusplus
+
+// Set to 1 to calculate CRC-16-CCITT 8 bytes at a time with slicing-by-8,
+// which uses 4 KiB of lookup tables instead of 512 bytes.
+#ifndef PW_CHECKSUM_CRC16_CCITT_SLICING_BY_8
+#define PW_CHECKSUM_CRC16_CCITT_SLICING_BY_8 0
+#endif  // PW_CHECKSUM_CRC16_CCITT_SLICING_BY_8
@@ -29,6 +29,11 @@ using TheChecksum = pw::checksum::Crc16Ccitt;
 using TheChecksum = pw::checksum::Crc32EightBit;
 #endif
 
+#ifdef USE_CRC32_SLICING_BY_8_CHECKSUM
+#include "pw_checksum/crc32.h"
+using TheChecksum = pw::checksum::Crc32SlicingBy8;
+#endif
+
 #ifdef USE_CRC32_4BIT_CHECKSUM
 #include "pw_checksum/crc32.h"
 using TheChecksum = pw::checksum::Crc32FourBit;
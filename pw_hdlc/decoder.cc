@@ -14,6 +14,8 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <cstring>
+
 #include "pw_assert/check.h"
 #include "pw_bytes/endian.h"
 #include "pw_hdlc/internal/protocol.h"
@@ -100,6 +102,37 @@ Result<Frame> Decoder::Process(const byte new_byte) {
   PW_CRASH("Bad decoder state");
 }
 
+Result<Frame> Decoder::ProcessUntilResult(ConstByteSpan& data) {
+  while (!data.empty()) {
+    // Skip over runs of bytes that do not change the decoder's state, then
+    // process the byte that ends the run individually.
+    size_t run_size = 0;
+    if (state_ == State::kFrame) {
+      run_size = FindByteToEscape(data);
+      AppendRun(data.first(run_size));
+    } else if (state_ == State::kInterFrame) {
+      const auto* flag = static_cast<const byte*>(
+          std::memchr(data.data(), static_cast<int>(kFlag), data.size()));
+      run_size = flag == nullptr ? data.size()
+                                 : static_cast<size_t>(flag - data.data());
+      // Count bytes to track how many are discarded.
+      current_frame_size_ += run_size;
+    }
+
+    data = data.subspan(run_size);
+    if (data.empty()) {
+      break;
+    }
+
+    Result<Frame> result = Process(data.front());
+    data = data.subspan(1);
+    if (result.status() != Status::Unavailable()) {
+      return result;
+    }
+  }
+  return Status::Unavailable();
+}
+
 void Decoder::AppendByte(byte new_byte) {
   if (current_frame_size_ < max_size()) {
     buffer_[current_frame_size_] = new_byte;
@@ -118,6 +151,43 @@ void Decoder::AppendByte(byte new_byte) {
   current_frame_size_ += 1;
 }
 
+void Decoder::AppendRun(ConstByteSpan run) {
+  // Short runs do not replace the whole ring buffer of trailing bytes.
+  if (run.size() < last_read_bytes_.size()) {
+    for (byte b : run) {
+      AppendByte(b);
+    }
+    return;
+  }
+
+  if (current_frame_size_ < max_size()) {
+    std::memcpy(&buffer_[current_frame_size_],
+                run.data(),
+                std::min(run.size(), max_size() - current_frame_size_));
+  }
+
+  // Add the bytes held in the ring buffer, oldest first, to the running
+  // checksum, followed by all but the last four bytes of the run. The last
+  // four bytes of the run then fill the ring buffer.
+  const size_t held = std::min(current_frame_size_, last_read_bytes_.size());
+  size_t index = (last_read_bytes_index_ + last_read_bytes_.size() - held) %
+                 last_read_bytes_.size();
+  for (size_t i = 0; i < held; ++i) {
+    fcs_.Update(last_read_bytes_[index]);
+    index = (index + 1) % last_read_bytes_.size();
+  }
+
+  const size_t to_checksum = run.size() - last_read_bytes_.size();
+  fcs_.Update(run.first(to_checksum));
+  std::memcpy(last_read_bytes_.data(),
+              run.data() + to_checksum,
+              last_read_bytes_.size());
+  last_read_bytes_index_ = 0;
+
+  // Always increase size: if it is larger than the buffer, overflow occurred.
+  current_frame_size_ += run.size();
+}
+
 Status Decoder::CheckFrame() const {
   // Empty frames are not an error; repeated flag characters are okay.
   if (current_frame_size_ == 0u) {
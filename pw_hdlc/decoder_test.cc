@@ -14,13 +14,17 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
+#include "pw_containers/vector.h"
 #include "pw_fuzzer/fuzztest.h"
+#include "pw_hdlc/encoder.h"
 #include "pw_hdlc/internal/protocol.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::hdlc {
 namespace {
@@ -154,6 +158,100 @@ TEST(Decoder, TooLargeForBuffer_DecodesNextFrame) {
   EXPECT_EQ(OkStatus(), decoder.Process(kFlag).status());
 }
 
+TEST(Decoder, ProcessSpan_TooLargeForBuffer_StaysWithinBufferBoundaries) {
+  std::array<byte, 16> buffer = bytes::Initialized<16>('?');
+
+  Decoder decoder(span(buffer.data(), 8));
+
+  Status status = Status::Unknown();
+  decoder.Process(
+      bytes::String("~12345678901234567890\xf2\x19\x63\x90~"),
+      [&status](const Result<Frame>& result) { status = result.status(); });
+
+  for (size_t i = 8; i < buffer.size(); ++i) {
+    ASSERT_EQ(byte{'?'}, buffer[i]);
+  }
+
+  EXPECT_EQ(Status::ResourceExhausted(), status);
+}
+
+TEST(Decoder, ProcessSpan_FramesSplitAcrossCalls) {
+  constexpr uint64_t kAddress = 0x3c;
+
+  // Payloads with long runs of bytes that need no escaping, and bytes that do.
+  std::array<byte, 40> payload_0 = bytes::Initialized<40>('a');
+  std::array<byte, 40> payload_1 = bytes::Initialized<40>('b');
+  payload_1[3] = kFlag;
+  payload_1[4] = kEscape;
+  payload_1[39] = kFlag;
+  std::array<byte, 1> payload_2 = {kEscape};
+  const std::array<ConstByteSpan, 3> payloads = {
+      payload_0, payload_1, payload_2};
+
+  std::array<byte, 256> encoded_buffer;
+  stream::MemoryWriter writer(encoded_buffer);
+  for (ConstByteSpan payload : payloads) {
+    ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, payload, writer));
+  }
+  ConstByteSpan encoded = writer.WrittenData();
+
+  // Feed the encoded frames to the decoder in chunks of different sizes.
+  for (size_t chunk_size = 1; chunk_size <= encoded.size(); ++chunk_size) {
+    DecoderBuffer<64> decoder;
+    size_t frames = 0;
+
+    for (size_t i = 0; i < encoded.size(); i += chunk_size) {
+      decoder.Process(
+          encoded.subspan(i, std::min(chunk_size, encoded.size() - i)),
+          [&](const Result<Frame>& result) {
+            ASSERT_EQ(OkStatus(), result.status());
+            ASSERT_LT(frames, payloads.size());
+            EXPECT_EQ(kAddress, result.value().address());
+            const ConstByteSpan data = result.value().data();
+            const ConstByteSpan expected = payloads[frames];
+            ASSERT_EQ(expected.size(), data.size());
+            EXPECT_TRUE(std::equal(data.begin(), data.end(), expected.begin()));
+            frames += 1;
+          });
+    }
+
+    EXPECT_EQ(payloads.size(), frames) << "chunk size " << chunk_size;
+  }
+}
+
+void ProcessSpanMatchesProcessByte(ConstByteSpan data) {
+  struct Outcome {
+    Status status;
+    size_t data_size;
+  };
+
+  DecoderBuffer<64> span_decoder;
+  Vector<Outcome, 1024> span_results;
+  span_decoder.Process(data, [&span_results](const Result<Frame>& result) {
+    span_results.push_back(
+        {result.status(), result.ok() ? result.value().data().size() : 0});
+  });
+
+  DecoderBuffer<64> byte_decoder;
+  size_t index = 0;
+  for (byte b : data) {
+    const auto result = byte_decoder.Process(b);
+    if (result.status() == Status::Unavailable()) {
+      continue;
+    }
+    ASSERT_LT(index, span_results.size());
+    EXPECT_EQ(result.status(), span_results[index].status);
+    if (result.ok()) {
+      EXPECT_EQ(result.value().data().size(), span_results[index].data_size);
+    }
+    index += 1;
+  }
+  EXPECT_EQ(index, span_results.size());
+}
+
+FUZZ_TEST(Decoder, ProcessSpanMatchesProcessByte)
+    .WithDomains(VectorOf<1024>(Arbitrary<byte>()));
+
 void ProcessNeverCrashes(ConstByteSpan data) {
   DecoderBuffer<1024> decoder;
   for (byte b : data) {
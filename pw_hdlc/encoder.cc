@@ -23,6 +23,7 @@
 #include "pw_hdlc/encoded_size.h"
 #include "pw_hdlc/internal/encoder.h"
 #include "pw_span/span.h"
+#include "pw_status/try.h"
 #include "pw_varint/varint.h"
 
 using std::byte;
@@ -30,33 +31,47 @@ using std::byte;
 namespace pw::hdlc {
 namespace internal {
 
-Status EscapeAndWrite(const byte b, stream::Writer& writer) {
-  if (b == kFlag) {
-    return writer.Write(kEscapedFlag);
-  }
-  if (b == kEscape) {
-    return writer.Write(kEscapedEscape);
-  }
-  return writer.Write(b);
-}
-
 Status Encoder::WriteData(ConstByteSpan data) {
-  auto begin = data.begin();
-  while (true) {
-    auto end = std::find_if(begin, data.end(), NeedsEscaping);
-
-    if (Status status = writer_.Write(span(begin, end)); !status.ok()) {
-      return status;
+  // Escaped bytes and the short runs between them are collected in a buffer,
+  // so that data with many bytes to escape does not need a write for each of
+  // them. Runs that do not fit in the buffer are written directly.
+  std::array<byte, 32> buffer;
+  size_t buffered = 0;
+
+  for (ConstByteSpan remaining = data; !remaining.empty();) {
+    const size_t run_size = FindByteToEscape(remaining);
+
+    if (buffered > 0 && buffered + run_size > buffer.size()) {
+      PW_TRY(writer_.Write(span(buffer).first(buffered)));
+      buffered = 0;
     }
-    if (end == data.end()) {
-      fcs_.Update(data);
-      return OkStatus();
+    if (run_size > buffer.size()) {
+      PW_TRY(writer_.Write(remaining.first(run_size)));
+    } else {
+      std::memcpy(&buffer[buffered], remaining.data(), run_size);
+      buffered += run_size;
     }
-    if (Status status = EscapeAndWrite(*end, writer_); !status.ok()) {
-      return status;
+
+    remaining = remaining.subspan(run_size);
+    if (remaining.empty()) {
+      break;
     }
-    begin = end + 1;
+
+    if (buffered + 2 > buffer.size()) {
+      PW_TRY(writer_.Write(span(buffer).first(buffered)));
+      buffered = 0;
+    }
+    buffer[buffered++] = kEscape;
+    buffer[buffered++] = Escape(remaining.front());
+    remaining = remaining.subspan(1);
   }
+
+  if (buffered > 0) {
+    PW_TRY(writer_.Write(span(buffer).first(buffered)));
+  }
+
+  fcs_.Update(data);
+  return OkStatus();
 }
 
 Status Encoder::FinishFrame() {
@@ -21,6 +21,7 @@
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
+#include "pw_hdlc/decoder.h"
 #include "pw_hdlc/encoded_size.h"
 #include "pw_hdlc/internal/encoder.h"
 #include "pw_hdlc/internal/protocol.h"
@@ -184,6 +185,42 @@ TEST_F(WriteUnnumberedFrame, PayloadTooLarge_WritesNothing) {
   EXPECT_EQ(0u, writer_.bytes_written());
 }
 
+TEST(WriteUIFrame, LongPayloadWithManyEscapes) {
+  // Runs of varying lengths between bytes that need escaping, including runs
+  // longer than the encoder's internal buffer.
+  std::array<byte, 200> payload;
+  size_t run_length = 0;
+  size_t next_escape = 0;
+  for (size_t i = 0; i < payload.size(); ++i) {
+    if (i == next_escape) {
+      payload[i] = run_length % 2 == 0 ? kFlag : kEscape;
+      run_length += 1;
+      next_escape = i + 1 + (run_length * 7) % 45;
+    } else {
+      payload[i] = static_cast<byte>('a' + i % 26);
+    }
+  }
+
+  std::array<byte, MaxEncodedFrameSize(payload.size())> buffer;
+  stream::MemoryWriter writer(buffer);
+  ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, payload, writer));
+
+  // Check the encoded frame by decoding it, which also verifies the FCS.
+  DecoderBuffer<payload.size() + 16> decoder;
+  size_t frames = 0;
+  decoder.Process(writer.WrittenData(), [&](const Result<Frame>& result) {
+    ASSERT_EQ(OkStatus(), result.status());
+    EXPECT_EQ(kAddress, result.value().address());
+    ASSERT_EQ(payload.size(), result.value().data().size());
+    EXPECT_EQ(0,
+              std::memcmp(payload.data(),
+                          result.value().data().data(),
+                          payload.size()));
+    frames += 1;
+  });
+  EXPECT_EQ(1u, frames);
+}
+
 class ErrorWriter : public stream::NonSeekableWriter {
  private:
   Status DoWrite(ConstByteSpan) override { return Status::Unimplemented(); }
@@ -0,0 +1,113 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures HDLC encoding and decoding of a 16 KiB stream of 1 KiB frames.
+// Decoding is measured both a byte at a time and a span at a time. Divide the
+// 16 KiB by the reported time to get throughput.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/check.h"
+#include "pw_bytes/span.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_hdlc/encoded_size.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_result/result.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::hdlc {
+namespace {
+
+constexpr uint64_t kAddress = 123;
+constexpr size_t kFrameSize = 1024;
+constexpr size_t kFrames = 16;
+
+// Payloads, where one byte in every kEscapeInterval bytes must be escaped.
+template <size_t kEscapeInterval>
+constexpr std::array<std::byte, kFrameSize> MakePayload() {
+  std::array<std::byte, kFrameSize> payload{};
+  for (size_t i = 0; i < payload.size(); ++i) {
+    payload[i] = i % kEscapeInterval == 0
+                     ? kFlag
+                     : static_cast<std::byte>((i * 37) % 0x70);
+  }
+  return payload;
+}
+
+constexpr auto kRarelyEscaped = MakePayload<256>();
+constexpr auto kOftenEscaped = MakePayload<8>();
+
+constexpr size_t kMaxEncodedSize =
+    kFrames * MaxEncodedFrameSize(kRarelyEscaped.size());
+
+// Encodes kFrames frames with the payload into the buffer.
+ConstByteSpan EncodeFrames(ConstByteSpan payload, ByteSpan buffer) {
+  stream::MemoryWriter writer(buffer);
+  for (size_t i = 0; i < kFrames; ++i) {
+    PW_CHECK_OK(WriteUIFrame(kAddress, payload, writer));
+  }
+  return writer.WrittenData();
+}
+
+void Encode(perf_test::State& state, ConstByteSpan payload) {
+  static std::array<std::byte, kMaxEncodedSize> buffer;
+
+  while (state.KeepRunning()) {
+    EncodeFrames(payload, buffer);
+  }
+}
+
+void DecodeByteAtATime(perf_test::State& state, ConstByteSpan payload) {
+  static std::array<std::byte, kMaxEncodedSize> buffer;
+  static DecoderBuffer<kFrameSize + 16> decoder;
+  const ConstByteSpan encoded = EncodeFrames(payload, buffer);
+
+  size_t frames = 0;
+  while (state.KeepRunning()) {
+    for (std::byte b : encoded) {
+      if (decoder.Process(b).ok()) {
+        frames += 1;
+      }
+    }
+  }
+  PW_CHECK_UINT_NE(frames, 0);
+}
+
+void DecodeSpan(perf_test::State& state, ConstByteSpan payload) {
+  static std::array<std::byte, kMaxEncodedSize> buffer;
+  static DecoderBuffer<kFrameSize + 16> decoder;
+  const ConstByteSpan encoded = EncodeFrames(payload, buffer);
+
+  size_t frames = 0;
+  while (state.KeepRunning()) {
+    decoder.Process(encoded, [&frames](const Result<Frame>& frame) {
+      PW_CHECK_OK(frame.status());
+      frames += 1;
+    });
+  }
+  PW_CHECK_UINT_NE(frames, 0);
+}
+
+PW_PERF_TEST(EncodeRarelyEscaped, Encode, kRarelyEscaped);
+PW_PERF_TEST(EncodeOftenEscaped, Encode, kOftenEscaped);
+PW_PERF_TEST(DecodeByteAtATimeRarelyEscaped, DecodeByteAtATime, kRarelyEscaped);
+PW_PERF_TEST(DecodeByteAtATimeOftenEscaped, DecodeByteAtATime, kOftenEscaped);
+PW_PERF_TEST(DecodeSpanRarelyEscaped, DecodeSpan, kRarelyEscaped);
+PW_PERF_TEST(DecodeSpanOftenEscaped, DecodeSpan, kOftenEscaped);
+
+}  // namespace
+}  // namespace pw::hdlc
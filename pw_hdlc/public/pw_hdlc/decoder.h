@@ -103,10 +103,14 @@ class Decoder {
 
   /// @brief Processes a span of data and calls the provided callback with each
   /// frame or error.
+  ///
+  /// This is equivalent to calling `Process(std::byte)` for each byte, but
+  /// handles runs of bytes that are not flags or escapes in bulk, which is
+  /// considerably faster for large amounts of data.
   template <typename F, typename... Args>
   void Process(ConstByteSpan data, F&& callback, Args&&... args) {
-    for (std::byte b : data) {
-      auto result = Process(b);
+    while (!data.empty()) {
+      auto result = ProcessUntilResult(data);
       if (result.status() != Status::Unavailable()) {
         std::invoke(
             std::forward<F>(callback), std::forward<Args>(args)..., result);
@@ -137,8 +141,16 @@ class Decoder {
     fcs_.clear();
   }
 
+  // Processes bytes from the start of data until one of them produces a
+  // result other than UNAVAILABLE, or until data is exhausted. Processed bytes
+  // are removed from data.
+  Result<Frame> ProcessUntilResult(ConstByteSpan& data);
+
   void AppendByte(std::byte new_byte);
 
+  // Appends a run of bytes that are neither flags nor escapes to the frame.
+  void AppendRun(ConstByteSpan run);
+
   Status CheckFrame() const;
 
   bool VerifyFrameCheckSequence() const;
@@ -14,7 +14,10 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 
+#include "pw_bytes/span.h"
 #include "pw_varint/varint.h"
 
 namespace pw::hdlc {
@@ -68,6 +71,38 @@ constexpr bool NeedsEscaping(std::byte b) {
 
 constexpr std::byte Escape(std::byte b) { return b ^ kEscapeConstant; }
 
+// Returns the index of the first byte in data that needs escaping, or
+// data.size() if there is none. Data is checked a word at a time, so long runs
+// of bytes that need no escaping are skipped quickly.
+inline size_t FindByteToEscape(ConstByteSpan data) {
+  constexpr uint64_t kOnes = 0x0101010101010101;
+  constexpr uint64_t kHighBits = 0x8080808080808080;
+  constexpr uint64_t kFlags = kOnes * static_cast<uint8_t>(kFlag);
+  constexpr uint64_t kEscapes = kOnes * static_cast<uint8_t>(kEscape);
+
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= data.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data.data() + i, sizeof(word));
+
+    // A byte of (word ^ pattern) is zero where word matches the pattern. The
+    // high bit of a byte in (x - kOnes) & ~x is set if that byte of x is zero.
+    const uint64_t flags = word ^ kFlags;
+    const uint64_t escapes = word ^ kEscapes;
+    if ((((flags - kOnes) & ~flags) | ((escapes - kOnes) & ~escapes)) &
+        kHighBits) {
+      break;
+    }
+  }
+
+  for (; i < data.size(); ++i) {
+    if (NeedsEscaping(data[i])) {
+      break;
+    }
+  }
+  return i;
+}
+
 // Class that manages the 1-byte control field of an HDLC U-frame.
 class UFrameControl {
  public:
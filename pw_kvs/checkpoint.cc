@@ -0,0 +1,286 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "KVS"
+#define PW_LOG_LEVEL PW_KVS_LOG_LEVEL
+
+#include "pw_kvs/internal/checkpoint.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "pw_checksum/crc32.h"
+#include "pw_kvs/alignment.h"
+#include "pw_kvs/internal/entry.h"
+#include "pw_kvs_private/config.h"
+#include "pw_log/log.h"
+#include "pw_status/try.h"
+
+namespace pw::kvs::internal {
+namespace {
+
+using std::byte;
+using Address = FlashPartition::Address;
+
+// For KVS magic value always use a random 32 bit integer rather than a human
+// readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr uint32_t kCheckpointMagic = 0x5a83c2d7;
+
+constexpr Address kNoAddress = Address(-1);
+
+constexpr uint32_t kInvalidatedMarker = 0;
+
+constexpr size_t kWriteBufferSize =
+    std::max(kMaxFlashAlignment, 4 * Entry::kMinAlignmentBytes);
+
+constexpr size_t RecordsSizeBytes(size_t sector_count,
+                                  size_t entry_count,
+                                  size_t redundancy) {
+  return sizeof(CheckpointHeader) +
+         sector_count * sizeof(CheckpointSectorRecord) +
+         entry_count *
+             (sizeof(CheckpointEntryRecord) + redundancy * sizeof(uint32_t));
+}
+
+// The checksum covers everything in the header after the checksum field.
+span<const byte> ChecksummedHeaderBytes(const CheckpointHeader& header) {
+  return as_bytes(span(&header, 1))
+      .subspan(offsetof(CheckpointHeader, checksum) + sizeof(header.checksum));
+}
+
+// Calls the function with each record that follows the header, in order.
+template <typename Function>
+Status ForEachRecord(const Sectors& sectors,
+                     const EntryCache& entries,
+                     Function&& function) {
+  for (const SectorDescriptor& sector : sectors) {
+    const CheckpointSectorRecord record = {
+        .writable_bytes = static_cast<uint32_t>(sector.writable_bytes()),
+        .valid_bytes = static_cast<uint32_t>(sector.valid_bytes()),
+    };
+    PW_TRY(function(as_bytes(span(&record, 1))));
+  }
+
+  for (const EntryMetadata& metadata : entries) {
+    const CheckpointEntryRecord record = {
+        .key_hash = metadata.hash(),
+        .transaction_id = metadata.transaction_id(),
+        .state = static_cast<uint32_t>(metadata.state()),
+    };
+    PW_TRY(function(as_bytes(span(&record, 1))));
+
+    for (size_t i = 0; i < entries.redundancy(); ++i) {
+      const uint32_t address = i < metadata.addresses().size()
+                                   ? metadata.addresses()[i]
+                                   : kNoAddress;
+      PW_TRY(function(as_bytes(span(&address, 1))));
+    }
+  }
+  return OkStatus();
+}
+
+// Reads a record at *address, adds it to the checksum, and advances *address.
+template <typename T>
+Status ReadRecord(FlashPartition& partition,
+                  Address* address,
+                  checksum::Crc32& crc,
+                  T* record) {
+  PW_TRY(partition.Read(*address, sizeof(*record), record));
+  crc.Update(as_bytes(span(record, 1)));
+  *address += sizeof(*record);
+  return OkStatus();
+}
+
+}  // namespace
+
+Status Checkpoint::Write(const FlashPartition& kvs_partition,
+                         const Sectors& sectors,
+                         const EntryCache& entries) {
+  const size_t alignment_bytes = partition_->alignment_bytes();
+  const size_t marker_size =
+      AlignUp(sizeof(kInvalidatedMarker), alignment_bytes);
+  const Address marker_address = AlignUp(
+      RecordsSizeBytes(
+          sectors.size(), entries.total_entries(), entries.redundancy()),
+      alignment_bytes);
+
+  if (marker_address + marker_size > partition_->size_bytes()) {
+    PW_LOG_ERROR("KVS checkpoint of %u bytes does not fit in a %u B partition",
+                 unsigned(marker_address + marker_size),
+                 unsigned(partition_->size_bytes()));
+    return Status::ResourceExhausted();
+  }
+
+  CheckpointHeader header = {
+      .magic = kCheckpointMagic,
+      .checksum = 0,
+      .sector_size_bytes =
+          static_cast<uint32_t>(kvs_partition.sector_size_bytes()),
+      .sector_count = static_cast<uint16_t>(sectors.size()),
+      .redundancy = static_cast<uint16_t>(entries.redundancy()),
+      .entry_count = static_cast<uint32_t>(entries.total_entries()),
+  };
+
+  checksum::Crc32 crc;
+  crc.Update(ChecksummedHeaderBytes(header));
+  ForEachRecord(sectors, entries, [&crc](span<const byte> data) {
+    crc.Update(data);
+    return OkStatus();
+  }).IgnoreError();  // Calculating the checksum cannot fail.
+  header.checksum = crc.value();
+
+  // The old checkpoint is gone as soon as the erase starts.
+  marker_address_ = kNoMarker;
+  const size_t sector_size_bytes = partition_->sector_size_bytes();
+  PW_TRY(partition_->Erase(
+      0, (marker_address + marker_size + sector_size_bytes - 1) /
+             sector_size_bytes));
+
+  FlashPartition::Output output(*partition_, 0);
+  AlignedWriterBuffer<kWriteBufferSize> writer(alignment_bytes, output);
+  PW_TRY(writer.Write(&header, sizeof(header)).status());
+  PW_TRY(ForEachRecord(sectors, entries, [&writer](span<const byte> data) {
+    return writer.Write(data).status();
+  }));
+  PW_TRY(writer.Flush().status());
+
+  PW_LOG_DEBUG("Wrote KVS checkpoint with %u entries",
+               unsigned(header.entry_count));
+  marker_address_ = marker_address;
+  return OkStatus();
+}
+
+Status Checkpoint::Load(const FlashPartition& kvs_partition,
+                        Sectors& sectors,
+                        EntryCache& entries) {
+  marker_address_ = kNoMarker;
+
+  CheckpointHeader header;
+  PW_TRY(partition_->Read(0, sizeof(header), &header));
+
+  if (partition_->AppearsErased(as_bytes(span(&header.magic, 1)))) {
+    return Status::NotFound();
+  }
+  if (header.magic != kCheckpointMagic) {
+    return Status::DataLoss();
+  }
+  const size_t alignment_bytes = partition_->alignment_bytes();
+  const size_t marker_size =
+      AlignUp(sizeof(kInvalidatedMarker), alignment_bytes);
+  const Address marker_address = AlignUp(
+      RecordsSizeBytes(
+          header.sector_count, header.entry_count, header.redundancy),
+      alignment_bytes);
+
+  if (marker_address + marker_size > partition_->size_bytes()) {
+    return Status::DataLoss();
+  }
+
+  bool marker_erased;
+  PW_TRY(
+      partition_->IsRegionErased(marker_address, marker_size, &marker_erased));
+  if (!marker_erased) {
+    PW_LOG_DEBUG("KVS checkpoint was invalidated");
+    return Status::FailedPrecondition();
+  }
+
+  // There is a checkpoint that has not been invalidated. Track it even if it
+  // turns out to be unusable so that it can be invalidated.
+  marker_address_ = marker_address;
+
+  if (header.sector_size_bytes != kvs_partition.sector_size_bytes() ||
+      header.sector_count != sectors.size() ||
+      header.redundancy != entries.redundancy() ||
+      header.entry_count > entries.max_entries()) {
+    PW_LOG_INFO("KVS checkpoint does not match the KVS configuration");
+    return Status::FailedPrecondition();
+  }
+
+  checksum::Crc32 crc;
+  crc.Update(ChecksummedHeaderBytes(header));
+  Address address = sizeof(header);
+
+  const size_t sector_size_bytes = kvs_partition.sector_size_bytes();
+  for (SectorDescriptor& sector : sectors) {
+    CheckpointSectorRecord record;
+    PW_TRY(ReadRecord(*partition_, &address, crc, &record));
+
+    if (record.writable_bytes > sector_size_bytes ||
+        record.valid_bytes > sector_size_bytes - record.writable_bytes) {
+      return Status::DataLoss();
+    }
+    sector.set_writable_bytes(record.writable_bytes);
+    sector.AddValidBytes(record.valid_bytes);
+  }
+
+  for (size_t i = 0; i < header.entry_count; ++i) {
+    CheckpointEntryRecord record;
+    PW_TRY(ReadRecord(*partition_, &address, crc, &record));
+    if (record.state > static_cast<uint32_t>(EntryState::kDeleted)) {
+      return Status::DataLoss();
+    }
+
+    // Every entry has at least one address.
+    uint32_t entry_address;
+    PW_TRY(ReadRecord(*partition_, &address, crc, &entry_address));
+    if (entry_address >= kvs_partition.size_bytes()) {
+      return Status::DataLoss();
+    }
+
+    EntryMetadata metadata = entries.AddNew(
+        {
+            .key_hash = record.key_hash,
+            .transaction_id = record.transaction_id,
+            .state = static_cast<EntryState>(record.state),
+        },
+        entry_address);
+
+    for (size_t copy = 1; copy < header.redundancy; ++copy) {
+      PW_TRY(ReadRecord(*partition_, &address, crc, &entry_address));
+      if (entry_address == kNoAddress) {
+        continue;
+      }
+      if (entry_address >= kvs_partition.size_bytes()) {
+        return Status::DataLoss();
+      }
+      metadata.AddNewAddress(entry_address);
+    }
+  }
+
+  if (crc.value() != header.checksum) {
+    PW_LOG_WARN("KVS checkpoint checksum mismatch");
+    return Status::DataLoss();
+  }
+  return OkStatus();
+}
+
+Status Checkpoint::Invalidate() {
+  if (!current()) {
+    return OkStatus();
+  }
+
+  FlashPartition::Output output(*partition_, marker_address_);
+  AlignedWriterBuffer<kWriteBufferSize> writer(partition_->alignment_bytes(),
+                                               output);
+  PW_TRY(writer.Write(&kInvalidatedMarker, sizeof(kInvalidatedMarker))
+             .status());
+  PW_TRY(writer.Flush().status());
+
+  // Only forget the checkpoint once it is invalidated in flash, so sectors are
+  // not erased while a stale checkpoint could still be loaded.
+  marker_address_ = kNoMarker;
+  return OkStatus();
+}
+
+}  // namespace pw::kvs::internal
@@ -45,7 +45,7 @@ Status Entry::Read(FlashPartition& partition,
   if (partition.AppearsErased(as_bytes(span(&header.magic, 1)))) {
     return Status::NotFound();
   }
-  if (header.key_length_bytes > kMaxKeyLength) {
+  if ((header.key_length_bytes & ~kBatchContinuesBit) > kMaxKeyLength) {
     return Status::DataLoss();
   }
 
@@ -79,7 +79,8 @@ Entry::Entry(FlashPartition& partition,
              Key key,
              span<const byte> value,
              uint16_t value_size_bytes,
-             uint32_t transaction_id)
+             uint32_t transaction_id,
+             bool batch_continues)
     : Entry(&partition,
             address,
             format,
@@ -87,7 +88,8 @@ Entry::Entry(FlashPartition& partition,
              .checksum = 0,
              .alignment_units =
                  alignment_bytes_to_units(partition.alignment_bytes()),
-             .key_length_bytes = static_cast<uint8_t>(key.size()),
+             .key_length_bytes = static_cast<uint8_t>(
+                 key.size() | (batch_continues ? kBatchContinuesBit : 0u)),
              .value_size_bytes = value_size_bytes,
              .transaction_id = transaction_id}) {
   if (checksum_algo_ != nullptr) {
@@ -106,10 +108,30 @@ StatusWithSize Entry::Write(Key key, span<const byte> value) const {
       {as_bytes(span(&header_, 1)), as_bytes(span(key)), value});
 }
 
+Status Entry::Write(AlignedWriter& writer,
+                    Key key,
+                    span<const byte> value) const {
+  PW_TRY(writer.Write(&header_, sizeof(header_)).status());
+  PW_TRY(writer.Write(as_bytes(span(key))).status());
+  PW_TRY(writer.Write(value).status());
+
+  // Pad to the entry's size so the next entry starts at its aligned address.
+  constexpr byte padding[kMinAlignmentBytes - 1] = {};
+  size_t padding_to_add = Padding(content_size(), alignment_bytes());
+
+  while (padding_to_add != 0u) {
+    const size_t chunk_size = std::min(padding_to_add, sizeof(padding));
+    PW_TRY(writer.Write(padding, chunk_size).status());
+    padding_to_add -= chunk_size;
+  }
+  return OkStatus();
+}
+
 Status Entry::Update(const EntryFormat& new_format,
                      uint32_t new_transaction_id) {
   checksum_algo_ = new_format.checksum;
   header_.magic = new_format.magic;
+  header_.key_length_bytes &= kKeyLengthMask;
   header_.alignment_units =
       alignment_bytes_to_units(partition_->alignment_bytes());
   header_.transaction_id = new_transaction_id;
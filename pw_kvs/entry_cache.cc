@@ -17,6 +17,7 @@
 
 #include "pw_kvs/internal/entry_cache.h"
 
+#include <algorithm>
 #include <cinttypes>
 
 #include "pw_assert/check.h"
@@ -66,56 +67,65 @@ StatusWithSize EntryCache::Find(FlashPartition& partition,
                                 Key key,
                                 EntryMetadata* metadata) const {
   const uint32_t hash = internal::Hash(key);
+  const int index = FindIndex(hash);
+
+  if (index == -1) {
+    return StatusWithSize::NotFound();
+  }
+
+  const size_t i = index;
   Entry::KeyBuffer key_buffer;
   bool error_detected = false;
+  bool key_found = false;
+  Key read_key;
 
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == hash) {
-      bool key_found = false;
-      Key read_key;
-
-      for (Address address : addresses(i)) {
-        Status read_result =
-            Entry::ReadKey(partition, address, key.size(), key_buffer.data());
-
-        read_key = Key(key_buffer.data(), key.size());
-
-        if (read_result.ok() && hash == internal::Hash(read_key)) {
-          key_found = true;
-          break;
-        } else {
-          // A hash mismatch can be caused by reading invalid data or a key hash
-          // collision of keys with differing size. To verify the data read from
-          // flash is good, validate the entry.
-          Entry entry;
-          read_result = Entry::Read(partition, address, formats, &entry);
-          if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
-            key_found = true;
-            break;
-          }
-
-          PW_LOG_WARN(
-              "   Found corrupt entry, invalidating this copy of the key");
-          error_detected = true;
-          sectors.FromAddress(address).mark_corrupt();
-        }
-      }
-      size_t error_val = error_detected ? 1 : 0;
-
-      if (!key_found) {
-        PW_LOG_ERROR("No valid entries for key. Data has been lost!");
-        return StatusWithSize::DataLoss(error_val);
-      } else if (key == read_key) {
-        PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
-        *metadata = EntryMetadata(descriptors_[i], addresses(i));
-        return StatusWithSize(error_val);
-      } else {
-        PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
-        return StatusWithSize::AlreadyExists(error_val);
+  for (Address address : addresses(i)) {
+    Status read_result =
+        Entry::ReadKey(partition, address, key.size(), key_buffer.data());
+
+    read_key = Key(key_buffer.data(), key.size());
+
+    if (read_result.ok() && hash == internal::Hash(read_key)) {
+      key_found = true;
+      break;
+    } else {
+      // A hash mismatch can be caused by reading invalid data or a key hash
+      // collision of keys with differing size. To verify the data read from
+      // flash is good, validate the entry.
+      Entry entry;
+      read_result = Entry::Read(partition, address, formats, &entry);
+      if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
+        key_found = true;
+        break;
       }
+
+      PW_LOG_WARN("   Found corrupt entry, invalidating this copy of the key");
+      error_detected = true;
+      sectors.FromAddress(address).mark_corrupt();
     }
   }
-  return StatusWithSize::NotFound();
+  size_t error_val = error_detected ? 1 : 0;
+
+  if (!key_found) {
+    PW_LOG_ERROR("No valid entries for key. Data has been lost!");
+    return StatusWithSize::DataLoss(error_val);
+  } else if (key == read_key) {
+    PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
+    *metadata = EntryMetadata(descriptors_[i], addresses(i));
+    return StatusWithSize(error_val);
+  } else {
+    PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
+    return StatusWithSize::AlreadyExists(error_val);
+  }
+}
+
+Status EntryCache::FindHash(uint32_t key_hash, EntryMetadata* metadata) const {
+  const int index = FindIndex(key_hash);
+  if (index == -1) {
+    return Status::NotFound();
+  }
+  *metadata = EntryMetadata(descriptors_[index], addresses(index));
+  return OkStatus();
 }
 
 EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
@@ -123,6 +133,9 @@ EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
   // TODO(hepler): DCHECK(!full());
   Address* first_address = ResetAddresses(descriptors_.size(), address);
   descriptors_.push_back(descriptor);
+  if (has_key_index()) {
+    IndexInsert(descriptors_.size() - 1);
+  }
   return EntryMetadata(descriptors_.back(), span(first_address, 1));
 }
 
@@ -134,6 +147,16 @@ EntryCache::iterator EntryCache::RemoveEntry(iterator& entry_it) {
       entry_it.metadata_.descriptor_ - &descriptors_.front();
   const KeyDescriptor last_desc = descriptors_[descriptors_.size() - 1];
 
+  // Drop the removed descriptor from the key index and point the last
+  // descriptor's slot at its new position before the descriptors move.
+  if (has_key_index()) {
+    IndexErase(IndexSlotFor(index_to_remove));
+    if (index_to_remove < descriptors_.size() - 1) {
+      key_index_[IndexSlotFor(descriptors_.size() - 1)] =
+          static_cast<IndexSlot>(index_to_remove + 1);
+    }
+  }
+
   // Since order is not important, this copies the last descriptor into the
   // deleted descriptor's space and then pops the last entry.
   Address* addresses_at_end = first_address(descriptors_.size() - 1);
@@ -152,10 +175,10 @@ EntryCache::iterator EntryCache::RemoveEntry(iterator& entry_it) {
   return {this, descriptors_.data() + index_to_remove};
 }
 
-// TODO(hepler): This method is the trigger of the O(valid_entries *
-// all_entries) time complexity for reading. At some cost to memory, this could
-// be optimized by using a hash table instead of scanning, but in practice this
-// should be fine for a small number of keys
+// Without a key index, this method is the trigger of the O(valid_entries *
+// all_entries) time complexity for reading, since FindIndex scans every
+// descriptor. This is fine for a small number of keys; larger stores should
+// provide a key index.
 Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
                                           Address address,
                                           size_t sector_size_bytes) const {
@@ -219,7 +242,25 @@ size_t EntryCache::present_entries() const {
   return present_entries;
 }
 
+void EntryCache::Reset() const {
+  descriptors_.clear();
+  std::fill(key_index_.begin(), key_index_.end(), kEmptyIndexSlot);
+}
+
 int EntryCache::FindIndex(uint32_t key_hash) const {
+  if (has_key_index()) {
+    // The key index always has more slots than descriptors, so there is always
+    // an empty slot to terminate the probe.
+    for (size_t slot = IndexHome(key_hash); key_index_[slot] != kEmptyIndexSlot;
+         slot = IndexNext(slot)) {
+      const size_t index = key_index_[slot] - 1u;
+      if (descriptors_[index].key_hash == key_hash) {
+        return index;
+      }
+    }
+    return -1;
+  }
+
   for (size_t i = 0; i < descriptors_.size(); ++i) {
     if (descriptors_[i].key_hash == key_hash) {
       return i;
@@ -228,6 +269,39 @@ int EntryCache::FindIndex(uint32_t key_hash) const {
   return -1;
 }
 
+size_t EntryCache::IndexSlotFor(size_t descriptor_index) const {
+  size_t slot = IndexHome(descriptors_[descriptor_index].key_hash);
+  while (key_index_[slot] != descriptor_index + 1u) {
+    PW_DCHECK_UINT_NE(key_index_[slot], kEmptyIndexSlot);
+    slot = IndexNext(slot);
+  }
+  return slot;
+}
+
+void EntryCache::IndexInsert(size_t descriptor_index) const {
+  size_t slot = IndexHome(descriptors_[descriptor_index].key_hash);
+  while (key_index_[slot] != kEmptyIndexSlot) {
+    slot = IndexNext(slot);
+  }
+  key_index_[slot] = static_cast<IndexSlot>(descriptor_index + 1);
+}
+
+void EntryCache::IndexErase(size_t slot) const {
+  // Backward-shift deletion: move later members of the probe sequence into the
+  // hole if their home slot is at or before the hole.
+  size_t hole = slot;
+  for (size_t next = IndexNext(hole); key_index_[next] != kEmptyIndexSlot;
+       next = IndexNext(next)) {
+    const size_t home = IndexHome(descriptors_[key_index_[next] - 1u].key_hash);
+    const size_t mask = key_index_.size() - 1;
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      key_index_[hole] = key_index_[next];
+      hole = next;
+    }
+  }
+  key_index_[hole] = kEmptyIndexSlot;
+}
+
 void EntryCache::AddAddressIfRoom(size_t descriptor_index,
                                   Address address) const {
   Address* const existing = first_address(descriptor_index);
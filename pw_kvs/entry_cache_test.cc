@@ -194,6 +194,106 @@ TEST_F(EmptyEntryCache, Iterator_Const_CanBeAssignedFromMutable) {
   EXPECT_EQ(99u, it->first_address());
 }
 
+class IndexedEntryCache : public ::testing::Test {
+ protected:
+  static constexpr size_t kMaxEntries = 32;
+  static constexpr size_t kRedundancy = 2;
+  static constexpr size_t kIndexSlots = 64;
+
+  IndexedEntryCache()
+      : entries_(descriptors_, addresses_, kRedundancy, key_index_) {}
+
+  // Returns a descriptor whose hash lands in the same home slot as every other
+  // descriptor from this function, forcing long probe sequences.
+  static constexpr KeyDescriptor Colliding(uint32_t i, uint32_t transaction) {
+    return {.key_hash = static_cast<uint32_t>(i * kIndexSlots + 7),
+            .transaction_id = transaction,
+            .state = EntryState::kValid};
+  }
+
+  Vector<KeyDescriptor, kMaxEntries> descriptors_;
+  EntryCache::AddressList<kMaxEntries, kRedundancy> addresses_;
+  EntryCache::KeyIndex<kIndexSlots> key_index_{};
+
+  EntryCache entries_;
+};
+
+static_assert(EntryCache::ValidKeyIndexSize<32, 0>());
+static_assert(EntryCache::ValidKeyIndexSize<32, 64>());
+static_assert(!EntryCache::ValidKeyIndexSize<32, 32>());
+static_assert(!EntryCache::ValidKeyIndexSize<32, 48>());
+
+TEST_F(IndexedEntryCache, AddNewOrUpdateExisting_FindsCollidingEntries) {
+  ASSERT_TRUE(entries_.has_key_index());
+
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(Colliding(i, 1), i * 100, 1));
+  }
+  ASSERT_TRUE(entries_.full());
+
+  // Newer versions of every key replace the existing descriptors.
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(Colliding(i, 2), i * 100, 1));
+  }
+  EXPECT_EQ(kMaxEntries, entries_.total_entries());
+
+  for (const EntryMetadata& entry : entries_) {
+    EXPECT_EQ(2u, entry.transaction_id());
+  }
+}
+
+TEST_F(IndexedEntryCache, RemoveEntry_KeepsIndexConsistent) {
+  for (uint32_t i = 0; i < 10; ++i) {
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(Colliding(i, 1), i * 100, 1));
+  }
+
+  // Remove every other entry, starting from the first one. Removal moves the
+  // last descriptor into the removed descriptor's position.
+  EntryCache::iterator it = entries_.begin();
+  while (it != entries_.end()) {
+    it = entries_.RemoveEntry(it);
+    if (it == entries_.end()) {
+      break;
+    }
+    ++it;
+  }
+  ASSERT_EQ(5u, entries_.total_entries());
+
+  // Every remaining entry is still found; every removed entry is added anew.
+  size_t remaining = 0;
+  for (uint32_t i = 0; i < 10; ++i) {
+    const size_t before = entries_.total_entries();
+    ASSERT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(Colliding(i, 2), i * 100, 1));
+    if (entries_.total_entries() == before) {
+      remaining += 1;
+    }
+  }
+  EXPECT_EQ(5u, remaining);
+  EXPECT_EQ(10u, entries_.total_entries());
+
+  for (const EntryMetadata& entry : entries_) {
+    EXPECT_EQ(2u, entry.transaction_id());
+    EXPECT_EQ((entry.hash() - 7) / kIndexSlots * 100, entry.first_address());
+  }
+}
+
+TEST_F(IndexedEntryCache, Reset_ClearsIndex) {
+  ASSERT_EQ(OkStatus(), entries_.AddNewOrUpdateExisting(kDescriptor, 10, 1));
+  entries_.Reset();
+  EXPECT_EQ(0u, entries_.total_entries());
+
+  // An older transaction is added rather than ignored as stale.
+  KeyDescriptor older = kDescriptor;
+  older.transaction_id -= 1;
+  ASSERT_EQ(OkStatus(), entries_.AddNewOrUpdateExisting(older, 20, 1));
+  ASSERT_EQ(1u, entries_.total_entries());
+  EXPECT_EQ(20u, entries_.begin()->first_address());
+}
+
 constexpr size_t kSectorSize = 64;
 constexpr uint32_t kMagic = 0xa14ae726;
 // For KVS entry magic value always use a random 32 bit integer rather than a
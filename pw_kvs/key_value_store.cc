@@ -36,6 +36,10 @@ constexpr bool InvalidKey(Key key) {
   return key.empty() || (key.size() > internal::Entry::kMaxKeyLength);
 }
 
+// Buffer for packing a batch's entries into as few aligned writes as possible.
+constexpr size_t kBatchWriteBufferSize =
+    std::max(kMaxFlashAlignment, 4 * internal::Entry::kMinAlignmentBytes);
+
 }  // namespace
 
 KeyValueStore::KeyValueStore(FlashPartition* partition,
@@ -45,12 +49,16 @@ KeyValueStore::KeyValueStore(FlashPartition* partition,
                              Vector<SectorDescriptor>& sector_descriptor_list,
                              const SectorDescriptor** temp_sectors_to_skip,
                              Vector<KeyDescriptor>& key_descriptor_list,
-                             Address* addresses)
+                             Address* addresses,
+                             span<internal::EntryCache::IndexSlot> key_index)
     : partition_(*partition),
       formats_(formats),
       sectors_(sector_descriptor_list, *partition, temp_sectors_to_skip),
-      entry_cache_(key_descriptor_list, addresses, redundancy),
+      entry_cache_(key_descriptor_list, addresses, redundancy, key_index),
       options_(options),
+      checkpoint_(),
+      value_cache_(nullptr),
+      complete_batch_end_(0),
       initialized_(InitializationState::kNotInitialized),
       error_detected_(false),
       internal_stats_({}),
@@ -61,6 +69,12 @@ Status KeyValueStore::Init() {
   error_detected_ = false;
   last_transaction_id_ = 0;
 
+  // Transaction IDs restart if the flash was erased, so cached values could
+  // match new entries.
+  if (value_cache_ != nullptr) {
+    value_cache_->Clear();
+  }
+
   PW_LOG_INFO("Initializing key value store");
   if (partition_.sector_count() > sectors_.max_size()) {
     PW_LOG_ERROR(
@@ -146,8 +160,23 @@ Status KeyValueStore::Init() {
 Status KeyValueStore::InitializeMetadata() {
   const size_t sector_size_bytes = partition_.sector_size_bytes();
 
+  if (checkpoint_.enabled()) {
+    const Status status = InitializeFromCheckpoint();
+    if (status.ok()) {
+      return OkStatus();
+    }
+    PW_LOG_INFO("KVS checkpoint not used (%s); reading all entries",
+                status.str());
+    last_transaction_id_ = 0;
+
+    // Sectors may be erased after this, so make sure an unusable checkpoint
+    // can never be loaded. If this fails, it is retried before any erase.
+    checkpoint_.Invalidate().IgnoreError();
+  }
+
   sectors_.Reset();
   entry_cache_.Reset();
+  complete_batch_end_ = 0;
 
   PW_LOG_DEBUG("First pass: Read all entries from all sectors");
   Address sector_address = 0;
@@ -161,6 +190,7 @@ Status KeyValueStore::InitializeMetadata() {
     Address entry_address = sector_address;
 
     size_t sector_corrupt_bytes = 0;
+    bool partial_batch_found = false;
 
     for (int num_entries_in_sector = 0; true; num_entries_in_sector++) {
       PW_LOG_DEBUG("Load entry: sector=%u, entry#=%d, address=%u",
@@ -179,6 +209,9 @@ Status KeyValueStore::InitializeMetadata() {
         PW_LOG_DEBUG(
             "Hit un-written data in sector; moving to the next sector");
         break;
+      } else if (status.IsAborted()) {
+        // The entry is from a partly written batch, so it was ignored.
+        partial_batch_found = true;
       } else if (!status.ok()) {
         // The entry could not be read, indicating likely data corruption within
         // the sector. Try to scan the remainder of the sector for other
@@ -210,6 +243,12 @@ Status KeyValueStore::InitializeMetadata() {
                                 (entry_address - sector_address));
     }
 
+    if (partial_batch_found) {
+      // Don't write after a partly written batch, since a new entry could
+      // appear to complete it.
+      sector.set_writable_bytes(0);
+    }
+
     if (sector_corrupt_bytes > 0) {
       // If the sector contains corrupt data, prevent any further entries from
       // being written to it by indicating that it has no space. This should
@@ -315,6 +354,10 @@ KeyValueStore::StorageStats KeyValueStore::GetStorageStats() const {
   stats.corrupt_sectors_recovered = internal_stats_.corrupt_sectors_recovered;
   stats.missing_redundant_entries_recovered =
       internal_stats_.missing_redundant_entries_recovered;
+  if (value_cache_ != nullptr) {
+    stats.value_cache_hits = value_cache_->hits();
+    stats.value_cache_misses = value_cache_->misses();
+  }
 
   for (const SectorDescriptor& sector : sectors_) {
     stats.in_use_bytes += sector.valid_bytes();
@@ -375,10 +418,147 @@ Status KeyValueStore::LoadEntry(Address entry_address,
   // A valid entry was found, so update the next entry address before doing any
   // of the checks that happen in AddNewOrUpdateExisting.
   *next_entry_address = entry.next_address();
+  PW_TRY(CheckBatchComplete(entry));
+
   return entry_cache_.AddNewOrUpdateExisting(
       entry.descriptor(key), entry.address(), partition_.sector_size_bytes());
 }
 
+Status KeyValueStore::InitializeFromCheckpoint() {
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+
+  sectors_.Reset();
+  entry_cache_.Reset();
+  complete_batch_end_ = 0;
+  PW_TRY(checkpoint_.Load(partition_, sectors_, entry_cache_));
+
+  PW_LOG_DEBUG("Loaded checkpoint; reading entries written after it");
+  Address sector_address = 0;
+  bool empty_sector_found = false;
+
+  for (SectorDescriptor& sector : sectors_) {
+    Address entry_address =
+        sector_address + sector_size_bytes - sector.writable_bytes();
+    bool partial_batch_found = false;
+
+    while (sectors_.AddressInSector(sector, entry_address)) {
+      Address next_entry_address;
+      Status status = ReplayEntry(entry_address, &next_entry_address);
+      if (status.IsNotFound()) {
+        break;  // Hit un-written data in the sector.
+      }
+      if (status.IsAborted()) {
+        partial_batch_found = true;
+      } else {
+        PW_TRY(status);
+      }
+
+      entry_address = next_entry_address;
+      sector.set_writable_bytes(sector_size_bytes -
+                                (entry_address - sector_address));
+    }
+
+    if (partial_batch_found) {
+      sector.set_writable_bytes(0);
+    }
+
+    if (sector.Empty(sector_size_bytes)) {
+      empty_sector_found = true;
+    }
+    sector_address += sector_size_bytes;
+  }
+
+  if (!empty_sector_found) {
+    return Status::FailedPrecondition();
+  }
+
+  Address newest_key = 0;
+  for (const EntryMetadata& metadata : entry_cache_) {
+    if (metadata.addresses().size() < redundancy()) {
+      return Status::FailedPrecondition();
+    }
+    if (metadata.IsNewerThan(last_transaction_id_)) {
+      last_transaction_id_ = metadata.transaction_id();
+      newest_key = metadata.addresses().back();
+    }
+  }
+
+  sectors_.set_last_new_sector(newest_key);
+  return OkStatus();
+}
+
+Status KeyValueStore::ReplayEntry(Address entry_address,
+                                  Address* next_entry_address) {
+  Entry entry;
+  PW_TRY(Entry::Read(partition_, entry_address, formats_, &entry));
+
+  Entry::KeyBuffer key_buffer;
+  PW_TRY_ASSIGN(size_t key_length, entry.ReadKey(key_buffer));
+  const Key key(key_buffer.data(), key_length);
+
+  PW_TRY(entry.VerifyChecksumInFlash());
+  *next_entry_address = entry.next_address();
+  PW_TRY(CheckBatchComplete(entry));
+
+  const KeyDescriptor descriptor = entry.descriptor(key);
+  EntryMetadata metadata;
+
+  // A newer entry replaces every copy of the existing one, so their bytes are
+  // no longer valid.
+  if (entry_cache_.FindHash(descriptor.key_hash, &metadata).ok() &&
+      descriptor.transaction_id > metadata.transaction_id()) {
+    for (Address address : metadata.addresses()) {
+      Entry prior_entry;
+      PW_TRY(Entry::Read(partition_, address, formats_, &prior_entry));
+      sectors_.FromAddress(address).RemoveValidBytes(prior_entry.size());
+    }
+  }
+
+  PW_TRY(entry_cache_.AddNewOrUpdateExisting(
+      descriptor, entry.address(), partition_.sector_size_bytes()));
+
+  // Count this entry's bytes if the cache kept it, rather than ignoring it as
+  // stale or as a copy beyond the redundancy.
+  PW_TRY(entry_cache_.FindHash(descriptor.key_hash, &metadata));
+  if (metadata.transaction_id() == descriptor.transaction_id) {
+    for (Address address : metadata.addresses()) {
+      if (address == entry.address()) {
+        sectors_.FromAddress(address).AddValidBytes(entry.size());
+      }
+    }
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::CheckBatchComplete(const Entry& entry) {
+  if (!entry.batch_continues() || entry.address() < complete_batch_end_) {
+    return OkStatus();
+  }
+
+  // The rest of the batch directly follows this entry in the same sector.
+  const SectorDescriptor& sector = sectors_.FromAddress(entry.address());
+  Address address = entry.next_address();
+
+  while (sectors_.AddressInSector(sector, address)) {
+    Entry next_entry;
+    if (!Entry::Read(partition_, address, formats_, &next_entry).ok() ||
+        next_entry.transaction_id() != entry.transaction_id() ||
+        !next_entry.VerifyChecksumInFlash().ok()) {
+      break;
+    }
+
+    address = next_entry.next_address();
+    if (!next_entry.batch_continues()) {
+      complete_batch_end_ = address;
+      return OkStatus();
+    }
+  }
+
+  PW_LOG_WARN("Ignoring entry at %u from a partly written batch",
+              unsigned(entry.address()));
+  return Status::Aborted();
+}
+
 // Scans flash memory within a sector to find a KVS entry magic.
 Status KeyValueStore::ScanForEntry(const SectorDescriptor& sector,
                                    Address start_address,
@@ -501,6 +681,113 @@ Status KeyValueStore::Delete(Key key) {
   return WriteEntryForExistingKey(metadata, EntryState::kDeleted, key, {});
 }
 
+Status KeyValueStore::Batch::Add(Key key,
+                                 span<const byte> value,
+                                 bool deleted) {
+  if (InvalidKey(key)) {
+    return Status::InvalidArgument();
+  }
+
+  for (const Operation& operation : operations_) {
+    if (operation.key == key) {
+      return Status::AlreadyExists();
+    }
+  }
+
+  if (operations_.full() ||
+      buffer_.size() - buffer_used_ < key.size() + value.size()) {
+    return Status::ResourceExhausted();
+  }
+
+  // Copy the key and value so the caller's buffers need not outlive the batch.
+  byte* const key_data = &buffer_[buffer_used_];
+  std::memcpy(key_data, key.data(), key.size());
+  byte* const value_data = key_data + key.size();
+  std::copy(value.begin(), value.end(), value_data);
+  buffer_used_ += key.size() + value.size();
+
+  operations_.push_back({
+      .key = Key(reinterpret_cast<const char*>(key_data), key.size()),
+      .value = span<const byte>(value_data, value.size()),
+      .deleted = deleted,
+  });
+  return OkStatus();
+}
+
+Status KeyValueStore::Commit(const Batch& batch) {
+  if (!initialized()) {
+    return Status::FailedPrecondition();
+  }
+  if (batch.empty()) {
+    return OkStatus();
+  }
+
+  size_t batch_size = 0;
+  for (const Batch::Operation& operation : batch.operations_) {
+    batch_size += Entry::size(partition_, operation.key, operation.value);
+  }
+
+  if (batch_size > partition_.sector_size_bytes()) {
+    PW_LOG_DEBUG("%u B batch cannot fit in one sector", unsigned(batch_size));
+    return Status::InvalidArgument();
+  }
+
+  PW_TRY(CheckBatch(batch));
+
+  // Find space for each copy of the batch. This may garbage collect sectors,
+  // which relocates entries but does not add or remove keys.
+  Address* reserved_addresses = entry_cache_.TempReservedAddressesForWrite();
+  PW_TRY(GetAddressesForWrite(reserved_addresses, batch_size));
+
+  // The whole batch shares one transaction ID, which is burned even if the
+  // write fails, as in CreateEntry.
+  last_transaction_id_ += 1;
+  const uint32_t transaction_id = last_transaction_id_;
+
+  // Once the first copy is written, the batch is committed, so update the key
+  // descriptors. The old entries and their copies are now stale.
+  PW_TRY(WriteBatchCopy(
+      batch, transaction_id, reserved_addresses[0], batch_size));
+
+  Address address = reserved_addresses[0];
+  for (const Batch::Operation& operation : batch.operations_) {
+    const KeyDescriptor descriptor{
+        internal::Hash(operation.key),
+        transaction_id,
+        operation.deleted ? EntryState::kDeleted : EntryState::kValid};
+
+    EntryMetadata metadata;
+    if (entry_cache_.FindHash(descriptor.key_hash, &metadata).ok()) {
+      Entry prior_entry;
+      PW_TRY(ReadEntry(metadata, prior_entry));
+      for (Address prior_address : metadata.addresses()) {
+        sectors_.FromAddress(prior_address)
+            .RemoveValidBytes(prior_entry.size());
+      }
+      InvalidateCachedValue(descriptor.key_hash);
+      metadata.Reset(descriptor, address);
+    } else {
+      entry_cache_.AddNew(descriptor, address);
+    }
+    address += Entry::size(partition_, operation.key, operation.value);
+  }
+
+  // Write the additional copies of the batch, if redundancy is greater than 1.
+  for (size_t i = 1; i < redundancy(); ++i) {
+    PW_TRY(WriteBatchCopy(
+        batch, transaction_id, reserved_addresses[i], batch_size));
+
+    address = reserved_addresses[i];
+    for (const Batch::Operation& operation : batch.operations_) {
+      EntryMetadata metadata;
+      PW_TRY(entry_cache_.FindHash(internal::Hash(operation.key), &metadata));
+      metadata.AddNewAddress(address);
+      address += Entry::size(partition_, operation.key, operation.value);
+    }
+  }
+  return OkStatus();
+}
+
 void KeyValueStore::Item::ReadKey() {
   key_buffer_.fill('\0');
 
@@ -583,6 +870,16 @@ StatusWithSize KeyValueStore::Get(Key key,
                                   const EntryMetadata& metadata,
                                   span<std::byte> value_buffer,
                                   size_t offset_bytes) const {
+  if (value_cache_ != nullptr) {
+    StatusWithSize cached = value_cache_->Get(metadata.hash(),
+                                              metadata.transaction_id(),
+                                              value_buffer,
+                                              offset_bytes);
+    if (!cached.IsNotFound()) {
+      return cached;
+    }
+  }
+
   Entry entry;
 
   PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
@@ -595,8 +892,13 @@ StatusWithSize KeyValueStore::Get(Key key,
       std::memset(value_buffer.data(), 0, result.size());
       return StatusWithSize(verify_result, 0);
     }
+  }
 
-    return StatusWithSize(verify_result, result.size());
+  // Only cache complete values.
+  if (result.ok() && offset_bytes == 0u && value_cache_ != nullptr) {
+    value_cache_->Put(metadata.hash(),
+                      metadata.transaction_id(),
+                      value_buffer.first(result.size()));
   }
   return result;
 }
@@ -634,6 +936,14 @@ Status KeyValueStore::FixedSizeGet(Key key,
 }
 
 StatusWithSize KeyValueStore::ValueSize(const EntryMetadata& metadata) const {
+  if (value_cache_ != nullptr) {
+    StatusWithSize cached =
+        value_cache_->ValueSize(metadata.hash(), metadata.transaction_id());
+    if (cached.ok()) {
+      return cached;
+    }
+  }
+
   Entry entry;
   PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
 
@@ -665,6 +975,94 @@ Status KeyValueStore::CheckReadOperation(Key key) const {
   return OkStatus();
 }
 
+Status KeyValueStore::CheckBatch(const Batch& batch) {
+  size_t new_keys = 0;
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    const Batch::Operation& operation = batch.operations_[i];
+
+    // Keys in a batch are unique, but their hashes must be as well.
+    const uint32_t hash = internal::Hash(operation.key);
+    for (size_t j = 0; j < i; ++j) {
+      if (internal::Hash(batch.operations_[j].key) == hash) {
+        return Status::AlreadyExists();
+      }
+    }
+
+    EntryMetadata metadata;
+    if (operation.deleted) {
+      PW_TRY(FindExisting(operation.key, &metadata));
+      continue;
+    }
+
+    const Status status = FindEntry(operation.key, &metadata);
+    if (status.IsNotFound()) {
+      new_keys += 1;
+    } else {
+      PW_TRY(status);
+    }
+  }
+
+  if (new_keys > entry_cache_.max_entries() - entry_cache_.total_entries()) {
+    PW_LOG_WARN("KVS full: batch adds %u keys, but there is room for %u",
+                unsigned(new_keys),
+                unsigned(entry_cache_.max_entries() -
+                         entry_cache_.total_entries()));
+    return Status::ResourceExhausted();
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::WriteBatchCopy(const Batch& batch,
+                                     uint32_t transaction_id,
+                                     Address address,
+                                     size_t batch_size) {
+  SectorDescriptor& sector = sectors_.FromAddress(address);
+  const Address batch_address = address;
+
+  // Pack the entries into one stream of aligned writes. Every entry but the
+  // last is marked as continuing the batch.
+  Status status;
+  {
+    FlashPartition::Output output(partition_, address);
+    AlignedWriterBuffer<kBatchWriteBufferSize> writer(
+        std::max(partition_.alignment_bytes(), Entry::kMinAlignmentBytes),
+        output);
+
+    for (size_t i = 0; status.ok() && i < batch.size(); ++i) {
+      const Batch::Operation& operation = batch.operations_[i];
+      const Entry entry = CreateBatchEntry(
+          address, operation, transaction_id, i + 1 < batch.size());
+      status = entry.Write(writer, operation.key, operation.value);
+      address = entry.next_address();
+    }
+    status.Update(writer.Flush().status());
+  }
+
+  if (!status.ok()) {
+    PW_LOG_ERROR("Failed to write %u B batch at %#x",
+                 unsigned(batch_size),
+                 unsigned(batch_address));
+  }
+
+  for (address = batch_address;
+       status.ok() && options_.verify_on_write &&
+       address < batch_address + batch_size;) {
+    Entry entry;
+    status = Entry::Read(partition_, address, formats_, &entry);
+    if (status.ok()) {
+      status = entry.VerifyChecksumInFlash();
+      address = entry.next_address();
+    }
+  }
+
+  // A failed write may have disturbed all of the space, so it is never reused.
+  sector.RemoveWritableBytes(batch_size);
+  PW_TRY(MarkSectorCorruptIfNotOk(status, &sector));
+  sector.AddValidBytes(batch_size);
+  return OkStatus();
+}
+
 Status KeyValueStore::WriteEntryForExistingKey(EntryMetadata& metadata,
                                                EntryState new_state,
                                                Key key,
@@ -773,6 +1171,7 @@ KeyValueStore::EntryMetadata KeyValueStore::UpdateKeyDescriptor(
     sectors_.FromAddress(address).RemoveValidBytes(prior_size);
   }
 
+  InvalidateCachedValue(prior_metadata->hash());
   prior_metadata->Reset(entry.descriptor(prior_metadata->hash()), new_address);
   return *prior_metadata;
 }
@@ -913,6 +1312,12 @@ Status KeyValueStore::RelocateEntry(const EntryMetadata& metadata,
   // that will result in a new empty sector. Also find a sector that does not
   // have reclaimable space (mostly for the full GC, where that would result in
   // an immediate extra relocation).
+  // A relocated entry is no longer next to the rest of its batch, so it must
+  // stand alone.
+  if (entry.batch_continues()) {
+    PW_TRY(entry.Update(formats_.primary(), entry.transaction_id()));
+  }
+
   SectorDescriptor* new_sector;
 
   PW_TRY(sectors_.FindSpaceDuringGarbageCollection(
@@ -1009,6 +1414,12 @@ Status KeyValueStore::FullMaintenanceHelper(MaintenanceType maintenance_type) {
   }
 #endif  // PW_KVS_REMOVE_DELETED_KEYS_IN_HEAVY_MAINTENANCE
 
+  // Snapshot the now-compacted state for fast initialization.
+  if (checkpoint_.enabled() && overall_status.ok() && !error_detected_) {
+    overall_status.Update(
+        checkpoint_.Write(partition_, sectors_, entry_cache_));
+  }
+
   if (overall_status.ok()) {
     PW_LOG_INFO("Full maintenance complete");
   } else {
@@ -1089,6 +1500,7 @@ Status KeyValueStore::GarbageCollectSector(
   if (!sector_to_gc.Empty(partition_.sector_size_bytes())) {
     sector_to_gc.mark_corrupt();
     internal_stats_.sector_erase_count++;
+    PW_TRY(checkpoint_.Invalidate());
     PW_TRY(partition_.Erase(sectors_.BaseAddress(sector_to_gc), 1));
     sector_to_gc.set_writable_bytes(partition_.sector_size_bytes());
   }
@@ -1304,6 +1716,28 @@ Status KeyValueStore::Repair() {
   return FixErrors();
 }
 
+KeyValueStore::Entry KeyValueStore::CreateBatchEntry(
+    Address address,
+    const Batch::Operation& operation,
+    uint32_t transaction_id,
+    bool batch_continues) {
+  if (operation.deleted) {
+    return Entry::Tombstone(partition_,
+                            address,
+                            formats_.primary(),
+                            operation.key,
+                            transaction_id,
+                            batch_continues);
+  }
+  return Entry::Valid(partition_,
+                      address,
+                      formats_.primary(),
+                      operation.key,
+                      operation.value,
+                      transaction_id,
+                      batch_continues);
+}
+
 KeyValueStore::Entry KeyValueStore::CreateEntry(Address address,
                                                 Key key,
                                                 span<const byte> value,
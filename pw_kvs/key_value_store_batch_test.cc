@@ -0,0 +1,288 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr size_t kMaxEntries = 32;
+constexpr size_t kSectorCount = 4;
+constexpr size_t kSectorSize = 512;
+
+ChecksumCrc16 checksum;
+
+// For KVS magic value always use a random 32 bit integer rather than a human
+// readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x2c6e31f5, .checksum = &checksum};
+
+template <size_t kRedundancy>
+class KvsBatch : public ::testing::Test {
+ protected:
+  using Kvs = KeyValueStoreBuffer<kMaxEntries, kSectorCount, kRedundancy>;
+
+  KvsBatch() : flash_(16), partition_(&flash_), kvs_(&partition_, kFormat) {
+    EXPECT_EQ(OkStatus(), partition_.Erase());
+    EXPECT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  uint32_t GetValue(Kvs& kvs, std::string_view key) {
+    uint32_t value = 0;
+    EXPECT_EQ(OkStatus(), kvs.Get(key, &value));
+    return value;
+  }
+
+  // Erases the last entry written for a key with a uint32_t value from the
+  // fake flash, as if the write had been interrupted before it.
+  void EraseLastEntry(std::string_view key) {
+    const span<byte> buffer = flash_.buffer();
+    const auto key_bytes = as_bytes(span(key));
+    auto found = buffer.end();
+
+    for (auto it = std::search(buffer.begin(),
+                               buffer.end(),
+                               key_bytes.begin(),
+                               key_bytes.end());
+         it != buffer.end();
+         it = std::search(
+             it + 1, buffer.end(), key_bytes.begin(), key_bytes.end())) {
+      found = it;
+    }
+    ASSERT_NE(found, buffer.end());
+
+    constexpr uint32_t kValue = 0;
+    const auto entry_start = found - sizeof(internal::EntryHeader);
+    std::fill(entry_start,
+              entry_start + internal::Entry::size(
+                                partition_, key, as_bytes(span(&kValue, 1))),
+              FakeFlashMemory::kErasedValue);
+  }
+
+  FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  FlashPartition partition_;
+  Kvs kvs_;
+  KeyValueStore::BatchBuffer<8, 128> batch_;
+};
+
+using KvsBatchRedundancy1 = KvsBatch<1>;
+using KvsBatchRedundancy2 = KvsBatch<2>;
+
+TEST_F(KvsBatchRedundancy1, Commit_AppliesPutsAndDeletes) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("a", uint32_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.Put("b", uint32_t(2)));
+
+  ASSERT_EQ(OkStatus(), batch_.Put("a", uint32_t(10)));
+  ASSERT_EQ(OkStatus(), batch_.Delete("b"));
+  ASSERT_EQ(OkStatus(), batch_.Put("c", uint32_t(30)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  EXPECT_EQ(10u, GetValue(kvs_, "a"));
+  uint32_t value;
+  EXPECT_EQ(Status::NotFound(), kvs_.Get("b", &value));
+  EXPECT_EQ(30u, GetValue(kvs_, "c"));
+  EXPECT_EQ(2u, kvs_.size());
+}
+
+TEST_F(KvsBatchRedundancy1, Commit_UsesOneTransactionId) {
+  const uint32_t transaction_count = kvs_.transaction_count();
+
+  ASSERT_EQ(OkStatus(), batch_.Put("a", uint32_t(1)));
+  ASSERT_EQ(OkStatus(), batch_.Put("b", uint32_t(2)));
+  ASSERT_EQ(OkStatus(), batch_.Put("c", uint32_t(3)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  EXPECT_EQ(transaction_count + 1, kvs_.transaction_count());
+}
+
+TEST_F(KvsBatchRedundancy1, Commit_EmptyBatch_WritesNothing) {
+  const uint32_t transaction_count = kvs_.transaction_count();
+  EXPECT_EQ(OkStatus(), kvs_.Commit(batch_));
+  EXPECT_EQ(transaction_count, kvs_.transaction_count());
+}
+
+TEST_F(KvsBatchRedundancy1, Commit_DeleteMissingKey_WritesNothing) {
+  ASSERT_EQ(OkStatus(), batch_.Put("a", uint32_t(1)));
+  ASSERT_EQ(OkStatus(), batch_.Delete("missing"));
+
+  EXPECT_EQ(Status::NotFound(), kvs_.Commit(batch_));
+  EXPECT_EQ(0u, kvs_.size());
+  EXPECT_EQ(0u, kvs_.GetStorageStats().in_use_bytes);
+}
+
+TEST_F(KvsBatchRedundancy1, Commit_LargerThanSector_InvalidArgument) {
+  std::array<byte, kSectorSize / 2> value{};
+  KeyValueStore::BatchBuffer<2, 2 * kSectorSize> batch;
+  ASSERT_EQ(OkStatus(), batch.Put("a", value));
+  ASSERT_EQ(OkStatus(), batch.Put("b", value));
+
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.Commit(batch));
+  EXPECT_EQ(0u, kvs_.size());
+}
+
+TEST_F(KvsBatchRedundancy1, Commit_TooManyNewKeys_ResourceExhausted) {
+  for (size_t i = 0; i < kMaxEntries - 1; ++i) {
+    const char key[] = {'k', char('a' + i / 16), char('a' + i % 16)};
+    ASSERT_EQ(OkStatus(), kvs_.Put(std::string_view(key, 3), uint32_t(i)));
+  }
+
+  ASSERT_EQ(OkStatus(), batch_.Put("new_1", uint32_t(1)));
+  ASSERT_EQ(OkStatus(), batch_.Put("new_2", uint32_t(2)));
+  EXPECT_EQ(Status::ResourceExhausted(), kvs_.Commit(batch_));
+  EXPECT_EQ(kMaxEntries - 1, kvs_.size());
+}
+
+TEST_F(KvsBatchRedundancy1, Batch_CopiesKeysAndValues) {
+  {
+    char key[] = "temporary";
+    uint32_t value = 123;
+    ASSERT_EQ(OkStatus(), batch_.Put(key, value));
+    std::memset(key, 'x', sizeof(key) - 1);
+    value = 0;
+  }
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+  EXPECT_EQ(123u, GetValue(kvs_, "temporary"));
+}
+
+TEST_F(KvsBatchRedundancy1, Batch_DuplicateKey_AlreadyExists) {
+  ASSERT_EQ(OkStatus(), batch_.Put("a", uint32_t(1)));
+  EXPECT_EQ(Status::AlreadyExists(), batch_.Put("a", uint32_t(2)));
+  EXPECT_EQ(Status::AlreadyExists(), batch_.Delete("a"));
+  EXPECT_EQ(1u, batch_.size());
+}
+
+TEST_F(KvsBatchRedundancy1, Batch_Full_ResourceExhausted) {
+  KeyValueStore::BatchBuffer<1, 16> batch;
+  ASSERT_EQ(OkStatus(), batch.Put("a", uint32_t(1)));
+  EXPECT_EQ(Status::ResourceExhausted(), batch.Put("b", uint32_t(2)));
+
+  batch.clear();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(Status::ResourceExhausted(),
+            batch.Put("a_key_longer_than_the_buffer", uint32_t(1)));
+}
+
+TEST_F(KvsBatchRedundancy1, Batch_InvalidKey_InvalidArgument) {
+  EXPECT_EQ(Status::InvalidArgument(), batch_.Put("", uint32_t(1)));
+}
+
+TEST_F(KvsBatchRedundancy1, Init_CompleteBatch_Loaded) {
+  ASSERT_EQ(OkStatus(), batch_.Put("a", uint32_t(1)));
+  ASSERT_EQ(OkStatus(), batch_.Put("b", uint32_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  Kvs kvs(&partition_, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_EQ(1u, GetValue(kvs, "a"));
+  EXPECT_EQ(2u, GetValue(kvs, "b"));
+}
+
+TEST_F(KvsBatchRedundancy1, Init_PartlyWrittenBatch_Ignored) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("a", uint32_t(1)));
+
+  ASSERT_EQ(OkStatus(), batch_.Put("a", uint32_t(10)));
+  ASSERT_EQ(OkStatus(), batch_.Put("b", uint32_t(20)));
+  ASSERT_EQ(OkStatus(), batch_.Put("c", uint32_t(30)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+  EraseLastEntry("c");
+
+  Kvs kvs(&partition_, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_EQ(1u, GetValue(kvs, "a"));
+  uint32_t value;
+  EXPECT_EQ(Status::NotFound(), kvs.Get("b", &value));
+  EXPECT_EQ(Status::NotFound(), kvs.Get("c", &value));
+  EXPECT_EQ(1u, kvs.size());
+}
+
+TEST_F(KvsBatchRedundancy1, Init_PartlyWrittenBatch_NotCompletedByLaterWrites) {
+  ASSERT_EQ(OkStatus(), batch_.Put("a", uint32_t(10)));
+  ASSERT_EQ(OkStatus(), batch_.Put("b", uint32_t(20)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+  EraseLastEntry("b");
+
+  {
+    Kvs kvs(&partition_, kFormat);
+    ASSERT_EQ(OkStatus(), kvs.Init());
+    ASSERT_EQ(OkStatus(), kvs.Put("b", uint32_t(2)));
+    ASSERT_EQ(OkStatus(), kvs.Put("c", uint32_t(3)));
+  }
+
+  Kvs kvs(&partition_, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  uint32_t value;
+  EXPECT_EQ(Status::NotFound(), kvs.Get("a", &value));
+  EXPECT_EQ(2u, GetValue(kvs, "b"));
+  EXPECT_EQ(3u, GetValue(kvs, "c"));
+}
+
+TEST_F(KvsBatchRedundancy1, GarbageCollect_KeepsRelocatedBatchEntries) {
+  ASSERT_EQ(OkStatus(), batch_.Put("a", uint32_t(1)));
+  ASSERT_EQ(OkStatus(), batch_.Put("b", uint32_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  // Overwrite the last entry in the batch until its sector is garbage
+  // collected, which relocates "a" without the rest of its batch.
+  for (uint32_t i = 0; kvs_.GetStorageStats().sector_erase_count < kSectorCount;
+       ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put("b", i));
+  }
+
+  Kvs kvs(&partition_, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_EQ(1u, GetValue(kvs, "a"));
+}
+
+TEST_F(KvsBatchRedundancy2, Commit_WritesAllCopies) {
+  ASSERT_EQ(OkStatus(), batch_.Put("a", uint32_t(1)));
+  ASSERT_EQ(OkStatus(), batch_.Put("b", uint32_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+
+  Kvs kvs(&partition_, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_FALSE(kvs.error_detected());
+  EXPECT_EQ(0u, kvs.GetStorageStats().missing_redundant_entries_recovered);
+  EXPECT_EQ(kvs_.GetStorageStats().in_use_bytes,
+            kvs.GetStorageStats().in_use_bytes);
+}
+
+TEST_F(KvsBatchRedundancy2, Init_PartlyWrittenSecondCopy_BatchCommitted) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("z", uint32_t(0)));
+
+  ASSERT_EQ(OkStatus(), batch_.Put("a", uint32_t(1)));
+  ASSERT_EQ(OkStatus(), batch_.Put("b", uint32_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch_));
+  EraseLastEntry("b");  // Only erases the second copy.
+
+  Kvs kvs(&partition_, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  EXPECT_EQ(1u, GetValue(kvs, "a"));
+  EXPECT_EQ(2u, GetValue(kvs, "b"));
+  EXPECT_EQ(2u, kvs.GetStorageStats().missing_redundant_entries_recovered);
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -0,0 +1,244 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kMaxEntries = 64;
+constexpr size_t kSectorCount = 4;
+constexpr size_t kRedundancy = 2;
+
+ChecksumCrc16 checksum;
+
+// For KVS magic value always use a random 32 bit integer rather than a human
+// readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x5f1b3c2d, .checksum = &checksum};
+
+// Partition that counts the bytes read, to tell whether Init() read every
+// entry or used the checkpoint.
+class ReadCountingPartition : public FlashPartition {
+ public:
+  explicit ReadCountingPartition(FlashMemory* flash) : FlashPartition(flash) {}
+
+  StatusWithSize Read(Address address, span<std::byte> output) override {
+    bytes_read_ += output.size();
+    return FlashPartition::Read(address, output);
+  }
+
+  size_t bytes_read() const { return bytes_read_; }
+  void reset_bytes_read() { bytes_read_ = 0; }
+
+ private:
+  size_t bytes_read_ = 0;
+};
+
+using Kvs = KeyValueStoreBuffer<kMaxEntries, kSectorCount, kRedundancy>;
+
+class KvsCheckpoint : public ::testing::Test {
+ protected:
+  KvsCheckpoint()
+      : flash_(16),
+        partition_(&flash_),
+        checkpoint_flash_(16),
+        checkpoint_partition_(&checkpoint_flash_),
+        kvs_(&partition_, kFormat) {
+    EXPECT_EQ(OkStatus(), partition_.Erase());
+    EXPECT_EQ(OkStatus(), checkpoint_partition_.Erase());
+    kvs_.EnableCheckpoints(checkpoint_partition_);
+    EXPECT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  void PutKeys(size_t first, size_t count, uint32_t value_offset) {
+    for (size_t i = first; i < first + count; ++i) {
+      key_.clear();
+      key_.Format("key_%u", static_cast<unsigned>(i));
+      ASSERT_EQ(OkStatus(),
+                kvs_.Put(key_.view(), static_cast<uint32_t>(i + value_offset)));
+    }
+  }
+
+  // Checks that a KVS initialized with checkpoints has the same contents and
+  // stats as one initialized by reading every entry. Returns the bytes read by
+  // the checkpointed KVS's Init().
+  size_t ExpectInitMatchesFullScan() {
+    Kvs full_scan(&partition_, kFormat);
+    EXPECT_EQ(OkStatus(), full_scan.Init());
+
+    Kvs checkpointed(&partition_, kFormat);
+    checkpointed.EnableCheckpoints(checkpoint_partition_);
+    partition_.reset_bytes_read();
+    EXPECT_EQ(OkStatus(), checkpointed.Init());
+    const size_t bytes_read = partition_.bytes_read();
+
+    EXPECT_EQ(full_scan.size(), checkpointed.size());
+    for (const auto& item : full_scan) {
+      uint32_t expected = 0;
+      uint32_t actual = 0;
+      EXPECT_EQ(OkStatus(), item.Get(&expected));
+      EXPECT_EQ(OkStatus(), checkpointed.Get(item.key(), &actual));
+      EXPECT_EQ(expected, actual);
+    }
+
+    const KeyValueStore::StorageStats expected = full_scan.GetStorageStats();
+    const KeyValueStore::StorageStats actual = checkpointed.GetStorageStats();
+    EXPECT_EQ(expected.writable_bytes, actual.writable_bytes);
+    EXPECT_EQ(expected.in_use_bytes, actual.in_use_bytes);
+    EXPECT_EQ(expected.reclaimable_bytes, actual.reclaimable_bytes);
+    EXPECT_EQ(expected.sector_erase_count, actual.sector_erase_count);
+    EXPECT_EQ(expected.corrupt_sectors_recovered,
+              actual.corrupt_sectors_recovered);
+    EXPECT_EQ(expected.missing_redundant_entries_recovered,
+              actual.missing_redundant_entries_recovered);
+    return bytes_read;
+  }
+
+  size_t FullScanBytesRead() {
+    Kvs full_scan(&partition_, kFormat);
+    partition_.reset_bytes_read();
+    EXPECT_EQ(OkStatus(), full_scan.Init());
+    return partition_.bytes_read();
+  }
+
+  FakeFlashMemoryBuffer<1024, kSectorCount> flash_;
+  ReadCountingPartition partition_;
+  FakeFlashMemoryBuffer<1024, 2> checkpoint_flash_;
+  FlashPartition checkpoint_partition_;
+  Kvs kvs_;
+  StringBuffer<16> key_;
+};
+
+TEST_F(KvsCheckpoint, Init_NoCheckpoint_ReadsAllEntries) {
+  PutKeys(0, 10, 0);
+  EXPECT_EQ(FullScanBytesRead(), ExpectInitMatchesFullScan());
+}
+
+TEST_F(KvsCheckpoint, Init_FromCheckpoint_ReadsFewerBytes) {
+  PutKeys(0, 10, 0);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  EXPECT_LT(ExpectInitMatchesFullScan(), FullScanBytesRead());
+}
+
+TEST_F(KvsCheckpoint, Init_FromCheckpoint_ReplaysLaterEntries) {
+  PutKeys(0, 10, 0);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  PutKeys(5, 10, 100);  // Update 5 keys and add 5 new ones.
+  ASSERT_EQ(OkStatus(), kvs_.Delete("key_0"));
+
+  EXPECT_LT(ExpectInitMatchesFullScan(), FullScanBytesRead());
+
+  Kvs checkpointed(&partition_, kFormat);
+  checkpointed.EnableCheckpoints(checkpoint_partition_);
+  ASSERT_EQ(OkStatus(), checkpointed.Init());
+  uint32_t value = 0;
+  EXPECT_EQ(Status::NotFound(), checkpointed.Get("key_0", &value));
+  EXPECT_EQ(OkStatus(), checkpointed.Get("key_5", &value));
+  EXPECT_EQ(105u, value);
+  EXPECT_EQ(OkStatus(), checkpointed.Get("key_14", &value));
+  EXPECT_EQ(114u, value);
+}
+
+TEST_F(KvsCheckpoint, Init_CorruptCheckpoint_FallsBackToFullScan) {
+  PutKeys(0, 10, 0);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  // Flip a bit in the first entry record, after the header and sector records.
+  checkpoint_flash_.buffer()[20 + 8 * kSectorCount] ^= std::byte{0x01};
+
+  EXPECT_EQ(FullScanBytesRead(), ExpectInitMatchesFullScan());
+}
+
+TEST_F(KvsCheckpoint, GarbageCollect_InvalidatesCheckpoint) {
+  PutKeys(0, 10, 0);
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  // Update the same keys until a sector must be garbage collected.
+  const size_t erase_count = kvs_.GetStorageStats().sector_erase_count;
+  for (uint32_t i = 1; kvs_.GetStorageStats().sector_erase_count == erase_count;
+       ++i) {
+    PutKeys(0, 10, i * 100);
+  }
+
+  EXPECT_EQ(FullScanBytesRead(), ExpectInitMatchesFullScan());
+}
+
+// The largest sector size the KVS supports that is a multiple of the alignment.
+constexpr size_t kLargeSectorSize = 0xFFF0;
+
+FakeFlashMemoryBuffer<kLargeSectorSize, 3> large_sector_flash(16);
+FakeFlashMemoryBuffer<64 * 1024, 2> too_large_sector_flash(16);
+
+TEST(KvsCheckpointSectorSize, LargeSectors_RestoresSectorUsage) {
+  ReadCountingPartition partition(&large_sector_flash);
+  FakeFlashMemoryBuffer<1024, 2> checkpoint_flash(16);
+  FlashPartition checkpoint_partition(&checkpoint_flash);
+  ASSERT_EQ(OkStatus(), partition.Erase());
+  ASSERT_EQ(OkStatus(), checkpoint_partition.Erase());
+
+  Kvs kvs(&partition, kFormat);
+  kvs.EnableCheckpoints(checkpoint_partition);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  ASSERT_EQ(OkStatus(), kvs.Put("key", uint32_t{1}));
+  ASSERT_EQ(OkStatus(), kvs.FullMaintenance());
+  const KeyValueStore::StorageStats expected = kvs.GetStorageStats();
+  ASSERT_GT(expected.writable_bytes, kLargeSectorSize);
+
+  Kvs full_scan(&partition, kFormat);
+  partition.reset_bytes_read();
+  ASSERT_EQ(OkStatus(), full_scan.Init());
+  const size_t full_scan_bytes_read = partition.bytes_read();
+
+  Kvs checkpointed(&partition, kFormat);
+  checkpointed.EnableCheckpoints(checkpoint_partition);
+  partition.reset_bytes_read();
+  ASSERT_EQ(OkStatus(), checkpointed.Init());
+  EXPECT_LT(partition.bytes_read(), full_scan_bytes_read);
+  const KeyValueStore::StorageStats actual = checkpointed.GetStorageStats();
+  EXPECT_EQ(expected.writable_bytes, actual.writable_bytes);
+  EXPECT_EQ(expected.in_use_bytes, actual.in_use_bytes);
+  EXPECT_EQ(expected.reclaimable_bytes, actual.reclaimable_bytes);
+}
+
+TEST(KvsCheckpointSectorSize, 64KiBSectors_InitFailsWithoutCheckpoint) {
+  FlashPartition partition(&too_large_sector_flash);
+  FakeFlashMemoryBuffer<1024, 2> checkpoint_flash(16);
+  FlashPartition checkpoint_partition(&checkpoint_flash);
+  ASSERT_EQ(OkStatus(), partition.Erase());
+  ASSERT_EQ(OkStatus(), checkpoint_partition.Erase());
+
+  Kvs kvs(&partition, kFormat);
+  kvs.EnableCheckpoints(checkpoint_partition);
+  EXPECT_EQ(Status::FailedPrecondition(), kvs.Init());
+  EXPECT_EQ(Status::FailedPrecondition(), kvs.FullMaintenance());
+
+  bool erased = false;
+  ASSERT_EQ(OkStatus(),
+            checkpoint_partition.IsRegionErased(
+                0, checkpoint_partition.size_bytes(), &erased));
+  EXPECT_TRUE(erased);
+}
+
+}  // namespace
+}  // namespace pw::kvs
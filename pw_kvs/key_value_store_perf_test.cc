@@ -0,0 +1,140 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_assert/check.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_kvs/value_cache.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kSectorSize = 4 * 1024;
+constexpr size_t kSectorCount = 32;
+constexpr size_t kMaxEntries = 1024;
+constexpr size_t kKeyIndexSlots = 2 * kMaxEntries;
+
+// For KVS entry magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x3bd7e1a2, .checksum = nullptr};
+
+FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash(16);
+FlashPartition partition(&flash);
+
+// Fills a KVS with key_count keys, then measures looking up the most recently
+// written key. Without a key index, that key's descriptor is the last one
+// scanned, so this is the worst case lookup.
+template <size_t kIndexSlots>
+void GetWithKeyCount(perf_test::State& state, size_t key_count) {
+  static KeyValueStoreBuffer<kMaxEntries, kSectorCount, 1, 1, kIndexSlots> kvs(
+      &partition, kFormat);
+
+  PW_CHECK_OK(partition.Erase());
+  PW_CHECK_OK(kvs.Init());
+
+  StringBuffer<16> key;
+  for (size_t i = 0; i < key_count; ++i) {
+    key.clear();
+    key.Format("key_%u", static_cast<unsigned>(i));
+    PW_CHECK_OK(kvs.Put(key.view(), static_cast<uint32_t>(i)));
+  }
+
+  uint32_t value;
+  while (state.KeepRunning()) {
+    kvs.Get(key.view(), &value).IgnoreError();
+  }
+}
+
+PW_PERF_TEST(Get16Keys, GetWithKeyCount<0>, 16);
+PW_PERF_TEST(Get128Keys, GetWithKeyCount<0>, 128);
+PW_PERF_TEST(Get1024Keys, GetWithKeyCount<0>, 1024);
+
+PW_PERF_TEST(Get16KeysIndexed, GetWithKeyCount<kKeyIndexSlots>, 16);
+PW_PERF_TEST(Get128KeysIndexed, GetWithKeyCount<kKeyIndexSlots>, 128);
+PW_PERF_TEST(Get1024KeysIndexed, GetWithKeyCount<kKeyIndexSlots>, 1024);
+
+// Measures reading the same value repeatedly, with and without a value cache.
+template <bool kUseValueCache>
+void GetSameKey(perf_test::State& state) {
+  static KeyValueStoreBuffer<kMaxEntries, kSectorCount> kvs(&partition,
+                                                            kFormat);
+  static ValueCacheBuffer<8, sizeof(uint32_t)> value_cache;
+  if constexpr (kUseValueCache) {
+    kvs.EnableValueCache(value_cache);
+  }
+  PW_CHECK_OK(partition.Erase());
+  PW_CHECK_OK(kvs.Init());
+  PW_CHECK_OK(kvs.Put("hot_key", uint32_t(42)));
+
+  uint32_t value;
+  while (state.KeepRunning()) {
+    kvs.Get("hot_key", &value).IgnoreError();
+  }
+}
+
+PW_PERF_TEST(GetSameKeyUncached, GetSameKey<false>);
+PW_PERF_TEST(GetSameKeyCached, GetSameKey<true>);
+
+constexpr size_t kKeysPerUpdate = 8;
+constexpr std::array<std::string_view, kKeysPerUpdate> kUpdateKeys = {
+    "key_0", "key_1", "key_2", "key_3", "key_4", "key_5", "key_6", "key_7"};
+
+// Measures updating a group of related keys with one Put per key.
+void PutKeysIndividually(perf_test::State& state) {
+  static KeyValueStoreBuffer<kMaxEntries, kSectorCount> kvs(&partition,
+                                                            kFormat);
+  PW_CHECK_OK(partition.Erase());
+  PW_CHECK_OK(kvs.Init());
+
+  uint32_t value = 0;
+  while (state.KeepRunning()) {
+    value += 1;
+    for (std::string_view key : kUpdateKeys) {
+      kvs.Put(key, value).IgnoreError();
+    }
+  }
+}
+
+// Measures updating the same group of keys with one batch.
+void PutKeysInBatch(perf_test::State& state) {
+  static KeyValueStoreBuffer<kMaxEntries, kSectorCount> kvs(&partition,
+                                                            kFormat);
+  PW_CHECK_OK(partition.Erase());
+  PW_CHECK_OK(kvs.Init());
+
+  KeyValueStore::BatchBuffer<kKeysPerUpdate, 128> batch;
+  uint32_t value = 0;
+  while (state.KeepRunning()) {
+    value += 1;
+    batch.clear();
+    for (std::string_view key : kUpdateKeys) {
+      batch.Put(key, value).IgnoreError();
+    }
+    kvs.Commit(batch).IgnoreError();
+  }
+}
+
+PW_PERF_TEST(PutEightKeysIndividually, PutKeysIndividually);
+PW_PERF_TEST(PutEightKeysInBatch, PutKeysInBatch);
+
+}  // namespace
+}  // namespace pw::kvs
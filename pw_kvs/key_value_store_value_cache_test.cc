@@ -0,0 +1,241 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_kvs/value_cache.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kMaxEntries = 32;
+constexpr size_t kSectorCount = 4;
+
+ChecksumCrc16 checksum;
+
+// For KVS magic value always use a random 32 bit integer rather than a human
+// readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x6a1f23c9, .checksum = &checksum};
+
+// Partition that counts the bytes read, to tell whether a value was read from
+// flash or from the cache.
+class ReadCountingPartition : public FlashPartition {
+ public:
+  explicit ReadCountingPartition(FlashMemory* flash) : FlashPartition(flash) {}
+
+  StatusWithSize Read(Address address, span<std::byte> output) override {
+    bytes_read_ += output.size();
+    return FlashPartition::Read(address, output);
+  }
+
+  size_t bytes_read() const { return bytes_read_; }
+  void reset_bytes_read() { bytes_read_ = 0; }
+
+ private:
+  size_t bytes_read_ = 0;
+};
+
+class KvsValueCache : public ::testing::Test {
+ protected:
+  KvsValueCache()
+      : flash_(16), partition_(&flash_), kvs_(&partition_, kFormat) {
+    EXPECT_EQ(OkStatus(), partition_.Erase());
+    kvs_.EnableValueCache(cache_);
+    EXPECT_EQ(OkStatus(), kvs_.Init());
+  }
+
+  size_t hits() const { return kvs_.GetStorageStats().value_cache_hits; }
+  size_t misses() const { return kvs_.GetStorageStats().value_cache_misses; }
+
+  FakeFlashMemoryBuffer<512, kSectorCount> flash_;
+  ReadCountingPartition partition_;
+  ValueCacheBuffer<2, 8> cache_;
+  KeyValueStoreBuffer<kMaxEntries, kSectorCount> kvs_;
+};
+
+TEST_F(KvsValueCache, Get_SecondReadIsCached) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(123)));
+
+  uint32_t value = 0;
+  partition_.reset_bytes_read();
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+  const size_t uncached_bytes_read = partition_.bytes_read();
+  EXPECT_EQ(123u, value);
+  EXPECT_EQ(0u, hits());
+  EXPECT_EQ(1u, misses());
+
+  value = 0;
+  partition_.reset_bytes_read();
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+  EXPECT_LT(partition_.bytes_read(), uncached_bytes_read);
+  EXPECT_EQ(123u, value);
+  EXPECT_EQ(1u, hits());
+  EXPECT_EQ(1u, misses());
+}
+
+TEST_F(KvsValueCache, Get_WithOffset) {
+  constexpr std::array<char, 6> kValue = {'a', 'b', 'c', 'd', 'e', 'f'};
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", kValue));
+  std::array<char, 6> buffer{};
+  ASSERT_EQ(OkStatus(),
+            kvs_.Get("key", as_writable_bytes(span(buffer))).status());
+  ASSERT_EQ(1u, misses());
+
+  auto result = kvs_.Get("key", as_writable_bytes(span(buffer).first(2)), 1);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(2u, result.size());
+  EXPECT_EQ('b', buffer[0]);
+  EXPECT_EQ('c', buffer[1]);
+
+  result = kvs_.Get("key", as_writable_bytes(span(buffer)), 4);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(2u, result.size());
+  EXPECT_EQ('e', buffer[0]);
+  EXPECT_EQ('f', buffer[1]);
+
+  EXPECT_EQ(Status::OutOfRange(),
+            kvs_.Get("key", as_writable_bytes(span(buffer)), 7).status());
+  EXPECT_EQ(3u, hits());
+  EXPECT_EQ(1u, misses());
+}
+
+TEST_F(KvsValueCache, ValueSize_UsesCache) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint16_t(1)));
+  uint16_t value;
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+
+  EXPECT_EQ(2u, kvs_.ValueSize("key").size());
+}
+
+TEST_F(KvsValueCache, Put_InvalidatesCachedValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(1)));
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+  EXPECT_EQ(2u, value);
+  EXPECT_EQ(0u, hits());
+  EXPECT_EQ(2u, misses());
+}
+
+TEST_F(KvsValueCache, Delete_InvalidatesCachedValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(1)));
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+
+  ASSERT_EQ(OkStatus(), kvs_.Delete("key"));
+  EXPECT_EQ(Status::NotFound(), kvs_.Get("key", &value));
+}
+
+TEST_F(KvsValueCache, Commit_InvalidatesCachedValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(1)));
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+
+  KeyValueStore::BatchBuffer<2, 32> batch;
+  ASSERT_EQ(OkStatus(), batch.Put("key", uint32_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch));
+
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+  EXPECT_EQ(2u, value);
+}
+
+TEST_F(KvsValueCache, Get_EvictsLeastRecentlyUsed) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("a", uint32_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.Put("b", uint32_t(2)));
+  ASSERT_EQ(OkStatus(), kvs_.Put("c", uint32_t(3)));
+
+  uint32_t value;
+  ASSERT_EQ(OkStatus(), kvs_.Get("a", &value));  // miss
+  ASSERT_EQ(OkStatus(), kvs_.Get("b", &value));  // miss
+  ASSERT_EQ(OkStatus(), kvs_.Get("a", &value));  // hit
+  ASSERT_EQ(OkStatus(), kvs_.Get("c", &value));  // miss, evicts b
+  EXPECT_EQ(1u, hits());
+  EXPECT_EQ(3u, misses());
+
+  ASSERT_EQ(OkStatus(), kvs_.Get("a", &value));  // hit
+  ASSERT_EQ(OkStatus(), kvs_.Get("b", &value));  // miss, evicts c
+  EXPECT_EQ(2u, value);
+  EXPECT_EQ(2u, hits());
+  EXPECT_EQ(4u, misses());
+}
+
+TEST_F(KvsValueCache, Get_LargeValueIsNotCached) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("big", std::array<uint32_t, 3>{1, 2, 3}));
+
+  std::array<uint32_t, 3> value{};
+  ASSERT_EQ(OkStatus(), kvs_.Get("big", &value));
+  ASSERT_EQ(OkStatus(), kvs_.Get("big", &value));
+  EXPECT_EQ(3u, value[2]);
+  EXPECT_EQ(0u, hits());
+  EXPECT_EQ(2u, misses());
+}
+
+TEST_F(KvsValueCache, GarbageCollect_CachedValuesStillCorrect) {
+  uint32_t value;
+  for (uint32_t i = 1; kvs_.GetStorageStats().sector_erase_count == 0u; ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put("a", i));
+    ASSERT_EQ(OkStatus(), kvs_.Get("a", &value));
+    ASSERT_EQ(OkStatus(), kvs_.Put("b", i * 2));
+  }
+  const uint32_t expected = value;
+  ASSERT_EQ(OkStatus(), kvs_.Get("a", &value));
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+
+  const size_t hits_before = hits();
+  ASSERT_EQ(OkStatus(), kvs_.Get("a", &value));
+  EXPECT_EQ(expected, value);
+  EXPECT_EQ(hits_before + 1, hits());
+}
+
+TEST_F(KvsValueCache, Init_ClearsCache) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(1)));
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+
+  // After an erase, the new entry has the same transaction ID as the old one.
+  ASSERT_EQ(OkStatus(), partition_.Erase());
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  ASSERT_EQ(OkStatus(), kvs_.Put("key", uint32_t(2)));
+
+  ASSERT_EQ(OkStatus(), kvs_.Get("key", &value));
+  EXPECT_EQ(2u, value);
+}
+
+TEST(KvsValueCacheDisabled, StatsAreZero) {
+  FakeFlashMemoryBuffer<512, kSectorCount> flash(16);
+  FlashPartition partition(&flash);
+  ASSERT_EQ(OkStatus(), partition.Erase());
+  KeyValueStoreBuffer<kMaxEntries, kSectorCount> kvs(&partition, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  ASSERT_EQ(OkStatus(), kvs.Put("key", uint32_t(1)));
+  uint32_t value;
+  ASSERT_EQ(OkStatus(), kvs.Get("key", &value));
+  ASSERT_EQ(OkStatus(), kvs.Get("key", &value));
+
+  EXPECT_EQ(0u, kvs.GetStorageStats().value_cache_hits);
+  EXPECT_EQ(0u, kvs.GetStorageStats().value_cache_misses);
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -0,0 +1,201 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PW_FLASH"
+#define PW_LOG_LEVEL PW_KVS_LOG_LEVEL
+
+#include "pw_kvs/mapped_file_flash_memory.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "pw_kvs_private/config.h"
+#include "pw_log/log.h"
+
+namespace pw::kvs {
+namespace {
+
+void BusyWait(std::chrono::nanoseconds duration) {
+  if (duration.count() <= 0) {
+    return;
+  }
+  const auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+}  // namespace
+
+Status MappedFileFlashMemory::Enable() {
+  if (IsEnabled()) {
+    return OkStatus();
+  }
+
+  const int fd = open(path_, O_RDWR | O_CREAT, 0644);
+  if (fd == -1) {
+    PW_LOG_ERROR(
+        "Failed to open flash file %s: %s", path_, std::strerror(errno));
+    return Status::Unavailable();
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    PW_LOG_ERROR(
+        "Failed to stat flash file %s: %s", path_, std::strerror(errno));
+    close(fd);
+    return Status::Unavailable();
+  }
+
+  const size_t file_size = static_cast<size_t>(file_stat.st_size);
+  const size_t flash_size = sector_size_bytes() * sector_count();
+  if (file_size < flash_size &&
+      ftruncate(fd, static_cast<off_t>(flash_size)) != 0) {
+    PW_LOG_ERROR("Failed to resize flash file %s to %u B: %s",
+                 path_,
+                 unsigned(flash_size),
+                 std::strerror(errno));
+    close(fd);
+    return Status::Unavailable();
+  }
+
+  void* const mapping =
+      mmap(nullptr, flash_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    PW_LOG_ERROR(
+        "Failed to map flash file %s: %s", path_, std::strerror(errno));
+    close(fd);
+    return Status::Internal();
+  }
+
+  fd_ = fd;
+  mapping_ = span(static_cast<std::byte*>(mapping), flash_size);
+
+  // A new or extended file reads as zeros; make it read as erased flash.
+  if (file_size < flash_size) {
+    std::memset(mapping_.data() + file_size,
+                int(kErasedValue),
+                flash_size - file_size);
+  }
+  return OkStatus();
+}
+
+Status MappedFileFlashMemory::Disable() {
+  if (!IsEnabled()) {
+    return OkStatus();
+  }
+
+  Status status = OkStatus();
+  if (msync(mapping_.data(), mapping_.size(), MS_SYNC) != 0) {
+    PW_LOG_ERROR(
+        "Failed to sync flash file %s: %s", path_, std::strerror(errno));
+    status = Status::Internal();
+  }
+  munmap(mapping_.data(), mapping_.size());
+  close(fd_);
+
+  fd_ = -1;
+  mapping_ = span<std::byte>();
+  return status;
+}
+
+Status MappedFileFlashMemory::Erase(Address address, size_t num_sectors) {
+  if (!IsEnabled()) {
+    return Status::FailedPrecondition();
+  }
+  if (address % sector_size_bytes() != 0) {
+    PW_LOG_ERROR(
+        "Attempted to erase sector at non-sector aligned boundary; address %x",
+        unsigned(address));
+    return Status::InvalidArgument();
+  }
+  if (address / sector_size_bytes() + num_sectors > sector_count()) {
+    PW_LOG_ERROR(
+        "Tried to erase a sector at an address past flash end; "
+        "address: %x, sector count: %u",
+        unsigned(address),
+        unsigned(num_sectors));
+    return Status::OutOfRange();
+  }
+
+  BusyWait(latency_.erase_per_sector * num_sectors);
+  std::memset(mapping_.data() + address,
+              int(kErasedValue),
+              sector_size_bytes() * num_sectors);
+  return OkStatus();
+}
+
+StatusWithSize MappedFileFlashMemory::Read(Address address,
+                                           span<std::byte> output) {
+  if (!IsEnabled()) {
+    return StatusWithSize::FailedPrecondition();
+  }
+  if (address > mapping_.size() || output.size() > mapping_.size() - address) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  std::memcpy(output.data(), mapping_.data() + address, output.size());
+  return StatusWithSize(output.size());
+}
+
+StatusWithSize MappedFileFlashMemory::Write(Address address,
+                                            span<const std::byte> data) {
+  if (!IsEnabled()) {
+    return StatusWithSize::FailedPrecondition();
+  }
+  if (address % alignment_bytes() != 0 ||
+      data.size() % alignment_bytes() != 0) {
+    PW_LOG_ERROR("Unaligned write; address %x, size %u B, alignment %u",
+                 unsigned(address),
+                 unsigned(data.size()),
+                 unsigned(alignment_bytes()));
+    return StatusWithSize::InvalidArgument();
+  }
+
+  if (address > mapping_.size() || data.size() > mapping_.size() - address) {
+    PW_LOG_ERROR(
+        "Write beyond end of memory; address %x, size %u B, max address %x",
+        unsigned(address),
+        unsigned(data.size()),
+        unsigned(mapping_.size()));
+    return StatusWithSize::OutOfRange();
+  }
+
+  for (size_t i = 0; i < data.size(); i++) {
+    if (mapping_[address + i] != kErasedValue) {
+      PW_LOG_ERROR("Writing to previously written address: %x",
+                   unsigned(address + i));
+      return StatusWithSize::Unknown();
+    }
+  }
+
+  BusyWait(latency_.program_per_write_unit *
+           (data.size() / alignment_bytes()));
+  std::memcpy(mapping_.data() + address, data.data(), data.size());
+  return StatusWithSize(data.size());
+}
+
+std::byte* MappedFileFlashMemory::FlashAddressToMcuAddress(
+    Address address) const {
+  if (!IsEnabled() || address > mapping_.size()) {
+    return nullptr;
+  }
+  return mapping_.data() + address;
+}
+
+}  // namespace pw::kvs
@@ -0,0 +1,188 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/mapped_file_flash_memory.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+
+namespace pw::kvs {
+namespace {
+
+using std::byte;
+
+constexpr size_t kSectorSize = 4096;
+constexpr size_t kSectorCount = 4;
+constexpr size_t kAlignment = 16;
+
+// For KVS magic value always use a random 32 bit integer rather than a human
+// readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x2c7e9f14, .checksum = nullptr};
+
+class MappedFileFlash : public ::testing::Test {
+ protected:
+  MappedFileFlash() : path_{"/tmp/pw_kvs_mapped_flash_XXXXXX"} {
+    const int fd = mkstemp(path_);
+    EXPECT_NE(fd, -1);
+    close(fd);
+  }
+
+  ~MappedFileFlash() override { unlink(path_); }
+
+  char path_[32];
+};
+
+TEST_F(MappedFileFlash, Enable_NewFileIsErased) {
+  MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount, kAlignment);
+  ASSERT_EQ(OkStatus(), flash.Enable());
+  ASSERT_EQ(kSectorSize * kSectorCount, flash.buffer().size());
+
+  for (byte b : flash.buffer()) {
+    ASSERT_EQ(MappedFileFlashMemory::kErasedValue, b);
+  }
+}
+
+TEST_F(MappedFileFlash, Enable_MissingDirectory_Unavailable) {
+  MappedFileFlashMemory flash(
+      "/nonexistent/pw_kvs/flash", kSectorSize, kSectorCount);
+  EXPECT_EQ(Status::Unavailable(), flash.Enable());
+  EXPECT_FALSE(flash.IsEnabled());
+}
+
+TEST_F(MappedFileFlash, NotEnabled_FailedPrecondition) {
+  MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount);
+  std::array<byte, 4> buffer{};
+  EXPECT_EQ(Status::FailedPrecondition(), flash.Erase(0, 1));
+  EXPECT_EQ(Status::FailedPrecondition(), flash.Read(0, buffer).status());
+  EXPECT_EQ(Status::FailedPrecondition(), flash.Write(0, buffer).status());
+  EXPECT_EQ(nullptr, flash.FlashAddressToMcuAddress(0));
+}
+
+TEST_F(MappedFileFlash, Write_RequiresErase) {
+  MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount, kAlignment);
+  ASSERT_EQ(OkStatus(), flash.Enable());
+
+  std::array<byte, kAlignment> data;
+  data.fill(byte{0x5a});
+  ASSERT_EQ(OkStatus(), flash.Write(kAlignment, data).status());
+  EXPECT_EQ(Status::Unknown(), flash.Write(kAlignment, data).status());
+
+  ASSERT_EQ(OkStatus(), flash.Erase(0, 1));
+  EXPECT_EQ(OkStatus(), flash.Write(kAlignment, data).status());
+}
+
+TEST_F(MappedFileFlash, Write_Unaligned_InvalidArgument) {
+  MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount, kAlignment);
+  ASSERT_EQ(OkStatus(), flash.Enable());
+
+  std::array<byte, kAlignment> data{};
+  EXPECT_EQ(Status::InvalidArgument(), flash.Write(1, data).status());
+  EXPECT_EQ(Status::InvalidArgument(),
+            flash.Write(0, span(data).first(kAlignment - 1)).status());
+}
+
+TEST_F(MappedFileFlash, OutOfRange) {
+  MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount, kAlignment);
+  ASSERT_EQ(OkStatus(), flash.Enable());
+
+  std::array<byte, kAlignment> data{};
+  const size_t end = kSectorSize * kSectorCount;
+  EXPECT_EQ(Status::OutOfRange(), flash.Read(end - 1, data).status());
+  EXPECT_EQ(Status::OutOfRange(), flash.Write(end, data).status());
+  EXPECT_EQ(Status::OutOfRange(), flash.Erase(kSectorSize, kSectorCount));
+  EXPECT_EQ(Status::InvalidArgument(), flash.Erase(1, 1));
+}
+
+TEST_F(MappedFileFlash, FlashAddressToMcuAddress_PointsIntoMapping) {
+  MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount, kAlignment);
+  ASSERT_EQ(OkStatus(), flash.Enable());
+
+  std::array<byte, kAlignment> data;
+  data.fill(byte{0x12});
+  ASSERT_EQ(OkStatus(), flash.Write(kSectorSize, data).status());
+
+  const byte* mapped = flash.FlashAddressToMcuAddress(kSectorSize);
+  ASSERT_NE(nullptr, mapped);
+  EXPECT_EQ(0, std::memcmp(mapped, data.data(), data.size()));
+}
+
+TEST_F(MappedFileFlash, Contents_PersistAcrossDisable) {
+  std::array<byte, kAlignment> data;
+  data.fill(byte{0x34});
+  {
+    MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount, kAlignment);
+    ASSERT_EQ(OkStatus(), flash.Enable());
+    ASSERT_EQ(OkStatus(), flash.Write(2 * kSectorSize, data).status());
+    ASSERT_EQ(OkStatus(), flash.Disable());
+    EXPECT_FALSE(flash.IsEnabled());
+  }
+
+  MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount, kAlignment);
+  ASSERT_EQ(OkStatus(), flash.Enable());
+  std::array<byte, kAlignment> read{};
+  ASSERT_EQ(OkStatus(), flash.Read(2 * kSectorSize, read).status());
+  EXPECT_EQ(data, read);
+}
+
+TEST_F(MappedFileFlash, Latency_DelaysEraseAndProgram) {
+  MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount, kAlignment);
+  ASSERT_EQ(OkStatus(), flash.Enable());
+  flash.set_latency({.program_per_write_unit = std::chrono::microseconds(100),
+                     .erase_per_sector = std::chrono::milliseconds(1)});
+
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(OkStatus(), flash.Erase(0, 2));
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(2));
+
+  std::array<byte, 4 * kAlignment> data{};
+  start = std::chrono::steady_clock::now();
+  ASSERT_EQ(OkStatus(), flash.Write(0, data).status());
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::microseconds(400));
+}
+
+TEST_F(MappedFileFlash, KeyValueStore_PersistsAcrossInit) {
+  {
+    MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount, kAlignment);
+    ASSERT_EQ(OkStatus(), flash.Enable());
+    FlashPartition partition(&flash);
+    KeyValueStoreBuffer<16, kSectorCount> kvs(&partition, kFormat);
+    ASSERT_EQ(OkStatus(), kvs.Init());
+    ASSERT_EQ(OkStatus(), kvs.Put("key", uint32_t(0xfeedbeef)));
+  }
+
+  MappedFileFlashMemory flash(path_, kSectorSize, kSectorCount, kAlignment);
+  ASSERT_EQ(OkStatus(), flash.Enable());
+  FlashPartition partition(&flash);
+  KeyValueStoreBuffer<16, kSectorCount> kvs(&partition, kFormat);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs.Get("key", &value));
+  EXPECT_EQ(0xfeedbeefu, value);
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -0,0 +1,146 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/check.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_kvs/mapped_file_flash_memory.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::kvs {
+namespace {
+
+// A 4 MiB partition.
+constexpr size_t kSectorSize = 4 * 1024;
+constexpr size_t kSectorCount = 1024;
+constexpr size_t kAlignment = 16;
+constexpr size_t kMaxEntries = 1024;
+constexpr size_t kKeyCount = 256;
+
+// For KVS entry magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x58c1a7e3, .checksum = nullptr};
+
+using Value = std::array<uint32_t, 16>;
+
+// Maps a new temporary file, which is removed when the test exits.
+MappedFileFlashMemory& OpenFlash() {
+  static char path[] = "/tmp/pw_kvs_perf_flash_XXXXXX";
+  const int fd = mkstemp(path);
+  PW_CHECK_INT_NE(fd, -1, "Failed to create a temporary flash file");
+  close(fd);
+
+  static MappedFileFlashMemory flash(
+      path, kSectorSize, kSectorCount, kAlignment);
+  PW_CHECK_OK(flash.Enable());
+  unlink(path);
+  return flash;
+}
+
+MappedFileFlashMemory& Flash() {
+  static MappedFileFlashMemory& flash = OpenFlash();
+  return flash;
+}
+
+KeyValueStore& Kvs() {
+  static FlashPartition partition(&Flash());
+  static KeyValueStoreBuffer<kMaxEntries, kSectorCount> kvs(&partition,
+                                                            kFormat);
+  return kvs;
+}
+
+void Reset(const MappedFileFlashMemory::Latency& latency) {
+  Flash().set_latency({});
+  PW_CHECK_OK(Flash().Erase(0, kSectorCount));
+  PW_CHECK_OK(Kvs().Init());
+  Flash().set_latency(latency);
+}
+
+// Measures writing kKeyCount 64 B values, cycling through the partition and
+// garbage collecting as it fills.
+void PutValues(perf_test::State& state,
+               MappedFileFlashMemory::Latency latency) {
+  Reset(latency);
+
+  StringBuffer<16> key;
+  Value value{};
+  while (state.KeepRunning()) {
+    value[0] += 1;
+    for (size_t i = 0; i < kKeyCount; ++i) {
+      key.clear();
+      key.Format("key_%u", static_cast<unsigned>(i));
+      Kvs().Put(key.view(), value).IgnoreError();
+    }
+  }
+}
+
+// Measures reading back kKeyCount 64 B values.
+void GetValues(perf_test::State& state) {
+  Reset({});
+
+  StringBuffer<16> key;
+  Value value{};
+  for (size_t i = 0; i < kKeyCount; ++i) {
+    key.clear();
+    key.Format("key_%u", static_cast<unsigned>(i));
+    PW_CHECK_OK(Kvs().Put(key.view(), value));
+  }
+
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kKeyCount; ++i) {
+      key.clear();
+      key.Format("key_%u", static_cast<unsigned>(i));
+      Kvs().Get(key.view(), &value).IgnoreError();
+    }
+  }
+}
+
+// Measures Init() on a partition holding kKeyCount entries.
+void InitWithValues(perf_test::State& state) {
+  Reset({});
+
+  StringBuffer<16> key;
+  const Value value{};
+  for (size_t i = 0; i < kKeyCount; ++i) {
+    key.clear();
+    key.Format("key_%u", static_cast<unsigned>(i));
+    PW_CHECK_OK(Kvs().Put(key.view(), value));
+  }
+
+  while (state.KeepRunning()) {
+    Kvs().Init().IgnoreError();
+  }
+}
+
+PW_PERF_TEST(Put256Values, PutValues, MappedFileFlashMemory::Latency{});
+PW_PERF_TEST(Put256ValuesWithFlashLatency,
+             PutValues,
+             MappedFileFlashMemory::Latency{
+                 .program_per_write_unit = std::chrono::nanoseconds(500),
+                 .erase_per_sector = std::chrono::microseconds(100),
+             });
+PW_PERF_TEST(Get256Values, GetValues);
+PW_PERF_TEST(Init256Values, InitWithValues);
+
+}  // namespace
+}  // namespace pw::kvs
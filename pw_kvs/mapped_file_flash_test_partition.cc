@@ -0,0 +1,65 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "pw_assert/check.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/flash_test_partition.h"
+#include "pw_kvs/mapped_file_flash_memory.h"
+
+namespace pw::kvs {
+
+namespace {
+
+#if !defined(PW_FLASH_TEST_SECTORS) || (PW_FLASH_TEST_SECTORS <= 0)
+#error PW_FLASH_TEST_SECTORS must be defined and > 0
+#endif  // PW_FLASH_TEST_SECTORS
+
+#if !defined(PW_FLASH_TEST_SECTOR_SIZE) || (PW_FLASH_TEST_SECTOR_SIZE <= 0)
+#error PW_FLASH_TEST_SECTOR_SIZE must be defined and > 0
+#endif  // PW_FLASH_TEST_SECTOR_SIZE
+
+#if !defined(PW_FLASH_TEST_ALIGNMENT) || (PW_FLASH_TEST_ALIGNMENT <= 0)
+#error PW_FLASH_TEST_ALIGNMENT must be defined and > 0
+#endif  // PW_FLASH_TEST_ALIGNMENT
+
+constexpr size_t kFlashTestSectors = PW_FLASH_TEST_SECTORS;
+constexpr size_t kFlashTestSectorSize = PW_FLASH_TEST_SECTOR_SIZE;
+constexpr size_t kFlashTestAlignment = PW_FLASH_TEST_ALIGNMENT;
+
+// Maps a new temporary file. The file is unlinked once mapped, so it is
+// removed when the test exits.
+MappedFileFlashMemory& TestFlash() {
+  static char path[] = "/tmp/pw_kvs_test_flash_XXXXXX";
+  const int fd = mkstemp(path);
+  PW_CHECK_INT_NE(fd, -1, "Failed to create a temporary flash file");
+  close(fd);
+
+  static MappedFileFlashMemory flash(
+      path, kFlashTestSectorSize, kFlashTestSectors, kFlashTestAlignment);
+  PW_CHECK_OK(flash.Enable());
+  unlink(path);
+  return flash;
+}
+
+}  // namespace
+
+FlashPartition& FlashTestPartition() {
+  static FlashPartition test_partition(&TestFlash());
+  return test_partition;
+}
+
+}  // namespace pw::kvs
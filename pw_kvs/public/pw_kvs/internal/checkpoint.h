@@ -0,0 +1,120 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/internal/entry_cache.h"
+#include "pw_kvs/internal/sectors.h"
+#include "pw_status/status.h"
+
+namespace pw {
+namespace kvs {
+namespace internal {
+
+// Header for a KVS checkpoint. A checkpoint is a snapshot of the KVS's
+// in-memory state (sector usage and key descriptors) stored in a separate
+// flash partition. Loading a checkpoint allows the KVS to skip reading every
+// entry in flash during initialization.
+//
+// The header is followed by one CheckpointSectorRecord per sector, then one
+// CheckpointEntryRecord per key descriptor. Each entry record is followed by
+// redundancy addresses. After the records, at the next aligned address, is an
+// invalidation marker, which is left erased while the checkpoint is current.
+struct CheckpointHeader {
+  uint32_t magic;
+  uint32_t checksum;  // CRC32 of the rest of the header and all records
+  uint32_t sector_size_bytes;
+  uint16_t sector_count;
+  uint16_t redundancy;
+  uint32_t entry_count;
+};
+
+static_assert(sizeof(CheckpointHeader) == 20, "No padding in the header");
+
+// Sectors may be 64 KiB or larger, so byte counts are 32 bits.
+struct CheckpointSectorRecord {
+  uint32_t writable_bytes;
+  uint32_t valid_bytes;
+};
+
+struct CheckpointEntryRecord {
+  uint32_t key_hash;
+  uint32_t transaction_id;
+  uint32_t state;
+};
+
+// Reads and writes KVS checkpoints to a flash partition.
+//
+// A checkpoint is only valid while the flash it describes is unchanged except
+// for appended entries. Any erase of a KVS sector makes the checkpoint stale,
+// so Invalidate() MUST be called before erasing a sector.
+class Checkpoint {
+ public:
+  using Address = FlashPartition::Address;
+
+  constexpr Checkpoint() : partition_(nullptr), marker_address_(kNoMarker) {}
+
+  // Sets the partition in which to store checkpoints.
+  void set_partition(FlashPartition& partition) { partition_ = &partition; }
+
+  bool enabled() const { return partition_ != nullptr; }
+
+  // Erases the checkpoint partition and writes a checkpoint of the provided
+  // sectors and entries, which are stored in kvs_partition.
+  //
+  //                    OK: the checkpoint was written
+  //    RESOURCE_EXHAUSTED: the checkpoint does not fit in the partition
+  //
+  Status Write(const FlashPartition& kvs_partition,
+               const Sectors& sectors,
+               const EntryCache& entries);
+
+  // Loads the checkpoint into the provided sectors and entries. The sectors
+  // and entries must be Reset() before calling Load. If Load fails, they are
+  // left in an indeterminate state and must be Reset() again. If a checkpoint
+  // that has not been invalidated is found, current() is true afterwards, even
+  // if it could not be loaded.
+  //
+  //                    OK: the checkpoint was loaded
+  //             NOT_FOUND: there is no checkpoint in the partition
+  //   FAILED_PRECONDITION: the checkpoint was invalidated or does not match
+  //                        this KVS's configuration
+  //             DATA_LOSS: the checkpoint's checksum does not match
+  //
+  Status Load(const FlashPartition& kvs_partition,
+              Sectors& sectors,
+              EntryCache& entries);
+
+  // Marks the current checkpoint as stale, if there is one. This is a single
+  // aligned write; no erase is needed.
+  Status Invalidate();
+
+  // True if there is a checkpoint in flash that has not been invalidated.
+  bool current() const { return marker_address_ != kNoMarker; }
+
+ private:
+  static constexpr Address kNoMarker = Address(-1);
+
+  FlashPartition* partition_;
+
+  // Address of the invalidation marker of the current checkpoint.
+  Address marker_address_;
+};
+
+}  // namespace internal
+}  // namespace kvs
+}  // namespace pw
@@ -67,9 +67,16 @@ class Entry {
                      const EntryFormat& format,
                      Key key,
                      span<const std::byte> value,
-                     uint32_t transaction_id) {
-    return Entry(
-        partition, address, format, key, value, value.size(), transaction_id);
+                     uint32_t transaction_id,
+                     bool batch_continues = false) {
+    return Entry(partition,
+                 address,
+                 format,
+                 key,
+                 value,
+                 value.size(),
+                 transaction_id,
+                 batch_continues);
   }
 
   // Creates a new Entry for a tombstone entry, which marks a deleted key.
@@ -77,14 +84,16 @@ class Entry {
                          Address address,
                          const EntryFormat& format,
                          Key key,
-                         uint32_t transaction_id) {
+                         uint32_t transaction_id,
+                         bool batch_continues = false) {
     return Entry(partition,
                  address,
                  format,
                  key,
                  {},
                  kDeletedValueLength,
-                 transaction_id);
+                 transaction_id,
+                 batch_continues);
   }
 
   Entry() = default;
@@ -99,9 +108,17 @@ class Entry {
 
   StatusWithSize Write(Key key, span<const std::byte> value) const;
 
+  // Writes this entry, including padding, to an AlignedWriter positioned at
+  // this entry's address. This allows packing several consecutive entries into
+  // one stream of aligned writes. The writer is not flushed.
+  Status Write(AlignedWriter& writer,
+               Key key,
+               span<const std::byte> value) const;
+
   // Changes the format and transcation ID for this entry. In order to calculate
   // the new checksum, the entire entry is read into a small stack-allocated
   // buffer. The updated entry may be written to flash using the Copy function.
+  // The updated entry is no longer part of a batch.
   Status Update(const EntryFormat& new_format, uint32_t new_transaction_id);
 
   // Writes this entry at a new address. The key and value are read from the
@@ -151,7 +168,9 @@ class Entry {
   size_t size() const { return AlignUp(content_size(), alignment_bytes()); }
 
   // The length of the key in bytes. Keys are not null terminated.
-  size_t key_length() const { return header_.key_length_bytes; }
+  size_t key_length() const {
+    return header_.key_length_bytes & kKeyLengthMask;
+  }
 
   // The size of the value, without padding. The size is 0 if this is a
   // tombstone entry.
@@ -168,18 +187,30 @@ class Entry {
     return header_.value_size_bytes == kDeletedValueLength;
   }
 
+  // True if this entry is part of a batch and more entries of the batch follow
+  // it. The last entry in a batch does not have this set, so a batch is only
+  // complete if it ends with an entry with the same transaction ID for which
+  // this is false.
+  bool batch_continues() const {
+    return (header_.key_length_bytes & kBatchContinuesBit) != 0u;
+  }
+
   void DebugLog() const;
 
  private:
   static constexpr uint16_t kDeletedValueLength = 0xFFFF;
 
+  static constexpr uint8_t kKeyLengthMask = 0b111111;
+  static constexpr uint8_t kBatchContinuesBit = 0b1000000;
+
   Entry(FlashPartition& partition,
         Address address,
         const EntryFormat& format,
         Key key,
         span<const std::byte> value,
         uint16_t value_size_bytes,
-        uint32_t transaction_id);
+        uint32_t transaction_id,
+        bool batch_continues);
 
   constexpr Entry(FlashPartition* partition,
                   Address address,
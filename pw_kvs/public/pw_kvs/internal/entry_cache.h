@@ -13,8 +13,10 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <type_traits>
 
 #include "pw_containers/vector.h"
@@ -24,6 +26,7 @@
 #include "pw_kvs/internal/sectors.h"
 #include "pw_kvs/key.h"
 #include "pw_span/span.h"
+#include "pw_status/status.h"
 
 namespace pw {
 namespace kvs {
@@ -70,7 +73,8 @@ class EntryMetadata {
   void RemoveAddress(Address address_to_remove);
 
   // Resets the KeyDescrtiptor and addresses to refer to the provided
-  // KeyDescriptor and address.
+  // KeyDescriptor and address. If the EntryCache has a key index, the new
+  // descriptor MUST have the same key hash as the one it replaces.
   void Reset(const KeyDescriptor& descriptor, Address address);
 
  private:
@@ -152,15 +156,41 @@ class EntryCache {
   template <size_t kMaxEntries, size_t kRedundancy>
   using AddressList = Address[kMaxEntries * kRedundancy + kRedundancy];
 
+  // Slot in the optional open-addressed key index. A slot holds one plus the
+  // index of a KeyDescriptor, or kEmptyIndexSlot if it is unused.
+  using IndexSlot = uint16_t;
+
+  static constexpr IndexSlot kEmptyIndexSlot = 0;
+
+  // The type to use for a key index with the specified number of slots. The
+  // slot count must be a power of two larger than the maximum number of
+  // entries, or zero to disable the index. Value-initialized slots are empty.
+  template <size_t kIndexSlots>
+  using KeyIndex = std::array<IndexSlot, kIndexSlots>;
+
+  template <size_t kMaxEntries, size_t kIndexSlots>
+  static constexpr bool ValidKeyIndexSize() {
+    return kIndexSlots == 0u ||
+           ((kIndexSlots & (kIndexSlots - 1)) == 0u &&
+            kIndexSlots > kMaxEntries &&
+            kMaxEntries <= std::numeric_limits<IndexSlot>::max());
+  }
+
+  // Constructs an EntryCache. If key_index is non-empty, it is used as an
+  // open-addressed hash table from key hash to descriptor, which makes lookups
+  // O(1) instead of a scan over all descriptors. The key index must be empty
+  // (all kEmptyIndexSlot) or Reset() must be called before the cache is used.
   constexpr EntryCache(Vector<KeyDescriptor>& descriptors,
                        Address* addresses,
-                       size_t redundancy)
+                       size_t redundancy,
+                       span<IndexSlot> key_index = {})
       : descriptors_(descriptors),
         addresses_(addresses),
-        redundancy_(redundancy) {}
+        redundancy_(redundancy),
+        key_index_(key_index) {}
 
   // Clears all KeyDescriptors.
-  void Reset() const { descriptors_.clear(); }
+  void Reset() const;
 
   // Finds the metadata for an entry matching a particular key. Searches for a
   // KeyDescriptor that matches this key and sets *metadata to point to it if
@@ -180,6 +210,10 @@ class EntryCache {
                       Key key,
                       EntryMetadata* metadata) const;
 
+  // Finds the metadata for the descriptor with the specified key hash without
+  // reading flash. Returns NOT_FOUND if no descriptor has this hash.
+  Status FindHash(uint32_t key_hash, EntryMetadata* metadata) const;
+
   // Adds a new descriptor to the descriptor list. The entry MUST be unique and
   // the EntryCache must NOT be full!
   EntryMetadata AddNew(const KeyDescriptor& descriptor, Address address) const;
@@ -217,6 +251,9 @@ class EntryCache {
   // The maximum number of entries supported by this EntryCache.
   size_t max_entries() const { return descriptors_.max_size(); }
 
+  // True if lookups go through the key index rather than a linear scan.
+  bool has_key_index() const { return !key_index_.empty(); }
+
   iterator begin() const { return {this, descriptors_.begin()}; }
   const_iterator cbegin() const { return {this, descriptors_.begin()}; }
 
@@ -226,6 +263,25 @@ class EntryCache {
  private:
   int FindIndex(uint32_t key_hash) const;
 
+  // Key index helpers. These are only called if has_key_index() is true.
+  size_t IndexHome(uint32_t key_hash) const {
+    return key_hash & (key_index_.size() - 1);
+  }
+
+  size_t IndexNext(size_t slot) const {
+    return (slot + 1) & (key_index_.size() - 1);
+  }
+
+  // Returns the slot that refers to the descriptor at the specified index.
+  size_t IndexSlotFor(size_t descriptor_index) const;
+
+  // Adds the descriptor at the specified index to the key index.
+  void IndexInsert(size_t descriptor_index) const;
+
+  // Removes a slot from the key index, shifting back any entries that probed
+  // past it so no tombstones are needed.
+  void IndexErase(size_t slot) const;
+
   // Adds the address to the descriptor at the specified index if there is an
   // address slot available.
   void AddAddressIfRoom(size_t descriptor_index, Address address) const;
@@ -242,6 +298,7 @@ class EntryCache {
   Vector<KeyDescriptor>& descriptors_;
   FlashPartition::Address* const addresses_;
   const size_t redundancy_;
+  const span<IndexSlot> key_index_;
 };
 
 }  // namespace internal
@@ -22,12 +22,14 @@
 #include "pw_kvs/checksum.h"
 #include "pw_kvs/flash_memory.h"
 #include "pw_kvs/format.h"
+#include "pw_kvs/internal/checkpoint.h"
 #include "pw_kvs/internal/entry.h"
 #include "pw_kvs/internal/entry_cache.h"
 #include "pw_kvs/internal/key_descriptor.h"
 #include "pw_kvs/internal/sectors.h"
 #include "pw_kvs/internal/span_traits.h"
 #include "pw_kvs/key.h"
+#include "pw_kvs/value_cache.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
@@ -97,6 +99,35 @@ class KeyValueStore {
   //
   Status Init();
 
+  // Enables checkpoints, which speed up Init() for large partitions. Must be
+  // called before Init().
+  //
+  // Full and heavy maintenance write a checkpoint, a checksummed snapshot of
+  // the key descriptors and sector usage, to checkpoint_partition. Init() then
+  // loads the checkpoint and reads only entries written after it, rather than
+  // every entry in the KVS partition. Init() falls back to reading every entry
+  // if the checkpoint is missing, corrupt, or stale. Garbage collecting a
+  // sector makes the checkpoint stale until the next maintenance.
+  //
+  // checkpoint_partition must be separate from the KVS's partition and large
+  // enough for a 20 B header, 8 B per sector, and (12 + 4 * redundancy) B per
+  // entry.
+  void EnableCheckpoints(FlashPartition& checkpoint_partition) {
+    checkpoint_.set_partition(checkpoint_partition);
+  }
+
+  // Enables a read-through cache of values. Get() and ValueSize() serve cached
+  // values from RAM; values not in the cache are read from flash and then
+  // added to it. Cached values are not reverified with verify_on_read, since
+  // they were verified when they were read from flash. Writing or deleting a
+  // key removes its value from the cache, and Init() clears it.
+  //
+  // The cache must outlive the KVS and may only be used by one KVS.
+  void EnableValueCache(ValueCache& value_cache) {
+    value_cache_ = &value_cache;
+    value_cache_->Clear();
+  }
+
   bool initialized() const {
     return initialized_ == InitializationState::kReady;
   }
@@ -174,6 +205,93 @@ class KeyValueStore {
   //
   Status Delete(Key key);
 
+  // Stages puts and deletes that are committed together with Commit(). Keys
+  // and values are copied into the batch's buffer when staged. Use a
+  // BatchBuffer to declare a Batch with storage.
+  class Batch {
+   public:
+    Batch(const Batch&) = delete;
+    Batch& operator=(const Batch&) = delete;
+
+    // Stages a put. The value may be a span of bytes or a trivially copyable
+    // object, as with KeyValueStore::Put.
+    //
+    //                    OK: the put was staged
+    //    RESOURCE_EXHAUSTED: the batch is out of operations or buffer space
+    //        ALREADY_EXISTS: the key is already staged in this batch
+    //      INVALID_ARGUMENT: key is empty or too long
+    //
+    template <typename T,
+              typename std::enable_if_t<ConvertsToSpan<T>::value>* = nullptr>
+    Status Put(const Key& key, const T& value) {
+      return Add(key, as_bytes(internal::make_span(value)), false);
+    }
+
+    template <typename T,
+              typename std::enable_if_t<!ConvertsToSpan<T>::value>* = nullptr>
+    Status Put(const Key& key, const T& value) {
+      CheckThatObjectCanBePutOrGet<T>();
+      return Add(key, as_bytes(span<const T>(&value, 1)), false);
+    }
+
+    // Stages a delete. Returns the same statuses as Put.
+    Status Delete(Key key) { return Add(key, {}, true); }
+
+    // Removes all staged operations.
+    void clear() {
+      operations_.clear();
+      buffer_used_ = 0;
+    }
+
+    size_t size() const { return operations_.size(); }
+
+    bool empty() const { return operations_.empty(); }
+
+   protected:
+    struct Operation {
+      Key key;
+      span<const std::byte> value;
+      bool deleted;
+    };
+
+    constexpr Batch(Vector<Operation>& operations, span<std::byte> buffer)
+        : operations_(operations), buffer_(buffer), buffer_used_(0) {}
+
+   private:
+    friend class KeyValueStore;
+
+    Status Add(Key key, span<const std::byte> value, bool deleted);
+
+    Vector<Operation>& operations_;
+    span<std::byte> buffer_;
+    size_t buffer_used_;
+  };
+
+  template <size_t kMaxOperations, size_t kBufferSizeBytes>
+  class BatchBuffer;
+
+  // Writes all of a batch's puts and deletes under a single transaction ID.
+  // Either all of them take effect or, if the write is interrupted, none of
+  // them do. Each copy of the batch is written contiguously to one sector, so
+  // the entries for all operations must fit in one sector together. Puts of
+  // values that match the stored value are written anyway.
+  //
+  // Init() ignores a batch that was only partly written. Older firmware that
+  // does not support batches reports entries written by Commit() as corrupt.
+  //
+  //                    OK: every operation in the batch was applied
+  //             NOT_FOUND: a deleted key is not present in the KVS
+  //             DATA_LOSS: checksum validation failed after writing the data
+  //    RESOURCE_EXHAUSTED: there is not enough space or there are not enough
+  //                        key descriptors for the batch
+  //        ALREADY_EXISTS: a key's hash matches the hash of a different key in
+  //                        the KVS or in the batch
+  //   FAILED_PRECONDITION: the KVS is not initialized
+  //      INVALID_ARGUMENT: the batch's entries do not fit in one sector
+  //
+  // If the batch cannot be applied, nothing is written.
+  Status Commit(const Batch& batch);
+
   // Returns the size of the value corresponding to the key.
   //
   //                    OK: the size was returned successfully
@@ -325,6 +443,8 @@ class KeyValueStore {
     size_t sector_erase_count;
     size_t corrupt_sectors_recovered;
     size_t missing_redundant_entries_recovered;
+    size_t value_cache_hits;    // Always 0 without a value cache.
+    size_t value_cache_misses;  // Always 0 without a value cache.
   };
 
   StorageStats GetStorageStats() const;
@@ -357,7 +477,8 @@ class KeyValueStore {
   using SectorDescriptor = internal::SectorDescriptor;
 
   // In the future, will be able to provide additional EntryFormats for
-  // backwards compatibility.
+  // backwards compatibility. If key_index is non-empty, it is used as a hash
+  // index for key lookups (see internal::EntryCache).
   KeyValueStore(FlashPartition* partition,
                 span<const EntryFormat> formats,
                 const Options& options,
@@ -365,7 +486,8 @@ class KeyValueStore {
                 Vector<SectorDescriptor>& sector_descriptor_list,
                 const SectorDescriptor** temp_sectors_to_skip,
                 Vector<KeyDescriptor>& key_descriptor_list,
-                Address* addresses);
+                Address* addresses,
+                span<internal::EntryCache::IndexSlot> key_index = {});
 
  private:
   using EntryMetadata = internal::EntryMetadata;
@@ -383,6 +505,17 @@ class KeyValueStore {
 
   Status InitializeMetadata();
   Status LoadEntry(Address entry_address, Address* next_entry_address);
+
+  // Loads the checkpoint, then applies entries written after it to the
+  // checkpointed state. Fails if the result would not match a full scan of
+  // the partition without errors, in which case a full scan is needed.
+  Status InitializeFromCheckpoint();
+  Status ReplayEntry(Address entry_address, Address* next_entry_address);
+
+  // Checks that the entry is not part of a batch that was only partly written.
+  // Returns ABORTED if the entry must be ignored.
+  Status CheckBatchComplete(const Entry& entry);
+
   Status ScanForEntry(const SectorDescriptor& sector,
                       Address start_address,
                       Address* next_entry_address);
@@ -397,8 +530,29 @@ class KeyValueStore {
 
   Status PutBytes(Key key, span<const std::byte> value);
 
+  // Checks that the batch's operations can all be applied, without writing.
+  Status CheckBatch(const Batch& batch);
+
+  // Writes one copy of each of the batch's entries starting at address.
+  Status WriteBatchCopy(const Batch& batch,
+                        uint32_t transaction_id,
+                        Address address,
+                        size_t batch_size);
+
+  Entry CreateBatchEntry(Address address,
+                         const Batch::Operation& operation,
+                         uint32_t transaction_id,
+                         bool batch_continues);
+
   StatusWithSize ValueSize(const EntryMetadata& metadata) const;
 
+  // Removes a key's value from the value cache, if there is one.
+  void InvalidateCachedValue(uint32_t key_hash) {
+    if (value_cache_ != nullptr) {
+      value_cache_->Invalidate(key_hash);
+    }
+  }
+
   Status ReadEntry(const EntryMetadata& metadata, Entry& entry) const;
 
   // Finds the metadata for an entry matching a particular key. Searches for a
@@ -543,6 +697,16 @@ class KeyValueStore {
 
   Options options_;
 
+  // Optional snapshot of the sectors and entry cache for fast initialization.
+  internal::Checkpoint checkpoint_;
+
+  // Optional cache of recently read values.
+  ValueCache* value_cache_;
+
+  // During initialization, the end of the last batch that was found to be
+  // complete. Entries before this address do not need to be checked again.
+  Address complete_batch_end_;
+
   // Threshold value for when to garbage collect all stale data. Above the
   // threshold, GC all reclaimable bytes regardless of if valid data is in
   // sector. Below the threshold, only GC sectors with reclaimable bytes and no
@@ -577,10 +741,30 @@ class KeyValueStore {
   uint32_t last_transaction_id_;
 };
 
+// A KeyValueStore::Batch with storage for up to kMaxOperations operations,
+// whose keys and values total up to kBufferSizeBytes.
+template <size_t kMaxOperations, size_t kBufferSizeBytes>
+class KeyValueStore::BatchBuffer : public KeyValueStore::Batch {
+ public:
+  constexpr BatchBuffer() : Batch(operations_, buffer_), buffer_{} {}
+
+ private:
+  static_assert(kMaxOperations > 0u);
+
+  Vector<Operation, kMaxOperations> operations_;
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+};
+
+// kKeyIndexSlots sizes an optional hash index over the key descriptors. With
+// the default of 0, every key lookup scans all key descriptors. Otherwise,
+// kKeyIndexSlots must be a power of two greater than kMaxEntries, and lookups
+// take O(1) time at a cost of 2 bytes of RAM per slot. A slot count of at
+// least twice kMaxEntries keeps probe sequences short.
 template <size_t kMaxEntries,
           size_t kMaxUsableSectors,
           size_t kRedundancy = 1,
-          size_t kEntryFormats = 1>
+          size_t kEntryFormats = 1,
+          size_t kKeyIndexSlots = 0>
 class KeyValueStoreBuffer : public KeyValueStore {
  public:
   // Constructs a KeyValueStore on the partition, with support for one
@@ -609,9 +793,11 @@ class KeyValueStoreBuffer : public KeyValueStore {
                       sectors_,
                       temp_sectors_to_skip_,
                       key_descriptors_,
-                      addresses_),
+                      addresses_,
+                      key_index_),
         sectors_(),
         key_descriptors_(),
+        key_index_(),
         formats_() {
     std::copy(formats.begin(), formats.end(), formats_.begin());
   }
@@ -621,6 +807,9 @@ class KeyValueStoreBuffer : public KeyValueStore {
   static_assert(kMaxUsableSectors > 0u);
   static_assert(kRedundancy > 0u);
   static_assert(kEntryFormats > 0u);
+  static_assert(
+      internal::EntryCache::ValidKeyIndexSize<kMaxEntries, kKeyIndexSlots>(),
+      "kKeyIndexSlots must be 0 or a power of two greater than kMaxEntries");
 
   Vector<SectorDescriptor, kMaxUsableSectors> sectors_;
 
@@ -641,6 +830,9 @@ class KeyValueStoreBuffer : public KeyValueStore {
   // KeyDescriptors.
   internal::EntryCache::AddressList<kRedundancy, kMaxEntries> addresses_;
 
+  // Optional open-addressed hash index from key hash to KeyDescriptor.
+  internal::EntryCache::KeyIndex<kKeyIndexSlots> key_index_;
+
   // EntryFormats that can be read by this KeyValueStore.
   std::array<EntryFormat, kEntryFormats> formats_;
 };
@@ -0,0 +1,101 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw::kvs {
+
+// Host-side FlashMemory backed by a memory-mapped file, for running the KVS and
+// blob store against large partitions that persist across runs. Like
+// FakeFlashMemory, it requires erase before write and checks alignment.
+//
+// Enable() opens the file, creating it if needed, and maps it. Bytes past the
+// end of an existing file are initialized to the erased value. Disable() syncs
+// and unmaps the file. Only available on POSIX hosts.
+//
+// FlashAddressToMcuAddress() returns a pointer into the mapping, so readers
+// that support memory-mapped flash can read without copying.
+class MappedFileFlashMemory : public FlashMemory {
+ public:
+  static constexpr size_t kDefaultAlignmentBytes = 1;
+
+  static constexpr std::byte kErasedValue = std::byte{0xff};
+
+  // Optional delays to model the time a real flash takes to program and erase.
+  // Delays are busy-waits, for accuracy at microsecond scale.
+  struct Latency {
+    // Delay for each alignment_bytes() unit written.
+    std::chrono::nanoseconds program_per_write_unit{0};
+
+    // Delay for each sector erased.
+    std::chrono::nanoseconds erase_per_sector{0};
+  };
+
+  // The path must remain valid until Enable() is called.
+  MappedFileFlashMemory(const char* path,
+                        size_t sector_size,
+                        size_t sector_count,
+                        size_t alignment_bytes = kDefaultAlignmentBytes)
+      : FlashMemory(sector_size, sector_count, alignment_bytes),
+        path_(path),
+        fd_(-1),
+        mapping_(),
+        latency_() {}
+
+  MappedFileFlashMemory(const MappedFileFlashMemory&) = delete;
+  MappedFileFlashMemory& operator=(const MappedFileFlashMemory&) = delete;
+
+  ~MappedFileFlashMemory() override { Disable().IgnoreError(); }
+
+  // Opens and maps the file.
+  //
+  //                    OK: the file is mapped
+  //           UNAVAILABLE: the file could not be opened or resized
+  //              INTERNAL: the file could not be mapped
+  //
+  Status Enable() override;
+
+  // Syncs and unmaps the file.
+  Status Disable() override;
+
+  bool IsEnabled() const override { return fd_ != -1; }
+
+  Status Erase(Address address, size_t num_sectors) override;
+
+  StatusWithSize Read(Address address, span<std::byte> output) override;
+
+  StatusWithSize Write(Address address, span<const std::byte> data) override;
+
+  std::byte* FlashAddressToMcuAddress(Address address) const override;
+
+  void set_latency(const Latency& latency) { latency_ = latency; }
+
+  // Access the mapped file for testing purposes. Not part of the FlashMemory
+  // API. Empty when not enabled.
+  span<std::byte> buffer() const { return mapping_; }
+
+ private:
+  const char* path_;
+  int fd_;
+  span<std::byte> mapping_;
+  Latency latency_;
+};
+
+}  // namespace pw::kvs
@@ -0,0 +1,128 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw {
+namespace kvs {
+
+class KeyValueStore;
+
+// A fixed-size cache of KVS values, keyed by key hash. Reads of cached values
+// are served from RAM instead of flash. When the cache is full, the least
+// recently used value is evicted.
+//
+// Each cached value is tagged with the transaction ID of the entry it was read
+// from, so a value is never returned after its key is rewritten. The KVS also
+// drops a key's cached value when the key is written or deleted.
+//
+// Use ValueCacheBuffer to allocate a ValueCache.
+class ValueCache {
+ public:
+  struct Slot {
+    uint32_t key_hash;
+    uint32_t transaction_id;
+    uint32_t last_used;
+    uint32_t value_size;
+    bool in_use;
+  };
+
+  ValueCache(const ValueCache&) = delete;
+  ValueCache& operator=(const ValueCache&) = delete;
+
+  // Removes all values from the cache. Does not reset hits() or misses().
+  void Clear();
+
+  // The largest value that is cached. Larger values are always read from flash.
+  size_t max_value_size_bytes() const { return max_value_size_bytes_; }
+
+  // The number of reads served from the cache and the number that had to read
+  // from flash.
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+
+ protected:
+  constexpr ValueCache(span<Slot> slots,
+                       span<std::byte> values,
+                       size_t max_value_size_bytes)
+      : slots_(slots),
+        values_(values),
+        max_value_size_bytes_(max_value_size_bytes),
+        use_count_(0),
+        hits_(0),
+        misses_(0) {}
+
+ private:
+  friend class KeyValueStore;
+
+  // Reads a cached value, with the same semantics as Entry::ReadValue. Returns
+  // NOT_FOUND if the value is not cached.
+  StatusWithSize Get(uint32_t key_hash,
+                     uint32_t transaction_id,
+                     span<std::byte> buffer,
+                     size_t offset_bytes);
+
+  // Returns the size of a cached value, or NOT_FOUND if it is not cached.
+  StatusWithSize ValueSize(uint32_t key_hash, uint32_t transaction_id) const;
+
+  // Adds a value to the cache, evicting the least recently used value if the
+  // cache is full. Values larger than max_value_size_bytes() are not cached.
+  void Put(uint32_t key_hash,
+           uint32_t transaction_id,
+           span<const std::byte> value);
+
+  // Removes the value for a key, if it is cached.
+  void Invalidate(uint32_t key_hash);
+
+  const Slot* Find(uint32_t key_hash, uint32_t transaction_id) const;
+
+  std::byte* SlotValue(const Slot& slot) const {
+    return values_.data() +
+           static_cast<size_t>(&slot - slots_.data()) * max_value_size_bytes_;
+  }
+
+  span<Slot> slots_;
+  span<std::byte> values_;
+  size_t max_value_size_bytes_;
+
+  // Incremented on every access; a slot's last_used is set from it.
+  uint32_t use_count_;
+
+  size_t hits_;
+  size_t misses_;
+};
+
+// A ValueCache that caches up to kSlots values of up to kMaxValueSizeBytes.
+template <size_t kSlots, size_t kMaxValueSizeBytes>
+class ValueCacheBuffer : public ValueCache {
+ public:
+  ValueCacheBuffer()
+      : ValueCache(slots_, values_, kMaxValueSizeBytes), slots_{}, values_{} {}
+
+ private:
+  static_assert(kSlots > 0u);
+  static_assert(kMaxValueSizeBytes > 0u);
+
+  std::array<Slot, kSlots> slots_;
+  std::array<std::byte, kSlots * kMaxValueSizeBytes> values_;
+};
+
+}  // namespace kvs
+}  // namespace pw
@@ -0,0 +1,116 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/value_cache.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw::kvs {
+
+void ValueCache::Clear() {
+  for (Slot& slot : slots_) {
+    slot.in_use = false;
+  }
+}
+
+StatusWithSize ValueCache::Get(uint32_t key_hash,
+                               uint32_t transaction_id,
+                               span<std::byte> buffer,
+                               size_t offset_bytes) {
+  const Slot* const found = Find(key_hash, transaction_id);
+  if (found == nullptr) {
+    misses_ += 1;
+    return StatusWithSize::NotFound();
+  }
+
+  hits_ += 1;
+  Slot& slot = slots_[static_cast<size_t>(found - slots_.data())];
+  slot.last_used = ++use_count_;
+
+  if (offset_bytes > slot.value_size) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  const size_t remaining_bytes = slot.value_size - offset_bytes;
+  const size_t read_size = std::min(buffer.size(), remaining_bytes);
+  std::memcpy(buffer.data(), SlotValue(slot) + offset_bytes, read_size);
+
+  if (read_size != remaining_bytes) {
+    return StatusWithSize::ResourceExhausted(read_size);
+  }
+  return StatusWithSize(read_size);
+}
+
+StatusWithSize ValueCache::ValueSize(uint32_t key_hash,
+                                     uint32_t transaction_id) const {
+  const Slot* const slot = Find(key_hash, transaction_id);
+  if (slot == nullptr) {
+    return StatusWithSize::NotFound();
+  }
+  return StatusWithSize(slot->value_size);
+}
+
+void ValueCache::Put(uint32_t key_hash,
+                     uint32_t transaction_id,
+                     span<const std::byte> value) {
+  if (value.size() > max_value_size_bytes_) {
+    return;
+  }
+
+  // Reuse the key's slot if it has one. Otherwise, use an empty slot or evict
+  // the least recently used value.
+  Slot* slot = nullptr;
+  for (Slot& candidate : slots_) {
+    if (candidate.in_use && candidate.key_hash == key_hash) {
+      slot = &candidate;
+      break;
+    }
+    if (slot == nullptr) {
+      slot = &candidate;
+    } else if (slot->in_use && (!candidate.in_use ||
+                                candidate.last_used < slot->last_used)) {
+      slot = &candidate;
+    }
+  }
+
+  slot->key_hash = key_hash;
+  slot->transaction_id = transaction_id;
+  slot->last_used = ++use_count_;
+  slot->value_size = static_cast<uint32_t>(value.size());
+  slot->in_use = true;
+  std::memcpy(SlotValue(*slot), value.data(), value.size());
+}
+
+void ValueCache::Invalidate(uint32_t key_hash) {
+  for (Slot& slot : slots_) {
+    if (slot.in_use && slot.key_hash == key_hash) {
+      slot.in_use = false;
+      return;
+    }
+  }
+}
+
+const ValueCache::Slot* ValueCache::Find(uint32_t key_hash,
+                                         uint32_t transaction_id) const {
+  for (const Slot& slot : slots_) {
+    if (slot.in_use && slot.key_hash == key_hash &&
+        slot.transaction_id == transaction_id) {
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace pw::kvs
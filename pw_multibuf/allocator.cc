@@ -0,0 +1,243 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_multibuf/allocator.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "pw_assert/check.h"
+
+namespace pw::multibuf {
+namespace {
+
+// Returns the size of the region for a ``MultiBuf``, or 0 if it overflows.
+size_t RegionSize(size_t size, size_t headroom, size_t tailroom) {
+  constexpr size_t kMaxSize = std::numeric_limits<size_t>::max();
+  if (headroom > kMaxSize - size || tailroom > kMaxSize - size - headroom) {
+    return 0;
+  }
+  return headroom + size + tailroom;
+}
+
+}  // namespace
+
+/// Tracks a region allocated by a ``MultiBufAllocator``.
+///
+/// The memory for the first ``Chunk`` is reserved along with the region, so
+/// that creating it cannot fail.
+class MultiBufAllocator::RegionTracker final : public ChunkRegionTracker {
+ public:
+  RegionTracker(MultiBufAllocator& allocator, ByteSpan region, void* chunk)
+      : allocator_(allocator), region_(region), first_chunk_(chunk) {}
+
+  ~RegionTracker() final = default;
+
+  ByteSpan Region() const final { return region_; }
+
+  // Creates the ``MultiBuf`` holding this region, with ``headroom`` bytes
+  // reserved before its data.
+  MultiBuf MakeMultiBuf(size_t headroom, size_t size);
+
+ protected:
+  void Destroy() final {
+    MultiBufAllocator& allocator = allocator_;
+    ByteSpan region = region_;
+    std::destroy_at(this);
+    allocator.FreeRegion(this, region);
+  }
+
+  void* AllocateChunkClass() final {
+    if (first_chunk_ != nullptr) {
+      return std::exchange(first_chunk_, nullptr);
+    }
+    return allocator_.AllocateChunkClass();
+  }
+
+  void DeallocateChunkClass(void* ptr) final {
+    allocator_.DeallocateChunkClass(ptr);
+  }
+
+ private:
+  MultiBufAllocator& allocator_;
+  const ByteSpan region_;
+  void* first_chunk_;
+};
+
+MultiBuf MultiBufAllocator::RegionTracker::MakeMultiBuf(size_t headroom,
+                                                        size_t size) {
+  std::optional<OwnedChunk> chunk = Chunk::CreateFirstForRegion(*this);
+  PW_CHECK(chunk.has_value());
+  (*chunk)->Slice(headroom, headroom + size);
+  MultiBuf buf;
+  buf.PushFrontChunk(std::move(*chunk));
+  return buf;
+}
+
+MultiBufAllocator::MultiBufAllocator(ByteSpan region,
+                                     allocator::Allocator& metadata_allocator)
+    : metadata_allocator_(metadata_allocator) {
+  std::lock_guard lock(lock_);
+  PW_CHECK_OK(data_allocator_.Init(region));
+  for (const auto* block : data_allocator_.blocks()) {
+    max_region_size_ = std::max(max_region_size_, block->InnerSize());
+  }
+}
+
+std::optional<MultiBuf> MultiBufAllocator::Allocate(size_t size,
+                                                    size_t headroom,
+                                                    size_t tailroom) {
+  RegionTracker* tracker;
+  {
+    std::lock_guard lock(lock_);
+    // Leave the memory to earlier requests that are waiting for it.
+    if (!waiters_.empty()) {
+      return std::nullopt;
+    }
+    tracker = AllocateRegion(size, headroom, tailroom);
+  }
+  if (tracker == nullptr) {
+    return std::nullopt;
+  }
+  return tracker->MakeMultiBuf(headroom, size);
+}
+
+Status MultiBufAllocator::AllocateAsync(Waiter& waiter) {
+  const size_t region_size =
+      RegionSize(waiter.size_, waiter.headroom_, waiter.tailroom_);
+  if (region_size == 0) {
+    return Status::InvalidArgument();
+  }
+  {
+    std::lock_guard lock(lock_);
+    // A request that cannot fit even in an empty region would block all later
+    // requests forever.
+    if (region_size > max_region_size_) {
+      return Status::OutOfRange();
+    }
+    waiters_.push_back(waiter);
+  }
+  ServeWaiters();
+  return OkStatus();
+}
+
+bool MultiBufAllocator::Cancel(Waiter& waiter) {
+  std::lock_guard lock(lock_);
+  return waiters_.remove(waiter);
+}
+
+MultiBufAllocator::Stats MultiBufAllocator::GetStats() const {
+  std::lock_guard lock(lock_);
+  Stats stats{};
+  for (const auto* block : data_allocator_.blocks()) {
+    if (!block->Used()) {
+      stats.free_bytes += block->InnerSize();
+      stats.largest_free_block =
+          std::max(stats.largest_free_block, block->InnerSize());
+    }
+  }
+  stats.allocations = allocations_;
+  return stats;
+}
+
+MultiBufAllocator::RegionTracker* MultiBufAllocator::AllocateRegion(
+    size_t size, size_t headroom, size_t tailroom) {
+  const size_t region_size = RegionSize(size, headroom, tailroom);
+  if (region_size == 0) {
+    return nullptr;
+  }
+
+  // The data does not need to be aligned, since the headroom moves it anyway.
+  void* data = data_allocator_.Allocate(allocator::Layout(region_size, 1));
+  if (data == nullptr) {
+    return nullptr;
+  }
+  void* tracker =
+      metadata_allocator_.Allocate(allocator::Layout::Of<RegionTracker>());
+  void* chunk = metadata_allocator_.Allocate(allocator::Layout::Of<Chunk>());
+  if (tracker == nullptr || chunk == nullptr) {
+    if (tracker != nullptr) {
+      metadata_allocator_.Deallocate(tracker,
+                                     allocator::Layout::Of<RegionTracker>());
+    }
+    if (chunk != nullptr) {
+      metadata_allocator_.Deallocate(chunk, allocator::Layout::Of<Chunk>());
+    }
+    data_allocator_.Deallocate(data, allocator::Layout(region_size, 1));
+    return nullptr;
+  }
+
+  ++allocations_;
+  return new (tracker) RegionTracker(
+      *this, ByteSpan(static_cast<std::byte*>(data), region_size), chunk);
+}
+
+void MultiBufAllocator::FreeRegion(void* tracker, ByteSpan region) {
+  {
+    std::lock_guard lock(lock_);
+    data_allocator_.Deallocate(region.data(),
+                               allocator::Layout(region.size(), 1));
+    metadata_allocator_.Deallocate(tracker,
+                                   allocator::Layout::Of<RegionTracker>());
+    --allocations_;
+  }
+  ServeWaiters();
+}
+
+void MultiBufAllocator::ServeWaiters() {
+  while (true) {
+    AllocationCallback callback;
+    size_t headroom;
+    size_t size;
+    RegionTracker* tracker;
+    {
+      std::lock_guard lock(lock_);
+      if (waiters_.empty()) {
+        return;
+      }
+      Waiter& waiter = waiters_.front();
+      tracker =
+          AllocateRegion(waiter.size_, waiter.headroom_, waiter.tailroom_);
+      if (tracker == nullptr) {
+        return;
+      }
+      waiters_.pop_front();
+
+      // Once popped, the waiter cannot be cancelled and may be destroyed by
+      // its owner, so take everything needed from it before unlocking.
+      callback = std::move(waiter.callback_);
+      headroom = waiter.headroom_;
+      size = waiter.size_;
+    }
+
+    // Invoke the callback without holding the lock, since it may allocate.
+    callback(tracker->MakeMultiBuf(headroom, size));
+  }
+}
+
+void* MultiBufAllocator::AllocateChunkClass() {
+  std::lock_guard lock(lock_);
+  return metadata_allocator_.Allocate(allocator::Layout::Of<Chunk>());
+}
+
+void MultiBufAllocator::DeallocateChunkClass(void* ptr) {
+  std::lock_guard lock(lock_);
+  metadata_allocator_.Deallocate(ptr, allocator::Layout::Of<Chunk>());
+}
+
+}  // namespace pw::multibuf
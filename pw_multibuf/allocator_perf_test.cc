@@ -0,0 +1,102 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures MultiBufAllocator on a workload of mixed-size packets, as a
+// network stack might see: mostly small control packets, with some full-size
+// data packets. Each packet reserves headroom and tailroom for framing. After
+// the runs, logs how fragmented the region is while packets are live.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_allocator/tlsf_allocator.h"
+#include "pw_assert/check.h"
+#include "pw_bytes/span.h"
+#include "pw_log/log.h"
+#include "pw_multibuf/allocator.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::multibuf {
+namespace {
+
+constexpr size_t kRegionSize = 32 * 1024;
+constexpr size_t kMetadataSize = 16 * 1024;
+constexpr size_t kLivePackets = 48;
+constexpr int kSteps = 10000;
+constexpr size_t kHeadroom = 16;
+constexpr size_t kTailroom = 4;
+
+alignas(std::max_align_t) std::array<std::byte, kRegionSize> region;
+alignas(std::max_align_t) std::array<std::byte, kMetadataSize> metadata;
+
+size_t PacketSize(uint32_t random) {
+  switch (random % 8) {
+    case 0:
+      return 1500;
+    case 1:
+    case 2:
+      return 512;
+    default:
+      return 32 + random % 96;
+  }
+}
+
+void MixedPackets(perf_test::State& state) {
+  allocator::TlsfAllocator<> metadata_allocator;
+  PW_CHECK_OK(metadata_allocator.Init(ByteSpan(metadata)));
+  MultiBufAllocator allocator(region, metadata_allocator);
+  std::array<std::optional<MultiBuf>, kLivePackets> packets;
+
+  uint32_t random = 1;
+  size_t allocations = 0;
+  size_t failures = 0;
+  while (state.KeepRunning()) {
+    // Replace a random live packet with a new one on each step.
+    for (int step = 0; step < kSteps; ++step) {
+      random = random * 1103515245u + 12345u;
+      std::optional<MultiBuf>& packet = packets[(random >> 8) % kLivePackets];
+      packet.reset();
+      packet =
+          allocator.Allocate(PacketSize(random >> 16), kHeadroom, kTailroom);
+      if (packet.has_value()) {
+        ++allocations;
+      } else {
+        ++failures;
+      }
+    }
+  }
+
+  const MultiBufAllocator::Stats stats = allocator.GetStats();
+  PW_CHECK_UINT_NE(allocations, 0);
+  PW_LOG_INFO(
+      "%u allocations, %u failed; %u bytes free, largest free block %u bytes",
+      static_cast<unsigned>(allocations),
+      static_cast<unsigned>(failures),
+      static_cast<unsigned>(stats.free_bytes),
+      static_cast<unsigned>(stats.largest_free_block));
+  PW_LOG_INFO("Fragmentation: %u%%",
+              static_cast<unsigned>(
+                  100 - stats.largest_free_block * 100 / stats.free_bytes));
+
+  for (std::optional<MultiBuf>& packet : packets) {
+    packet.reset();
+  }
+}
+
+PW_PERF_TEST(MultiBufAllocator10kMixedPackets, MixedPackets);
+
+}  // namespace
+}  // namespace pw::multibuf
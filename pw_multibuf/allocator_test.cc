@@ -0,0 +1,208 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_multibuf/allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_multibuf/internal/test_utils.h"
+#include "pw_status/status.h"
+
+namespace pw::multibuf {
+namespace {
+
+using ::pw::multibuf::internal::TrackingAllocatorWithMemory;
+
+constexpr size_t kRegionSize = 1024;
+constexpr size_t kMetadataSize = 2048;
+
+class MultiBufAllocatorTest : public ::testing::Test {
+ protected:
+  MultiBufAllocatorTest() : allocator_(region_, metadata_) {}
+
+  ~MultiBufAllocatorTest() override {
+    // All of the bookkeeping was freed along with the MultiBufs.
+    EXPECT_EQ(metadata_.count(), 0U);
+  }
+
+  alignas(std::max_align_t) std::array<std::byte, kRegionSize> region_;
+  TrackingAllocatorWithMemory<kMetadataSize> metadata_;
+  MultiBufAllocator allocator_;
+};
+
+TEST_F(MultiBufAllocatorTest, AllocateReturnsBufOfSize) {
+  std::optional<MultiBuf> buf = allocator_.Allocate(64);
+  ASSERT_TRUE(buf.has_value());
+  EXPECT_EQ(buf->size(), 64U);
+  EXPECT_EQ(buf->Chunks().size(), 1U);
+  EXPECT_GE(buf->ChunkBegin()->data(), region_.data());
+  EXPECT_LE(buf->ChunkBegin()->data() + 64, region_.data() + region_.size());
+}
+
+TEST_F(MultiBufAllocatorTest, HeadroomAndTailroomCanBeClaimed) {
+  std::optional<MultiBuf> buf = allocator_.Allocate(32, 8, 4);
+  ASSERT_TRUE(buf.has_value());
+  Chunk& chunk = *buf->ChunkBegin();
+  std::byte* data = chunk.data();
+  EXPECT_EQ(chunk.size(), 32U);
+
+  // Headers and footers are added in place, without moving the data.
+  EXPECT_TRUE(chunk.ClaimPrefix(8));
+  EXPECT_EQ(chunk.data(), data - 8);
+  EXPECT_TRUE(chunk.ClaimSuffix(4));
+  EXPECT_EQ(chunk.size(), 44U);
+
+  // There is no more space to claim.
+  EXPECT_FALSE(chunk.ClaimPrefix(1));
+  EXPECT_FALSE(chunk.ClaimSuffix(1));
+}
+
+TEST_F(MultiBufAllocatorTest, ReleaseFreesMemory) {
+  const MultiBufAllocator::Stats initial = allocator_.GetStats();
+  EXPECT_EQ(initial.allocations, 0U);
+  {
+    std::optional<MultiBuf> buf = allocator_.Allocate(128, 16, 16);
+    ASSERT_TRUE(buf.has_value());
+    const MultiBufAllocator::Stats stats = allocator_.GetStats();
+    EXPECT_EQ(stats.allocations, 1U);
+    EXPECT_LE(stats.free_bytes, initial.free_bytes - 160);
+    EXPECT_GT(metadata_.count(), 0U);
+  }
+  const MultiBufAllocator::Stats stats = allocator_.GetStats();
+  EXPECT_EQ(stats.allocations, 0U);
+  EXPECT_EQ(stats.free_bytes, initial.free_bytes);
+  EXPECT_EQ(stats.largest_free_block, initial.largest_free_block);
+}
+
+TEST_F(MultiBufAllocatorTest, SplitChunksAreFreed) {
+  std::optional<MultiBuf> buf = allocator_.Allocate(64);
+  ASSERT_TRUE(buf.has_value());
+  auto [it, chunk] = buf->TakeChunk(buf->ChunkBegin());
+  std::optional<OwnedChunk> front = chunk->TakeFront(16);
+  ASSERT_TRUE(front.has_value());
+  EXPECT_EQ(front->size(), 16U);
+  EXPECT_EQ(chunk.size(), 48U);
+
+  // The region is freed once both chunks are released.
+  chunk.Release();
+  EXPECT_EQ(allocator_.GetStats().allocations, 1U);
+  front->Release();
+  EXPECT_EQ(allocator_.GetStats().allocations, 0U);
+}
+
+TEST_F(MultiBufAllocatorTest, AllocateFailsWhenFull) {
+  std::optional<MultiBuf> buf = allocator_.Allocate(kRegionSize / 2);
+  ASSERT_TRUE(buf.has_value());
+  EXPECT_FALSE(allocator_.Allocate(kRegionSize / 2).has_value());
+  EXPECT_FALSE(allocator_.Allocate(kRegionSize * 2).has_value());
+  EXPECT_FALSE(allocator_.Allocate(0).has_value());
+}
+
+TEST_F(MultiBufAllocatorTest, AllocateAsyncWithMemoryAvailable) {
+  std::optional<MultiBuf> result;
+  MultiBufAllocator::Waiter waiter(
+      32, 4, 4, [&result](MultiBuf&& buf) { result = std::move(buf); });
+  EXPECT_EQ(allocator_.AllocateAsync(waiter), OkStatus());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->size(), 32U);
+  EXPECT_FALSE(allocator_.Cancel(waiter));
+}
+
+TEST_F(MultiBufAllocatorTest, AllocateAsyncWaitsForMemory) {
+  std::optional<MultiBuf> buf = allocator_.Allocate(kRegionSize / 2);
+  ASSERT_TRUE(buf.has_value());
+
+  std::optional<MultiBuf> result;
+  MultiBufAllocator::Waiter waiter(
+      kRegionSize / 2, 0, 0, [&result](MultiBuf&& b) {
+        result = std::move(b);
+      });
+  EXPECT_EQ(allocator_.AllocateAsync(waiter), OkStatus());
+  EXPECT_FALSE(result.has_value());
+
+  // Other allocations wait behind the request.
+  EXPECT_FALSE(allocator_.Allocate(1).has_value());
+
+  buf->Release();
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->size(), kRegionSize / 2);
+}
+
+TEST_F(MultiBufAllocatorTest, AllocateAsyncServesInOrder) {
+  std::optional<MultiBuf> buf = allocator_.Allocate(kRegionSize / 2);
+  ASSERT_TRUE(buf.has_value());
+
+  struct {
+    std::array<std::optional<MultiBuf>, 3> results;
+    size_t served = 0;
+  } context;
+  auto callback = [&context](MultiBuf&& b) {
+    context.results[context.served++] = std::move(b);
+  };
+  MultiBufAllocator::Waiter large(kRegionSize / 2, 0, 0, callback);
+  MultiBufAllocator::Waiter small1(16, 0, 0, callback);
+  MultiBufAllocator::Waiter small2(24, 0, 0, callback);
+  EXPECT_EQ(allocator_.AllocateAsync(large), OkStatus());
+  EXPECT_EQ(allocator_.AllocateAsync(small1), OkStatus());
+  EXPECT_EQ(allocator_.AllocateAsync(small2), OkStatus());
+
+  // The small requests fit, but wait for the large one.
+  EXPECT_EQ(context.served, 0U);
+
+  buf->Release();
+  ASSERT_EQ(context.served, 3U);
+  EXPECT_EQ(context.results[0]->size(), kRegionSize / 2);
+  EXPECT_EQ(context.results[1]->size(), 16U);
+  EXPECT_EQ(context.results[2]->size(), 24U);
+}
+
+TEST_F(MultiBufAllocatorTest, CancelledWaiterIsNotServed) {
+  std::optional<MultiBuf> buf = allocator_.Allocate(kRegionSize / 2);
+  ASSERT_TRUE(buf.has_value());
+
+  bool called = false;
+  MultiBufAllocator::Waiter waiter(
+      kRegionSize / 2, 0, 0, [&called](MultiBuf&&) { called = true; });
+  EXPECT_EQ(allocator_.AllocateAsync(waiter), OkStatus());
+  EXPECT_TRUE(allocator_.Cancel(waiter));
+  EXPECT_FALSE(allocator_.Cancel(waiter));
+
+  buf->Release();
+  EXPECT_FALSE(called);
+  EXPECT_TRUE(allocator_.Allocate(1).has_value());
+}
+
+TEST_F(MultiBufAllocatorTest, AllocateAsyncRejectsImpossibleRequests) {
+  bool called = false;
+  auto callback = [&called](MultiBuf&&) { called = true; };
+  MultiBufAllocator::Waiter empty(0, 0, 0, callback);
+  MultiBufAllocator::Waiter too_large(kRegionSize * 2, 0, 0, callback);
+  MultiBufAllocator::Waiter overflow(
+      std::numeric_limits<size_t>::max(), 1, 0, callback);
+  EXPECT_EQ(allocator_.AllocateAsync(empty), Status::InvalidArgument());
+  EXPECT_EQ(allocator_.AllocateAsync(overflow), Status::InvalidArgument());
+  EXPECT_EQ(allocator_.AllocateAsync(too_large), Status::OutOfRange());
+  EXPECT_FALSE(allocator_.Cancel(too_large));
+  EXPECT_FALSE(called);
+
+  // Rejected requests do not block later ones.
+  EXPECT_TRUE(allocator_.Allocate(1).has_value());
+}
+
+}  // namespace
+}  // namespace pw::multibuf
@@ -0,0 +1,179 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/tlsf_allocator.h"
+#include "pw_bytes/span.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_function/function.h"
+#include "pw_multibuf/chunk.h"
+#include "pw_multibuf/multibuf.h"
+#include "pw_status/status.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::multibuf {
+
+/// Allocates ``MultiBuf`` s from a fixed region of memory.
+///
+/// Each ``MultiBuf`` holds a single ``Chunk``, with space reserved before and
+/// after its data. Lower layers of a protocol stack can use ``ClaimPrefix``
+/// and ``ClaimSuffix`` to add their headers and footers to this space without
+/// copying the data.
+///
+/// The region is divided using a ``pw::allocator::TlsfAllocator``, so
+/// allocating and freeing take constant time. ``Chunk`` objects and the
+/// bookkeeping for each allocation come from a separate
+/// ``pw::allocator::Allocator``, so that the region only holds data. This
+/// allows the region to be placed in memory suited for I/O, such as
+/// DMA-capable memory.
+///
+/// When there is not enough memory, callers can wait for it using
+/// ``AllocateAsync``.
+///
+/// All ``MultiBuf`` s must be released before the allocator is destroyed.
+class MultiBufAllocator {
+ public:
+  /// Receives the ``MultiBuf`` of an asynchronous allocation.
+  using AllocationCallback = Function<void(MultiBuf&&)>;
+
+  /// An asynchronous allocation request.
+  ///
+  /// ``Waiter`` s are owned by the caller, and must remain valid until their
+  /// callback is invoked or they are cancelled. Each ``Waiter`` is used for a
+  /// single allocation.
+  class Waiter : public IntrusiveList<Waiter>::Item {
+   public:
+    /// Requests a ``MultiBuf`` of ``size`` bytes, with ``headroom`` bytes
+    /// reserved before and ``tailroom`` bytes reserved after its data.
+    Waiter(size_t size,
+           size_t headroom,
+           size_t tailroom,
+           AllocationCallback&& callback)
+        : size_(size),
+          headroom_(headroom),
+          tailroom_(tailroom),
+          callback_(std::move(callback)) {}
+
+   private:
+    friend class MultiBufAllocator;
+
+    size_t size_;
+    size_t headroom_;
+    size_t tailroom_;
+    AllocationCallback callback_;
+  };
+
+  /// Usage of the region, for diagnostics.
+  struct Stats {
+    /// Bytes of the region that are not allocated.
+    size_t free_bytes;
+
+    /// Size of the largest contiguous free space. Allocations, including their
+    /// headroom and tailroom, cannot be larger than this.
+    size_t largest_free_block;
+
+    /// Number of allocated regions that have not yet been freed.
+    size_t allocations;
+  };
+
+  /// Creates an allocator for ``MultiBuf`` s in ``region``, using
+  /// ``metadata_allocator`` for ``Chunk`` objects and bookkeeping.
+  ///
+  /// Crashes if ``region`` is too small or too large to be used.
+  MultiBufAllocator(ByteSpan region, allocator::Allocator& metadata_allocator);
+
+  // Not copyable or movable.
+  MultiBufAllocator(const MultiBufAllocator&) = delete;
+  MultiBufAllocator& operator=(const MultiBufAllocator&) = delete;
+
+  /// Allocates a ``MultiBuf`` of ``size`` bytes.
+  ///
+  /// ``headroom`` bytes before and ``tailroom`` bytes after the data are
+  /// reserved, and can be added to the front or back of the ``MultiBuf`` 's
+  /// ``Chunk`` with ``ClaimPrefix`` and ``ClaimSuffix``.
+  ///
+  /// Returns ``std::nullopt`` if there is not enough memory, or if requests
+  /// from ``AllocateAsync`` are waiting for memory.
+  ///
+  /// This method will acquire a mutex and is not IRQ safe.
+  std::optional<MultiBuf> Allocate(size_t size,
+                                   size_t headroom = 0,
+                                   size_t tailroom = 0);
+
+  /// Allocates a ``MultiBuf`` as requested by ``waiter``, once there is enough
+  /// memory.
+  ///
+  /// Requests are served in order. If there is enough memory and no earlier
+  /// requests are waiting, the callback is invoked before this method returns.
+  /// Otherwise, it is invoked by the thread that releases the memory, and
+  /// must not block.
+  ///
+  /// Requests that could never be served are rejected rather than queued,
+  /// since they would block all later requests.
+  ///
+  /// This method will acquire a mutex and is not IRQ safe.
+  ///
+  /// @retval OK The request was served or queued.
+  /// @retval INVALID_ARGUMENT The total size of the request is zero or
+  ///                          overflows.
+  /// @retval OUT_OF_RANGE The request is larger than the region.
+  Status AllocateAsync(Waiter& waiter);
+
+  /// Cancels an asynchronous allocation.
+  ///
+  /// Returns ``true`` if ``waiter`` was cancelled, or ``false`` if its
+  /// callback has already been invoked or is about to be.
+  ///
+  /// This method will acquire a mutex and is not IRQ safe.
+  bool Cancel(Waiter& waiter);
+
+  /// Returns the usage of the region.
+  ///
+  /// This method is ``O(n)`` in the number of allocations, and will acquire a
+  /// mutex and is not IRQ safe.
+  Stats GetStats() const;
+
+ private:
+  class RegionTracker;
+
+  // Allocates the region and bookkeeping for a ``MultiBuf``. Returns null if
+  // there is not enough memory.
+  RegionTracker* AllocateRegion(size_t size, size_t headroom, size_t tailroom)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Frees the memory of a region whose tracker has been destroyed.
+  void FreeRegion(void* tracker, ByteSpan region) PW_LOCKS_EXCLUDED(lock_);
+
+  // Invokes the callbacks of waiters, in order, until one cannot be served.
+  void ServeWaiters() PW_LOCKS_EXCLUDED(lock_);
+
+  void* AllocateChunkClass() PW_LOCKS_EXCLUDED(lock_);
+  void DeallocateChunkClass(void* ptr) PW_LOCKS_EXCLUDED(lock_);
+
+  mutable sync::Mutex lock_;
+  allocator::TlsfAllocator<> data_allocator_ PW_GUARDED_BY(lock_);
+  // Only used while holding `lock_`.
+  allocator::Allocator& metadata_allocator_;
+  IntrusiveList<Waiter> waiters_ PW_GUARDED_BY(lock_);
+  size_t allocations_ PW_GUARDED_BY(lock_) = 0;
+  // The largest region that can be allocated when the region is empty.
+  size_t max_region_size_ PW_GUARDED_BY(lock_) = 0;
+};
+
+}  // namespace pw::multibuf
@@ -368,6 +368,4 @@ class MultiBuf {
   Chunk* first_;
 };
 
-class MultiBufAllocator {};
-
 }  // namespace pw::multibuf
@@ -13,7 +13,9 @@
 // the License.
 #include "pw_multisink/multisink.h"
 
+#include <cstdint>
 #include <cstring>
+#include <optional>
 
 #include "pw_assert/check.h"
 #include "pw_bytes/span.h"
@@ -26,6 +28,15 @@
 
 namespace pw {
 namespace multisink {
+namespace {
+
+// Returns whether the entry with staging ID `a` was staged before the one with
+// `b`. Compares the difference to handle staging IDs wrapping around.
+bool StagedBefore(uint32_t a, uint32_t b) {
+  return static_cast<int32_t>(a - b) < 0;
+}
+
+}  // namespace
 
 void MultiSink::HandleEntry(ConstByteSpan entry) {
   std::lock_guard lock(lock_);
@@ -90,6 +101,10 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
   std::lock_guard lock(lock_);
   PW_DCHECK_PTR_EQ(drain.multisink_, this);
 
+  if (MergeStagingBuffers()) {
+    NotifyListeners();
+  }
+
   const Status peek_status = drain.reader_.PeekFrontWithPreamble(
       buffer, entry_sequence_id_out, bytes_read);
 
@@ -170,6 +185,31 @@ void MultiSink::DetachDrain(Drain& drain) {
               "The drain wasn't already attached.");
 }
 
+void MultiSink::AttachStagingBuffer(StagingBuffer& staging_buffer) {
+  std::lock_guard lock(lock_);
+  PW_DCHECK_PTR_EQ(staging_buffer.multisink_, nullptr);
+  staging_buffer.multisink_ = this;
+  staging_buffers_.push_back(staging_buffer);
+}
+
+void MultiSink::DetachStagingBuffer(StagingBuffer& staging_buffer) {
+  std::lock_guard lock(lock_);
+  PW_DCHECK_PTR_EQ(staging_buffer.multisink_, this);
+  if (MergeStagingBuffers()) {
+    NotifyListeners();
+  }
+  staging_buffer.multisink_ = nullptr;
+  [[maybe_unused]] bool was_detached = staging_buffers_.remove(staging_buffer);
+  PW_DCHECK(was_detached, "The staging buffer wasn't already attached.");
+}
+
+void MultiSink::FlushStagingBuffers() {
+  std::lock_guard lock(lock_);
+  if (MergeStagingBuffers()) {
+    NotifyListeners();
+  }
+}
+
 void MultiSink::AttachListener(Listener& listener) {
   std::lock_guard lock(lock_);
   listeners_.push_back(listener);
@@ -185,6 +225,8 @@ void MultiSink::DetachListener(Listener& listener) {
 
 void MultiSink::Clear() {
   std::lock_guard lock(lock_);
+  // Merge staged entries first, so that their sequence IDs are used.
+  MergeStagingBuffers();
   ring_buffer_.Clear();
 }
 
@@ -194,6 +236,61 @@ void MultiSink::NotifyListeners() {
   }
 }
 
+bool MultiSink::MergeStagingBuffers() {
+  bool merged = false;
+  for (StagingBuffer& staging_buffer : staging_buffers_) {
+    const uint32_t drop_count =
+        staging_buffer.drop_count_.exchange(0, std::memory_order_relaxed);
+    if (drop_count > 0) {
+      sequence_id_ += drop_count;
+      total_ingress_drops_ += drop_count;
+      merged = true;
+    }
+  }
+
+  // Repeatedly find the staging buffer whose oldest entry was staged first,
+  // and move its entries until reaching one staged after the oldest entry of
+  // another staging buffer. Each staging buffer holds its entries in the order
+  // they were staged, so only their oldest entries need to be compared.
+  while (true) {
+    StagingBuffer* oldest = nullptr;
+    uint32_t oldest_staging_id = 0;
+    std::optional<uint32_t> next_staging_id;
+    for (StagingBuffer& staging_buffer : staging_buffers_) {
+      uint32_t staging_id;
+      ConstByteSpan entry;
+      if (!staging_buffer.PeekFront(staging_id, entry)) {
+        continue;
+      }
+      if (oldest == nullptr || StagedBefore(staging_id, oldest_staging_id)) {
+        if (oldest != nullptr) {
+          next_staging_id = oldest_staging_id;
+        }
+        oldest = &staging_buffer;
+        oldest_staging_id = staging_id;
+      } else if (!next_staging_id.has_value() ||
+                 StagedBefore(staging_id, *next_staging_id)) {
+        next_staging_id = staging_id;
+      }
+    }
+    if (oldest == nullptr) {
+      return merged;
+    }
+
+    uint32_t staging_id;
+    ConstByteSpan entry;
+    while (oldest->PeekFront(staging_id, entry) &&
+           (!next_staging_id.has_value() ||
+            StagedBefore(staging_id, *next_staging_id))) {
+      const Status push_back_status =
+          ring_buffer_.PushBack(entry, sequence_id_++);
+      PW_DCHECK_OK(push_back_status);
+      oldest->PopFront(entry);
+      merged = true;
+    }
+  }
+}
+
 Status MultiSink::UnsafeForEachEntry(
     const Function<void(ConstByteSpan)>& callback, size_t max_num_entries) {
   MultiSink::UnsafeIterationWrapper multisink_iteration = UnsafeIteration();
@@ -223,6 +320,89 @@ Status MultiSink::UnsafeForEachEntry(
   return OkStatus();
 }
 
+void MultiSink::StagingBuffer::HandleEntry(ConstByteSpan entry) {
+  PW_DCHECK_NOTNULL(multisink_);
+  const size_t size = sizeof(Header) + entry.size();
+  const size_t capacity = buffer_.size();
+  const size_t read_offset = read_offset_.load(std::memory_order_acquire);
+  size_t write_offset = write_offset_.load(std::memory_order_relaxed);
+
+  // Find contiguous space for the entry, leaving a byte unused so that a full
+  // buffer can be told apart from an empty one.
+  size_t padding = 0;
+  if (read_offset > write_offset) {
+    if (read_offset - write_offset - 1 < size) {
+      HandleDropped();
+      return;
+    }
+  } else if (capacity - write_offset - (read_offset == 0 ? 1 : 0) < size) {
+    // Skip the end of the buffer, and write the entry at the start.
+    if (read_offset == 0 || read_offset - 1 < size) {
+      HandleDropped();
+      return;
+    }
+    padding = capacity - write_offset;
+  }
+
+  if (padding >= sizeof(Header)) {
+    const Header header{.staging_id = 0, .size = kPadding};
+    std::memcpy(&buffer_[write_offset], &header, sizeof(header));
+  }
+  if (padding > 0) {
+    write_offset = 0;
+  }
+
+  // Order the entry after those staged earlier in any staging buffer.
+  const Header header{
+      .staging_id = multisink_->next_staging_id_.fetch_add(
+          1, std::memory_order_relaxed),
+      .size = static_cast<uint32_t>(entry.size()),
+  };
+  std::memcpy(&buffer_[write_offset], &header, sizeof(header));
+  std::memcpy(buffer_.subspan(write_offset + sizeof(header)).data(),
+              entry.data(),
+              entry.size());
+  write_offset += size;
+  if (write_offset == capacity) {
+    write_offset = 0;
+  }
+  write_offset_.store(write_offset, std::memory_order_release);
+}
+
+bool MultiSink::StagingBuffer::PeekFront(uint32_t& staging_id_out,
+                                         ConstByteSpan& entry_out) {
+  size_t read_offset = read_offset_.load(std::memory_order_relaxed);
+  const size_t write_offset = write_offset_.load(std::memory_order_acquire);
+  if (read_offset == write_offset) {
+    return false;
+  }
+
+  // Entries that did not fit at the end of the buffer were written at the
+  // start.
+  Header header;
+  bool wrapped = buffer_.size() - read_offset < sizeof(header);
+  if (!wrapped) {
+    std::memcpy(&header, &buffer_[read_offset], sizeof(header));
+    wrapped = header.size == kPadding;
+  }
+  if (wrapped) {
+    read_offset = 0;
+    std::memcpy(&header, buffer_.data(), sizeof(header));
+  }
+  staging_id_out = header.staging_id;
+  entry_out = buffer_.subspan(read_offset + sizeof(header), header.size);
+  return true;
+}
+
+void MultiSink::StagingBuffer::PopFront(ConstByteSpan entry) {
+  size_t read_offset =
+      static_cast<size_t>(entry.data() + entry.size() - buffer_.data());
+  if (read_offset == buffer_.size()) {
+    read_offset = 0;
+  }
+  read_offset_.store(read_offset, std::memory_order_release);
+}
+
 Status MultiSink::Drain::PopEntry(const PeekedEntry& entry) {
   PW_DCHECK_NOTNULL(multisink_);
   return multisink_->PopEntry(*this, entry);
@@ -0,0 +1,170 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how long producer threads take to add entries to a MultiSink while
+// a drain reads them, with 1 to 16 producers. Entries are either added
+// directly, which takes the multisink's lock for each entry, or through a
+// staging buffer for each producer, which does not. Logs how many entries were
+// dropped, which should be none.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/check.h"
+#include "pw_log/log.h"
+#include "pw_multisink/multisink.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/yield.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::multisink {
+namespace {
+
+constexpr size_t kEntriesPerProducer = 256;
+constexpr size_t kEntrySize = 32;
+constexpr size_t kMaxProducers = 16;
+
+// Leave room for all of the entries, so that none are dropped and only the
+// cost of adding entries is measured.
+constexpr size_t kBufferSize = kMaxProducers * kEntriesPerProducer * 48;
+constexpr size_t kStagingBufferSize = kEntriesPerProducer * 48;
+
+std::array<std::byte, kBufferSize> buffer;
+std::array<std::byte, kEntrySize> drain_buffer;
+
+class Producer : public thread::ThreadCore {
+ public:
+  Producer() : staging_(staging_buffer_) {}
+
+  void Start(MultiSink& multisink,
+             bool staged,
+             std::atomic<size_t>& running_producers) {
+    multisink_ = &multisink;
+    staged_ = staged;
+    running_producers_ = &running_producers;
+  }
+
+  MultiSink::StagingBuffer& staging() { return staging_; }
+
+ private:
+  void Run() override {
+    const std::array<std::byte, kEntrySize> entry{};
+    for (size_t i = 0; i < kEntriesPerProducer; ++i) {
+      if (staged_) {
+        staging_.HandleEntry(entry);
+      } else {
+        multisink_->HandleEntry(entry);
+      }
+    }
+    running_producers_->fetch_sub(1);
+  }
+
+  std::array<std::byte, kStagingBufferSize> staging_buffer_{};
+  MultiSink::StagingBuffer staging_;
+  MultiSink* multisink_ = nullptr;
+  bool staged_ = false;
+  std::atomic<size_t>* running_producers_ = nullptr;
+};
+
+struct Counts {
+  size_t read = 0;
+  size_t dropped = 0;
+};
+
+// Reads all available entries.
+void DrainAll(MultiSink::Drain& drain, Counts& counts) {
+  while (true) {
+    uint32_t drop_count = 0;
+    uint32_t ingress_drop_count = 0;
+    const Result<ConstByteSpan> result =
+        drain.PopEntry(drain_buffer, drop_count, ingress_drop_count);
+    counts.dropped += drop_count + ingress_drop_count;
+    if (result.status().IsOutOfRange()) {
+      return;
+    }
+    ++counts.read;
+  }
+}
+
+template <size_t kProducers>
+void Contention(perf_test::State& state, bool staged) {
+  static_assert(kProducers <= kMaxProducers);
+  static std::array<Producer, kProducers> producers;
+  MultiSink multisink(buffer);
+  MultiSink::Drain drain;
+  multisink.AttachDrain(drain);
+  if (staged) {
+    for (Producer& producer : producers) {
+      multisink.AttachStagingBuffer(producer.staging());
+    }
+  }
+
+  Counts counts;
+  while (state.KeepRunning()) {
+    std::atomic<size_t> running_producers = kProducers;
+    std::array<thread::Thread, kProducers> threads;
+    for (size_t i = 0; i < kProducers; ++i) {
+      producers[i].Start(multisink, staged, running_producers);
+      threads[i] = thread::Thread(thread::stl::Options(), producers[i]);
+    }
+    while (running_producers.load() > 0) {
+      DrainAll(drain, counts);
+      this_thread::yield();
+    }
+    for (thread::Thread& thread : threads) {
+      thread.join();
+    }
+    DrainAll(drain, counts);
+  }
+
+  // Every entry was either read or counted as dropped.
+  const size_t total = counts.read + counts.dropped;
+  PW_CHECK_UINT_EQ(total % (kProducers * kEntriesPerProducer), 0);
+  PW_LOG_INFO("%u entries read, %u dropped",
+              static_cast<unsigned>(counts.read),
+              static_cast<unsigned>(counts.dropped));
+  if (staged) {
+    for (Producer& producer : producers) {
+      multisink.DetachStagingBuffer(producer.staging());
+    }
+  }
+  multisink.DetachDrain(drain);
+}
+
+template <size_t kProducers>
+void Locked(perf_test::State& state) {
+  Contention<kProducers>(state, false);
+}
+
+template <size_t kProducers>
+void Staged(perf_test::State& state) {
+  Contention<kProducers>(state, true);
+}
+
+PW_PERF_TEST(MultiSinkLocked1Producer, Locked<1>);
+PW_PERF_TEST(MultiSinkLocked2Producers, Locked<2>);
+PW_PERF_TEST(MultiSinkLocked4Producers, Locked<4>);
+PW_PERF_TEST(MultiSinkLocked8Producers, Locked<8>);
+PW_PERF_TEST(MultiSinkLocked16Producers, Locked<16>);
+PW_PERF_TEST(MultiSinkStaged1Producer, Staged<1>);
+PW_PERF_TEST(MultiSinkStaged2Producers, Staged<2>);
+PW_PERF_TEST(MultiSinkStaged4Producers, Staged<4>);
+PW_PERF_TEST(MultiSinkStaged8Producers, Staged<8>);
+PW_PERF_TEST(MultiSinkStaged16Producers, Staged<16>);
+
+}  // namespace
+}  // namespace pw::multisink
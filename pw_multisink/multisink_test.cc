@@ -532,6 +532,110 @@ TEST_F(MultiSinkTest, DetachedDrainReportsDropCount) {
   VerifyPopEntry(drains_[0], kMessage, 0, ingress_drops);
 }
 
+TEST_F(MultiSinkTest, StagedEntriesAreMergedInOrder) {
+  std::array<std::byte, 64> staging_buffer1;
+  std::array<std::byte, 64> staging_buffer2;
+  MultiSink::StagingBuffer staging1(staging_buffer1);
+  MultiSink::StagingBuffer staging2(staging_buffer2);
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachStagingBuffer(staging1);
+  multisink_.AttachStagingBuffer(staging2);
+
+  staging1.HandleEntry(kMessage);
+  staging2.HandleEntry(kMessageOther);
+  staging1.HandleEntry(kMessage);
+  staging2.HandleEntry(kMessageOther);
+
+  // Draining merges the staged entries.
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  VerifyPopEntry(drains_[0], kMessageOther, 0, 0);
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  VerifyPopEntry(drains_[0], kMessageOther, 0, 0);
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 0);
+
+  multisink_.DetachStagingBuffer(staging1);
+  multisink_.DetachStagingBuffer(staging2);
+}
+
+TEST_F(MultiSinkTest, FlushStagingBuffersNotifiesListeners) {
+  std::array<std::byte, 64> staging_buffer;
+  MultiSink::StagingBuffer staging(staging_buffer);
+  multisink_.AttachStagingBuffer(staging);
+  multisink_.AttachListener(listeners_[0]);
+  ExpectNotificationCount(listeners_[0], 1u);
+
+  // Staging does not take the lock to notify listeners.
+  staging.HandleEntry(kMessage);
+  staging.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 0u);
+
+  multisink_.FlushStagingBuffers();
+  ExpectNotificationCount(listeners_[0], 1u);
+  multisink_.FlushStagingBuffers();
+  ExpectNotificationCount(listeners_[0], 0u);
+
+  multisink_.AttachDrain(drains_[0]);
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  multisink_.DetachStagingBuffer(staging);
+}
+
+TEST_F(MultiSinkTest, FullStagingBufferReportsIngressDrops) {
+  // Each entry takes 12 bytes, and one byte is unused, so two entries fit.
+  std::array<std::byte, 32> staging_buffer;
+  MultiSink::StagingBuffer staging(staging_buffer);
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachStagingBuffer(staging);
+
+  staging.HandleEntry(kMessage);
+  staging.HandleEntry(kMessageOther);
+  staging.HandleEntry(kMessage);
+  staging.HandleDropped(2);
+
+  VerifyPopEntry(drains_[0], kMessage, 0, 3);
+  VerifyPopEntry(drains_[0], kMessageOther, 0, 0);
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 0);
+
+  // There is space again once the entries are merged.
+  staging.HandleEntry(kMessage);
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  multisink_.DetachStagingBuffer(staging);
+}
+
+TEST_F(MultiSinkTest, StagingBufferWrapsAround) {
+  std::array<std::byte, 41> staging_buffer;
+  MultiSink::StagingBuffer staging(staging_buffer);
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachStagingBuffer(staging);
+
+  // Stage entries of different sizes, so that they end at different offsets
+  // and some do not fit at the end of the buffer.
+  std::array<std::byte, 8> message;
+  for (size_t i = 0; i < 50; ++i) {
+    std::memset(message.data(), static_cast<int>(i), message.size());
+    const ConstByteSpan first = span(message).first(i % 8);
+    const ConstByteSpan second = span(message).first(8 - i % 8);
+    staging.HandleEntry(first);
+    staging.HandleEntry(second);
+    VerifyPopEntry(drains_[0], first, 0, 0);
+    VerifyPopEntry(drains_[0], second, 0, 0);
+  }
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 0);
+  multisink_.DetachStagingBuffer(staging);
+}
+
+TEST_F(MultiSinkTest, DetachStagingBufferMergesEntries) {
+  std::array<std::byte, 64> staging_buffer;
+  MultiSink::StagingBuffer staging(staging_buffer);
+  multisink_.AttachStagingBuffer(staging);
+  staging.HandleEntry(kMessage);
+  multisink_.DetachStagingBuffer(staging);
+
+  multisink_.AttachDrain(drains_[0]);
+  VerifyPopEntry(drains_[0], kMessage, 0, 0);
+  VerifyPopEntry(drains_[0], std::nullopt, 0, 0);
+}
+
 TEST(UnsafeIteration, NoLimit) {
   constexpr std::array<std::string_view, 5> kExpectedEntries{
       "one", "two", "three", "four", "five"};
@@ -181,6 +181,34 @@ class LogWriterThread : public thread::ThreadCore {
   const MessageSpan& message_stack_;
 };
 
+// Adds the provided messages to the shared multisink through a staging buffer.
+class StagedLogWriterThread : public thread::ThreadCore {
+ public:
+  StagedLogWriterThread(MultiSink& multisink, const MessageSpan& message_stack)
+      : multisink_(multisink),
+        staging_(staging_buffer_),
+        message_stack_(message_stack) {
+    multisink_.AttachStagingBuffer(staging_);
+  }
+
+  ~StagedLogWriterThread() override {
+    multisink_.DetachStagingBuffer(staging_);
+  }
+
+  void Run() override {
+    for (const auto& message : message_stack_) {
+      staging_.HandleEntry(as_bytes(span(std::string_view(message))));
+      pw::this_thread::yield();
+    }
+  }
+
+ private:
+  MultiSink& multisink_;
+  std::array<std::byte, kBufferSize> staging_buffer_{};
+  MultiSink::StagingBuffer staging_;
+  const MessageSpan& message_stack_;
+};
+
 class MultiSinkTest : public ::testing::Test {
  protected:
   MultiSinkTest() : multisink_(buffer_) {}
@@ -332,6 +360,46 @@ TEST_F(MultiSinkTest, MultipleWritersMultipleReaders) {
             expected_message_and_drop_count - drop_count);
 }
 
+TEST_F(MultiSinkTest, MultipleStagedWritersMultipleReaders) {
+  const uint32_t log_count = 100;
+  const uint32_t drop_count = 7;
+  const uint32_t expected_message_and_drop_count = 2 * log_count + drop_count;
+  const auto message_stack = MessagePool::Instance().GetMessages(log_count);
+
+  // Start reader threads.
+  LogPopReaderThread reader_thread_core1(multisink_,
+                                         expected_message_and_drop_count);
+  thread::Thread reader_thread1(test::MultiSinkTestThreadOptions(),
+                                reader_thread_core1);
+  LogPeekAndCommitReaderThread reader_thread_core2(
+      multisink_, expected_message_and_drop_count);
+  thread::Thread reader_thread2(test::MultiSinkTestThreadOptions(),
+                                reader_thread_core2);
+  // Start writer threads.
+  StagedLogWriterThread writer_thread_core1(multisink_, message_stack);
+  thread::Thread writer_thread1(test::MultiSinkTestThreadOptions(),
+                                writer_thread_core1);
+  StagedLogWriterThread writer_thread_core2(multisink_, message_stack);
+  thread::Thread writer_thread2(test::MultiSinkTestThreadOptions(),
+                                writer_thread_core2);
+
+  // Wait for writer thread to end.
+  writer_thread1.join();
+  writer_thread2.join();
+  multisink_.HandleDropped(drop_count);
+  multisink_.FlushStagingBuffers();
+  reader_thread1.join();
+  reader_thread2.join();
+
+  EXPECT_EQ(reader_thread_core1.drop_count(), drop_count);
+  EXPECT_EQ(reader_thread_core2.drop_count(), drop_count);
+  // Since we don't know the order that messages came in, we can't check them.
+  EXPECT_EQ(reader_thread_core1.received_messages().size(),
+            expected_message_and_drop_count - drop_count);
+  EXPECT_EQ(reader_thread_core2.received_messages().size(),
+            expected_message_and_drop_count - drop_count);
+}
+
 TEST_F(MultiSinkTest, OverflowMultisink) {
   // Expect the multisink to overflow and readers to not fail when poping, or
   // peeking and commiting entries.
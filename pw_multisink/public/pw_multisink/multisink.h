@@ -13,10 +13,13 @@
 // the License.
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <limits>
 #include <mutex>
 
 #include "pw_bytes/span.h"
+#include "pw_containers/intrusive_list.h"
 #include "pw_function/function.h"
 #include "pw_multisink/config.h"
 #include "pw_result/result.h"
@@ -238,6 +241,74 @@ class MultiSink {
     virtual void OnNewEntryAvailable() = 0;
   };
 
+  // A lock-free queue of entries waiting to be added to a MultiSink, attached
+  // via AttachStagingBuffer.
+  //
+  // Each StagingBuffer has a single writer, e.g. one per thread or per core,
+  // which adds entries with HandleEntry without taking the multisink's lock.
+  // Staged entries are moved into the multisink in the order they were
+  // staged, across all staging buffers, when FlushStagingBuffers is called or
+  // a drain peeks or pops. This lets threads that produce entries at high
+  // rates avoid contending on the multisink's lock.
+  class StagingBuffer : public IntrusiveList<StagingBuffer>::Item {
+   public:
+    // Constructs a staging buffer backed by the provided buffer. Each entry
+    // takes 8 bytes in addition to its data.
+    explicit StagingBuffer(ByteSpan buffer) : buffer_(buffer) {}
+
+    // Staging buffers are not copyable or movable.
+    StagingBuffer(const StagingBuffer&) = delete;
+    StagingBuffer& operator=(const StagingBuffer&) = delete;
+    StagingBuffer(StagingBuffer&&) = delete;
+    StagingBuffer& operator=(StagingBuffer&&) = delete;
+
+    // Stages an entry to be added to the multisink. If there is not enough
+    // space, the entry is dropped, and reported as an ingress drop.
+    //
+    // This function is lock-free, and may be called from an interrupt if the
+    // buffer is only written from that interrupt.
+    //
+    // Precondition: The staging buffer must be attached to a multisink.
+    // Precondition: Only one thread at a time may write to a staging buffer.
+    void HandleEntry(ConstByteSpan entry);
+
+    // Notifies the multisink of messages dropped before ingress, as with
+    // MultiSink::HandleDropped.
+    //
+    // Precondition: The staging buffer must be attached to a multisink.
+    void HandleDropped(uint32_t drop_count = 1) {
+      drop_count_.fetch_add(drop_count, std::memory_order_relaxed);
+    }
+
+   private:
+    friend MultiSink;
+
+    // Precedes the data of each staged entry.
+    struct Header {
+      uint32_t staging_id;
+      uint32_t size;
+    };
+
+    // Marks the unused space at the end of the buffer when an entry did not
+    // fit there.
+    static constexpr uint32_t kPadding = std::numeric_limits<uint32_t>::max();
+
+    // Reads the oldest staged entry. Returns false if there are none.
+    bool PeekFront(uint32_t& staging_id_out, ConstByteSpan& entry_out);
+
+    // Removes the entry returned by PeekFront.
+    void PopFront(ConstByteSpan entry);
+
+    const ByteSpan buffer_;
+    MultiSink* multisink_ = nullptr;
+
+    // Offsets of the oldest entry and of the space for the next one. The
+    // buffer is empty when they are equal, so one byte is always left unused.
+    std::atomic<size_t> read_offset_ = 0;
+    std::atomic<size_t> write_offset_ = 0;
+    std::atomic<uint32_t> drop_count_ = 0;
+  };
+
   class iterator {
    public:
     iterator& operator++() {
@@ -349,6 +420,30 @@ class MultiSink {
   // Precondition: The drain must be attached to this multisink.
   void DetachDrain(Drain& drain) PW_LOCKS_EXCLUDED(lock_);
 
+  // Attaches a staging buffer to the multisink, so that entries can be added
+  // to the multisink through it without locking.
+  //
+  // Precondition: The staging buffer must not be attached to a multisink.
+  void AttachStagingBuffer(StagingBuffer& staging_buffer)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Detaches a staging buffer from the multisink, after moving its staged
+  // entries into the multisink.
+  //
+  // Precondition: The staging buffer must be attached to this multisink, and
+  // must not be written to while it is detached.
+  void DetachStagingBuffer(StagingBuffer& staging_buffer)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Moves the entries and drop counts in all attached staging buffers into the
+  // multisink, in the order they were staged, and notifies the listeners if
+  // there were any. This takes time proportional to the number of staged
+  // entries, and should typically be called by a single thread that drains
+  // the multisink, e.g. periodically or before draining.
+  //
+  // Entries that are being staged concurrently may be moved by a later call.
+  void FlushStagingBuffers() PW_LOCKS_EXCLUDED(lock_);
+
   // Attach a listener to the multisink. The listener will be notified
   // immediately when attached, to allow late drain users to consume existing
   // entries. If draining in response to the notification, ensure that the drain
@@ -364,8 +459,9 @@ class MultiSink {
   // Precondition: The listener must be attached to this multisink.
   void DetachListener(Listener& listener) PW_LOCKS_EXCLUDED(lock_);
 
-  // Removes all data from the internal buffer. The multisink's sequence ID is
-  // not modified, so readers may interpret this event as droppping entries.
+  // Removes all data from the internal buffer, including staged entries. The
+  // multisink's sequence ID is not modified, so readers may interpret this
+  // event as droppping entries.
   void Clear() PW_LOCKS_EXCLUDED(lock_);
 
   // Uses MultiSink's unsafe iteration to dump the contents to a user-provided
@@ -415,11 +511,18 @@ class MultiSink {
   // Notifies attached listeners of new entries or an updated drop count.
   void NotifyListeners() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Moves staged entries and drop counts into the ring buffer. Returns true if
+  // there were any.
+  bool MergeStagingBuffers() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   IntrusiveList<Listener> listeners_ PW_GUARDED_BY(lock_);
+  IntrusiveList<StagingBuffer> staging_buffers_ PW_GUARDED_BY(lock_);
   ring_buffer::PrefixedEntryRingBufferMulti ring_buffer_ PW_GUARDED_BY(lock_);
   Drain oldest_entry_drain_ PW_GUARDED_BY(lock_);
   uint32_t sequence_id_ PW_GUARDED_BY(lock_);
   uint32_t total_ingress_drops_ PW_GUARDED_BY(lock_);
+  // Orders entries across staging buffers.
+  std::atomic<uint32_t> next_staging_id_ = 0;
   LockType lock_;
 };
 
@@ -12,7 +12,9 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 
 #include "pw_perf_test/perf_test.h"
 
@@ -54,5 +56,22 @@ PW_PERF_TEST(
     4);
 // DOCSTAG: [pw_perf_test_examples-lambda_example]
 
+// DOCSTAG: [pw_perf_test_examples-throughput_example]
+std::array<uint8_t, 1024> data;
+
+void Checksum(pw::perf_test::State& state) {
+  state.SetBytesProcessed(data.size());
+  volatile uint32_t checksum = 0;
+  while (state.KeepRunning()) {
+    uint32_t sum = 0;
+    for (uint8_t byte : data) {
+      sum += byte;
+    }
+    checksum = checksum + sum;
+  }
+}
+PW_PERF_TEST(Checksum1KiB, Checksum);
+// DOCSTAG: [pw_perf_test_examples-throughput_example]
+
 }  // namespace
 }  // namespace pw::perf_test
@@ -14,11 +14,23 @@
 
 #include "pw_perf_test/internal/framework.h"
 
+#include "pw_perf_test/config.h"
 #include "pw_perf_test/internal/test_info.h"
 #include "pw_perf_test/internal/timer.h"
 
 namespace pw::perf_test::internal {
 
+namespace {
+
+constexpr IterationConfig kIterationConfig = {
+    .warmup_iterations = PW_PERF_TEST_CONFIG_WARMUP_ITERATIONS,
+    .min_iterations = PW_PERF_TEST_CONFIG_MIN_ITERATIONS,
+    .max_iterations = PW_PERF_TEST_CONFIG_MAX_SAMPLES,
+    .target_duration = PW_PERF_TEST_CONFIG_TARGET_DURATION,
+};
+
+}  // namespace
+
 Framework Framework::framework_;
 
 int Framework::RunAllTests() {
@@ -30,7 +42,7 @@ int Framework::RunAllTests() {
 
   for (const TestInfo* test = tests_; test != nullptr; test = test->next()) {
     State test_state = internal::CreateState(
-        kDefaultIterations, *event_handler_, test->test_name());
+        kIterationConfig, *event_handler_, test->test_name());
     test->Run(test_state);
   }
   internal::TimerCleanup();
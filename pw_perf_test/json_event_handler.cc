@@ -0,0 +1,76 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_perf_test/json_event_handler.h"
+
+#include <cstdint>
+
+#include "pw_perf_test/internal/timer.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::perf_test {
+namespace {
+
+// Appends `str` as a JSON string.
+void AppendString(StringBuilder& json, const char* str) {
+  json << '"';
+  for (; *str != '\0'; ++str) {
+    const char c = *str;
+    if (c == '"' || c == '\\') {
+      json << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      json.Format("\\u%04x", static_cast<unsigned>(c));
+    } else {
+      json << c;
+    }
+  }
+  json << '"';
+}
+
+void AppendField(StringBuilder& json, const char* key, int64_t value) {
+  json << ",\"" << key << "\":" << value;
+}
+
+}  // namespace
+
+void JsonEventHandler::TestCaseEnd(const TestCase& info,
+                                   const Results& end_result) {
+  StringBuffer<kMaxLineSize> json;
+  json << "{\"name\":";
+  AppendString(json, info.name);
+  json << ",\"unit\":\"" << internal::GetDurationUnitStr() << '"';
+  AppendField(json, "iterations", end_result.iterations);
+  AppendField(json, "warmup_iterations", end_result.warmup_iterations);
+  AppendField(json, "mean", end_result.mean);
+  AppendField(json, "min", end_result.min);
+  AppendField(json, "max", end_result.max);
+  AppendField(json, "p50", end_result.p50);
+  AppendField(json, "p90", end_result.p90);
+  AppendField(json, "p99", end_result.p99);
+  AppendField(json, "trimmed_mean", end_result.trimmed_mean);
+  AppendField(json, "stddev", end_result.stddev);
+  AppendField(json, "outliers", end_result.outliers);
+  if (end_result.bytes_per_iteration != 0) {
+    AppendField(json, "bytes_per_iteration", end_result.bytes_per_iteration);
+  }
+  if (end_result.items_per_iteration != 0) {
+    AppendField(json, "items_per_iteration", end_result.items_per_iteration);
+  }
+  json << "}\n";
+  if (json.ok()) {
+    writer_.Write(json.data(), json.size()).IgnoreError();
+  }
+}
+
+}  // namespace pw::perf_test
@@ -0,0 +1,106 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_perf_test/json_event_handler.h"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "gtest/gtest.h"
+#include "pw_perf_test/internal/timer.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::perf_test {
+namespace {
+
+class JsonEventHandlerTest : public ::testing::Test {
+ protected:
+  JsonEventHandlerTest() : writer_(buffer_), handler_(writer_) {}
+
+  std::string_view output() const {
+    return std::string_view(reinterpret_cast<const char*>(writer_.data()),
+                            writer_.bytes_written());
+  }
+
+  // Appends the line expected for `MakeResults()` to `line`.
+  template <size_t kSize>
+  void Expect(StringBuffer<kSize>& line, const char* name, const char* extra) {
+    line << "{\"name\":" << name << ",\"unit\":\""
+         << internal::GetDurationUnitStr() << '"'
+         << ",\"iterations\":10,\"warmup_iterations\":1,\"mean\":100"
+         << ",\"min\":90,\"max\":130,\"p50\":99,\"p90\":110,\"p99\":130"
+         << ",\"trimmed_mean\":97,\"stddev\":5,\"outliers\":1" << extra << "}\n";
+  }
+
+  static Results MakeResults() {
+    Results results{};
+    results.mean = 100;
+    results.max = 130;
+    results.min = 90;
+    results.iterations = 10;
+    results.p50 = 99;
+    results.p90 = 110;
+    results.p99 = 130;
+    results.trimmed_mean = 97;
+    results.stddev = 5;
+    results.outliers = 1;
+    results.warmup_iterations = 1;
+    return results;
+  }
+
+  std::array<std::byte, 1024> buffer_{};
+  stream::MemoryWriter writer_;
+  JsonEventHandler handler_;
+};
+
+TEST_F(JsonEventHandlerTest, WritesOneLinePerTest) {
+  handler_.RunAllTestsStart(TestRunInfo{.total_tests = 2,
+                                        .default_iterations = 10});
+  handler_.TestCaseStart(TestCase{.name = "First"});
+  handler_.TestCaseIteration(IterationResult{.number = 1, .result = 100});
+  handler_.TestCaseEnd(TestCase{.name = "First"}, MakeResults());
+  handler_.TestCaseEnd(TestCase{.name = "Second"}, MakeResults());
+  handler_.RunAllTestsEnd();
+
+  StringBuffer<512> expected;
+  Expect(expected, "\"First\"", "");
+  Expect(expected, "\"Second\"", "");
+  EXPECT_EQ(output(), expected.view());
+}
+
+TEST_F(JsonEventHandlerTest, WritesThroughput) {
+  Results results = MakeResults();
+  results.bytes_per_iteration = 256;
+  results.items_per_iteration = 8;
+  handler_.TestCaseEnd(TestCase{.name = "Throughput"}, results);
+
+  StringBuffer<512> expected;
+  Expect(expected,
+         "\"Throughput\"",
+         ",\"bytes_per_iteration\":256,\"items_per_iteration\":8");
+  EXPECT_EQ(output(), expected.view());
+}
+
+TEST_F(JsonEventHandlerTest, EscapesName) {
+  handler_.TestCaseEnd(TestCase{.name = "a\"b\\c\n"}, MakeResults());
+
+  StringBuffer<512> expected;
+  Expect(expected, R"("a\"b\\c\u000a")", "");
+  EXPECT_EQ(output(), expected.view());
+}
+
+}  // namespace
+}  // namespace pw::perf_test
@@ -15,12 +15,31 @@
 
 #include "pw_perf_test/logging_event_handler.h"
 
+#include <cstdint>
+
 #include "pw_log/log.h"
 #include "pw_perf_test/event_handler.h"
 #include "pw_perf_test/googletest_style_event_handler.h"
 #include "pw_perf_test/internal/timer.h"
 
 namespace pw::perf_test {
+namespace {
+
+// Logs the rate of `amount` per second, or per million clock cycles, when each
+// iteration takes `mean`.
+void LogThroughput(int64_t amount, const char* name, int64_t mean) {
+  constexpr bool kNanoseconds =
+      internal::kDurationUnit == internal::DurationUnit::kNanoseconds;
+  constexpr double kPeriod = kNanoseconds ? 1e9 : 1e6;
+  const double rate = static_cast<double>(amount) * kPeriod /
+                      static_cast<double>(mean > 0 ? mean : 1);
+  PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_CASE_THROUGHPUT,
+              static_cast<long>(rate),
+              name,
+              kNanoseconds ? "second" : "million clock cycles");
+}
+
+}  // namespace
 
 void LoggingEventHandler::RunAllTestsStart(const TestRunInfo& summary) {
   PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_RUN_ALL_TESTS_START);
@@ -43,6 +62,24 @@ void LoggingEventHandler::TestCaseEnd(const TestCase& info,
               static_cast<long>(end_result.max),
               internal::GetDurationUnitStr(),
               end_result.iterations);
+  PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_CASE_PERCENTILES,
+              static_cast<long>(end_result.p50),
+              internal::GetDurationUnitStr(),
+              static_cast<long>(end_result.p90),
+              internal::GetDurationUnitStr(),
+              static_cast<long>(end_result.p99),
+              internal::GetDurationUnitStr(),
+              static_cast<long>(end_result.stddev),
+              internal::GetDurationUnitStr(),
+              static_cast<long>(end_result.trimmed_mean),
+              internal::GetDurationUnitStr(),
+              end_result.outliers);
+  if (end_result.bytes_per_iteration != 0) {
+    LogThroughput(end_result.bytes_per_iteration, "bytes", end_result.mean);
+  }
+  if (end_result.items_per_iteration != 0) {
+    LogThroughput(end_result.items_per_iteration, "items", end_result.mean);
+  }
   PW_LOG_INFO(PW_PERF_TEST_GOOGLESTYLE_CASE_END, info.name);
 }
 
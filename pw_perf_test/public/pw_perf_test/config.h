@@ -0,0 +1,46 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// The largest number of measured iterations in a test. The duration of each
+// iteration is kept to compute percentiles, so this sets the size of the
+// buffer in each `State`.
+#if !defined(PW_PERF_TEST_CONFIG_MAX_SAMPLES)
+#define PW_PERF_TEST_CONFIG_MAX_SAMPLES 100
+#endif  // !defined(PW_PERF_TEST_CONFIG_MAX_SAMPLES)
+
+// The number of iterations run before measurement starts, to warm up caches
+// and branch predictors. The durations of these iterations are not reported.
+#if !defined(PW_PERF_TEST_CONFIG_WARMUP_ITERATIONS)
+#define PW_PERF_TEST_CONFIG_WARMUP_ITERATIONS 1
+#endif  // !defined(PW_PERF_TEST_CONFIG_WARMUP_ITERATIONS)
+
+// The smallest number of measured iterations in a test.
+#if !defined(PW_PERF_TEST_CONFIG_MIN_ITERATIONS)
+#define PW_PERF_TEST_CONFIG_MIN_ITERATIONS 10
+#endif  // !defined(PW_PERF_TEST_CONFIG_MIN_ITERATIONS)
+
+// The total time, in units of the timer backend, that the measured iterations
+// of a test should take. The number of iterations is calibrated from the
+// duration of the warmup iterations, between the minimum and the number of
+// samples. If this is 0, or there are no warmup iterations, the minimum number
+// of iterations are run.
+#if !defined(PW_PERF_TEST_CONFIG_TARGET_DURATION)
+#define PW_PERF_TEST_CONFIG_TARGET_DURATION 100000000
+#endif  // !defined(PW_PERF_TEST_CONFIG_TARGET_DURATION)
+
+static_assert(PW_PERF_TEST_CONFIG_MIN_ITERATIONS > 0);
+static_assert(PW_PERF_TEST_CONFIG_MIN_ITERATIONS <=
+              PW_PERF_TEST_CONFIG_MAX_SAMPLES);
+static_assert(PW_PERF_TEST_CONFIG_WARMUP_ITERATIONS >= 0);
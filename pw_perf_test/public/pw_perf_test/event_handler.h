@@ -23,17 +23,47 @@ struct IterationResult {
   int64_t result;
 };
 
-/// Data reported upon the completion of an iteration.
+/// Data reported upon the completion of a performance test.
+///
+/// Durations are in the unit of the timer backend.
 struct Results {
+  /// Mean duration of the iterations.
   int64_t mean;
   int64_t max;
   int64_t min;
+
+  /// Number of measured iterations.
   int iterations;
+
+  /// Percentiles of the iteration durations.
+  int64_t p50 = 0;
+  int64_t p90 = 0;
+  int64_t p99 = 0;
+
+  /// Mean and standard deviation of the iteration durations, excluding
+  /// outliers.
+  int64_t trimmed_mean = 0;
+  int64_t stddev = 0;
+
+  /// Number of iterations more than 1.5 times the interquartile range outside
+  /// of the first and third quartiles. These are excluded from the trimmed
+  /// mean and standard deviation.
+  int outliers = 0;
+
+  /// Number of iterations run before measuring.
+  int warmup_iterations = 0;
+
+  /// Amount of work done by each iteration, as set by the test. 0 if unset.
+  int64_t bytes_per_iteration = 0;
+  int64_t items_per_iteration = 0;
 };
 
 /// Stores information on the upcoming collection of tests.
 struct TestRunInfo {
   int total_tests;
+
+  /// The smallest number of measured iterations of each test. Tests that run
+  /// quickly are run for more iterations.
   int default_iterations;
 };
 
@@ -16,12 +16,17 @@
 #define PW_PERF_TEST_GOOGLESTYLE_RUN_ALL_TESTS_START \
   "[==========] Running all tests."
 #define PW_PERF_TEST_GOOGLESTYLE_BEGINNING_SUMMARY \
-  "[ PLANNING ] %d test(s) with %d run(s) each."
+  "[ PLANNING ] %d test(s) with at least %d run(s) each."
 #define PW_PERF_TEST_GOOGLESTYLE_RUN_ALL_TESTS_END \
   "[==========] Done running all tests."
 
 #define PW_PERF_TEST_GOOGLESTYLE_CASE_START "[ RUN      ] %s"
 #define PW_PERF_TEST_GOOGLESTYLE_CASE_RESULT \
   "[  RESULT  ] MEAN: %ld %s, MIN: %ld %s, MAX: %ld %s, ITERATIONS: %d"
+#define PW_PERF_TEST_GOOGLESTYLE_CASE_PERCENTILES                            \
+  "[  RESULT  ] P50: %ld %s, P90: %ld %s, P99: %ld %s, STDDEV: %ld %s, " \
+  "TRIMMED MEAN: %ld %s, OUTLIERS: %d"
+#define PW_PERF_TEST_GOOGLESTYLE_CASE_THROUGHPUT \
+  "[  RESULT  ] THROUGHPUT: %ld %s per %s"
 #define PW_PERF_TEST_GOOGLESTYLE_CASE_END "[     DONE ] %s"
 #define PW_PERF_TEST_GOOGLESTYLE_ITERATION_REPORT "[ Iteration ] #%ld: %ld %s"
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include "pw_perf_test/config.h"
 #include "pw_perf_test/event_handler.h"
 
 namespace pw::perf_test::internal {
@@ -28,7 +29,8 @@ class Framework {
   constexpr Framework()
       : event_handler_(nullptr),
         tests_(nullptr),
-        run_info_{.total_tests = 0, .default_iterations = kDefaultIterations} {}
+        run_info_{.total_tests = 0,
+                  .default_iterations = PW_PERF_TEST_CONFIG_MIN_ITERATIONS} {}
 
   static Framework& Get() { return framework_; }
 
@@ -41,8 +43,6 @@ class Framework {
   int RunAllTests();
 
  private:
-  static constexpr int kDefaultIterations = 10;
-
   EventHandler* event_handler_;
 
   // Pointer to the list of tests
@@ -0,0 +1,50 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_perf_test/event_handler.h"
+#include "pw_stream/stream.h"
+
+namespace pw::perf_test {
+
+/// An event handler that writes the results of each test as a line of JSON.
+///
+/// Each line is an object with the test's name, the duration unit of the
+/// timer, and each field of `Results`. Lines that do not start with `{` are
+/// not results, so the output can be mixed with logs and still be parsed, for
+/// example by `pw_perf_test.compare`:
+///
+/// @code{.json}
+///   {"name":"Foo","unit":"ns","iterations":10,"warmup_iterations":1,...}
+/// @endcode
+class JsonEventHandler : public EventHandler {
+ public:
+  /// Longest line that can be written. Results of tests with long names that
+  /// do not fit are dropped.
+  static constexpr size_t kMaxLineSize = 512;
+
+  explicit constexpr JsonEventHandler(stream::Writer& writer)
+      : writer_(writer) {}
+
+  void RunAllTestsStart(const TestRunInfo&) override {}
+  void RunAllTestsEnd() override {}
+  void TestCaseStart(const TestCase&) override {}
+  void TestCaseEnd(const TestCase& info, const Results& end_result) override;
+  void TestCaseIteration(const IterationResult&) override {}
+
+ private:
+  stream::Writer& writer_;
+};
+
+}  // namespace pw::perf_test
@@ -13,12 +13,14 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstdint>
-#include <limits>
 
 #include "pw_assert/assert.h"
+#include "pw_perf_test/config.h"
 #include "pw_perf_test/event_handler.h"
 #include "pw_perf_test/internal/timer.h"
+#include "pw_span/span.h"
 
 namespace pw::perf_test {
 
@@ -27,58 +29,109 @@ class State;
 
 namespace internal {
 
+// Controls how many iterations of a test are run.
+struct IterationConfig {
+  // Iterations that are run, but not measured, before the measured ones.
+  int warmup_iterations;
+
+  // Bounds on the number of measured iterations.
+  int min_iterations;
+  int max_iterations;
+
+  // Total duration that the measured iterations should take, used to choose
+  // the number of iterations from the duration of the warmup iterations. If
+  // this is 0, `min_iterations` are run.
+  int64_t target_duration;
+};
+
 // Allows access to the private State object constructor
 State CreateState(int durations,
                   EventHandler& event_handler,
                   const char* test_name);
 
+State CreateState(const IterationConfig& config,
+                  EventHandler& event_handler,
+                  const char* test_name);
+
+// Computes the statistics of the iteration durations in `samples`, which must
+// not be empty. Sorts `samples`. Only the fields of `Results` that describe
+// the durations are set.
+Results ComputeStatistics(span<int64_t> samples);
+
 }  // namespace internal
 
 /// Records the performance of a test case over many iterations.
+///
+/// A number of warmup iterations are run first, and are not measured. Their
+/// duration is used to choose how many iterations to measure, so that fast
+/// tests collect more samples. The duration of each measured iteration is kept
+/// to report its distribution when the test ends.
 class State {
  public:
+  /// The largest number of measured iterations.
+  static constexpr int kMaxSamples = PW_PERF_TEST_CONFIG_MAX_SAMPLES;
+
   // KeepRunning() should be called in a while loop. Responsible for managing
   // iterations and timestamps.
   bool KeepRunning();
 
+  /// Sets the number of bytes processed by each iteration, to report the
+  /// test's throughput. Must be called before the loop ends.
+  void SetBytesProcessed(int64_t bytes) { bytes_per_iteration_ = bytes; }
+
+  /// Sets the number of items processed by each iteration, to report the
+  /// test's throughput. Must be called before the loop ends.
+  void SetItemsProcessed(int64_t items) { items_per_iteration_ = items; }
+
  private:
   // Allows the framework to create state objects and unit tests for the state
   // class
-  friend State internal::CreateState(int durations,
+  friend State internal::CreateState(const internal::IterationConfig& config,
                                      EventHandler& event_handler,
                                      const char* test_name);
 
   // Privated constructor to prevent unauthorized instances of the state class.
-  constexpr State(int iterations,
+  constexpr State(const internal::IterationConfig& config,
                   EventHandler& event_handler,
                   const char* test_name)
-      : test_iterations_(iterations),
+      : config_(config),
+        test_iterations_(config.min_iterations),
+        current_iteration_(-config.warmup_iterations - 1),
         iteration_start_(),
         event_handler_(&event_handler),
         test_info{.name = test_name} {
-    PW_ASSERT(test_iterations_ > 0);
+    PW_ASSERT(config_.warmup_iterations >= 0);
+    PW_ASSERT(config_.min_iterations > 0);
+    PW_ASSERT(config_.min_iterations <= config_.max_iterations);
+    PW_ASSERT(config_.max_iterations <= kMaxSamples);
   }
 
-  int64_t mean_ = -1;
+  // Sets the number of measured iterations, once warmup is done.
+  void Calibrate();
+
+  // Computes the results of the measured iterations. Reorders `samples_`.
+  Results ComputeResults();
 
-  // Stores the total number of iterations wanted
+  internal::IterationConfig config_;
+
+  // Stores the total number of measured iterations wanted
   int test_iterations_;
 
-  // Stores the total duration of the tests.
-  int64_t total_duration_ = 0;
+  // Total duration of the warmup iterations.
+  int64_t warmup_duration_ = 0;
+
+  // Duration of each measured iteration.
+  std::array<int64_t, kMaxSamples> samples_{};
 
-  // Smallest value of the iterations
-  int64_t min_ = std::numeric_limits<int64_t>::max();
+  int64_t bytes_per_iteration_ = 0;
+  int64_t items_per_iteration_ = 0;
 
-  // Largest value of the iterations
-  int64_t max_ = std::numeric_limits<int64_t>::min();
+  // The current iteration. Negative while warming up.
+  int current_iteration_;
 
   // Time at the start of the iteration
   internal::Timestamp iteration_start_;
 
-  // The current iteration.
-  int current_iteration_ = -1;
-
   EventHandler* event_handler_;
 
   TestCase test_info;
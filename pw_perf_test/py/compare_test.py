@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for comparing perf test results."""
+
+import unittest
+
+from pw_perf_test.compare import compare, parse_results
+
+
+def _result(name: str, mean: int, unit: str = 'ns') -> str:
+    return (
+        f'{{"name":"{name}","unit":"{unit}","iterations":10,'
+        f'"warmup_iterations":1,"mean":{mean},"min":{mean},"max":{mean},'
+        f'"p50":{mean},"p90":{mean},"p99":{mean},"trimmed_mean":{mean},'
+        f'"stddev":0,"outliers":0}}'
+    )
+
+
+class CompareTest(unittest.TestCase):
+    """Tests for comparing perf test results."""
+
+    def test_parse_ignores_logs(self):
+        results = parse_results(
+            [
+                'INF  [ RUN      ] Foo',
+                _result('Foo', 100) + '\n',
+                '{not json',
+                '{"no_name": 1}',
+                _result('Bar', 200),
+            ]
+        )
+        self.assertEqual(sorted(results), ['Bar', 'Foo'])
+        self.assertEqual(results['Foo']['mean'], 100)
+
+    def test_regression_past_threshold(self):
+        baseline = parse_results([_result('Foo', 100), _result('Bar', 100)])
+        current = parse_results([_result('Foo', 104), _result('Bar', 110)])
+        comparisons = {c.name: c for c in compare(baseline, current)}
+        self.assertFalse(comparisons['Foo'].regressed(5.0))
+        self.assertTrue(comparisons['Bar'].regressed(5.0))
+        self.assertAlmostEqual(comparisons['Bar'].change_percent, 10.0)
+
+    def test_improvement_is_not_regression(self):
+        baseline = parse_results([_result('Foo', 100)])
+        current = parse_results([_result('Foo', 50)])
+        (comparison,) = compare(baseline, current)
+        self.assertFalse(comparison.regressed(0.0))
+        self.assertAlmostEqual(comparison.change_percent, -50.0)
+
+    def test_skips_unmatched_tests(self):
+        baseline = parse_results([_result('Foo', 100), _result('Old', 100)])
+        current = parse_results(
+            [_result('Foo', 100, unit='clock cycles'), _result('New', 100)]
+        )
+        self.assertEqual(compare(baseline, current), [])
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,171 @@
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Compares perf test results against a baseline.
+
+Reads the output of perf tests run with the JSON event handler, and fails if
+any test is slower than in the baseline by more than a threshold. Lines of the
+output that are not JSON results, such as logs, are ignored.
+
+  python -m pw_perf_test.compare baseline.txt current.txt --threshold 5
+"""
+
+import argparse
+from dataclasses import dataclass
+import json
+import logging
+from pathlib import Path
+import sys
+from typing import Dict, Iterable, List, Optional
+
+import pw_cli.log
+
+_LOG = logging.getLogger(__package__)
+
+METRICS = ('mean', 'trimmed_mean', 'min', 'max', 'p50', 'p90', 'p99')
+
+
+@dataclass
+class Comparison:
+    """The change in a metric of a test from its baseline."""
+
+    name: str
+    unit: str
+    baseline: int
+    current: int
+
+    @property
+    def change_percent(self) -> float:
+        if self.baseline == 0:
+            return 0.0 if self.current == 0 else float('inf')
+        return (self.current - self.baseline) * 100.0 / self.baseline
+
+    def regressed(self, threshold_percent: float) -> bool:
+        return self.change_percent > threshold_percent
+
+
+def parse_results(lines: Iterable[str]) -> Dict[str, dict]:
+    """Returns the results in perf test output, by test name."""
+    results: Dict[str, dict] = {}
+    for line in lines:
+        line = line.strip()
+        if not line.startswith('{'):
+            continue
+        try:
+            result = json.loads(line)
+        except json.JSONDecodeError:
+            continue
+        if isinstance(result, dict) and 'name' in result:
+            results[result['name']] = result
+    return results
+
+
+def compare(
+    baseline: Dict[str, dict], current: Dict[str, dict], metric: str = 'mean'
+) -> List[Comparison]:
+    """Compares a metric of the tests that are in both sets of results.
+
+    Tests measured in different units are skipped.
+    """
+    comparisons: List[Comparison] = []
+    for name, result in current.items():
+        base: Optional[dict] = baseline.get(name)
+        if base is None:
+            _LOG.info('%s: not in the baseline', name)
+            continue
+        if base.get('unit') != result.get('unit'):
+            _LOG.warning(
+                '%s: measured in %s, but the baseline is in %s',
+                name,
+                result.get('unit'),
+                base.get('unit'),
+            )
+            continue
+        comparisons.append(
+            Comparison(name, result['unit'], base[metric], result[metric])
+        )
+    for name in baseline.keys() - current.keys():
+        _LOG.warning('%s: in the baseline, but was not run', name)
+    return comparisons
+
+
+def _parse_args() -> argparse.Namespace:
+    """Parses the script's arguments."""
+
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+    )
+    parser.add_argument(
+        'baseline',
+        type=Path,
+        help='Perf test output to compare against',
+    )
+    parser.add_argument(
+        'current',
+        type=Path,
+        help='Perf test output to check',
+    )
+    parser.add_argument(
+        '--threshold',
+        type=float,
+        default=5.0,
+        help='Largest allowed increase in the metric, in percent',
+    )
+    parser.add_argument(
+        '--metric',
+        choices=METRICS,
+        default='mean',
+        help='Result to compare',
+    )
+
+    return parser.parse_args()
+
+
+def main(baseline: Path, current: Path, threshold: float, metric: str) -> int:
+    with baseline.open() as file:
+        baseline_results = parse_results(file)
+    with current.open() as file:
+        current_results = parse_results(file)
+
+    if not current_results:
+        _LOG.error('No perf test results in %s', current)
+        return 1
+
+    regressions = 0
+    for comparison in compare(baseline_results, current_results, metric):
+        log = _LOG.info
+        if comparison.regressed(threshold):
+            log = _LOG.error
+            regressions += 1
+        log(
+            '%s: %s %d -> %d %s (%+.1f%%)',
+            comparison.name,
+            metric,
+            comparison.baseline,
+            comparison.current,
+            comparison.unit,
+            comparison.change_percent,
+        )
+
+    if regressions:
+        _LOG.error(
+            '%d test(s) regressed by more than %.1f%%', regressions, threshold
+        )
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    pw_cli.log.install()
+    sys.exit(main(**vars(_parse_args())))
@@ -14,7 +14,11 @@
 
 #include "pw_perf_test/state.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "pw_log/log.h"
+#include "pw_span/span.h"
 
 namespace pw::perf_test {
 namespace internal {
@@ -22,45 +26,141 @@ namespace internal {
 State CreateState(int durations,
                   EventHandler& event_handler,
                   const char* test_name) {
-  return State(durations, event_handler, test_name);
+  return CreateState(IterationConfig{.warmup_iterations = 0,
+                                     .min_iterations = durations,
+                                     .max_iterations = durations,
+                                     .target_duration = 0},
+                     event_handler,
+                     test_name);
+}
+
+State CreateState(const IterationConfig& config,
+                  EventHandler& event_handler,
+                  const char* test_name) {
+  return State(config, event_handler, test_name);
+}
+
+namespace {
+
+// Returns the nearest-rank percentile of the sorted `samples`.
+int64_t Percentile(span<const int64_t> samples, int percent) {
+  const size_t rank =
+      (samples.size() * static_cast<size_t>(percent) + 99) / 100;
+  return samples[rank == 0 ? 0 : rank - 1];
+}
+
+}  // namespace
+
+Results ComputeStatistics(span<int64_t> samples) {
+  PW_ASSERT(!samples.empty());
+  std::sort(samples.begin(), samples.end());
+
+  Results results{};
+  results.iterations = static_cast<int>(samples.size());
+  results.min = samples.front();
+  results.max = samples.back();
+  results.p50 = Percentile(samples, 50);
+  results.p90 = Percentile(samples, 90);
+  results.p99 = Percentile(samples, 99);
+
+  // Exclude outliers using Tukey's fences. The median is always inside them.
+  const int64_t q1 = Percentile(samples, 25);
+  const int64_t q3 = Percentile(samples, 75);
+  const int64_t fence = (q3 - q1) * 3 / 2;
+  int64_t all_total = 0;
+  int64_t total = 0;
+  int count = 0;
+  for (int64_t sample : samples) {
+    all_total += sample;
+    if (sample < q1 - fence || sample > q3 + fence) {
+      ++results.outliers;
+    } else {
+      total += sample;
+      ++count;
+    }
+  }
+  results.mean = all_total / static_cast<int64_t>(samples.size());
+  results.trimmed_mean = total / count;
+
+  double variance = 0;
+  if (count > 1) {
+    const double mean = static_cast<double>(total) / count;
+    for (int64_t sample : samples) {
+      if (sample >= q1 - fence && sample <= q3 + fence) {
+        const double deviation = static_cast<double>(sample) - mean;
+        variance += deviation * deviation;
+      }
+    }
+    variance /= count - 1;
+  }
+  results.stddev = static_cast<int64_t>(std::sqrt(variance));
+  return results;
 }
+
 }  // namespace internal
 
 bool State::KeepRunning() {
   internal::Timestamp iteration_end = internal::GetCurrentTimestamp();
-  if (current_iteration_ == -1) {
+  if (current_iteration_ < -config_.warmup_iterations) {
     ++current_iteration_;
     event_handler_->TestCaseStart(test_info);
+    if (current_iteration_ == 0) {
+      Calibrate();
+    }
     iteration_start_ = internal::GetCurrentTimestamp();
     return true;
   }
   int64_t duration = internal::GetDuration(iteration_start_, iteration_end);
-  if (duration > max_) {
-    max_ = duration;
-  }
-  if (duration < min_) {
-    min_ = duration;
+  if (current_iteration_ < 0) {
+    warmup_duration_ += duration;
+    ++current_iteration_;
+    if (current_iteration_ == 0) {
+      Calibrate();
+    }
+    iteration_start_ = internal::GetCurrentTimestamp();
+    return true;
   }
-  total_duration_ += duration;
+  samples_[static_cast<size_t>(current_iteration_)] = duration;
   ++current_iteration_;
   PW_LOG_DEBUG("Iteration number: %d - Duration: %ld",
                current_iteration_,
                static_cast<long>(duration));
   event_handler_->TestCaseIteration({current_iteration_, duration});
   if (current_iteration_ == test_iterations_) {
-    PW_LOG_DEBUG("Total Duration: %ld  Total Iterations: %d",
-                 static_cast<long>(total_duration_),
-                 test_iterations_);
-    mean_ = total_duration_ / test_iterations_;
-    PW_LOG_DEBUG("Mean: %ld: ", static_cast<long>(mean_));
-    PW_LOG_DEBUG("Minimum: %ld", static_cast<long>(min_));
-    PW_LOG_DEBUG("Maxmimum: %ld", static_cast<long>(max_));
-    event_handler_->TestCaseEnd(test_info,
-                                Results{mean_, max_, min_, test_iterations_});
+    const Results results = ComputeResults();
+    PW_LOG_DEBUG("Mean: %ld: ", static_cast<long>(results.mean));
+    PW_LOG_DEBUG("Minimum: %ld", static_cast<long>(results.min));
+    PW_LOG_DEBUG("Maxmimum: %ld", static_cast<long>(results.max));
+    event_handler_->TestCaseEnd(test_info, results);
     return false;
   }
   iteration_start_ = internal::GetCurrentTimestamp();
   return true;
 }
 
+void State::Calibrate() {
+  if (config_.target_duration <= 0 || config_.warmup_iterations == 0) {
+    return;
+  }
+  const int64_t per_iteration =
+      std::max<int64_t>(warmup_duration_ / config_.warmup_iterations, 1);
+  const int64_t iterations =
+      std::clamp<int64_t>(config_.target_duration / per_iteration,
+                          config_.min_iterations,
+                          config_.max_iterations);
+  test_iterations_ = static_cast<int>(iterations);
+  PW_LOG_DEBUG("Warmup duration: %ld  Iterations: %d",
+               static_cast<long>(warmup_duration_),
+               test_iterations_);
+}
+
+Results State::ComputeResults() {
+  Results results = internal::ComputeStatistics(
+      span(samples_.data(), static_cast<size_t>(test_iterations_)));
+  results.warmup_iterations = config_.warmup_iterations;
+  results.bytes_per_iteration = bytes_per_iteration_;
+  results.items_per_iteration = items_per_iteration_;
+  return results;
+}
+
 }  // namespace pw::perf_test
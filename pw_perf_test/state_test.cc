@@ -14,6 +14,9 @@
 
 #include "pw_perf_test/state.h"
 
+#include <array>
+#include <cstdint>
+
 #include "gtest/gtest.h"
 #include "pw_perf_test/event_handler.h"
 
@@ -29,6 +32,22 @@ class EmptyEventHandler : public EventHandler {
   void RunAllTestsEnd() override {}
 };
 
+// Records the events reported for a test.
+class RecordingEventHandler : public EmptyEventHandler {
+ public:
+  void TestCaseEnd(const TestCase&, const Results& results) override {
+    results_ = results;
+  }
+  void TestCaseIteration(const IterationResult&) override { ++iterations_; }
+
+  const Results& results() const { return results_; }
+  int iterations() const { return iterations_; }
+
+ private:
+  Results results_{};
+  int iterations_ = 0;
+};
+
 EmptyEventHandler handler;
 
 void TestFunction() {
@@ -58,5 +77,145 @@ TEST(StateTest, SingleTest) {
   EXPECT_EQ(total_iterations, test_iterations);
 }
 
+TEST(StateTest, WarmupIterationsAreNotReported) {
+  RecordingEventHandler recorder;
+  State state_obj = internal::CreateState(
+      internal::IterationConfig{.warmup_iterations = 2,
+                                .min_iterations = 5,
+                                .max_iterations = 5,
+                                .target_duration = 0},
+      recorder,
+      "");
+  int total_iterations = 0;
+  while (state_obj.KeepRunning()) {
+    ++total_iterations;
+    TestFunction();
+  }
+  EXPECT_EQ(total_iterations, 7);
+  EXPECT_EQ(recorder.iterations(), 5);
+  EXPECT_EQ(recorder.results().iterations, 5);
+  EXPECT_EQ(recorder.results().warmup_iterations, 2);
+}
+
+TEST(StateTest, CalibratesIterationsToTargetDuration) {
+  RecordingEventHandler recorder;
+  State state_obj = internal::CreateState(
+      internal::IterationConfig{.warmup_iterations = 1,
+                                .min_iterations = 2,
+                                .max_iterations = 20,
+                                .target_duration = INT64_MAX},
+      recorder,
+      "");
+  int total_iterations = 0;
+  while (state_obj.KeepRunning()) {
+    ++total_iterations;
+    TestFunction();
+  }
+  EXPECT_EQ(total_iterations, 21);
+  EXPECT_EQ(recorder.results().iterations, 20);
+}
+
+TEST(StateTest, CalibratesIterationsToMinimum) {
+  RecordingEventHandler recorder;
+  State state_obj = internal::CreateState(
+      internal::IterationConfig{.warmup_iterations = 1,
+                                .min_iterations = 2,
+                                .max_iterations = 20,
+                                .target_duration = 1},
+      recorder,
+      "");
+  int total_iterations = 0;
+  while (state_obj.KeepRunning()) {
+    ++total_iterations;
+    TestFunction();
+  }
+  EXPECT_EQ(total_iterations, 3);
+  EXPECT_EQ(recorder.results().iterations, 2);
+}
+
+TEST(StateTest, ReportsStatistics) {
+  RecordingEventHandler recorder;
+  State state_obj = internal::CreateState(20, recorder, "");
+  state_obj.SetBytesProcessed(64);
+  state_obj.SetItemsProcessed(4);
+  while (state_obj.KeepRunning()) {
+    TestFunction();
+  }
+  const Results& results = recorder.results();
+  EXPECT_EQ(results.iterations, 20);
+  EXPECT_LE(results.min, results.p50);
+  EXPECT_LE(results.p50, results.p90);
+  EXPECT_LE(results.p90, results.p99);
+  EXPECT_EQ(results.p99, results.max);
+  EXPECT_EQ(results.bytes_per_iteration, 64);
+  EXPECT_EQ(results.items_per_iteration, 4);
+}
+
+TEST(StateTest, ComputeStatisticsOfRange) {
+  // 100, 99, ..., 1.
+  std::array<int64_t, 100> samples;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    samples[i] = static_cast<int64_t>(samples.size() - i);
+  }
+  const Results results = internal::ComputeStatistics(samples);
+  EXPECT_EQ(results.iterations, 100);
+  EXPECT_EQ(results.min, 1);
+  EXPECT_EQ(results.max, 100);
+  EXPECT_EQ(results.p50, 50);
+  EXPECT_EQ(results.p90, 90);
+  EXPECT_EQ(results.p99, 99);
+  EXPECT_EQ(results.outliers, 0);
+  EXPECT_EQ(results.mean, 50);
+  EXPECT_EQ(results.trimmed_mean, 50);
+  EXPECT_EQ(results.stddev, 29);  // sqrt(841.67)
+
+  // The samples are sorted.
+  EXPECT_EQ(samples.front(), 1);
+  EXPECT_EQ(samples.back(), 100);
+}
+
+TEST(StateTest, ComputeStatisticsExcludesOutliers) {
+  // The first and third quartiles are 100 and 120, so samples outside of
+  // [70, 150] are outliers.
+  std::array<int64_t, 10> samples = {
+      100, 120, 110, 130, 100, 110, 120, 1000, 110, 100};
+  const Results results = internal::ComputeStatistics(samples);
+  EXPECT_EQ(results.iterations, 10);
+  EXPECT_EQ(results.min, 100);
+  EXPECT_EQ(results.max, 1000);
+  EXPECT_EQ(results.p50, 110);
+  EXPECT_EQ(results.p90, 130);
+  EXPECT_EQ(results.p99, 1000);
+  EXPECT_EQ(results.outliers, 1);
+  EXPECT_EQ(results.mean, 200);          // 2000 / 10
+  EXPECT_EQ(results.trimmed_mean, 111);  // 1000 / 9
+  EXPECT_EQ(results.stddev, 10);         // sqrt(111.1)
+}
+
+TEST(StateTest, ComputeStatisticsExcludesLowOutliers) {
+  std::array<int64_t, 8> samples = {50, 50, 50, 50, 50, 50, 50, 2};
+  const Results results = internal::ComputeStatistics(samples);
+  EXPECT_EQ(results.min, 2);
+  EXPECT_EQ(results.p50, 50);
+  EXPECT_EQ(results.outliers, 1);
+  EXPECT_EQ(results.mean, 44);  // 352 / 8
+  EXPECT_EQ(results.trimmed_mean, 50);
+  EXPECT_EQ(results.stddev, 0);
+}
+
+TEST(StateTest, ComputeStatisticsOfOneSample) {
+  std::array<int64_t, 1> samples = {42};
+  const Results results = internal::ComputeStatistics(samples);
+  EXPECT_EQ(results.iterations, 1);
+  EXPECT_EQ(results.min, 42);
+  EXPECT_EQ(results.max, 42);
+  EXPECT_EQ(results.p50, 42);
+  EXPECT_EQ(results.p99, 42);
+  EXPECT_EQ(results.outliers, 0);
+  EXPECT_EQ(results.mean, 42);
+  EXPECT_EQ(results.trimmed_mean, 42);
+  EXPECT_EQ(results.stddev, 0);
+}
+
 }  // namespace
 }  // namespace pw::perf_test
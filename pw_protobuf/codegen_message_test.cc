@@ -35,6 +35,7 @@
 #include "pw_protobuf_test_protos/importer.pwpb.h"
 #include "pw_protobuf_test_protos/optional.pwpb.h"
 #include "pw_protobuf_test_protos/repeated.pwpb.h"
+#include "pw_protobuf_test_protos/wide.pwpb.h"
 
 namespace pw::protobuf {
 namespace {
@@ -393,6 +394,105 @@ TEST(CodegenMessage, Read) {
   EXPECT_EQ(message.bungle, -111);
 }
 
+TEST(CodegenMessage, ReadOutOfOrder) {
+  // clang-format off
+  constexpr uint8_t proto_data[] = {
+    // pigweed.bungle
+    0x70, 0x91, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01,
+    // pigweed.bin
+    0x40, 0x01,
+    // unknown field 15
+    0x78, 0x2a,
+    // pigweed.ratio
+    0x25, 0x8f, 0xc2, 0xb5, 0xbf,
+    // pigweed.cycles
+    0x19, 0xde, 0xad, 0xca, 0xfe, 0x10, 0x20, 0x30, 0x40,
+    // pigweed.ziggy
+    0x10, 0xdd, 0x01,
+    // pigweed.magic_number
+    0x08, 0x49,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(proto_data)));
+  Pigweed::StreamDecoder pigweed(reader);
+
+  Pigweed::Message message{};
+  const auto status = pigweed.Read(message);
+  ASSERT_EQ(status, OkStatus());
+
+  EXPECT_EQ(message.magic_number, 0x49u);
+  EXPECT_EQ(message.ziggy, -111);
+  EXPECT_EQ(message.cycles, 0x40302010fecaaddeu);
+  EXPECT_EQ(message.ratio, -1.42f);
+  EXPECT_EQ(message.bin, Pigweed::Protobuf::Binary::ZERO);
+  EXPECT_EQ(message.bungle, -111);
+}
+
+TEST(CodegenMessage, ReadSparseFieldsOutOfOrder) {
+  // clang-format off
+  constexpr uint8_t proto_data[] = {
+    // field_500000, v=7
+    0x80, 0x92, 0xf4, 0x01, 0x07,
+    // unknown field 400000, v=1
+    0x80, 0xa8, 0xc3, 0x01, 0x01,
+    // field_20, v=3
+    0xa0, 0x01, 0x03,
+    // field_1000, v=5
+    0xc0, 0x3e, 0x05,
+    // unknown field 600000, v=1
+    0x80, 0xfc, 0xa4, 0x02, 0x01,
+    // field_1, v=1
+    0x08, 0x01,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(proto_data)));
+  SparseMessage::StreamDecoder sparse(reader);
+
+  SparseMessage::Message message{};
+  ASSERT_EQ(sparse.Read(message), OkStatus());
+
+  EXPECT_EQ(message.field_1, 1u);
+  EXPECT_EQ(message.field_5, 0u);
+  EXPECT_EQ(message.field_20, 3u);
+  EXPECT_EQ(message.field_1000, 5u);
+  EXPECT_EQ(message.field_500000, 7u);
+}
+
+TEST(CodegenMessage, ReadNonPackedScalarInterleaved) {
+  // clang-format off
+  constexpr uint8_t proto_data[] = {
+    // uint32s[], v={0, 16}
+    0x08, 0x00,
+    0x08, 0x10,
+    // fixed32s[]. v={0}
+    0x35, 0x00, 0x00, 0x00, 0x00,
+    // uint32s[], v={32}
+    0x08, 0x20,
+    // fixed32s[]. v={16}
+    0x35, 0x10, 0x00, 0x00, 0x00,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(proto_data)));
+  RepeatedTest::StreamDecoder repeated_test(reader);
+
+  RepeatedTest::Message message{};
+  const auto status = repeated_test.Read(message);
+  ASSERT_EQ(status, OkStatus());
+
+  ASSERT_EQ(message.uint32s.size(), 3u);
+  for (unsigned short i = 0; i < 3; ++i) {
+    EXPECT_EQ(message.uint32s[i], i * 16u);
+  }
+
+  ASSERT_EQ(message.fixed32s.size(), 2u);
+  for (unsigned short i = 0; i < 2; ++i) {
+    EXPECT_EQ(message.fixed32s[i], i * 16u);
+  }
+}
+
 TEST(CodegenMessage, ReadNonPackedScalar) {
   // clang-format off
   constexpr uint8_t proto_data[] = {
@@ -0,0 +1,206 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures decoding a message with many fields into its generated struct.
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/check.h"
+#include "pw_bytes/span.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_protobuf/stream_decoder.h"
+#include "pw_protobuf_test_protos/wide.pwpb.h"
+#include "pw_status/status.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::protobuf {
+namespace {
+
+namespace SparseMessage = test::pwpb::SparseMessage;
+namespace WideMessage = test::pwpb::WideMessage;
+
+constexpr uint32_t kFirstField = 1;
+constexpr uint32_t kLastScalarField = 56;
+constexpr uint32_t kFirstUnknownField = 100;
+constexpr size_t kPackedValues = 16;
+constexpr size_t kDecodesPerIteration = 100;
+
+// Encodes every scalar field of a WideMessage, either in field number order or
+// in reverse order.
+ConstByteSpan EncodeScalars(ByteSpan buffer, bool reverse) {
+  MemoryEncoder encoder(buffer);
+
+  for (uint32_t i = kFirstField; i <= kLastScalarField; ++i) {
+    const uint32_t field = reverse ? kLastScalarField + kFirstField - i : i;
+    const uint32_t value = 1000 * field;
+
+    // Cycles through the field types as declared in wide.proto.
+    switch ((field - 1) % 12) {
+      case 0:
+      case 1:
+      case 3:
+      case 4:
+        encoder.WriteUint64(field, value).IgnoreError();
+        break;
+      case 2:
+        encoder.WriteSint32(field, static_cast<int32_t>(value)).IgnoreError();
+        break;
+      case 5:
+        encoder.WriteSint64(field, value).IgnoreError();
+        break;
+      case 6:
+      case 11:
+        encoder.WriteFixed32(field, value).IgnoreError();
+        break;
+      case 7:
+        encoder.WriteFixed64(field, value).IgnoreError();
+        break;
+      case 8:
+        encoder.WriteBool(field, true).IgnoreError();
+        break;
+      case 9:
+        encoder.WriteFloat(field, 1.5f).IgnoreError();
+        break;
+      case 10:
+        encoder.WriteDouble(field, 2.5).IgnoreError();
+        break;
+    }
+  }
+
+  PW_CHECK_OK(encoder.status());
+  return ConstByteSpan(encoder);
+}
+
+// Encodes as many fields as a WideMessage has scalars, none of which are in
+// WideMessage.
+ConstByteSpan EncodeUnknown(ByteSpan buffer) {
+  MemoryEncoder encoder(buffer);
+  for (uint32_t i = kFirstField; i <= kLastScalarField; ++i) {
+    encoder.WriteUint32(kFirstUnknownField + i, i).IgnoreError();
+  }
+  PW_CHECK_OK(encoder.status());
+  return ConstByteSpan(encoder);
+}
+
+// Encodes every field of a SparseMessage in reverse order.
+ConstByteSpan EncodeSparseInReverse(ByteSpan buffer) {
+  constexpr uint32_t kFields[] = {500000,
+                                  200000,
+                                  100000,
+                                  50000,
+                                  20000,
+                                  10000,
+                                  5000,
+                                  2000,
+                                  1000,
+                                  500,
+                                  200,
+                                  100,
+                                  50,
+                                  20,
+                                  5,
+                                  1};
+  MemoryEncoder encoder(buffer);
+  for (uint32_t field : kFields) {
+    encoder.WriteUint32(field, field).IgnoreError();
+  }
+  PW_CHECK_OK(encoder.status());
+  return ConstByteSpan(encoder);
+}
+
+// Encodes the packed repeated fields of a WideMessage.
+ConstByteSpan EncodePacked(ByteSpan buffer) {
+  MemoryEncoder encoder(buffer);
+
+  uint32_t uint32s[kPackedValues];
+  int64_t sint64s[kPackedValues];
+  uint32_t fixed32s[kPackedValues];
+  for (size_t i = 0; i < kPackedValues; ++i) {
+    uint32s[i] = static_cast<uint32_t>(i * 4099);
+    sint64s[i] = -static_cast<int64_t>(i * 65537);
+    fixed32s[i] = static_cast<uint32_t>(i);
+  }
+
+  encoder
+      .WritePackedUint32(
+          static_cast<uint32_t>(WideMessage::Fields::kPackedUint32s), uint32s)
+      .IgnoreError();
+  encoder
+      .WritePackedSint64(
+          static_cast<uint32_t>(WideMessage::Fields::kPackedSint64s), sint64s)
+      .IgnoreError();
+  encoder
+      .WritePackedFixed32(
+          static_cast<uint32_t>(WideMessage::Fields::kPackedFixed32s),
+          fixed32s)
+      .IgnoreError();
+
+  PW_CHECK_OK(encoder.status());
+  return ConstByteSpan(encoder);
+}
+
+void DecodeWideMessage(perf_test::State& state, ConstByteSpan encoded) {
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kDecodesPerIteration; ++i) {
+      WideMessage::Message message{};
+      stream::MemoryReader reader(encoded);
+      WideMessage::StreamDecoder decoder(reader);
+      PW_CHECK_OK(decoder.Read(message));
+    }
+  }
+}
+
+void DecodeScalarsInOrder(perf_test::State& state) {
+  std::byte buffer[512];
+  DecodeWideMessage(state, EncodeScalars(buffer, /*reverse=*/false));
+}
+
+void DecodeScalarsInReverse(perf_test::State& state) {
+  std::byte buffer[512];
+  DecodeWideMessage(state, EncodeScalars(buffer, /*reverse=*/true));
+}
+
+void DecodeUnknownFields(perf_test::State& state) {
+  std::byte buffer[512];
+  DecodeWideMessage(state, EncodeUnknown(buffer));
+}
+
+void DecodePacked(perf_test::State& state) {
+  std::byte buffer[256];
+  DecodeWideMessage(state, EncodePacked(buffer));
+}
+
+void DecodeSparseInReverse(perf_test::State& state) {
+  std::byte buffer[128];
+  const ConstByteSpan encoded = EncodeSparseInReverse(buffer);
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kDecodesPerIteration; ++i) {
+      SparseMessage::Message message{};
+      stream::MemoryReader reader(encoded);
+      SparseMessage::StreamDecoder decoder(reader);
+      PW_CHECK_OK(decoder.Read(message));
+    }
+  }
+}
+
+PW_PERF_TEST(DecodeWideMessageInOrder, DecodeScalarsInOrder);
+PW_PERF_TEST(DecodeWideMessageInReverse, DecodeScalarsInReverse);
+PW_PERF_TEST(DecodeWideMessageUnknownFields, DecodeUnknownFields);
+PW_PERF_TEST(DecodePackedFields, DecodePacked);
+PW_PERF_TEST(DecodeSparseMessageInReverse, DecodeSparseInReverse);
+
+}  // namespace
+}  // namespace pw::protobuf
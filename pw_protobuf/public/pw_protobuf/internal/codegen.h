@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include "pw_function/function.h"
@@ -124,6 +125,13 @@ class MessageField {
     return nested_message_fields_;
   }
 
+  // True for singular varint and fixed fields that are stored directly in
+  // their struct member, which covers most fields in typical messages.
+  constexpr bool is_plain_scalar() const {
+    return (field_info_ & kNotPlainScalarMask) == 0 &&
+           wire_type() != WireType::kDelimited;
+  }
+
   constexpr bool operator==(uint32_t field_number) const {
     return field_number == field_number_;
   }
@@ -162,6 +170,9 @@ class MessageField {
   static constexpr unsigned int kIsOptionalShift = 16u;
   static constexpr unsigned int kFieldSizeShift = 0u;
   static constexpr unsigned int kFieldSizeMask = kMaxFieldSize;
+  static constexpr uint32_t kNotPlainScalarMask =
+      1u << kIsFixedSizeShift | 1u << kIsRepeatedShift |
+      1u << kIsOptionalShift | 1u << kUseCallbackShift;
 
   uint32_t field_number_;
   uint32_t field_info_;
@@ -172,6 +183,67 @@ class MessageField {
 static_assert(sizeof(MessageField) <= sizeof(size_t) * 4,
               "MessageField should be four words or less");
 
+// Maps field numbers to entries in a message's MessageField table, so that
+// decoding a field does not require scanning the table. Codegen emits one next
+// to each message's kMessageFields as kMessageFieldIndex.
+//
+// A dense index has one entry per field number up to the largest in the
+// message, holding the field's table index plus one, or 0 if the message has
+// no such field. A sorted index holds the table indices ordered by field
+// number and is binary searched. Codegen emits a dense index unless the field
+// numbers are sparse.
+//
+// A default-constructed index is empty, in which case callers must scan the
+// table instead.
+class MessageFieldIndex {
+ public:
+  enum Kind : bool {
+    kSorted = false,
+    kDense = true,
+  };
+
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+  constexpr MessageFieldIndex() : entries_(), kind_(kSorted) {}
+
+  constexpr MessageFieldIndex(Kind kind, span<const uint16_t> entries)
+      : entries_(entries), kind_(kind) {}
+
+  constexpr bool empty() const { return entries_.empty(); }
+
+  // Returns the index in table of the field with this number, or kNotFound.
+  // table must be the table the index was generated for.
+  constexpr size_t Find(span<const MessageField> table,
+                        uint32_t field_number) const {
+    if (kind_ == kDense) {
+      if (field_number >= entries_.size() || entries_[field_number] == 0) {
+        return kNotFound;
+      }
+      return entries_[field_number] - 1u;
+    }
+
+    size_t low = 0;
+    size_t high = entries_.size();
+    while (low < high) {
+      const size_t mid = low + (high - low) / 2;
+      const uint32_t mid_field_number = table[entries_[mid]].field_number();
+      if (mid_field_number == field_number) {
+        return entries_[mid];
+      }
+      if (mid_field_number < field_number) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    return kNotFound;
+  }
+
+ private:
+  span<const uint16_t> entries_;
+  Kind kind_;
+};
+
 template <typename...>
 constexpr std::false_type kInvalidMessageStruct{};
 
@@ -533,9 +533,10 @@ class StreamDecoder {
   //
   // This is called by codegen subclass Read() functions that accept a typed
   // struct Message reference, using the appropriate codegen MessageField table
-  // corresponding to that type.
+  // corresponding to that type, and the table's index if there is one.
   Status Read(span<std::byte> message,
-              span<const internal::MessageField> table);
+              span<const internal::MessageField> table,
+              internal::MessageFieldIndex index = {});
 
  private:
   friend class BytesReader;
@@ -443,6 +443,9 @@ class MessageProperty(ProtoMember):
     def is_repeated(self) -> bool:
         return self._field.is_repeated()
 
+    def field_number(self) -> int:
+        return self._field.number()
+
     def max_size(self) -> int:
         """Returns the maximum size of the field."""
         if self._field.is_repeated():
@@ -2672,7 +2675,7 @@ def generate_class_for_message(
                 output.write_line(
                     f'return {base_class}::Read('
                     'pw::as_writable_bytes(pw::span(&message, 1)), '
-                    'kMessageFields);'
+                    'kMessageFields, kMessageFieldIndex);'
                 )
             output.write_line('}')
         elif class_type in (
@@ -3006,6 +3009,8 @@ def generate_table_for_message(
             'MessageField> kMessageFields = _kMessageFields;'
         )
 
+        generate_field_index_for_message(properties, output)
+
         member_list = ', '.join(
             [f'message.{prop.name()}' for prop in properties]
         )
@@ -3028,10 +3033,51 @@ def generate_table_for_message(
             f'inline constexpr pw::span<const {_INTERNAL_NAMESPACE}::'
             'MessageField> kMessageFields;'
         )
+        output.write_line(
+            f'inline constexpr {_INTERNAL_NAMESPACE}::MessageFieldIndex '
+            'kMessageFieldIndex;'
+        )
 
     output.write_line(f'}}  // namespace {namespace}')
 
 
+def generate_field_index_for_message(
+    properties: List[MessageProperty], output: OutputFile
+) -> None:
+    """Creates a C++ index from field numbers to kMessageFields entries.
+
+    The index is dense, with one entry per field number, unless that would
+    take more than twice the space of a sorted list of the table's entries.
+    """
+    assert 0 < len(properties) < 0xFFFF
+
+    numbers = [prop.field_number() for prop in properties]
+    max_number = max(numbers)
+
+    if max_number + 1 <= 2 * len(numbers):
+        kind = 'kDense'
+        entries = [0] * (max_number + 1)
+        for table_index, number in enumerate(numbers):
+            entries[number] = table_index + 1
+    else:
+        kind = 'kSorted'
+        entries = sorted(range(len(numbers)), key=lambda i: numbers[i])
+
+    output.write_line('inline constexpr uint16_t _kMessageFieldIndex[] = {')
+    with output.indent():
+        output.write_line(', '.join(str(entry) for entry in entries) + ',')
+    output.write_line('};')
+    output.write_line(
+        f'inline constexpr {_INTERNAL_NAMESPACE}::MessageFieldIndex '
+        'kMessageFieldIndex('
+    )
+    with output.indent():
+        output.write_line(
+            f'{_INTERNAL_NAMESPACE}::MessageFieldIndex::{kind}, '
+            '_kMessageFieldIndex);'
+        )
+
+
 def generate_sizes_for_message(
     message: ProtoMessage, root: ProtoNode, output: OutputFile
 ) -> None:
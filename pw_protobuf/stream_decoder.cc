@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <iterator>
 #include <limits>
 #include <optional>
 
@@ -40,6 +41,91 @@ namespace pw::protobuf {
 
 using internal::VarintType;
 
+namespace {
+
+// Stores a decoded varint in a bool, 32-bit, or 64-bit output, converting it
+// according to the decode type. Returns FAILED_PRECONDITION if the value does
+// not fit in the output.
+Status StoreVarint(uint64_t value,
+                   span<std::byte> out,
+                   VarintType decode_type) {
+  if (out.size() == sizeof(uint64_t)) {
+    if (decode_type == VarintType::kUnsigned) {
+      std::memcpy(out.data(), &value, out.size());
+    } else {
+      const int64_t signed_value = decode_type == VarintType::kZigZag
+                                       ? varint::ZigZagDecode(value)
+                                       : static_cast<int64_t>(value);
+      std::memcpy(out.data(), &signed_value, out.size());
+    }
+  } else if (out.size() == sizeof(uint32_t)) {
+    if (decode_type == VarintType::kUnsigned) {
+      if (value > std::numeric_limits<uint32_t>::max()) {
+        return Status::FailedPrecondition();
+      }
+      std::memcpy(out.data(), &value, out.size());
+    } else {
+      const int64_t signed_value = decode_type == VarintType::kZigZag
+                                       ? varint::ZigZagDecode(value)
+                                       : static_cast<int64_t>(value);
+      if (signed_value > std::numeric_limits<int32_t>::max() ||
+          signed_value < std::numeric_limits<int32_t>::min()) {
+        return Status::FailedPrecondition();
+      }
+      std::memcpy(out.data(), &signed_value, out.size());
+    }
+  } else if (out.size() == sizeof(bool)) {
+    PW_CHECK(decode_type == VarintType::kUnsigned,
+             "Protobuf bool can never be signed");
+    std::memcpy(out.data(), &value, out.size());
+  }
+
+  return OkStatus();
+}
+
+// Returns the entry for a field number in a message table, or nullptr if the
+// field is not in the table. Encoders generally write fields in the order they
+// are declared, which is the order of the table, so the entry after the
+// previous field is checked first, followed by the previous field's entry (for
+// repeated fields). Other fields are looked up in the generated index, or if
+// there is none, by scanning the table.
+//
+// last_index is updated to the index of the found entry.
+const internal::MessageField* FindField(
+    span<const internal::MessageField> table,
+    internal::MessageFieldIndex index,
+    uint32_t field_number,
+    size_t& last_index) {
+  const size_t next_index = last_index + 1;
+  if (next_index < table.size() &&
+      table[next_index].field_number() == field_number) {
+    last_index = next_index;
+    return &table[next_index];
+  }
+  if (last_index < table.size() &&
+      table[last_index].field_number() == field_number) {
+    return &table[last_index];
+  }
+
+  if (!index.empty()) {
+    const size_t found = index.Find(table, field_number);
+    if (found == internal::MessageFieldIndex::kNotFound) {
+      return nullptr;
+    }
+    last_index = found;
+    return &table[found];
+  }
+
+  const auto field = std::find(table.begin(), table.end(), field_number);
+  if (field == table.end()) {
+    return nullptr;
+  }
+  last_index = static_cast<size_t>(field - table.begin());
+  return &*field;
+}
+
+}  // namespace
+
 Status StreamDecoder::BytesReader::DoSeek(ptrdiff_t offset, Whence origin) {
   PW_TRY(status_);
   if (!decoder_.reader_.seekable()) {
@@ -339,39 +425,7 @@ StatusWithSize StreamDecoder::ReadOneVarint(span<std::byte> out,
   }
 
   position_ += sws.size();
-
-  if (out.size() == sizeof(uint64_t)) {
-    if (decode_type == VarintType::kUnsigned) {
-      std::memcpy(out.data(), &value, out.size());
-    } else {
-      const int64_t signed_value = decode_type == VarintType::kZigZag
-                                       ? varint::ZigZagDecode(value)
-                                       : static_cast<int64_t>(value);
-      std::memcpy(out.data(), &signed_value, out.size());
-    }
-  } else if (out.size() == sizeof(uint32_t)) {
-    if (decode_type == VarintType::kUnsigned) {
-      if (value > std::numeric_limits<uint32_t>::max()) {
-        return StatusWithSize(Status::FailedPrecondition(), sws.size());
-      }
-      std::memcpy(out.data(), &value, out.size());
-    } else {
-      const int64_t signed_value = decode_type == VarintType::kZigZag
-                                       ? varint::ZigZagDecode(value)
-                                       : static_cast<int64_t>(value);
-      if (signed_value > std::numeric_limits<int32_t>::max() ||
-          signed_value < std::numeric_limits<int32_t>::min()) {
-        return StatusWithSize(Status::FailedPrecondition(), sws.size());
-      }
-      std::memcpy(out.data(), &signed_value, out.size());
-    }
-  } else if (out.size() == sizeof(bool)) {
-    PW_CHECK(decode_type == VarintType::kUnsigned,
-             "Protobuf bool can never be signed");
-    std::memcpy(out.data(), &value, out.size());
-  }
-
-  return sws;
+  return StatusWithSize(StoreVarint(value, out, decode_type), sws.size());
 }
 
 Status StreamDecoder::ReadFixedField(span<std::byte> out) {
@@ -481,17 +535,64 @@ StatusWithSize StreamDecoder::ReadPackedVarintField(span<std::byte> out,
     return StatusWithSize(status_, 0);
   }
 
+  // Read the packed values from the stream in chunks rather than one byte at a
+  // time. Every value is at least one byte, so reading no more bytes than
+  // there are output slots never consumes a value that cannot be stored. An
+  // incomplete value at the end of a chunk is carried over to the next one.
+  std::byte buffer[4 * varint::kMaxVarint64SizeBytes];
+  size_t carried = 0;
   size_t bytes_read = 0;
   size_t number_out = 0;
   while (bytes_read < delimited_field_size_ && !out.empty()) {
-    const StatusWithSize sws = ReadOneVarint(out.first(elem_size), decode_type);
-    if (!sws.ok()) {
-      return StatusWithSize(sws.status(), number_out);
+    const size_t to_read = std::min({sizeof(buffer) - carried,
+                                     delimited_field_size_ - bytes_read,
+                                     out.size() / elem_size});
+    const Result<ByteSpan> result =
+        reader_.Read(span(buffer + carried, to_read));
+    if (!result.ok()) {
+      // The end of the stream within the field indicates a truncated proto.
+      if (result.status().IsOutOfRange()) {
+        status_ = Status::DataLoss();
+        return StatusWithSize(status_, number_out);
+      }
+      return StatusWithSize(result.status(), number_out);
+    }
+    position_ += result.value().size();
+    bytes_read += result.value().size();
+
+    // Decode the chunk in batches, then narrow each value to the output type.
+    span<const std::byte> data(buffer, carried + result.value().size());
+    while (!out.empty()) {
+      uint64_t values[16];
+      const size_t max_values =
+          std::min(std::size(values), out.size() / elem_size);
+      size_t size;
+      const size_t count =
+          varint::DecodeMany(data, span(values).first(max_values), &size);
+      if (count == 0) {
+        break;
+      }
+      for (size_t i = 0; i < count; ++i) {
+        if (Status status =
+                StoreVarint(values[i], out.first(elem_size), decode_type);
+            !status.ok()) {
+          return StatusWithSize(status, number_out);
+        }
+        out = out.subspan(elem_size);
+        ++number_out;
+      }
+      data = data.subspan(size);
     }
 
-    bytes_read += sws.size();
-    out = out.subspan(elem_size);
-    ++number_out;
+    // Whatever remains must be the start of a value that continues in the
+    // next chunk.
+    if (data.size() >= varint::kMaxVarint64SizeBytes ||
+        (!data.empty() && bytes_read == delimited_field_size_)) {
+      status_ = Status::DataLoss();
+      return StatusWithSize(status_, number_out);
+    }
+    std::memmove(buffer, data.data(), data.size());
+    carried = data.size();
   }
 
   if (bytes_read < delimited_field_size_) {
@@ -521,15 +622,18 @@ Status StreamDecoder::CheckOkToRead(WireType type) {
 }
 
 Status StreamDecoder::Read(span<std::byte> message,
-                           span<const internal::MessageField> table) {
+                           span<const internal::MessageField> table,
+                           internal::MessageFieldIndex index) {
   PW_TRY(status_);
 
+  // Index of the table entry for the most recently decoded field.
+  size_t last_index = 0;
+
   while (Next().ok()) {
-    // Find the field in the table,
-    // TODO: b/234876102 - Finding the field can be made more efficient.
-    const auto field =
-        std::find(table.begin(), table.end(), current_field_.field_number());
-    if (field == table.end()) {
+    // Find the field in the table.
+    const internal::MessageField* field =
+        FindField(table, index, current_field_.field_number(), last_index);
+    if (field == nullptr) {
       // If the field is not found, skip to the next one.
       // TODO: b/234873295 - Provide a way to allow the caller to inspect
       // unknown fields, and serialize them back out later.
@@ -552,6 +656,17 @@ Status StreamDecoder::Read(span<std::byte> message,
       continue;
     }
 
+    // Singular scalars are the most common fields, so read them directly
+    // rather than going through the checks below.
+    if (field->is_plain_scalar()) {
+      if (field->wire_type() == WireType::kVarint) {
+        PW_TRY(ReadVarintField(out, field->varint_type()));
+      } else {
+        PW_TRY(ReadFixedField(out));
+      }
+      continue;
+    }
+
     // Switch on the expected wire type of the field, not the actual, to ensure
     // the remote encoder doesn't influence our decoding unexpectedly.
     switch (field->wire_type()) {
@@ -1294,6 +1294,69 @@ TEST(StreamDecoder, PackedVarintInsufficientSpace) {
   EXPECT_EQ(uint32[1], 50u);
 }
 
+TEST(StreamDecoder, PackedVarintManyValues) {
+  // Enough two-byte values that the packed field is decoded in several chunks,
+  // with values split across chunk boundaries.
+  constexpr size_t kValues = 50;
+  std::array<uint8_t, 2 + 2 * kValues + 2> encoded_proto{};
+  // type=uint32[], k=1, v={300, 301, ...}
+  encoded_proto[0] = 0x0a;
+  encoded_proto[1] = 2 * kValues;
+  for (size_t i = 0; i < kValues; ++i) {
+    const size_t value = 300 + i;
+    encoded_proto[2 + 2 * i] = static_cast<uint8_t>(0x80 | (value & 0x7f));
+    encoded_proto[3 + 2 * i] = static_cast<uint8_t>(value >> 7);
+  }
+  // type=uint32, k=2, v=7
+  encoded_proto[2 + 2 * kValues] = 0x10;
+  encoded_proto[3 + 2 * kValues] = 0x07;
+
+  stream::MemoryReader reader(as_bytes(span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber().value(), 1u);
+  std::array<uint32_t, kValues> uint32{};
+  StatusWithSize size = decoder.ReadPackedUint32(uint32);
+  ASSERT_EQ(size.status(), OkStatus());
+  EXPECT_EQ(size.size(), kValues);
+
+  for (size_t i = 0; i < kValues; ++i) {
+    EXPECT_EQ(uint32[i], 300u + i);
+  }
+
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber().value(), 2u);
+  Result<uint32_t> uint32_value = decoder.ReadUint32();
+  ASSERT_EQ(uint32_value.status(), OkStatus());
+  EXPECT_EQ(uint32_value.value(), 7u);
+
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST(StreamDecoder, PackedVarintTruncated) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=uint32[], k=1, v={0, 150}, but the second value does not fit in the
+    // field's length.
+    0x0a, 0x02,
+    0x00,
+    0x96, 0x01
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(encoded_proto)));
+  StreamDecoder decoder(reader);
+
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  ASSERT_EQ(decoder.FieldNumber().value(), 1u);
+  std::array<uint32_t, 8> uint32{};
+  StatusWithSize size = decoder.ReadPackedUint32(uint32);
+  EXPECT_EQ(size.status(), Status::DataLoss());
+  EXPECT_EQ(size.size(), 1u);
+  EXPECT_EQ(uint32[0], 0u);
+}
+
 TEST(StreamDecoder, PackedVarintVector) {
   // clang-format off
   constexpr uint8_t encoded_proto[] = {
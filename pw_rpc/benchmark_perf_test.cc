@@ -0,0 +1,113 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures BenchmarkService UnaryEcho throughput when several threads process
+// requests on their own channels. Each ChannelOutput blocks for a fixed time
+// per packet, as a transport waiting on I/O would. With the default config,
+// the RPC lock is held while sending, so the threads' sends are serialized.
+// With PW_RPC_CONCURRENT_SEND, they overlap.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "pw_assert/check.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc/benchmark.h"
+#include "pw_rpc/internal/method_info.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/server.h"
+#include "pw_thread/sleep.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr size_t kMaxThreads = 4;
+constexpr size_t kRequestsPerThread = 32;
+constexpr auto kSendLatency = std::chrono::microseconds(50);
+
+using UnaryEcho = internal::MethodInfo<pw_rpc::raw::Benchmark::UnaryEcho>;
+
+class SlowOutput final : public ChannelOutput {
+ public:
+  SlowOutput() : ChannelOutput("SlowOutput") {}
+
+ private:
+  Status Send(span<const std::byte>) override {
+    this_thread::sleep_for(kSendLatency);
+    return OkStatus();
+  }
+};
+
+struct Context {
+  Context()
+      : channels{Channel::Create<1>(&outputs[0]),
+                 Channel::Create<2>(&outputs[1]),
+                 Channel::Create<3>(&outputs[2]),
+                 Channel::Create<4>(&outputs[3])},
+        server(channels) {
+    server.RegisterService(service);
+  }
+
+  std::array<SlowOutput, kMaxThreads> outputs;
+  std::array<Channel, kMaxThreads> channels;
+  BenchmarkService service;
+  Server server;
+};
+
+Context& GetContext() {
+  static Context context;
+  return context;
+}
+
+// Sends kRequestsPerThread UnaryEcho requests on a channel.
+void ProcessRequests(uint32_t channel_id) {
+  const std::byte payload[16] = {};
+  std::byte buffer[64];
+  const Result<ConstByteSpan> request =
+      internal::Packet(internal::pwpb::PacketType::REQUEST,
+                       channel_id,
+                       UnaryEcho::kServiceId,
+                       UnaryEcho::kMethodId,
+                       /*call_id=*/1,
+                       payload)
+          .Encode(buffer);
+  PW_CHECK_OK(request.status());
+
+  for (size_t i = 0; i < kRequestsPerThread; ++i) {
+    GetContext().server.ProcessPacket(*request).IgnoreError();
+  }
+}
+
+void UnaryEchoFromThreads(perf_test::State& state, size_t thread_count) {
+  std::array<std::thread, kMaxThreads> threads;
+
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < thread_count; ++i) {
+      threads[i] = std::thread(ProcessRequests, static_cast<uint32_t>(i + 1));
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+      threads[i].join();
+    }
+  }
+}
+
+PW_PERF_TEST(UnaryEcho1Thread, UnaryEchoFromThreads, 1);
+PW_PERF_TEST(UnaryEcho2Threads, UnaryEchoFromThreads, 2);
+PW_PERF_TEST(UnaryEcho4Threads, UnaryEchoFromThreads, 4);
+
+}  // namespace
+}  // namespace pw::rpc
@@ -152,10 +152,11 @@ void Call::MoveFrom(Call& other) {
   on_error_ = std::move(other.on_error_);
   on_next_ = std::move(other.on_next_);
 
-  // Mark the other call inactive, unregister it, and register this one.
+  // Unregister the other call, mark it inactive, and register this one. The
+  // other call must be unregistered first, since its IDs are used to find it.
+  endpoint().UnregisterCall(other);
   other.MarkClosed();
 
-  endpoint().UnregisterCall(other);
   endpoint().RegisterUniqueCall(*this);
 }
 
@@ -215,9 +216,28 @@ Status Call::SendPacket(PacketType type, ConstByteSpan payload, Status status) {
 Status Call::CloseAndSendFinalPacketLocked(PacketType type,
                                            ConstByteSpan response,
                                            Status status) {
+#if PW_RPC_CONCURRENT_SEND
+  // The RPC lock is released while the packet is sent. Close the call first so
+  // that other threads cannot send on it in the meantime.
+  if (!active_locked()) {
+    encoding_buffer.ReleaseIfAllocated();
+    return Status::FailedPrecondition();
+  }
+
+  Channel* channel = endpoint_->GetInternalChannel(channel_id_);
+  const Packet packet = MakePacket(type, response, status);
+  UnregisterAndMarkClosed();
+
+  if (channel == nullptr) {
+    encoding_buffer.ReleaseIfAllocated();
+    return Status::Unavailable();
+  }
+  return channel->Send(packet);
+#else
   const Status send_status = SendPacket(type, response, status);
   UnregisterAndMarkClosed();
   return send_status;
+#endif  // PW_RPC_CONCURRENT_SEND
 }
 
 Status Call::WriteLocked(ConstByteSpan payload) {
@@ -295,6 +315,19 @@ void Call::CloseClientCall() {
   UnregisterAndMarkClosed();
 }
 
+void Call::set_id(uint32_t id) {
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  // Active calls are indexed by their IDs, so re-register under the new ID.
+  if (active_locked()) {
+    endpoint().UnregisterCall(*this);
+    id_ = id;
+    endpoint().RegisterUniqueCall(*this);
+    return;
+  }
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+  id_ = id;
+}
+
 void Call::UnregisterAndMarkClosed() {
   if (active_locked()) {
     endpoint().UnregisterCall(*this);
@@ -0,0 +1,121 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how long a server takes to find the call for a client stream packet
+// when many calls are open. Set PW_RPC_CALL_INDEX_BUCKETS to compare the
+// indexed lookup with the default list scan.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/check.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc/service.h"
+#include "pw_rpc_private/fake_server_reader_writer.h"
+#include "pw_rpc_private/test_method.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::Packet;
+using internal::TestMethod;
+using internal::TestMethodUnion;
+using internal::pwpb::PacketType;
+
+constexpr uint32_t kChannelId = 1;
+constexpr uint32_t kServiceId = 42;
+constexpr uint32_t kMethodId = 100;
+
+class NullOutput final : public ChannelOutput {
+ public:
+  NullOutput() : ChannelOutput("NullOutput") {}
+
+ private:
+  Status Send(span<const std::byte>) override { return OkStatus(); }
+};
+
+class TestService : public Service {
+ public:
+  TestService()
+      : Service(kServiceId, methods_),
+        methods_{TestMethod(kMethodId, MethodType::kBidirectionalStreaming)} {}
+
+  const TestMethod& method() { return methods_[0].test_method(); }
+
+ private:
+  std::array<TestMethodUnion, 1> methods_;
+};
+
+// A server with kCalls open bidirectional streaming calls.
+template <size_t kCalls>
+class OpenCalls {
+ public:
+  OpenCalls()
+      : channels_{Channel::Create<kChannelId>(&output_)}, server_(channels_) {
+    server_.RegisterService(service_);
+
+    for (uint32_t i = 0; i < kCalls; ++i) {
+      internal::rpc_lock().lock();
+      internal::CallContext context(
+          server_, kChannelId, service_, service_.method(), /*call_id=*/i);
+      internal::test::FakeServerReaderWriter call(context.ClaimLocked());
+      internal::rpc_lock().unlock();
+      calls_[i] = std::move(call);
+    }
+
+    // Address packets to the first call, which was registered first.
+    const std::byte payload[] = {std::byte{0}};
+    const Result<ConstByteSpan> packet = Packet(PacketType::CLIENT_STREAM,
+                                                kChannelId,
+                                                kServiceId,
+                                                kMethodId,
+                                                /*call_id=*/0,
+                                                payload)
+                                             .Encode(packet_buffer_);
+    PW_CHECK_OK(packet.status());
+    packet_ = *packet;
+  }
+
+  void ProcessPacket() { server_.ProcessPacket(packet_).IgnoreError(); }
+
+ private:
+  NullOutput output_;
+  std::array<Channel, 1> channels_;
+  Server server_;
+  TestService service_;
+  std::array<internal::test::FakeServerReaderWriter, kCalls> calls_;
+
+  std::byte packet_buffer_[32];
+  ConstByteSpan packet_;
+};
+
+template <size_t kCalls>
+void ClientStreamPacket(perf_test::State& state) {
+  static OpenCalls<kCalls> calls;
+
+  while (state.KeepRunning()) {
+    calls.ProcessPacket();
+  }
+}
+
+PW_PERF_TEST(ClientStreamPacket1Call, ClientStreamPacket<1>);
+PW_PERF_TEST(ClientStreamPacket100Calls, ClientStreamPacket<100>);
+PW_PERF_TEST(ClientStreamPacket10000Calls, ClientStreamPacket<10000>);
+
+}  // namespace
+}  // namespace pw::rpc
@@ -18,11 +18,16 @@
 #include "pw_rpc/internal/channel.h"
 // clang-format on
 
+#include <array>
+#include <cstdint>
+#include <mutex>
+
 #include "pw_bytes/span.h"
 #include "pw_log/log.h"
 #include "pw_protobuf/decoder.h"
 #include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/encoding_buffer.h"
+#include "pw_toolchain/no_destructor.h"
 
 namespace pw::rpc {
 
@@ -43,8 +48,13 @@ Result<uint32_t> ExtractChannelId(ConstByteSpan packet) {
 }
 
 namespace internal {
+namespace {
 
-Status Channel::Send(const Packet& packet) {
+// Encodes a packet with the encoding buffer and passes it to the output. The
+// RPC lock is held unless PW_RPC_CONCURRENT_SEND is enabled.
+Status EncodeAndSend(ChannelOutput& output,
+                     uint32_t channel_id,
+                     const Packet& packet) PW_NO_LOCK_SAFETY_ANALYSIS {
   ByteSpan buffer = encoding_buffer.GetPacketBuffer(packet.payload().size());
   Result encoded = packet.Encode(buffer);
 
@@ -53,17 +63,17 @@ Status Channel::Send(const Packet& packet) {
     PW_LOG_ERROR(
         "Failed to encode RPC packet type %u to channel %u buffer, status %u",
         static_cast<unsigned>(packet.type()),
-        static_cast<unsigned>(id()),
+        static_cast<unsigned>(channel_id),
         encoded.status().code());
     return Status::Internal();
   }
 
-  Status sent = output().Send(encoded.value());
+  Status sent = output.Send(encoded.value());
   encoding_buffer.Release();
 
   if (!sent.ok()) {
     PW_LOG_DEBUG("Channel %u failed to send packet with status %u",
-                 static_cast<unsigned>(id()),
+                 static_cast<unsigned>(channel_id),
                  sent.code());
 
     return Status::Unknown();
@@ -71,5 +81,58 @@ Status Channel::Send(const Packet& packet) {
   return OkStatus();
 }
 
+}  // namespace
+
+#if PW_RPC_CONCURRENT_SEND
+
+sync::Mutex& ChannelOutputLock(ChannelOutput& output) {
+  static_assert(cfg::kChannelOutputLockShards > 0u &&
+                    cfg::kChannelOutputLockShards <
+                        ChannelOutput::kUnassignedLockShard,
+                "PW_RPC_CHANNEL_OUTPUT_LOCK_SHARDS must be in [1, 65535)");
+
+  static NoDestructor<std::array<sync::Mutex, cfg::kChannelOutputLockShards>>
+      locks;
+  static size_t next_shard = 0;  // Guarded by the RPC lock.
+
+  if (output.lock_shard_ == ChannelOutput::kUnassignedLockShard) {
+    output.lock_shard_ = static_cast<uint16_t>(next_shard);
+    next_shard = (next_shard + 1) % cfg::kChannelOutputLockShards;
+  }
+  return (*locks)[output.lock_shard_];
+}
+
+Status Channel::Send(const Packet& packet) PW_NO_LOCK_SAFETY_ANALYSIS {
+  ChannelOutput& channel_output = output();
+  const uint32_t channel_id = id();
+  sync::Mutex& output_lock = ChannelOutputLock(channel_output);
+
+  // Take the output's lock before releasing the RPC lock, so packets reach the
+  // output in the order they were produced. This channel object may be moved
+  // or closed once the RPC lock is released, so it must not be used again.
+  output_lock.lock();
+  rpc_lock().unlock();
+
+  const Status status = EncodeAndSend(channel_output, channel_id, packet);
+
+  output_lock.unlock();
+  rpc_lock().lock();
+  return status;
+}
+
+void Channel::WaitForPendingSends() const {
+  if (has_output()) {
+    std::lock_guard lock(ChannelOutputLock(output()));
+  }
+}
+
+#else
+
+Status Channel::Send(const Packet& packet) {
+  return EncodeAndSend(output(), id(), packet);
+}
+
+#endif  // PW_RPC_CONCURRENT_SEND
+
 }  // namespace internal
 }  // namespace pw::rpc
@@ -36,7 +36,7 @@ Status Client::ProcessPacket(ConstByteSpan data) {
 
   // Find an existing call for this RPC, if any.
   internal::rpc_lock().lock();
-  IntrusiveList<internal::Call>::iterator call = FindCall(packet);
+  internal::Call* call = FindCall(packet);
 
   internal::Channel* channel = GetInternalChannel(packet.channel_id());
 
@@ -47,7 +47,7 @@ Status Client::ProcessPacket(ConstByteSpan data) {
     return Status::Unavailable();
   }
 
-  if (call == calls_end()) {
+  if (call == nullptr) {
     // The call for the packet does not exist. If the packet is a server stream
     // message, notify the server so that it can kill the stream. Otherwise,
     // silently drop the packet (as it would terminate the RPC anyway).
@@ -78,10 +78,23 @@ Status Client::ProcessPacket(ConstByteSpan data) {
       if (call->has_server_stream()) {
         call->HandlePayload(packet.payload());
       } else {
+#if PW_RPC_CONCURRENT_SEND
+        // Sending releases the RPC lock, after which the call object may be
+        // moved or destroyed, so close the call before reporting the error.
+        call->HandleError(Status::InvalidArgument());
+        internal::rpc_lock().lock();
+        if (channel = GetInternalChannel(packet.channel_id());
+            channel != nullptr) {
+          channel->Send(Packet::ClientError(packet, Status::InvalidArgument()))
+              .IgnoreError();  // Errors are logged in Channel::Send.
+        }
+        internal::rpc_lock().unlock();
+#else
         // Report the error to the server so it can abort the RPC.
         channel->Send(Packet::ClientError(packet, Status::InvalidArgument()))
             .IgnoreError();  // Errors are logged in Channel::Send.
         call->HandleError(Status::InvalidArgument());
+#endif  // PW_RPC_CONCURRENT_SEND
         PW_LOG_DEBUG("Received SERVER_STREAM for RPC without a server stream");
       }
       break;
@@ -20,6 +20,10 @@ void ClientCall::MoveClientCallFrom(ClientCall& other)
     PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
   WaitUntilReadyForMove(*this, other);
   CloseClientCall();
+#if PW_RPC_CONCURRENT_SEND
+  // The RPC lock may have been released to send a completion request.
+  WaitUntilReadyForMove(*this, other);
+#endif  // PW_RPC_CONCURRENT_SEND
   MoveFrom(other);
 }
 
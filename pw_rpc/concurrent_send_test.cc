@@ -0,0 +1,266 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Tests for sending packets from multiple threads. With PW_RPC_CONCURRENT_SEND
+// enabled, the RPC lock is released while packets are sent, so sends to
+// different ChannelOutputs may run in parallel.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc_test_protos/test.raw_rpc.pb.h"
+#include "pw_sync/binary_semaphore.h"
+#include "pw_thread/non_portable_test_thread_options.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/thread.h"
+
+namespace pw::rpc {
+namespace {
+
+using namespace std::chrono_literals;
+
+using test::pw_rpc::raw::TestService;
+
+class TestServiceImpl final : public TestService::Service<TestServiceImpl> {
+ public:
+  static void TestUnaryRpc(ConstByteSpan, RawUnaryResponder&) {}
+
+  void TestAnotherUnaryRpc(ConstByteSpan, RawUnaryResponder&) {}
+
+  void TestServerStreamRpc(ConstByteSpan, RawServerWriter&) {}
+
+  void TestClientStreamRpc(RawServerReader&) {}
+
+  void TestBidirectionalStreamRpc(RawServerReaderWriter&) {}
+};
+
+constexpr size_t kWritesPerThread = 200;
+
+// Records the payloads sent for up to two RPCs and checks that each RPC's
+// payloads arrive in order. Optionally blocks in Send() until released.
+class RecordingOutput final : public ChannelOutput {
+ public:
+  RecordingOutput() : ChannelOutput("RecordingOutput") {}
+
+  void set_blocking(bool blocking) { blocking_ = blocking; }
+
+  // Waits until Send() is called while blocking is enabled.
+  void WaitForSend() { entered_.acquire(); }
+
+  // Disables blocking and allows a blocked Send() to return.
+  void Release() {
+    blocking_ = false;
+    release_.release();
+  }
+
+  size_t packets() const { return packets_.load(); }
+  bool in_order() const { return in_order_.load(); }
+
+ private:
+  Status Send(span<const std::byte> buffer) override {
+    if (blocking_) {
+      entered_.release();
+      release_.acquire();
+    }
+
+    auto packet = internal::Packet::FromBuffer(buffer);
+    if (!packet.ok() || packet->payload().empty()) {
+      in_order_ = false;
+      return OkStatus();
+    }
+
+    Rpc* rpc = nullptr;
+    for (Rpc& candidate : rpcs_) {
+      if (candidate.method_id == packet->method_id() ||
+          candidate.method_id == 0) {
+        rpc = &candidate;
+        break;
+      }
+    }
+    if (rpc == nullptr) {
+      in_order_ = false;
+      return OkStatus();
+    }
+
+    rpc->method_id = packet->method_id();
+    const auto payload = static_cast<uint8_t>(packet->payload()[0]);
+    if (payload != rpc->next_payload) {
+      in_order_ = false;
+    }
+    rpc->next_payload = static_cast<uint8_t>(payload + 1);
+    packets_ += 1;
+    return OkStatus();
+  }
+
+  struct Rpc {
+    uint32_t method_id = 0;
+    uint8_t next_payload = 0;
+  };
+
+  std::atomic<bool> blocking_{false};
+  sync::BinarySemaphore entered_;
+  sync::BinarySemaphore release_;
+
+  std::array<Rpc, 2> rpcs_{};
+  std::atomic<size_t> packets_{0};
+  std::atomic<bool> in_order_{true};
+};
+
+class ConcurrentSendTest : public ::testing::Test {
+ protected:
+  static constexpr uint32_t kChannelA = 1;
+  static constexpr uint32_t kChannelB = 2;
+
+  ConcurrentSendTest()
+      : channels_{Channel::Create<kChannelA>(&output_a_),
+                  Channel::Create<kChannelB>(&output_b_)},
+        server_(channels_) {
+    server_.RegisterService(service_);
+  }
+
+  RawServerWriter OpenWriter(uint32_t channel_id) {
+    return RawServerWriter::Open<TestService::TestServerStreamRpc>(
+        server_, channel_id, service_);
+  }
+
+  RawServerReaderWriter OpenReaderWriter(uint32_t channel_id) {
+    return RawServerReaderWriter::Open<
+        TestService::TestBidirectionalStreamRpc>(server_, channel_id, service_);
+  }
+
+  // Thread routines. The argument is the call to write to.
+  template <typename Call>
+  static void WriteAll(void* call) {
+    for (size_t i = 0; i < kWritesPerThread; ++i) {
+      const std::byte payload[] = {static_cast<std::byte>(i)};
+      EXPECT_EQ(OkStatus(), static_cast<Call*>(call)->Write(payload));
+    }
+  }
+
+  static void WriteOne(void* writer) {
+    const std::byte payload[] = {std::byte{0}};
+    EXPECT_EQ(OkStatus(),
+              static_cast<RawServerWriter*>(writer)->Write(payload));
+  }
+
+  static void CloseChannelA(void* test) {
+    auto& self = *static_cast<ConcurrentSendTest*>(test);
+    EXPECT_EQ(OkStatus(), self.server_.CloseChannel(kChannelA));
+    self.closed_ = true;
+  }
+
+  RecordingOutput output_a_;
+  RecordingOutput output_b_;
+  std::array<Channel, 2> channels_;
+  TestServiceImpl service_;
+  Server server_;
+  std::atomic<bool> closed_{false};
+};
+
+TEST_F(ConcurrentSendTest, WritesFromTwoThreads_SameOutput_ArriveInOrder) {
+  RawServerWriter writer = OpenWriter(kChannelA);
+  RawServerReaderWriter reader_writer = OpenReaderWriter(kChannelA);
+
+  thread::Thread thread_0(thread::test::TestOptionsThread0(),
+                          WriteAll<RawServerWriter>,
+                          &writer);
+  thread::Thread thread_1(thread::test::TestOptionsThread1(),
+                          WriteAll<RawServerReaderWriter>,
+                          &reader_writer);
+  thread_0.join();
+  thread_1.join();
+
+  EXPECT_EQ(2 * kWritesPerThread, output_a_.packets());
+  EXPECT_TRUE(output_a_.in_order());
+}
+
+TEST_F(ConcurrentSendTest, WritesFromTwoThreads_SeparateOutputs) {
+  RawServerWriter writer_a = OpenWriter(kChannelA);
+  RawServerWriter writer_b = OpenWriter(kChannelB);
+
+  thread::Thread thread_a(thread::test::TestOptionsThread0(),
+                          WriteAll<RawServerWriter>,
+                          &writer_a);
+  thread::Thread thread_b(thread::test::TestOptionsThread1(),
+                          WriteAll<RawServerWriter>,
+                          &writer_b);
+  thread_a.join();
+  thread_b.join();
+
+  EXPECT_EQ(kWritesPerThread, output_a_.packets());
+  EXPECT_TRUE(output_a_.in_order());
+  EXPECT_EQ(kWritesPerThread, output_b_.packets());
+  EXPECT_TRUE(output_b_.in_order());
+}
+
+TEST_F(ConcurrentSendTest, BlockedOutput_DoesNotBlockOtherOutputs) {
+  if (PW_RPC_CONCURRENT_SEND == 0) {
+    GTEST_SKIP() << "Skipping because the RPC lock is held while sending.";
+  }
+
+  RawServerWriter writer_a = OpenWriter(kChannelA);
+  RawServerWriter writer_b = OpenWriter(kChannelB);
+  output_a_.set_blocking(true);
+
+  thread::Thread thread_a(
+      thread::test::TestOptionsThread0(), WriteOne, &writer_a);
+  output_a_.WaitForSend();
+
+  // Output A is still sending, but the RPC lock is free.
+  const std::byte payload[] = {std::byte{0}};
+  EXPECT_EQ(OkStatus(), writer_b.Write(payload));
+  EXPECT_EQ(1u, output_b_.packets());
+  EXPECT_EQ(0u, output_a_.packets());
+
+  output_a_.Release();
+  thread_a.join();
+  EXPECT_EQ(1u, output_a_.packets());
+}
+
+TEST_F(ConcurrentSendTest, CloseChannel_WaitsForPendingSend) {
+  if (PW_RPC_CONCURRENT_SEND == 0) {
+    GTEST_SKIP() << "Skipping because the RPC lock is held while sending.";
+  }
+
+  RawServerWriter writer = OpenWriter(kChannelA);
+  output_a_.set_blocking(true);
+
+  thread::Thread send_thread(
+      thread::test::TestOptionsThread0(), WriteOne, &writer);
+  output_a_.WaitForSend();
+
+  thread::Thread close_thread(
+      thread::test::TestOptionsThread1(), CloseChannelA, this);
+
+  // CloseChannel() must not return while output A is in use.
+  this_thread::sleep_for(50ms);
+  EXPECT_FALSE(closed_.load());
+
+  output_a_.Release();
+  send_thread.join();
+  close_thread.join();
+
+  EXPECT_TRUE(closed_.load());
+  EXPECT_FALSE(writer.active());
+}
+
+}  // namespace
+}  // namespace pw::rpc
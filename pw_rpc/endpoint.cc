@@ -111,24 +111,61 @@ Result<Packet> Endpoint::ProcessPacket(span<const std::byte> data,
 
 void Endpoint::RegisterCall(Call& new_call) {
   // Mark any exisitng duplicate calls as cancelled.
-  auto [before_call, call] = FindIteratorsForCall(new_call);
-  if (call != calls_.end()) {
-    CloseCallAndMarkForCleanup(before_call, call, Status::Cancelled());
+  if (const CallPosition position = FindCallPosition(new_call);
+      position.found()) {
+    CloseCallAndMarkForCleanup(position, Status::Cancelled());
   }
 
   // Register the new call.
-  calls_.push_front(new_call);
+  RegisterUniqueCall(new_call);
 }
 
-std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-Endpoint::FindIteratorsForCall(uint32_t channel_id,
-                               uint32_t service_id,
-                               uint32_t method_id,
-                               uint32_t call_id) {
-  auto previous = calls_.before_begin();
-  auto call = calls_.begin();
+Endpoint::CallPosition Endpoint::FindCallPosition(uint32_t channel_id,
+                                                  uint32_t service_id,
+                                                  uint32_t method_id,
+                                                  uint32_t call_id) {
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  if (call_id == kOpenCallId) {
+    // Any call for this RPC matches, regardless of its ID, so check every
+    // bucket. Only unrequested calls and packets from legacy clients use this.
+    for (IntrusiveList<Call>& bucket : calls_) {
+      const CallPosition position =
+          FindCallInList(bucket, channel_id, service_id, method_id, call_id);
+      if (position.found()) {
+        return position;
+      }
+    }
+    return {&calls_[0], calls_[0].end(), calls_[0].end()};
+  }
+
+  IntrusiveList<Call>& bucket =
+      CallList(channel_id, service_id, method_id, call_id);
+  const CallPosition position =
+      FindCallInList(bucket, channel_id, service_id, method_id, call_id);
+
+  // An unrequested call is stored under kOpenCallId until the first packet for
+  // it arrives. If it hashes to a different bucket, check that bucket too.
+  IntrusiveList<Call>& open_bucket =
+      CallList(channel_id, service_id, method_id, kOpenCallId);
+  if (position.found() || &open_bucket == &bucket) {
+    return position;
+  }
+  return FindCallInList(
+      open_bucket, channel_id, service_id, method_id, call_id);
+#else
+  return FindCallInList(calls_, channel_id, service_id, method_id, call_id);
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+}
+
+Endpoint::CallPosition Endpoint::FindCallInList(IntrusiveList<Call>& list,
+                                                uint32_t channel_id,
+                                                uint32_t service_id,
+                                                uint32_t method_id,
+                                                uint32_t call_id) {
+  auto previous = list.before_begin();
+  auto call = list.begin();
 
-  while (call != calls_.end()) {
+  while (call != list.end()) {
     if (channel_id == call->channel_id_locked() &&
         service_id == call->service_id() && method_id == call->method_id()) {
       if (call_id == call->id() || call_id == kOpenCallId) {
@@ -137,15 +174,22 @@ Endpoint::FindIteratorsForCall(uint32_t channel_id,
       if (call->id() == kOpenCallId) {
         // Calls with ID of `kOpenCallId` were unrequested, and
         // are updated to have the call ID of the first matching request.
-        call->set_id(call_id);
+        Call& open_call = *call;
+        open_call.set_id(call_id);
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+        // Setting the ID moved the call to the front of its new bucket.
+        IntrusiveList<Call>& bucket = CallList(open_call);
+        return {&bucket, bucket.before_begin(), bucket.begin()};
+#else
         break;
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
       }
     }
     previous = call;
     ++call;
   }
 
-  return {previous, call};
+  return {&list, previous, call};
 }
 
 Status Endpoint::CloseChannel(uint32_t channel_id) {
@@ -156,6 +200,9 @@ Status Endpoint::CloseChannel(uint32_t channel_id) {
     rpc_lock().unlock();
     return Status::NotFound();
   }
+#if PW_RPC_CONCURRENT_SEND
+  channel->WaitForPendingSends();
+#endif  // PW_RPC_CONCURRENT_SEND
   channel->Close();
 
   // Close pending calls on the channel that's going away.
@@ -167,14 +214,26 @@ Status Endpoint::CloseChannel(uint32_t channel_id) {
 }
 
 void Endpoint::AbortCalls(AbortIdType type, uint32_t id) {
-  auto previous = calls_.before_begin();
-  auto current = calls_.begin();
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  for (IntrusiveList<Call>& bucket : calls_) {
+    AbortCallsInList(bucket, type, id);
+  }
+#else
+  AbortCallsInList(calls_, type, id);
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+}
 
-  while (current != calls_.end()) {
+void Endpoint::AbortCallsInList(IntrusiveList<Call>& list,
+                                AbortIdType type,
+                                uint32_t id) {
+  auto previous = list.before_begin();
+  auto current = list.begin();
+
+  while (current != list.end()) {
     if (id == (type == AbortIdType::kChannel ? current->channel_id_locked()
                                              : current->service_id())) {
-      current =
-          CloseCallAndMarkForCleanup(previous, current, Status::Aborted());
+      current = CloseCallAndMarkForCleanup({&list, previous, current},
+                                           Status::Aborted());
     } else {
       previous = current;
       ++current;
@@ -211,10 +270,19 @@ void Endpoint::RemoveAllCalls() {
 
   // Close all calls without invoking on_error callbacks, since the calls should
   // have been closed before the Endpoint was deleted.
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  for (IntrusiveList<Call>& bucket : calls_) {
+    while (!bucket.empty()) {
+      bucket.front().CloseFromDeletedEndpoint();
+      bucket.pop_front();
+    }
+  }
+#else
   while (!calls_.empty()) {
     calls_.front().CloseFromDeletedEndpoint();
     calls_.pop_front();
   }
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
   while (!to_cleanup_.empty()) {
     to_cleanup_.front().CloseFromDeletedEndpoint();
     to_cleanup_.pop_front();
@@ -27,6 +27,19 @@
 
 namespace pw::rpc {
 
+class ChannelOutput;
+
+#if PW_RPC_CONCURRENT_SEND
+namespace internal {
+
+// Returns the mutex that serializes sends to an output, assigning one if
+// needed. Outputs share PW_RPC_CHANNEL_OUTPUT_LOCK_SHARDS mutexes.
+sync::Mutex& ChannelOutputLock(ChannelOutput& output)
+    PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+}  // namespace internal
+#endif  // PW_RPC_CONCURRENT_SEND
+
 // Extracts the channel ID from a pw_rpc packet. Returns DATA_LOSS if the
 // packet is corrupt and the channel ID could not be found.
 Result<uint32_t> ExtractChannelId(ConstByteSpan packet);
@@ -68,7 +81,8 @@ class ChannelOutput {
   //
   // The RPC system’s internal lock is held while this function is called. Avoid
   // long-running operations, since these will delay any other users of the RPC
-  // system.
+  // system. If PW_RPC_CONCURRENT_SEND is enabled, the RPC lock is NOT held;
+  // instead, a lock that serializes sends to this output is held.
   //
   // !!! DANGER !!!
   //
@@ -86,6 +100,17 @@ class ChannelOutput {
 
  private:
   const char* name_;
+
+#if PW_RPC_CONCURRENT_SEND
+  friend sync::Mutex& internal::ChannelOutputLock(ChannelOutput& output);
+
+  static constexpr uint16_t kUnassignedLockShard = 0xffff;
+
+  // Index of the mutex that serializes sends to this output. Assigned
+  // round-robin when the output first sends a packet.
+  uint16_t lock_shard_ PW_GUARDED_BY(internal::rpc_lock()) =
+      kUnassignedLockShard;
+#endif  // PW_RPC_CONCURRENT_SEND
 };
 
 class Channel {
@@ -179,6 +204,8 @@ class Channel {
     return *output_;
   }
 
+  constexpr bool has_output() const { return output_ != nullptr; }
+
   void set_channel_id(uint32_t channel_id) { id_ = channel_id; }
 
   constexpr void Close() {
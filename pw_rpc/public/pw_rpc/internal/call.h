@@ -150,7 +150,7 @@ class Call : public IntrusiveList<Call>::Item {
 
   uint32_t id() const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) { return id_; }
 
-  void set_id(uint32_t id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) { id_ = id; }
+  void set_id(uint32_t id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
   // Public function for accessing the channel ID of this call. Set to 0 when
   // the call is closed.
@@ -231,11 +231,12 @@ class Call : public IntrusiveList<Call>::Item {
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
   // Sends the initial request for a client call. If the request fails, the call
-  // is closed.
+  // is closed. The call may have been closed by another thread while the RPC
+  // lock was released to send the packet (see PW_RPC_CONCURRENT_SEND).
   void SendInitialClientRequest(ConstByteSpan payload)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     if (const Status status = SendPacket(pwpb::PacketType::REQUEST, payload);
-        !status.ok()) {
+        !status.ok() && active_locked()) {
       CloseAndMarkForCleanup(status);
     }
   }
@@ -14,6 +14,7 @@
 #pragma once
 
 #include "pw_rpc/channel.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_status/status.h"
@@ -33,7 +34,16 @@ class Channel : public rpc::Channel {
   // Allow setting the channel ID for tests.
   using rpc::Channel::set_channel_id;
 
+  // Encodes and sends a packet. If PW_RPC_CONCURRENT_SEND is enabled, the RPC
+  // lock is released while the packet is encoded and sent.
   Status Send(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+#if PW_RPC_CONCURRENT_SEND
+  // Blocks until packets that are being sent to this channel's output have
+  // been sent. Called before the channel is closed, so the output is not in use
+  // once CloseChannel() returns.
+  void WaitForPendingSends() const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+#endif  // PW_RPC_CONCURRENT_SEND
 };
 
 }  // namespace pw::rpc::internal
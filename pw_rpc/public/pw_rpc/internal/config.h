@@ -67,6 +67,68 @@
 #define PW_RPC_USE_GLOBAL_MUTEX 1
 #endif  // PW_RPC_USE_GLOBAL_MUTEX
 
+/// Release the global RPC lock while packets are encoded and passed to
+/// @cpp_func{pw::rpc::ChannelOutput::Send()}. If this is set, calls that send
+/// through different `ChannelOutput`s encode and send in parallel, and each
+/// thread uses its own encoding buffer (`thread_local`).
+///
+/// Sends to the same `ChannelOutput` are serialized by one of
+/// @c_macro{PW_RPC_CHANNEL_OUTPUT_LOCK_SHARDS} mutexes, which are assigned to
+/// outputs round-robin the first time they send. The mutex is acquired before
+/// the RPC lock is released, so packets reach an output in the order pw_rpc
+/// produced them.
+///
+/// Requires @c_macro{PW_RPC_USE_GLOBAL_MUTEX} and `thread_local` support.
+/// This is disabled by default.
+#ifndef PW_RPC_CONCURRENT_SEND
+#define PW_RPC_CONCURRENT_SEND 0
+#endif  // PW_RPC_CONCURRENT_SEND
+
+#if PW_RPC_CONCURRENT_SEND
+static_assert(PW_RPC_USE_GLOBAL_MUTEX == 1,
+              "PW_RPC_CONCURRENT_SEND requires PW_RPC_USE_GLOBAL_MUTEX.");
+#endif  // PW_RPC_CONCURRENT_SEND
+
+/// If @c_macro{PW_RPC_CONCURRENT_SEND} is enabled, the number of mutexes that
+/// serialize sends to each `ChannelOutput`. Outputs that share a mutex do not
+/// send in parallel, so this should be at least the number of outputs that are
+/// used concurrently.
+#ifndef PW_RPC_CHANNEL_OUTPUT_LOCK_SHARDS
+#define PW_RPC_CHANNEL_OUTPUT_LOCK_SHARDS 8
+#endif  // PW_RPC_CHANNEL_OUTPUT_LOCK_SHARDS
+
+/// The number of buckets in each `Client` and `Server`'s call index. If this
+/// is nonzero, active calls are hashed into buckets by their channel, service,
+/// method, and call IDs, so finding the call for an incoming packet does not
+/// scan every active call. Each bucket adds one pointer to each endpoint.
+///
+/// Systems with many concurrent calls (hundreds or more) should set this to a
+/// power of two near the expected number of calls. This is 0 by default, which
+/// keeps all active calls in a single list.
+#ifndef PW_RPC_CALL_INDEX_BUCKETS
+#define PW_RPC_CALL_INDEX_BUCKETS 0
+#endif  // PW_RPC_CALL_INDEX_BUCKETS
+
+static_assert(
+    (PW_RPC_CALL_INDEX_BUCKETS & (PW_RPC_CALL_INDEX_BUCKETS - 1)) == 0,
+    "PW_RPC_CALL_INDEX_BUCKETS must be 0 or a power of two");
+
+/// The number of buckets in each `Server`'s service registry. If this is
+/// nonzero, registered services are split into buckets by service ID, so
+/// finding the service for an incoming packet does not scan every registered
+/// service. Each bucket adds one pointer to each `Server`.
+///
+/// Servers with many services (dozens or more) should set this to a power of
+/// two near the number of services. This is 0 by default, which keeps all
+/// services in a single list.
+#ifndef PW_RPC_SERVICE_INDEX_BUCKETS
+#define PW_RPC_SERVICE_INDEX_BUCKETS 0
+#endif  // PW_RPC_SERVICE_INDEX_BUCKETS
+
+static_assert(
+    (PW_RPC_SERVICE_INDEX_BUCKETS & (PW_RPC_SERVICE_INDEX_BUCKETS - 1)) == 0,
+    "PW_RPC_SERVICE_INDEX_BUCKETS must be 0 or a power of two");
+
 /// pw_rpc must yield the current thread when waiting for a callback to complete
 /// in a different thread. PW_RPC_YIELD_MODE determines how to yield. There are
 /// three supported settings:
@@ -248,8 +310,12 @@ inline constexpr size_t kNanopbStructMinBufferSize =
 inline constexpr size_t kEncodingBufferSizeBytes =
     PW_RPC_ENCODING_BUFFER_SIZE_BYTES;
 
+inline constexpr size_t kChannelOutputLockShards =
+    PW_RPC_CHANNEL_OUTPUT_LOCK_SHARDS;
+
 #undef PW_RPC_NANOPB_STRUCT_MIN_BUFFER_SIZE
 #undef PW_RPC_ENCODING_BUFFER_SIZE_BYTES
+#undef PW_RPC_CHANNEL_OUTPUT_LOCK_SHARDS
 
 }  // namespace pw::rpc::cfg
 
@@ -113,8 +113,13 @@ using EncodingBuffer = StaticEncodingBuffer;
 #endif  // PW_RPC_DYNAMIC_ALLOCATION
 
 // Instantiate the global encoding buffer variable, depending on whether dynamic
-// allocation is enabled or not.
+// allocation is enabled or not. If packets are sent without the RPC lock, each
+// thread encodes into its own buffer.
+#if PW_RPC_CONCURRENT_SEND
+inline thread_local EncodingBuffer encoding_buffer;
+#else
 inline EncodingBuffer encoding_buffer PW_GUARDED_BY(rpc_lock());
+#endif  // PW_RPC_CONCURRENT_SEND
 
 // Successful calls to EncodeToPayloadBuffer MUST send the returned buffer,
 // without releasing the RPC lock.
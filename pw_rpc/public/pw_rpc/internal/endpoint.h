@@ -13,7 +13,9 @@
 // the License.
 #pragma once
 
-#include <tuple>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
 #include "pw_assert/assert.h"
 #include "pw_containers/intrusive_list.h"
@@ -21,6 +23,7 @@
 #include "pw_rpc/internal/call.h"
 #include "pw_rpc/internal/channel.h"
 #include "pw_rpc/internal/channel_list.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_span/span.h"
@@ -72,7 +75,15 @@ class Endpoint {
   // Returns the number calls in the RPC calls list.
   size_t active_call_count() const PW_LOCKS_EXCLUDED(rpc_lock()) {
     RpcLockGuard lock;
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+    size_t count = 0;
+    for (const IntrusiveList<Call>& bucket : calls_) {
+      count += bucket.size();
+    }
+    return count;
+#else
     return calls_.size();
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
   }
 
   // Claims that `rpc_lock()` is held, returning a wrapped endpoint.
@@ -118,19 +129,13 @@ class Endpoint {
       PW_LOCKS_EXCLUDED(rpc_lock());
 
   // Finds a call object for an ongoing call associated with this packet, if
-  // any. The iterator will be calls_end() if no match was found.
-  IntrusiveList<Call>::iterator FindCall(const Packet& packet)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return std::get<1>(FindIteratorsForCall(packet.channel_id(),
-                                            packet.service_id(),
-                                            packet.method_id(),
-                                            packet.call_id()));
-  }
-
-  // Used to check if a call iterator is valid or not.
-  IntrusiveList<Call>::const_iterator calls_end() const
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return calls_.end();
+  // any. Returns nullptr if no match was found.
+  Call* FindCall(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    CallPosition position = FindCallPosition(packet.channel_id(),
+                                             packet.service_id(),
+                                             packet.method_id(),
+                                             packet.call_id());
+    return position.found() ? &*position.call : nullptr;
   }
 
   // Aborts calls associated with a particular service. Calls to
@@ -146,20 +151,31 @@ class Endpoint {
   // This method is protected so it can be exposed in tests.
   void CloseCallAndMarkForCleanup(Call& call, Status error)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    // Remove the call before closing it, since closing clears the IDs that
+    // select its list.
+    CallList(call).remove(call);
     call.CloseAndMarkForCleanupFromEndpoint(error);
-    calls_.remove(call);
     to_cleanup_.push_front(call);
   }
 
+  // The location of a call in the calls_ registry: the list that holds it and
+  // iterators to the call and the item before it.
+  struct CallPosition {
+    IntrusiveList<Call>* list;
+    IntrusiveList<Call>::iterator before_call;
+    IntrusiveList<Call>::iterator call;
+
+    bool found() const { return call != list->end(); }
+  };
+
   // Iterator version of CloseCallAndMarkForCleanup. Returns the iterator to the
   // item after the closed call.
   IntrusiveList<Call>::iterator CloseCallAndMarkForCleanup(
-      IntrusiveList<Call>::iterator before_call,
-      IntrusiveList<Call>::iterator call_iterator,
-      Status error) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    Call& call = *call_iterator;
+      CallPosition position, Status error)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    Call& call = *position.call;
     call.CloseAndMarkForCleanupFromEndpoint(error);
-    auto next = calls_.erase_after(before_call);
+    auto next = position.list->erase_after(position.before_call);
     to_cleanup_.push_front(call);
     return next;
   }
@@ -190,7 +206,7 @@ class Endpoint {
   // Registers a call that is known to be unique. The calls list is NOT checked
   // for existing calls.
   void RegisterUniqueCall(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    calls_.push_front(call);
+    CallList(call).push_front(call);
   }
 
   void CleanUpCall(Call& call) PW_UNLOCK_FUNCTION(rpc_lock()) {
@@ -202,26 +218,79 @@ class Endpoint {
   // Removes the provided call from the call registry.
   void UnregisterCall(const Call& call)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    bool closed_call_was_in_list = calls_.remove(call);
+    bool closed_call_was_in_list = CallList(call).remove(call);
     PW_DASSERT(closed_call_was_in_list);
   }
 
-  std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-  FindIteratorsForCall(uint32_t channel_id,
-                       uint32_t service_id,
-                       uint32_t method_id,
-                       uint32_t call_id)
+  // Returns the list that holds active calls with these IDs. If
+  // PW_RPC_CALL_INDEX_BUCKETS is 0, all active calls are in one list.
+  IntrusiveList<Call>& CallList(uint32_t channel_id,
+                                uint32_t service_id,
+                                uint32_t method_id,
+                                uint32_t call_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+    return calls_[CallBucket(channel_id, service_id, method_id, call_id)];
+#else
+    static_cast<void>(channel_id);
+    static_cast<void>(service_id);
+    static_cast<void>(method_id);
+    static_cast<void>(call_id);
+    return calls_;
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+  }
+
+  IntrusiveList<Call>& CallList(const Call& call)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return CallList(call.channel_id_locked(),
+                    call.service_id(),
+                    call.method_id(),
+                    call.id());
+  }
+
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  static constexpr size_t CallBucket(uint32_t channel_id,
+                                     uint32_t service_id,
+                                     uint32_t method_id,
+                                     uint32_t call_id) {
+    // Service and method IDs are already hashes. Spread the channel and call
+    // IDs, which are small integers, across the upper bits before folding.
+    uint32_t hash = service_id ^ (method_id * 0x9e3779b1u) ^
+                    (channel_id * 0x85ebca77u) ^ (call_id * 0xc2b2ae3du);
+    hash ^= hash >> 16;
+    return hash & (PW_RPC_CALL_INDEX_BUCKETS - 1);
+  }
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
+
+  // Finds the call with these IDs. A call_id of kOpenCallId matches any call
+  // for the RPC, and a call with ID kOpenCallId is assigned call_id.
+  CallPosition FindCallPosition(uint32_t channel_id,
+                                uint32_t service_id,
+                                uint32_t method_id,
+                                uint32_t call_id)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
-  std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-  FindIteratorsForCall(const Call& call)
+  CallPosition FindCallPosition(const Call& call)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return FindIteratorsForCall(call.channel_id_locked(),
-                                call.service_id(),
-                                call.method_id(),
-                                call.id());
+    return FindCallPosition(call.channel_id_locked(),
+                            call.service_id(),
+                            call.method_id(),
+                            call.id());
   }
 
+  // Searches one list for the call with these IDs.
+  CallPosition FindCallInList(IntrusiveList<Call>& list,
+                              uint32_t channel_id,
+                              uint32_t service_id,
+                              uint32_t method_id,
+                              uint32_t call_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Aborts matching calls in one list. Helper for AbortCalls().
+  void AbortCallsInList(IntrusiveList<Call>& list,
+                        AbortIdType type,
+                        uint32_t id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
   // Silently closes all calls. Called by the destructor. This is a
   // non-destructor function so that Clang's lock safety analysis applies.
   //
@@ -237,7 +306,16 @@ class Endpoint {
 
   // List of all active calls associated with this endpoint. Calls are added to
   // this list when they start and removed from it when they finish.
+  //
+  // If PW_RPC_CALL_INDEX_BUCKETS is set, the calls are instead split across
+  // that many lists by a hash of their IDs, so finding the call for a packet
+  // does not scan every active call.
+#if PW_RPC_CALL_INDEX_BUCKETS > 0
+  std::array<IntrusiveList<Call>, PW_RPC_CALL_INDEX_BUCKETS> calls_
+      PW_GUARDED_BY(rpc_lock());
+#else
   IntrusiveList<Call> calls_ PW_GUARDED_BY(rpc_lock());
+#endif  // PW_RPC_CALL_INDEX_BUCKETS > 0
 
   // List of all inactive calls that need to have their on_error callbacks
   // called. Calling on_error requires releasing the RPC lock, so calls are
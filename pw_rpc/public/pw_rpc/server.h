@@ -13,13 +13,16 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <tuple>
 
 #include "pw_containers/intrusive_list.h"
 #include "pw_rpc/channel.h"
 #include "pw_rpc/internal/call.h"
 #include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/endpoint.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/method.h"
@@ -54,11 +57,12 @@ class Server : public internal::Endpoint {
   void RegisterService(Service& service, OtherServices&... services)
       PW_LOCKS_EXCLUDED(internal::rpc_lock()) {
     internal::RpcLockGuard lock;
-    services_.push_front(service);  // Register the first service
+    // Register the first service.
+    ServiceList(service.id_).push_front(service);
 
     // Register any additional services by expanding the parameter pack. This
     // is a fold expression of the comma operator.
-    (services_.push_front(services), ...);
+    (ServiceList(services.id_).push_front(services), ...);
   }
 
   // Returns whether a service is registered.
@@ -69,7 +73,7 @@ class Server : public internal::Endpoint {
       PW_LOCKS_EXCLUDED(internal::rpc_lock()) {
     internal::RpcLockGuard lock;
 
-    for (const Service& svc : services_) {
+    for (const Service& svc : ServiceList(service.id_)) {
       if (&svc == &service) {
         return true;
       }
@@ -173,18 +177,18 @@ class Server : public internal::Endpoint {
 
   void HandleCompletionRequest(const internal::Packet& packet,
                                internal::Channel& channel,
-                               IntrusiveList<internal::Call>::iterator call)
-      const PW_UNLOCK_FUNCTION(internal::rpc_lock());
+                               internal::Call* call) const
+      PW_UNLOCK_FUNCTION(internal::rpc_lock());
 
   void HandleClientStreamPacket(const internal::Packet& packet,
                                 internal::Channel& channel,
-                                IntrusiveList<internal::Call>::iterator call)
-      const PW_UNLOCK_FUNCTION(internal::rpc_lock());
+                                internal::Call* call) const
+      PW_UNLOCK_FUNCTION(internal::rpc_lock());
 
   template <typename... OtherServices>
   void UnregisterServiceLocked(Service& service, OtherServices&... services)
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
-    services_.remove(service);
+    ServiceList(service.id_).remove(service);
     UnregisterServiceLocked(services...);
     AbortCallsForService(service);
   }
@@ -197,7 +201,33 @@ class Server : public internal::Endpoint {
   using Endpoint::CleanUpCalls;
   using Endpoint::GetInternalChannel;
 
+  // Returns the list that holds services with this ID. If
+  // PW_RPC_SERVICE_INDEX_BUCKETS is 0, all services are in one list.
+  IntrusiveList<Service>& ServiceList(uint32_t service_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
+#if PW_RPC_SERVICE_INDEX_BUCKETS > 0
+    // Service IDs are hashes of the service names, so use their low bits.
+    return services_[service_id & (PW_RPC_SERVICE_INDEX_BUCKETS - 1)];
+#else
+    static_cast<void>(service_id);
+    return services_;
+#endif  // PW_RPC_SERVICE_INDEX_BUCKETS > 0
+  }
+
+  const IntrusiveList<Service>& ServiceList(uint32_t service_id) const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
+    return const_cast<Server*>(this)->ServiceList(service_id);
+  }
+
+  // Registered services. If PW_RPC_SERVICE_INDEX_BUCKETS is set, services are
+  // split across that many lists by service ID, so finding the service for a
+  // packet does not scan every registered service.
+#if PW_RPC_SERVICE_INDEX_BUCKETS > 0
+  std::array<IntrusiveList<Service>, PW_RPC_SERVICE_INDEX_BUCKETS> services_
+      PW_GUARDED_BY(internal::rpc_lock());
+#else
   IntrusiveList<Service> services_ PW_GUARDED_BY(internal::rpc_lock());
+#endif  // PW_RPC_SERVICE_INDEX_BUCKETS > 0
 };
 
 }  // namespace pw::rpc
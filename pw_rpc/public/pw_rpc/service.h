@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
@@ -48,16 +50,16 @@ class Service : public IntrusiveList<Service>::Item {
   // a `const internal::MethodUnion*`.
   template <typename T, size_t kMethodCount>
   constexpr Service(uint32_t id, const std::array<T, kMethodCount>& methods)
-      : id_(id),
-        methods_(methods.data()),
-        method_size_(sizeof(T)),
-        method_count_(static_cast<uint16_t>(kMethodCount)) {
-    PW_MODIFY_DIAGNOSTICS_PUSH();
-    // GCC 10 emits spurious -Wtype-limits warnings for the static_assert.
-    PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wtype-limits");
-    static_assert(kMethodCount <= std::numeric_limits<uint16_t>::max());
-    PW_MODIFY_DIAGNOSTICS_POP();
-  }
+      : Service(id, methods, nullptr) {}
+
+  // Generated services also provide the IDs of their methods, in the same order
+  // as `methods`. The IDs must be sorted in ascending order, so FindMethod can
+  // binary search them instead of checking each method.
+  template <typename T, size_t kMethodCount>
+  constexpr Service(uint32_t id,
+                    const std::array<T, kMethodCount>& methods,
+                    const std::array<uint32_t, kMethodCount>& sorted_method_ids)
+      : Service(id, methods, sorted_method_ids.data()) {}
 
   // For use by tests with only one method.
   //
@@ -65,17 +67,49 @@ class Service : public IntrusiveList<Service>::Item {
   // is not considered part of the public API.
   template <typename T>
   constexpr Service(uint32_t id, const T& method)
-      : id_(id), methods_(&method), method_size_(sizeof(T)), method_count_(1) {}
+      : id_(id),
+        methods_(&method),
+        method_ids_(nullptr),
+        method_size_(sizeof(T)),
+        method_count_(1) {}
 
  private:
   friend class Server;
   friend class ServiceTestHelper;
 
+  template <typename T, size_t kMethodCount>
+  constexpr Service(uint32_t id,
+                    const std::array<T, kMethodCount>& methods,
+                    const uint32_t* sorted_method_ids)
+      : id_(id),
+        methods_(methods.data()),
+        method_ids_(sorted_method_ids),
+        method_size_(sizeof(T)),
+        method_count_(static_cast<uint16_t>(kMethodCount)) {
+    PW_MODIFY_DIAGNOSTICS_PUSH();
+    // GCC 10 emits spurious -Wtype-limits warnings for the static_assert.
+    PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wtype-limits");
+    static_assert(kMethodCount <= std::numeric_limits<uint16_t>::max());
+    PW_MODIFY_DIAGNOSTICS_POP();
+  }
+
   // Finds the method with the provided method_id. Returns nullptr if no match.
   const internal::Method* FindMethod(uint32_t method_id) const;
 
+  // Returns the method at this index in the methods_ array.
+  const internal::Method& MethodAt(size_t index) const {
+    const auto raw = reinterpret_cast<const std::byte*>(methods_);
+    return reinterpret_cast<const internal::MethodUnion*>(
+               raw + index * method_size_)
+        ->method();
+  }
+
   const uint32_t id_;
   const internal::MethodUnion* const methods_;
+
+  // Sorted IDs of the methods in methods_, or nullptr if not provided.
+  const uint32_t* const method_ids_;
+
   const uint16_t method_size_;
   const uint16_t method_count_;
 };
@@ -16,7 +16,7 @@
 import abc
 from datetime import datetime
 import os
-from typing import cast, Any, Iterable, Union
+from typing import cast, Any, Iterable, List, Union
 
 from pw_protobuf.output_file import OutputFile
 from pw_protobuf.proto_tree import ProtoNode, ProtoService, ProtoServiceMethod
@@ -54,6 +54,11 @@ def get_id(item: Union[ProtoService, ProtoServiceMethod]) -> str:
     return f'0x{ids.calculate(name):08x}'
 
 
+def _methods_by_id(service: ProtoService) -> List[ProtoServiceMethod]:
+    """Returns a service's methods sorted by ID, for binary search lookups."""
+    return sorted(service.methods(), key=lambda m: ids.calculate(m.name()))
+
+
 def client_call_type(method: ProtoServiceMethod, prefix: str) -> str:
     """Returns Client ReaderWriter/Reader/Writer/Recevier for the call."""
     if method.type() is ProtoServiceMethod.Type.UNARY:
@@ -400,7 +405,7 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
     with gen.indent():
         gen.line(
             'constexpr Service() : '
-            f'{base_class}(kServiceId, kPwRpcMethods) {{}}'
+            f'{base_class}(kServiceId, kPwRpcMethods, kPwRpcMethodIds) {{}}'
         )
 
     gen.line()
@@ -410,7 +415,7 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
         gen.line('friend class ::pw::rpc::internal::MethodLookup;')
         gen.line()
 
-        # Generate the method table
+        # Generate the method table, sorted by method ID.
         gen.line(
             'static constexpr std::array<'
             f'{RPC_NAMESPACE}::internal::{gen.method_union_name()},'
@@ -418,7 +423,7 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
         )
 
         with gen.indent(4):
-            for method in service.methods():
+            for method in _methods_by_id(service):
                 gen.method_descriptor(method)
 
         gen.line('};\n')
@@ -430,14 +435,14 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
 
 
 def _method_lookup_table(gen: CodeGenerator, service: ProtoService) -> None:
-    """Generates array of method IDs for looking up methods at compile time."""
+    """Generates the sorted array of method IDs used to look up methods."""
     gen.line(
         'static constexpr std::array<uint32_t, '
         f'{len(service.methods())}> kPwRpcMethodIds = {{'
     )
 
     with gen.indent(4):
-        for method in service.methods():
+        for method in _methods_by_id(service):
             gen.line(f'{get_id(method)},  // Hash of "{method.name()}"')
 
     gen.line('};')
@@ -79,14 +79,14 @@ Status Server::ProcessPacket(ConstByteSpan packet_data) {
     return OkStatus();
   }
 
-  IntrusiveList<internal::Call>::iterator call = FindCall(packet);
+  internal::Call* call = FindCall(packet);
 
   switch (packet.type()) {
     case PacketType::CLIENT_STREAM:
       HandleClientStreamPacket(packet, *channel, call);
       break;
     case PacketType::CLIENT_ERROR:
-      if (call != calls_end()) {
+      if (call != nullptr) {
         call->HandleError(packet.status());
       } else {
         internal::rpc_lock().unlock();
@@ -111,22 +111,22 @@ Status Server::ProcessPacket(ConstByteSpan packet_data) {
 std::tuple<Service*, const internal::Method*> Server::FindMethod(
     const internal::Packet& packet) {
   // Packets always include service and method IDs.
-  auto service = std::find_if(services_.begin(), services_.end(), [&](auto& s) {
+  IntrusiveList<Service>& services = ServiceList(packet.service_id());
+  auto service = std::find_if(services.begin(), services.end(), [&](auto& s) {
     return internal::UnwrapServiceId(s.service_id()) == packet.service_id();
   });
 
-  if (service == services_.end()) {
+  if (service == services.end()) {
     return {};
   }
 
   return {&(*service), service->FindMethod(packet.method_id())};
 }
 
-void Server::HandleCompletionRequest(
-    const internal::Packet& packet,
-    internal::Channel& channel,
-    IntrusiveList<internal::Call>::iterator call) const {
-  if (call == calls_end()) {
+void Server::HandleCompletionRequest(const internal::Packet& packet,
+                                     internal::Channel& channel,
+                                     internal::Call* call) const {
+  if (call == nullptr) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
     internal::rpc_lock().unlock();
@@ -151,11 +151,10 @@ void Server::HandleCompletionRequest(
   static_cast<internal::ServerCall&>(*call).HandleClientRequestedCompletion();
 }
 
-void Server::HandleClientStreamPacket(
-    const internal::Packet& packet,
-    internal::Channel& channel,
-    IntrusiveList<internal::Call>::iterator call) const {
-  if (call == calls_end()) {
+void Server::HandleClientStreamPacket(const internal::Packet& packet,
+                                      internal::Channel& channel,
+                                      internal::Call* call) const {
+  if (call == nullptr) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
     internal::rpc_lock().unlock();
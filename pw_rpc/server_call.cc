@@ -22,6 +22,10 @@ void ServerCall::MoveServerCallFrom(ServerCall& other) {
   // If this call is active, finish it first.
   if (active_locked()) {
     CloseAndSendResponseLocked(OkStatus()).IgnoreError();
+#if PW_RPC_CONCURRENT_SEND
+    // The RPC lock was released to send the response, so wait again.
+    WaitUntilReadyForMove(*this, other);
+#endif  // PW_RPC_CONCURRENT_SEND
   }
 
   MoveFrom(other);
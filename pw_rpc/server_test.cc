@@ -368,6 +368,54 @@ TEST_F(BasicServer, CloseChannel_PendingCall) {
   ASSERT_EQ(output_.total_packets(), 0u);
 }
 
+TEST_F(BasicServer, ManyCalls_PacketsReachTheirCalls) {
+  constexpr uint32_t kCallsPerChannel = 16;
+
+  struct Events {
+    int payloads = 0;
+    Status error;
+  };
+
+  std::array<internal::test::FakeServerReaderWriter, 2 * kCallsPerChannel>
+      calls;
+  std::array<Events, 2 * kCallsPerChannel> events{};
+
+  for (uint32_t i = 0; i < calls.size(); ++i) {
+    internal::rpc_lock().lock();
+    internal::CallContext context(server_,
+                                  channels_[i % 2].id(),
+                                  service_42_,
+                                  service_42_.method(100),
+                                  /*call_id=*/i / 2);
+    internal::test::FakeServerReaderWriter call(context.ClaimLocked());
+    internal::rpc_lock().unlock();
+    calls[i] = std::move(call);
+    calls[i].set_on_next([&e = events[i]](ConstByteSpan) { e.payloads += 1; });
+    calls[i].set_on_error([&e = events[i]](Status error) { e.error = error; });
+  }
+  EXPECT_EQ(static_cast<internal::Endpoint&>(server_).active_call_count(),
+            calls.size());
+
+  for (uint32_t i = 0; i < calls.size(); ++i) {
+    ASSERT_EQ(OkStatus(),
+              server_.ProcessPacket(EncodePacket(
+                  PacketType::CLIENT_STREAM, 1 + i % 2, 42, 100, i / 2)));
+  }
+  for (const Events& e : events) {
+    EXPECT_EQ(e.payloads, 1);
+  }
+
+  // Closing a channel aborts only the calls on that channel.
+  EXPECT_EQ(OkStatus(), server_.CloseChannel(1));
+  for (uint32_t i = 0; i < calls.size(); ++i) {
+    EXPECT_EQ(calls[i].active(), i % 2 == 1);
+    EXPECT_EQ(events[i].error, i % 2 == 0 ? Status::Aborted() : OkStatus());
+  }
+
+  EXPECT_EQ(OkStatus(), server_.CloseChannel(2));
+  EXPECT_EQ(static_cast<internal::Endpoint&>(server_).active_call_count(), 0u);
+}
+
 TEST_F(BasicServer, OpenChannel_UnusedSlot) {
   const span request = EncodePacket(PacketType::REQUEST, 9, 42, 100);
   EXPECT_EQ(Status::Unavailable(), server_.ProcessPacket(request));
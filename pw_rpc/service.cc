@@ -14,23 +14,27 @@
 
 #include "pw_rpc/service.h"
 
+#include <algorithm>
 #include <cstddef>
-#include <type_traits>
+#include <cstdint>
 
 namespace pw::rpc {
 
 const internal::Method* Service::FindMethod(uint32_t method_id) const {
-  const internal::MethodUnion* method_impl = methods_;
+  if (method_ids_ != nullptr) {
+    const uint32_t* const end = method_ids_ + method_count_;
+    const uint32_t* const id = std::lower_bound(method_ids_, end, method_id);
+    if (id == end || *id != method_id) {
+      return nullptr;
+    }
+    return &MethodAt(static_cast<size_t>(id - method_ids_));
+  }
 
   for (size_t i = 0; i < method_count_; ++i) {
-    const internal::Method* method = &method_impl->method();
-    if (method->id() == method_id) {
-      return method;
+    const internal::Method& method = MethodAt(i);
+    if (method.id() == method_id) {
+      return &method;
     }
-
-    const auto raw = reinterpret_cast<const std::byte*>(method_impl);
-    method_impl =
-        reinterpret_cast<const internal::MethodUnion*>(raw + method_size_);
   }
 
   return nullptr;
@@ -0,0 +1,157 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how long a server takes to find the service and method for a packet
+// when many services are registered. Set PW_RPC_SERVICE_INDEX_BUCKETS to
+// compare the bucketed service registry with the default list scan.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#include "pw_assert/check.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc/internal/hash.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc/service.h"
+#include "pw_rpc_private/test_method.h"
+
+namespace pw::rpc {
+namespace {
+
+using internal::Packet;
+using internal::TestMethod;
+using internal::TestMethodUnion;
+using internal::pwpb::PacketType;
+
+constexpr uint32_t kChannelId = 1;
+constexpr size_t kMethodCount = 16;
+
+// Method IDs in ascending order, so services may provide them for lookups.
+constexpr std::array<uint32_t, kMethodCount> kMethodIds = [] {
+  std::array<uint32_t, kMethodCount> ids{};
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ids[i] = static_cast<uint32_t>(0x1000 * (i + 1));
+  }
+  return ids;
+}();
+
+template <size_t... kIndices>
+std::array<TestMethodUnion, kMethodCount> MakeMethods(
+    std::index_sequence<kIndices...>) {
+  return {TestMethod(kMethodIds[kIndices])...};
+}
+
+// All services share one method table.
+const std::array<TestMethodUnion, kMethodCount> kMethods =
+    MakeMethods(std::make_index_sequence<kMethodCount>());
+
+// Hashes "Service0", "Service1", etc. as generated service IDs would be.
+uint32_t ServiceId(size_t index) {
+  char name[] = "Service00";
+  name[7] = static_cast<char>('0' + index / 10);
+  name[8] = static_cast<char>('0' + index % 10);
+  return internal::Hash(std::string_view(name, sizeof(name) - 1));
+}
+
+class NullOutput final : public ChannelOutput {
+ public:
+  NullOutput() : ChannelOutput("NullOutput") {}
+
+ private:
+  Status Send(span<const std::byte>) override { return OkStatus(); }
+};
+
+// A service that looks up its methods by checking each one.
+class LinearService : public Service {
+ public:
+  LinearService(uint32_t id) : Service(id, kMethods) {}
+};
+
+// A service that provides sorted method IDs, as generated services do.
+class SortedService : public Service {
+ public:
+  SortedService(uint32_t id) : Service(id, kMethods, kMethodIds) {}
+};
+
+template <typename ServiceType, size_t... kIndices>
+std::array<ServiceType, sizeof...(kIndices)> MakeServices(
+    std::index_sequence<kIndices...>) {
+  return {ServiceType(ServiceId(kIndices))...};
+}
+
+// A server with kServices registered services.
+template <typename ServiceType, size_t kServices>
+class RegisteredServices {
+ public:
+  RegisteredServices()
+      : channels_{Channel::Create<kChannelId>(&output_)},
+        server_(channels_),
+        services_(MakeServices<ServiceType>(
+            std::make_index_sequence<kServices>())) {
+    // Services are pushed to the front of the list, so the first registered
+    // service is the last one the default registry checks.
+    for (ServiceType& service : services_) {
+      server_.RegisterService(service);
+    }
+
+    // Address packets to the last method of the first service. CLIENT_ERROR
+    // packets for calls that are not open only exercise the dispatch path.
+    const Result<ConstByteSpan> packet =
+        Packet(PacketType::CLIENT_ERROR,
+               kChannelId,
+               ServiceId(0),
+               kMethodIds.back(),
+               /*call_id=*/1)
+            .Encode(packet_buffer_);
+    PW_CHECK_OK(packet.status());
+    packet_ = *packet;
+  }
+
+  void ProcessPacket() { server_.ProcessPacket(packet_).IgnoreError(); }
+
+ private:
+  NullOutput output_;
+  std::array<Channel, 1> channels_;
+  Server server_;
+  std::array<ServiceType, kServices> services_;
+
+  std::byte packet_buffer_[32];
+  ConstByteSpan packet_;
+};
+
+template <typename Services>
+void DispatchPacket(perf_test::State& state) {
+  static Services services;
+
+  while (state.KeepRunning()) {
+    services.ProcessPacket();
+  }
+}
+
+using Linear1 = RegisteredServices<LinearService, 1>;
+using Linear64 = RegisteredServices<LinearService, 64>;
+using Sorted1 = RegisteredServices<SortedService, 1>;
+using Sorted64 = RegisteredServices<SortedService, 64>;
+
+PW_PERF_TEST(LinearMethods1Service, DispatchPacket<Linear1>);
+PW_PERF_TEST(LinearMethods64Services, DispatchPacket<Linear64>);
+PW_PERF_TEST(SortedMethods1Service, DispatchPacket<Sorted1>);
+PW_PERF_TEST(SortedMethods64Services, DispatchPacket<Sorted64>);
+
+}  // namespace
+}  // namespace pw::rpc
@@ -80,6 +80,36 @@ TEST(Service, MultipleMethods_FindMethod_NotPresent) {
   EXPECT_EQ(ServiceTestHelper::FindMethod(service, 999), nullptr);
 }
 
+class SortedTestService : public Service {
+ public:
+  constexpr SortedTestService() : Service(0xabcd, kMethods, kMethodIds) {}
+
+  static constexpr std::array<ServiceTestMethodUnion, 5> kMethods = {
+      ServiceTestMethod(2, 'a'),
+      ServiceTestMethod(3, 'b'),
+      ServiceTestMethod(5, 'c'),
+      ServiceTestMethod(7, 'd'),
+      ServiceTestMethod(11, 'e'),
+  };
+  static constexpr std::array<uint32_t, 5> kMethodIds = {2, 3, 5, 7, 11};
+};
+
+TEST(Service, SortedMethodIds_FindMethod_Present) {
+  SortedTestService service;
+  for (size_t i = 0; i < SortedTestService::kMethods.size(); ++i) {
+    EXPECT_EQ(
+        ServiceTestHelper::FindMethod(service, SortedTestService::kMethodIds[i]),
+        &SortedTestService::kMethods[i].method());
+  }
+}
+
+TEST(Service, SortedMethodIds_FindMethod_NotPresent) {
+  SortedTestService service;
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 0), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 4), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 12), nullptr);
+}
+
 class EmptyTestService : public Service {
  public:
   constexpr EmptyTestService() : Service(0xabcd, kMethods) {}
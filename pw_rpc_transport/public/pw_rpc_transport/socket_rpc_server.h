@@ -0,0 +1,195 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_function/function.h"
+#include "pw_rpc_transport/rpc_transport.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/thread_core.h"
+
+namespace pw::rpc {
+
+// A client connection accepted by a SocketRpcServer. Connections are
+// RpcFrameSenders, so an RpcEgress can send packets to the client over them.
+class SocketRpcConnection : public RpcFrameSender {
+ public:
+  SocketRpcConnection() = default;
+
+  SocketRpcConnection(const SocketRpcConnection&) = delete;
+  SocketRpcConnection& operator=(const SocketRpcConnection&) = delete;
+
+  // The index of this connection within its server's connections. Indices are
+  // reused once a connection closes.
+  size_t index() const { return index_; }
+
+  size_t MaximumTransmissionUnit() const override { return mtu_; }
+
+  // Sends the frame to the client without blocking. If the socket's send
+  // buffer is full, the client is not keeping up, so the connection is shut
+  // down rather than stalling the serving thread; the client may have
+  // received part of the frame.
+  //
+  // Returns FAILED_PRECONDITION if the connection is closed,
+  // RESOURCE_EXHAUSTED if the send buffer was full, or OUT_OF_RANGE if the
+  // client disconnected.
+  Status Send(RpcFrame frame) override;
+
+ private:
+  friend class SocketRpcServer;
+
+  void Open(int fd, size_t mtu);
+  void set_ingress(RpcIngressHandler* ingress);
+  void Close();
+
+  // The thread handling the connection's events copies these while holding
+  // mutex_, so that the next thread to handle them sees its changes.
+  sync::Mutex mutex_;
+  int fd_ PW_GUARDED_BY(mutex_) = -1;
+  RpcIngressHandler* ingress_ PW_GUARDED_BY(mutex_) = nullptr;
+
+  size_t mtu_ = 0;
+  size_t index_ = 0;
+  bool in_use_ = false;  // Guarded by the server's mutex.
+};
+
+// Serves RPC clients over many socket connections from one or a few threads.
+// Connections are non-blocking sockets that are multiplexed with epoll, so no
+// thread is dedicated to a connection. Each serving thread reads into a read
+// buffer from a small pool rather than each connection having its own.
+//
+// When a client connects, the accept handler returns the RpcIngressHandler
+// that the client's data is passed to, typically an RpcIngress for a channel
+// owned by that client. Replies are sent with the connection's Send(). A
+// connection is only handled by one thread at a time, so each ingress is only
+// accessed from one thread at a time, as RpcIngress requires.
+//
+// Sends never block, so a client that stops reading cannot stall the other
+// connections on its serving thread. Instead, a client whose socket send
+// buffer fills up is disconnected.
+//
+// This class is only available on Linux. Use SocketRpcServerBuffer to declare
+// a server with its connections and read buffers.
+class SocketRpcServer : public thread::ThreadCore {
+ public:
+  // Called from a serving thread when a client connects. Returns the ingress
+  // for data received on the connection, or nullptr to reject the client. May
+  // be called from several serving threads at once, for different
+  // connections.
+  using AcceptHandler = Function<RpcIngressHandler*(SocketRpcConnection&)>;
+
+  // Called from a serving thread when a connection that was accepted closes,
+  // before its index is reused.
+  using CloseHandler = Function<void(SocketRpcConnection&)>;
+
+  // The server must be closed before it is destroyed.
+  ~SocketRpcServer() override;
+
+  SocketRpcServer(const SocketRpcServer&) = delete;
+  SocketRpcServer& operator=(const SocketRpcServer&) = delete;
+
+  // Starts listening for clients on the port. If port is 0, the OS picks one;
+  // use port() to find out which.
+  Status Listen(uint16_t port = 0);
+
+  uint16_t port() const { return port_; }
+
+  // Returns the number of connections that are currently open.
+  size_t num_connections();
+
+  // Accepts clients and passes their data to their ingresses until Stop() is
+  // called. Serve() may be called from as many threads at once as there are
+  // read buffers.
+  void Serve();
+
+  // Makes all calls to Serve() return. Call Close() once they have returned to
+  // close all connections.
+  void Stop();
+
+  // Closes all connections and stops listening. Must not be called while any
+  // thread is serving.
+  void Close();
+
+ protected:
+  // read_buffers is split into buffers of read_buffer_size bytes, up to 32.
+  SocketRpcServer(span<SocketRpcConnection> connections,
+                  ByteSpan read_buffers,
+                  size_t read_buffer_size,
+                  AcceptHandler&& accept_handler,
+                  CloseHandler&& close_handler);
+
+ private:
+  void Run() override { Serve(); }
+
+  ByteSpan AcquireReadBuffer();
+  void ReleaseReadBuffer(ByteSpan buffer);
+
+  SocketRpcConnection* AllocateConnection();
+  void FreeConnection(SocketRpcConnection& connection);
+
+  void AcceptConnections();
+  void HandleConnectionEvent(SocketRpcConnection& connection, ByteSpan buffer);
+  void CloseConnection(SocketRpcConnection& connection);
+
+  const span<SocketRpcConnection> connections_;
+  const ByteSpan read_buffers_;
+  const size_t read_buffer_size_;
+  AcceptHandler accept_handler_;
+  CloseHandler close_handler_;
+
+  int epoll_fd_ = -1;
+  int listen_fd_ = -1;
+  int stop_fd_ = -1;
+  uint16_t port_ = 0;
+
+  sync::Mutex mutex_;
+  uint32_t free_read_buffers_ PW_GUARDED_BY(mutex_);
+};
+
+// A SocketRpcServer with storage for up to kMaxConnections connections and
+// kReadBuffers serving threads, each reading up to kReadBufferSize bytes at a
+// time. kReadBufferSize is also the MTU of each connection.
+template <size_t kMaxConnections,
+          size_t kReadBufferSize,
+          size_t kReadBuffers = 1>
+class SocketRpcServerBuffer : public SocketRpcServer {
+ public:
+  explicit SocketRpcServerBuffer(AcceptHandler&& accept_handler,
+                                 CloseHandler&& close_handler = nullptr)
+      : SocketRpcServer(connections_,
+                        read_buffers_,
+                        kReadBufferSize,
+                        std::move(accept_handler),
+                        std::move(close_handler)) {}
+
+  // Closes the server while its connections still exist.
+  ~SocketRpcServerBuffer() override { Close(); }
+
+ private:
+  static_assert(kMaxConnections > 0u);
+  static_assert(kReadBufferSize > 0u);
+  static_assert(kReadBuffers > 0u && kReadBuffers <= 32u);
+
+  std::array<SocketRpcConnection, kMaxConnections> connections_;
+  std::array<std::byte, kReadBufferSize * kReadBuffers> read_buffers_;
+};
+
+}  // namespace pw::rpc
@@ -15,6 +15,7 @@
 
 #include <signal.h>
 
+#include <array>
 #include <atomic>
 #include <mutex>
 
@@ -76,10 +77,9 @@ class SocketRpcTransport : public RpcFrameSender, public thread::ThreadCore {
   void set_ingress(RpcIngressHandler& ingress) { ingress_ = &ingress; }
 
   Status Send(RpcFrame frame) override {
+    const std::array<ConstByteSpan, 2> buffers = {frame.header, frame.payload};
     std::lock_guard lock(write_mutex_);
-    PW_TRY(socket_stream_.Write(frame.header));
-    PW_TRY(socket_stream_.Write(frame.payload));
-    return OkStatus();
+    return socket_stream_.WriteV(buffers);
   }
 
   // Returns once the transport is connected to its peer.
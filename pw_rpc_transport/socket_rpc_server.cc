@@ -0,0 +1,417 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#define PW_LOG_MODULE_NAME "PW_RPC"
+
+#include "pw_rpc_transport/socket_rpc_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+
+#include "pw_assert/check.h"
+#include "pw_log/log.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr int kInvalidFd = -1;
+constexpr int kListenBacklog = 128;
+
+// Maximum number of events handled per epoll_wait() call.
+constexpr int kMaxEvents = 16;
+
+// Maximum number of reads from a connection per event. Once reached, the
+// connection is rearmed so that other connections get a turn.
+constexpr int kMaxReadsPerEvent = 16;
+
+constexpr uint32_t kConnectionEvents =
+    EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+
+}  // namespace
+
+void SocketRpcConnection::Open(int fd, size_t mtu) {
+  std::lock_guard lock(mutex_);
+  fd_ = fd;
+  mtu_ = mtu;
+}
+
+void SocketRpcConnection::set_ingress(RpcIngressHandler* ingress) {
+  std::lock_guard lock(mutex_);
+  ingress_ = ingress;
+}
+
+void SocketRpcConnection::Close() {
+  // Closing the socket also removes it from the epoll instance.
+  std::lock_guard lock(mutex_);
+  if (fd_ != kInvalidFd) {
+    close(fd_);
+    fd_ = kInvalidFd;
+  }
+  ingress_ = nullptr;
+}
+
+Status SocketRpcConnection::Send(RpcFrame frame) {
+  std::array<iovec, 2> iov;
+  size_t iov_count = 0;
+  for (ConstByteSpan data : {frame.header, frame.payload}) {
+    if (!data.empty()) {
+      iov[iov_count].iov_base = const_cast<std::byte*>(data.data());
+      iov[iov_count].iov_len = data.size();
+      ++iov_count;
+    }
+  }
+
+  msghdr message = {};
+  message.msg_iov = iov.data();
+  message.msg_iovlen = iov_count;
+
+  std::lock_guard lock(mutex_);
+  if (fd_ == kInvalidFd) {
+    return Status::FailedPrecondition();
+  }
+
+  while (message.msg_iovlen > 0) {
+    ssize_t bytes_sent = sendmsg(fd_, &message, MSG_NOSIGNAL);
+    if (bytes_sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        return errno == EPIPE ? Status::OutOfRange() : Status::Unknown();
+      }
+      // The socket's send buffer is full because the client is not reading.
+      // Waiting would stall every connection handled by this thread, so drop
+      // the client instead. The serving thread sees the shutdown and closes
+      // the connection.
+      shutdown(fd_, SHUT_RDWR);
+      return Status::ResourceExhausted();
+    }
+
+    // Skip past the data that was sent.
+    while (message.msg_iovlen > 0 &&
+           static_cast<size_t>(bytes_sent) >= message.msg_iov->iov_len) {
+      bytes_sent -= static_cast<ssize_t>(message.msg_iov->iov_len);
+      ++message.msg_iov;
+      --message.msg_iovlen;
+    }
+    if (message.msg_iovlen > 0) {
+      message.msg_iov->iov_base =
+          static_cast<std::byte*>(message.msg_iov->iov_base) + bytes_sent;
+      message.msg_iov->iov_len -= static_cast<size_t>(bytes_sent);
+    }
+  }
+  return OkStatus();
+}
+
+SocketRpcServer::SocketRpcServer(span<SocketRpcConnection> connections,
+                                 ByteSpan read_buffers,
+                                 size_t read_buffer_size,
+                                 AcceptHandler&& accept_handler,
+                                 CloseHandler&& close_handler)
+    : connections_(connections),
+      read_buffers_(read_buffers),
+      read_buffer_size_(read_buffer_size),
+      accept_handler_(std::move(accept_handler)),
+      close_handler_(std::move(close_handler)) {
+  const size_t num_read_buffers = read_buffers.size() / read_buffer_size;
+  PW_CHECK_UINT_LE(num_read_buffers, 32);
+  free_read_buffers_ =
+      num_read_buffers == 32 ? ~0u : (1u << num_read_buffers) - 1;
+}
+
+SocketRpcServer::~SocketRpcServer() {
+  // The connections belong to the derived class and are already destroyed, so
+  // only check that they were closed.
+  PW_CHECK_INT_EQ(epoll_fd_, kInvalidFd, "Close() the server first");
+  PW_CHECK_INT_EQ(listen_fd_, kInvalidFd, "Close() the server first");
+}
+
+Status SocketRpcServer::Listen(uint16_t port) {
+  if (listen_fd_ != kInvalidFd) {
+    return Status::FailedPrecondition();
+  }
+
+  const int listen_fd =
+      socket(AF_INET6, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listen_fd == kInvalidFd) {
+    return Status::Unknown();
+  }
+
+  // Allow binding to an address that may still be in use by a closed socket.
+  constexpr int value = 1;
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
+
+  sockaddr_in6 addr = {};
+  socklen_t addr_len = sizeof(addr);
+  addr.sin6_family = AF_INET6;
+  addr.sin6_port = htons(port);
+  addr.sin6_addr = in6addr_any;
+  if (bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), addr_len) < 0 ||
+      listen(listen_fd, kListenBacklog) < 0 ||
+      getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len) <
+          0) {
+    close(listen_fd);
+    return Status::Unknown();
+  }
+
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  listen_fd_ = listen_fd;
+  port_ = ntohs(addr.sin6_port);
+  if (epoll_fd_ == kInvalidFd || stop_fd_ == kInvalidFd) {
+    Close();
+    return Status::Unknown();
+  }
+
+  // The listening socket is edge-triggered, so only one serving thread is
+  // woken per new client. The stop event is level-triggered and never cleared,
+  // so it wakes every serving thread.
+  epoll_event listen_event = {};
+  listen_event.events = EPOLLIN | EPOLLET;
+  listen_event.data.ptr = &listen_fd_;
+  epoll_event stop_event = {};
+  stop_event.events = EPOLLIN;
+  stop_event.data.ptr = &stop_fd_;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &listen_event) < 0 ||
+      epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &stop_event) < 0) {
+    Close();
+    return Status::Unknown();
+  }
+  return OkStatus();
+}
+
+size_t SocketRpcServer::num_connections() {
+  std::lock_guard lock(mutex_);
+  size_t count = 0;
+  for (const SocketRpcConnection& connection : connections_) {
+    if (connection.in_use_) {
+      count += 1;
+    }
+  }
+  return count;
+}
+
+void SocketRpcServer::Serve() {
+  PW_CHECK_INT_NE(epoll_fd_, kInvalidFd, "Listen() must be called first");
+  const ByteSpan buffer = AcquireReadBuffer();
+
+  std::array<epoll_event, kMaxEvents> events;
+  bool stopped = false;
+  while (!stopped) {
+    const int count = epoll_wait(epoll_fd_, events.data(), kMaxEvents, -1);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      PW_LOG_ERROR("SocketRpcServer: epoll_wait failed: %s",
+                   std::strerror(errno));
+      break;
+    }
+
+    for (int i = 0; i < count; ++i) {
+      void* const source = events[i].data.ptr;
+      if (source == &stop_fd_) {
+        stopped = true;
+      } else if (source == &listen_fd_) {
+        AcceptConnections();
+      } else {
+        HandleConnectionEvent(*static_cast<SocketRpcConnection*>(source),
+                              buffer);
+      }
+    }
+  }
+
+  ReleaseReadBuffer(buffer);
+}
+
+void SocketRpcServer::Stop() {
+  if (stop_fd_ != kInvalidFd) {
+    const uint64_t value = 1;
+    [[maybe_unused]] const ssize_t result =
+        write(stop_fd_, &value, sizeof(value));
+  }
+}
+
+void SocketRpcServer::Close() {
+  for (SocketRpcConnection& connection : connections_) {
+    bool in_use;
+    {
+      std::lock_guard lock(mutex_);
+      in_use = connection.in_use_;
+    }
+    if (in_use) {
+      CloseConnection(connection);
+    }
+  }
+
+  for (int* fd : {&listen_fd_, &stop_fd_, &epoll_fd_}) {
+    if (*fd != kInvalidFd) {
+      close(*fd);
+      *fd = kInvalidFd;
+    }
+  }
+}
+
+ByteSpan SocketRpcServer::AcquireReadBuffer() {
+  std::lock_guard lock(mutex_);
+  PW_CHECK_UINT_NE(free_read_buffers_,
+                   0,
+                   "More threads are serving than there are read buffers");
+  const int index = __builtin_ctz(free_read_buffers_);
+  free_read_buffers_ &= ~(1u << index);
+  return read_buffers_.subspan(index * read_buffer_size_, read_buffer_size_);
+}
+
+void SocketRpcServer::ReleaseReadBuffer(ByteSpan buffer) {
+  const size_t index = (buffer.data() - read_buffers_.data()) /
+                       static_cast<ptrdiff_t>(read_buffer_size_);
+  std::lock_guard lock(mutex_);
+  free_read_buffers_ |= 1u << index;
+}
+
+SocketRpcConnection* SocketRpcServer::AllocateConnection() {
+  std::lock_guard lock(mutex_);
+  for (size_t i = 0; i < connections_.size(); ++i) {
+    if (!connections_[i].in_use_) {
+      connections_[i].in_use_ = true;
+      connections_[i].index_ = i;
+      return &connections_[i];
+    }
+  }
+  return nullptr;
+}
+
+void SocketRpcServer::FreeConnection(SocketRpcConnection& connection) {
+  std::lock_guard lock(mutex_);
+  connection.in_use_ = false;
+}
+
+void SocketRpcServer::AcceptConnections() {
+  // The listening socket is edge-triggered, so accept every pending client.
+  while (true) {
+    const int fd =
+        accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        PW_LOG_ERROR("SocketRpcServer: accept failed: %s",
+                     std::strerror(errno));
+      }
+      return;
+    }
+
+    SocketRpcConnection* connection = AllocateConnection();
+    if (connection == nullptr) {
+      PW_LOG_WARN("SocketRpcServer: rejecting client; all %u connections used",
+                  static_cast<unsigned>(connections_.size()));
+      close(fd);
+      continue;
+    }
+
+    // RPC packets may be sent as several small frames, so send each one
+    // immediately rather than waiting to fill a segment.
+    constexpr int value = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value));
+
+    connection->Open(fd, read_buffer_size_);
+    RpcIngressHandler* const ingress =
+        accept_handler_ != nullptr ? accept_handler_(*connection) : nullptr;
+    if (ingress == nullptr) {
+      connection->Close();
+      FreeConnection(*connection);
+      continue;
+    }
+    connection->set_ingress(ingress);
+
+    epoll_event event = {};
+    event.events = kConnectionEvents;
+    event.data.ptr = connection;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+      PW_LOG_ERROR("SocketRpcServer: failed to add connection: %s",
+                   std::strerror(errno));
+      CloseConnection(*connection);
+    }
+  }
+}
+
+void SocketRpcServer::HandleConnectionEvent(SocketRpcConnection& connection,
+                                            ByteSpan buffer) {
+  int fd;
+  RpcIngressHandler* ingress;
+  {
+    std::lock_guard lock(connection.mutex_);
+    fd = connection.fd_;
+    ingress = connection.ingress_;
+  }
+
+  // Connections are edge-triggered, so read until the socket is drained or the
+  // connection has had its turn.
+  for (int reads = 0; reads < kMaxReadsPerEvent; ++reads) {
+    const ssize_t bytes_read = recv(fd, buffer.data(), buffer.size(), 0);
+    if (bytes_read > 0) {
+      const Status status = ingress->ProcessIncomingData(
+          buffer.first(static_cast<size_t>(bytes_read)));
+      if (!status.ok()) {
+        PW_LOG_ERROR("SocketRpcServer: ingress handler error. Status %d",
+                     status.code());
+      }
+      continue;
+    }
+    if (bytes_read < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    }
+    // The client disconnected or the connection failed.
+    CloseConnection(connection);
+    return;
+  }
+
+  // Rearm the connection. If data is still pending, this queues a new event.
+  epoll_event event = {};
+  event.events = kConnectionEvents;
+  event.data.ptr = &connection;
+  int result;
+  {
+    std::lock_guard lock(connection.mutex_);
+    result = epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event);
+  }
+  if (result < 0) {
+    PW_LOG_ERROR("SocketRpcServer: failed to rearm connection: %s",
+                 std::strerror(errno));
+    CloseConnection(connection);
+  }
+}
+
+void SocketRpcServer::CloseConnection(SocketRpcConnection& connection) {
+  if (close_handler_ != nullptr) {
+    close_handler_(connection);
+  }
+  connection.Close();
+  FreeConnection(connection);
+}
+
+}  // namespace pw::rpc
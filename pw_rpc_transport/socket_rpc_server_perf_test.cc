@@ -0,0 +1,138 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+// Measures a SocketRpcServer serving clients over local loopback sockets. The
+// server echoes all data back to its clients from a single serving thread.
+//
+//   Connect:  8 clients connect, exchange one byte each, and disconnect.
+//             Divide 8 by the reported time to get connections per second.
+//   Messages: Each of N connected clients sends a 64-byte message and then
+//             each waits for its echo. Divide N by the reported time to get
+//             messages per second.
+
+#include <array>
+#include <cstddef>
+
+#include "pw_assert/check.h"
+#include "pw_bytes/span.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc_transport/socket_rpc_server.h"
+#include "pw_status/status.h"
+#include "pw_stream/socket_stream.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr size_t kMaxConnections = 256;
+constexpr size_t kReadBufferSize = 256;
+constexpr size_t kConnectClients = 8;
+constexpr size_t kMessageSize = 64;
+
+class EchoIngress : public RpcIngressHandler {
+ public:
+  void set_connection(SocketRpcConnection& connection) {
+    connection_ = &connection;
+  }
+
+  Status ProcessIncomingData(ConstByteSpan buffer) override {
+    return connection_->Send({.header = {}, .payload = buffer});
+  }
+
+ private:
+  SocketRpcConnection* connection_ = nullptr;
+};
+
+// A SocketRpcServer that echoes data, served from its own thread.
+class EchoServer {
+ public:
+  EchoServer()
+      : server_([this](SocketRpcConnection& connection) {
+          ingresses_[connection.index()].set_connection(connection);
+          return &ingresses_[connection.index()];
+        }) {
+    PW_CHECK_OK(server_.Listen());
+    thread_ = thread::Thread(thread::stl::Options(), server_);
+  }
+
+  ~EchoServer() {
+    server_.Stop();
+    thread_.join();
+    server_.Close();
+  }
+
+  uint16_t port() const { return server_.port(); }
+
+ private:
+  std::array<EchoIngress, kMaxConnections> ingresses_;
+  SocketRpcServerBuffer<kMaxConnections, kReadBufferSize> server_;
+  thread::Thread thread_;
+};
+
+void ReadExactly(stream::SocketStream& client, ByteSpan buffer) {
+  while (!buffer.empty()) {
+    auto result = client.Read(buffer);
+    PW_CHECK_OK(result.status());
+    buffer = buffer.subspan(result->size());
+  }
+}
+
+void Connect(perf_test::State& state) {
+  EchoServer server;
+  std::array<std::byte, 1> byte = {std::byte{1}};
+
+  while (state.KeepRunning()) {
+    std::array<stream::SocketStream, kConnectClients> clients;
+    for (stream::SocketStream& client : clients) {
+      PW_CHECK_OK(client.Connect("localhost", server.port()));
+      PW_CHECK_OK(client.Write(byte));
+    }
+    for (stream::SocketStream& client : clients) {
+      ReadExactly(client, byte);
+      client.Close();
+    }
+  }
+}
+
+void Messages(perf_test::State& state, size_t num_clients) {
+  static std::array<stream::SocketStream, kMaxConnections> clients;
+  PW_CHECK_UINT_LE(num_clients, clients.size());
+
+  EchoServer server;
+  for (size_t i = 0; i < num_clients; ++i) {
+    PW_CHECK_OK(clients[i].Connect("localhost", server.port()));
+  }
+
+  std::array<std::byte, kMessageSize> message{};
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < num_clients; ++i) {
+      PW_CHECK_OK(clients[i].Write(message));
+    }
+    for (size_t i = 0; i < num_clients; ++i) {
+      ReadExactly(clients[i], message);
+    }
+  }
+
+  for (size_t i = 0; i < num_clients; ++i) {
+    clients[i].Close();
+  }
+}
+
+PW_PERF_TEST(Connect8Clients, Connect);
+PW_PERF_TEST(Messages1Client, Messages, 1);
+PW_PERF_TEST(Messages16Clients, Messages, 16);
+PW_PERF_TEST(Messages128Clients, Messages, 128);
+
+}  // namespace
+}  // namespace pw::rpc
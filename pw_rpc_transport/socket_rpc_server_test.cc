@@ -0,0 +1,301 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_rpc_transport/socket_rpc_server.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "pw_bytes/span.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_status/status.h"
+#include "pw_stream/socket_stream.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/thread.h"
+#include "pw_thread_stl/options.h"
+
+namespace pw::rpc {
+namespace {
+
+using namespace std::chrono_literals;
+using chrono::SystemClock;
+
+constexpr size_t kMaxConnections = 4;
+constexpr size_t kReadBufferSize = 32;
+constexpr size_t kReadBuffers = 2;
+
+// Sends all data received on a connection back to the client.
+class EchoIngress : public RpcIngressHandler {
+ public:
+  void set_connection(SocketRpcConnection& connection) {
+    connection_ = &connection;
+  }
+
+  Status ProcessIncomingData(ConstByteSpan buffer) override {
+    EXPECT_LE(buffer.size(), kReadBufferSize);
+    return connection_->Send({.header = {}, .payload = buffer});
+  }
+
+ private:
+  SocketRpcConnection* connection_ = nullptr;
+};
+
+template <typename Condition>
+bool WaitFor(Condition condition) {
+  const SystemClock::time_point deadline =
+      SystemClock::TimePointAfterAtLeast(SystemClock::for_at_least(5s));
+  while (!condition()) {
+    if (SystemClock::now() > deadline) {
+      return false;
+    }
+    this_thread::sleep_for(SystemClock::for_at_least(1ms));
+  }
+  return true;
+}
+
+// Writes data to the client's stream and reads it back.
+void ExpectEcho(stream::SocketStream& client, ConstByteSpan data) {
+  ASSERT_EQ(client.Write(data), OkStatus());
+
+  std::vector<std::byte> received(data.size());
+  size_t size = 0;
+  while (size < received.size()) {
+    auto result = client.Read(span(received).subspan(size));
+    ASSERT_EQ(result.status(), OkStatus());
+    size += result->size();
+  }
+  EXPECT_TRUE(std::equal(data.begin(), data.end(), received.begin()));
+}
+
+std::vector<std::byte> MakeData(size_t size, uint8_t seed) {
+  std::vector<std::byte> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<std::byte>(seed + i * 7);
+  }
+  return data;
+}
+
+class SocketRpcServerTest : public ::testing::Test {
+ protected:
+  SocketRpcServerTest()
+      : server_(
+            [this](SocketRpcConnection& connection) -> RpcIngressHandler* {
+              if (reject_clients_) {
+                return nullptr;
+              }
+              accepted_ += 1;
+              ingresses_[connection.index()].set_connection(connection);
+              return &ingresses_[connection.index()];
+            },
+            [this](SocketRpcConnection&) { closed_ += 1; }) {}
+
+  ~SocketRpcServerTest() override {
+    server_.Stop();
+    for (thread::Thread& thread : threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+    server_.Close();
+  }
+
+  void StartServing(size_t num_threads) {
+    ASSERT_EQ(server_.Listen(), OkStatus());
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads_[i] = thread::Thread(thread::stl::Options(), server_);
+    }
+  }
+
+  void Connect(stream::SocketStream& client) {
+    ASSERT_EQ(client.Connect("localhost", server_.port()), OkStatus());
+  }
+
+  std::array<EchoIngress, kMaxConnections> ingresses_;
+  std::atomic<int> accepted_ = 0;
+  std::atomic<int> closed_ = 0;
+  std::atomic<bool> reject_clients_ = false;
+  SocketRpcServerBuffer<kMaxConnections, kReadBufferSize, kReadBuffers> server_;
+  std::array<thread::Thread, kReadBuffers> threads_;
+};
+
+// Sends messages from a client and checks that they are echoed.
+class EchoClient : public thread::ThreadCore {
+ public:
+  EchoClient(stream::SocketStream& client, uint8_t seed)
+      : client_(client), seed_(seed) {}
+
+ private:
+  void Run() override {
+    for (size_t message = 0; message < 20; ++message) {
+      ExpectEcho(client_, MakeData(64, static_cast<uint8_t>(seed_ + message)));
+    }
+  }
+
+  stream::SocketStream& client_;
+  uint8_t seed_;
+};
+
+TEST_F(SocketRpcServerTest, PassesEachClientsDataToItsIngress) {
+  StartServing(1);
+
+  std::array<stream::SocketStream, 3> clients;
+  for (stream::SocketStream& client : clients) {
+    Connect(client);
+  }
+
+  // Each message is larger than a read buffer.
+  for (size_t i = 0; i < clients.size(); ++i) {
+    ExpectEcho(clients[i], MakeData(100, static_cast<uint8_t>(i)));
+  }
+  EXPECT_EQ(accepted_, 3);
+  EXPECT_EQ(server_.num_connections(), 3u);
+}
+
+TEST_F(SocketRpcServerTest, MultipleServingThreads) {
+  StartServing(kReadBuffers);
+
+  std::array<stream::SocketStream, kMaxConnections> clients;
+  std::array<EchoClient, kMaxConnections> echo_clients = {
+      EchoClient(clients[0], 0),
+      EchoClient(clients[1], 1),
+      EchoClient(clients[2], 2),
+      EchoClient(clients[3], 3),
+  };
+  std::array<thread::Thread, kMaxConnections> client_threads;
+  for (size_t i = 0; i < clients.size(); ++i) {
+    Connect(clients[i]);
+    client_threads[i] =
+        thread::Thread(thread::stl::Options(), echo_clients[i]);
+  }
+  for (thread::Thread& thread : client_threads) {
+    thread.join();
+  }
+  EXPECT_EQ(accepted_, static_cast<int>(kMaxConnections));
+}
+
+TEST_F(SocketRpcServerTest, RejectedClient_IsDisconnected) {
+  reject_clients_ = true;
+  StartServing(1);
+
+  stream::SocketStream client;
+  Connect(client);
+  std::array<std::byte, 1> buffer;
+  EXPECT_EQ(client.Read(buffer).status(), Status::OutOfRange());
+  EXPECT_EQ(server_.num_connections(), 0u);
+  EXPECT_EQ(closed_, 0);
+}
+
+TEST_F(SocketRpcServerTest, ClientDisconnect_ClosesAndReusesConnection) {
+  StartServing(1);
+
+  for (int round = 1; round <= 2; ++round) {
+    std::array<stream::SocketStream, kMaxConnections> clients;
+    for (stream::SocketStream& client : clients) {
+      Connect(client);
+      ExpectEcho(client, MakeData(8, 1));
+    }
+    EXPECT_EQ(server_.num_connections(), kMaxConnections);
+
+    for (stream::SocketStream& client : clients) {
+      client.Close();
+    }
+    const int expected_closed = round * static_cast<int>(kMaxConnections);
+    EXPECT_TRUE(WaitFor([&] { return closed_ == expected_closed; }));
+    EXPECT_EQ(server_.num_connections(), 0u);
+  }
+}
+
+TEST_F(SocketRpcServerTest, TooManyClients_ExtraClientIsDisconnected) {
+  StartServing(1);
+
+  std::array<stream::SocketStream, kMaxConnections> clients;
+  for (stream::SocketStream& client : clients) {
+    Connect(client);
+  }
+  ASSERT_TRUE(WaitFor(
+      [&] { return accepted_ == static_cast<int>(kMaxConnections); }));
+
+  stream::SocketStream extra_client;
+  Connect(extra_client);
+  std::array<std::byte, 1> buffer;
+  EXPECT_EQ(extra_client.Read(buffer).status(), Status::OutOfRange());
+
+  // The existing clients are unaffected.
+  ExpectEcho(clients[0], MakeData(16, 2));
+}
+
+TEST(SocketRpcServer, DestroyedWithoutClose_ClosesConnections) {
+  EchoIngress ingress;
+  int closed = 0;
+  stream::SocketStream client;
+  {
+    SocketRpcServerBuffer<1, kReadBufferSize> server(
+        [&ingress](SocketRpcConnection& connection) -> RpcIngressHandler* {
+          ingress.set_connection(connection);
+          return &ingress;
+        },
+        [&closed](SocketRpcConnection&) { closed += 1; });
+    ASSERT_EQ(server.Listen(), OkStatus());
+    thread::Thread thread(thread::stl::Options(), server);
+
+    ASSERT_EQ(client.Connect("localhost", server.port()), OkStatus());
+    ExpectEcho(client, MakeData(8, 3));
+    server.Stop();
+    thread.join();
+  }
+
+  EXPECT_EQ(closed, 1);
+  std::array<std::byte, 1> buffer;
+  EXPECT_EQ(client.Read(buffer).status(), Status::OutOfRange());
+}
+
+TEST(SocketRpcServer, ClientThatStopsReading_IsDisconnected) {
+  std::array<EchoIngress, 2> ingresses;
+  std::atomic<int> closed = 0;
+  SocketRpcServerBuffer<2, kReadBufferSize> server(
+      [&ingresses](SocketRpcConnection& connection) -> RpcIngressHandler* {
+        ingresses[connection.index()].set_connection(connection);
+        return &ingresses[connection.index()];
+      },
+      [&closed](SocketRpcConnection&) { closed += 1; });
+  ASSERT_EQ(server.Listen(), OkStatus());
+  thread::Thread thread(thread::stl::Options(), server);
+
+  stream::SocketStream reader;
+  stream::SocketStream stalled;
+  ASSERT_EQ(reader.Connect("localhost", server.port()), OkStatus());
+  ASSERT_EQ(stalled.Connect("localhost", server.port()), OkStatus());
+
+  // Send data without reading the echoes until the server disconnects.
+  constexpr size_t kMaxBytes = 256 << 20;
+  const std::vector<std::byte> data = MakeData(64 << 10, 4);
+  size_t bytes_written = 0;
+  while (bytes_written < kMaxBytes && stalled.Write(data).ok()) {
+    bytes_written += data.size();
+  }
+  EXPECT_LT(bytes_written, kMaxBytes);
+  EXPECT_TRUE(WaitFor([&] { return closed == 1; }));
+
+  // The serving thread still serves other clients.
+  ExpectEcho(reader, MakeData(16, 5));
+
+  server.Stop();
+  thread.join();
+  server.Close();
+}
+
+}  // namespace
+}  // namespace pw::rpc
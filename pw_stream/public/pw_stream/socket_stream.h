@@ -86,6 +86,14 @@ class SocketStream : public NonSeekableReaderWriter {
 
   StatusWithSize DoRead(ByteSpan dest) override;
 
+#if !(defined(_WIN32) && _WIN32)
+  // Gathers the buffers into as few sendmsg() calls as possible.
+  Status DoWriteV(span<const ConstByteSpan> data) override;
+
+  // Scatters the received data across the buffers with a single readv().
+  StatusWithSize DoReadV(span<const ByteSpan> destinations) override;
+#endif  // !(defined(_WIN32) && _WIN32)
+
   // Take ownership of the connection. There may be multiple owners. Each time
   // TakeConnection is called, ReleaseConnection must be called to release
   // ownership, even if the connection is not valid.
@@ -24,6 +24,7 @@
 #include "pw_span/span.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
+#include "pw_status/try.h"
 
 namespace pw::stream {
 
@@ -122,6 +123,27 @@ class Stream {
     return Read(span(static_cast<std::byte*>(dest), size_bytes));
   }
 
+  /// Reads data from the stream into a sequence of buffers, if supported. The
+  /// buffers are filled in order; a buffer is only written to once all of the
+  /// buffers before it are full. Returns the total number of bytes read.
+  ///
+  /// Streams backed by a file descriptor may fill several buffers with a
+  /// single system call (e.g. `readv`). Other streams call DoRead() for each
+  /// buffer, stopping after the first short read.
+  ///
+  /// Derived classes should NOT try to override ReadV(). Instead, provide an
+  /// implementation by overriding DoReadV().
+  ///
+  /// @retval OK Between 1 and the total size of the buffers were read.
+  /// @retval UNIMPLEMENTED This stream does not support reading.
+  /// @retval FAILED_PRECONDITION The Reader is not in state to read data.
+  /// @retval RESOURCE_EXHAUSTED Unable to read any bytes at this time.
+  /// @retval OUT_OF_RANGE Reader has been exhausted, similar to EOF. No bytes
+  ///                      were read, no more will be read.
+  StatusWithSize ReadV(span<const ByteSpan> destinations) {
+    return DoReadV(destinations);
+  }
+
   /// Writes data to this stream. Data is not guaranteed to be fully written out
   /// to final resting place on Write return.
   ///
@@ -159,6 +181,27 @@ class Stream {
   /// @overload
   Status Write(const std::byte b) { return Write(&b, 1); }
 
+  /// Writes a sequence of buffers to this stream, in order, if supported.
+  /// This is equivalent to calling Write() for each buffer, but allows the
+  /// stream to gather the buffers into fewer operations. For example, a frame
+  /// header and its payload can be sent to a socket with one `sendmsg` call
+  /// rather than two `send` calls, without first copying them together.
+  ///
+  /// Streams that do not override DoWriteV() call DoWrite() for each
+  /// non-empty buffer. If one of those writes fails, the buffers before it
+  /// have already been written.
+  ///
+  /// Derived classes should NOT try to override WriteV(). Instead, provide an
+  /// implementation by overriding DoWriteV().
+  ///
+  /// @retval OK All of the data was accepted by the stream.
+  /// @retval UNIMPLEMENTED This stream does not support writing.
+  /// @retval FAILED_PRECONDITION The writer is not in a state to accept data.
+  /// @retval RESOURCE_EXHAUSTED The writer was unable to write all of the
+  ///                            requested data at this time.
+  /// @retval OUT_OF_RANGE The Writer has been exhausted, similar to EOF.
+  Status WriteV(span<const ConstByteSpan> data) { return DoWriteV(data); }
+
   /// Changes the current position in the stream for both reading and writing,
   /// if supported.
   ///
@@ -257,6 +300,38 @@ class Stream {
   /// Virtual Write() function implemented by derived classes.
   virtual Status DoWrite(ConstByteSpan data) = 0;
 
+  /// Virtual ReadV() function optionally implemented by derived classes. The
+  /// default implementation calls DoRead() for each buffer.
+  virtual StatusWithSize DoReadV(span<const ByteSpan> destinations) {
+    size_t total = 0;
+    for (ByteSpan destination : destinations) {
+      if (destination.empty()) {
+        continue;
+      }
+      const StatusWithSize result = DoRead(destination);
+      if (!result.ok()) {
+        // Report the bytes already read; the error recurs on the next read.
+        return total == 0 ? result : StatusWithSize(total);
+      }
+      total += result.size();
+      if (result.size() < destination.size()) {
+        break;
+      }
+    }
+    return StatusWithSize(total);
+  }
+
+  /// Virtual WriteV() function optionally implemented by derived classes. The
+  /// default implementation calls DoWrite() for each buffer.
+  virtual Status DoWriteV(span<const ConstByteSpan> data) {
+    for (ConstByteSpan buffer : data) {
+      if (!buffer.empty()) {
+        PW_TRY(DoWrite(buffer));
+      }
+    }
+    return OkStatus();
+  }
+
   /// Virtual Seek() function implemented by derived classes.
   virtual Status DoSeek(ptrdiff_t offset, Whence origin) = 0;
 
@@ -304,8 +379,12 @@ class Reader : public Stream {
       : Stream(true, false, seekability) {}
 
   using Stream::Write;
+  using Stream::WriteV;
 
   Status DoWrite(ConstByteSpan) final { return Status::Unimplemented(); }
+  Status DoWriteV(span<const ConstByteSpan>) final {
+    return Status::Unimplemented();
+  }
 };
 
 /// A Reader that supports at least relative seeking within some range of the
@@ -389,10 +468,14 @@ class Writer : public Stream {
       : Stream(false, true, seekability) {}
 
   using Stream::Read;
+  using Stream::ReadV;
 
   StatusWithSize DoRead(ByteSpan) final {
     return StatusWithSize::Unimplemented();
   }
+  StatusWithSize DoReadV(span<const ByteSpan>) final {
+    return StatusWithSize::Unimplemented();
+  }
 };
 
 /// A Writer that supports at least relative seeking within some range of the
@@ -27,6 +27,7 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif  // defined(_WIN32) && _WIN32
 
@@ -44,6 +45,12 @@ namespace {
 constexpr uint32_t kServerBacklogLength = 1;
 constexpr const char* kLocalhostAddress = "localhost";
 
+#if !(defined(_WIN32) && _WIN32)
+// Maximum number of buffers passed to a single sendmsg() or readv() call.
+// POSIX guarantees that IOV_MAX is at least 16.
+constexpr size_t kMaxIoVecs = 16;
+#endif  // !(defined(_WIN32) && _WIN32)
+
 // Set necessary options on a socket file descriptor.
 void ConfigureSocket([[maybe_unused]] int socket) {
 #if defined(__APPLE__)
@@ -254,6 +261,101 @@ StatusWithSize SocketStream::DoRead(ByteSpan dest) {
   return StatusWithSize(bytes_rcvd);
 }
 
+#if !(defined(_WIN32) && _WIN32)
+
+Status SocketStream::DoWriteV(span<const ConstByteSpan> data) {
+  int send_flags = 0;
+#if defined(__linux__)
+  send_flags |= MSG_NOSIGNAL;
+#endif  // defined(__linux__)
+
+  ConnectionOwnership ownership(this);
+  if (ownership.fd() == kInvalidFd) {
+    return Status::Unknown();
+  }
+
+  while (!data.empty()) {
+    iovec iov[kMaxIoVecs];
+    size_t iov_count = 0;
+    size_t total_size = 0;
+    for (; !data.empty() && iov_count < kMaxIoVecs; data = data.subspan(1)) {
+      if (data.front().empty()) {
+        continue;
+      }
+      iov[iov_count].iov_base = const_cast<std::byte*>(data.front().data());
+      iov[iov_count].iov_len = data.front().size_bytes();
+      total_size += data.front().size_bytes();
+      ++iov_count;
+    }
+    if (iov_count == 0) {
+      break;
+    }
+
+    msghdr message = {};
+    message.msg_iov = iov;
+    message.msg_iovlen = iov_count;
+    const ssize_t bytes_sent = sendmsg(ownership.fd(), &message, send_flags);
+
+    if (bytes_sent < 0 || static_cast<size_t>(bytes_sent) != total_size) {
+      if (errno == EPIPE) {
+        return Status::OutOfRange();
+      }
+      return Status::Unknown();
+    }
+  }
+  return OkStatus();
+}
+
+StatusWithSize SocketStream::DoReadV(span<const ByteSpan> destinations) {
+  iovec iov[kMaxIoVecs];
+  size_t iov_count = 0;
+  for (ByteSpan dest : destinations) {
+    if (iov_count == kMaxIoVecs) {
+      break;
+    }
+    if (!dest.empty()) {
+      iov[iov_count].iov_base = dest.data();
+      iov[iov_count].iov_len = dest.size_bytes();
+      ++iov_count;
+    }
+  }
+  if (iov_count == 0) {
+    return StatusWithSize(0);
+  }
+
+  ConnectionOwnership ownership(this);
+  if (ownership.fd() == kInvalidFd) {
+    return StatusWithSize::Unknown();
+  }
+
+  // Wait for data to read or a tear down notification.
+  pollfd fds_to_poll[2];
+  fds_to_poll[0].fd = ownership.fd();
+  fds_to_poll[0].events = POLLIN | POLLERR | POLLHUP;
+  fds_to_poll[1].fd = ownership.pipe_r_fd();
+  fds_to_poll[1].events = POLLIN;
+  poll(fds_to_poll, 2, -1);
+  if (!(fds_to_poll[0].revents & POLLIN)) {
+    return StatusWithSize::Unknown();
+  }
+
+  const ssize_t bytes_rcvd =
+      readv(ownership.fd(), iov, static_cast<int>(iov_count));
+  if (bytes_rcvd == 0) {
+    // Remote peer has closed the connection.
+    Close();
+    return StatusWithSize::OutOfRange();
+  } else if (bytes_rcvd < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    return StatusWithSize::Unknown();
+  }
+  return StatusWithSize(bytes_rcvd);
+}
+
+#endif  // !(defined(_WIN32) && _WIN32)
+
 int SocketStream::TakeConnection() {
   std::lock_guard lock(connection_mutex_);
   return TakeConnectionWithLockHeld();
@@ -0,0 +1,128 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+// Measures sending 16 frames, each a 16-byte header followed by a payload,
+// through a SocketStream connected to a local socket pair. Each frame is sent
+// in one of three ways:
+//
+//   TwoWrites:    Write() the header, then Write() the payload. Two send()
+//                 system calls per frame.
+//   CopyAndWrite: Copy the header and payload into one buffer and Write() it.
+//                 One send() system call per frame, plus a copy.
+//   WriteV:       WriteV() the header and payload. One sendmsg() system call
+//                 per frame and no copy.
+//
+// A thread drains the other end of the socket pair. Divide the bytes sent
+// (16 * (16 + payload size)) by the reported time to get throughput.
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+#include "pw_assert/check.h"
+#include "pw_bytes/span.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_stream/socket_stream.h"
+
+namespace pw::stream {
+namespace {
+
+constexpr size_t kFrames = 16;
+constexpr size_t kHeaderSize = 16;
+constexpr size_t kMaxPayloadSize = 1024;
+
+constexpr std::array<std::byte, kHeaderSize> kHeader = {};
+constexpr std::array<std::byte, kMaxPayloadSize> kPayload = {};
+
+// Connects a SocketStream to a thread that reads and discards all data.
+class DrainedSocket {
+ public:
+  DrainedSocket() {
+    int fds[2];
+    PW_CHECK_INT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    stream_ = SocketStream(fds[0]);
+    drain_fd_ = fds[1];
+    drain_thread_ = std::thread([this] { Drain(); });
+  }
+
+  ~DrainedSocket() {
+    stream_.Close();
+    drain_thread_.join();
+    close(drain_fd_);
+  }
+
+  SocketStream& stream() { return stream_; }
+
+ private:
+  void Drain() {
+    std::array<std::byte, 16384> buffer;
+    while (recv(drain_fd_, buffer.data(), buffer.size(), 0) > 0) {
+    }
+  }
+
+  SocketStream stream_;
+  int drain_fd_;
+  std::thread drain_thread_;
+};
+
+void TwoWrites(perf_test::State& state, size_t payload_size) {
+  DrainedSocket socket;
+  const ConstByteSpan payload = span(kPayload).first(payload_size);
+
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kFrames; ++i) {
+      PW_CHECK_OK(socket.stream().Write(kHeader));
+      PW_CHECK_OK(socket.stream().Write(payload));
+    }
+  }
+}
+
+void CopyAndWrite(perf_test::State& state, size_t payload_size) {
+  DrainedSocket socket;
+  std::array<std::byte, kHeaderSize + kMaxPayloadSize> frame;
+
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kFrames; ++i) {
+      std::memcpy(frame.data(), kHeader.data(), kHeader.size());
+      std::memcpy(frame.data() + kHeader.size(), kPayload.data(), payload_size);
+      PW_CHECK_OK(
+          socket.stream().Write(span(frame).first(kHeaderSize + payload_size)));
+    }
+  }
+}
+
+void WriteV(perf_test::State& state, size_t payload_size) {
+  DrainedSocket socket;
+  const std::array<ConstByteSpan, 2> frame = {
+      kHeader, span(kPayload).first(payload_size)};
+
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kFrames; ++i) {
+      PW_CHECK_OK(socket.stream().WriteV(frame));
+    }
+  }
+}
+
+PW_PERF_TEST(TwoWrites64, TwoWrites, 64);
+PW_PERF_TEST(CopyAndWrite64, CopyAndWrite, 64);
+PW_PERF_TEST(WriteV64, WriteV, 64);
+PW_PERF_TEST(TwoWrites1024, TwoWrites, 1024);
+PW_PERF_TEST(CopyAndWrite1024, CopyAndWrite, 1024);
+PW_PERF_TEST(WriteV1024, WriteV, 1024);
+
+}  // namespace
+}  // namespace pw::stream
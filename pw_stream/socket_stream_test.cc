@@ -14,6 +14,8 @@
 
 #include "pw_stream/socket_stream.h"
 
+#include <array>
+#include <cstring>
 #include <thread>
 
 #include "gtest/gtest.h"
@@ -167,6 +169,71 @@ TEST(SocketStreamTest, MultipleClients) {
   server.Close();
 }
 
+TEST(SocketStreamTest, WriteVReadV) {
+  ServerSocket server;
+  EXPECT_EQ(server.Listen(), OkStatus());
+
+  Result<SocketStream> server_stream = Status::Unavailable();
+  auto accept_thread = std::thread{[&]() { server_stream = server.Accept(); }};
+
+  SocketStream client;
+  EXPECT_EQ(client.Connect("localhost", server.port()), OkStatus());
+
+  accept_thread.join();
+  ASSERT_EQ(server_stream.status(), OkStatus());
+
+  // Send more buffers than fit in one sendmsg() call, including empty ones.
+  std::array<std::byte, 48> data;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<std::byte>(i);
+  }
+  std::array<ConstByteSpan, 24> buffers;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    buffers[i] = span(data).subspan(i * 2, i % 3 == 0 ? 0 : 2);
+  }
+  std::array<std::byte, 48> expected{};
+  size_t expected_size = 0;
+  for (ConstByteSpan buffer : buffers) {
+    std::memcpy(expected.data() + expected_size, buffer.data(), buffer.size());
+    expected_size += buffer.size();
+  }
+
+  auto write_status = Status::Unavailable();
+  auto write_thread =
+      std::thread{[&]() { write_status = client.WriteV(buffers); }};
+
+  // Scatter the data across a header buffer and a payload buffer.
+  std::array<std::byte, 4> header{};
+  std::array<std::byte, 64> payload{};
+  size_t received = 0;
+  while (received < expected_size) {
+    const std::array<ByteSpan, 2> destinations = {
+        received < header.size() ? span(header).subspan(received) : ByteSpan(),
+        received < header.size()
+            ? span(payload)
+            : span(payload).subspan(received - header.size()),
+    };
+    StatusWithSize result = server_stream->ReadV(destinations);
+    ASSERT_EQ(result.status(), OkStatus());
+    received += result.size();
+  }
+  write_thread.join();
+  EXPECT_EQ(write_status, OkStatus());
+
+  ASSERT_EQ(received, expected_size);
+  EXPECT_EQ(std::memcmp(header.data(), expected.data(), header.size()), 0);
+  EXPECT_EQ(std::memcmp(payload.data(),
+                        expected.data() + header.size(),
+                        expected_size - header.size()),
+            0);
+
+  // Reads report the closed connection.
+  client.Close();
+  std::array<ByteSpan, 1> destination = {span(payload)};
+  EXPECT_EQ(server_stream->ReadV(destination).status(), Status::OutOfRange());
+  server.Close();
+}
+
 TEST(SocketStreamTest, ReuseAutomaticServerPort) {
   uint16_t server_port = 0;
   SocketStream client_stream;
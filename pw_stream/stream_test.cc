@@ -14,6 +14,9 @@
 
 #include "pw_stream/stream.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <limits>
 
 #include "gtest/gtest.h"
@@ -134,6 +137,11 @@ void TestStreamImpl() {
   ASSERT_EQ(writable ? OkStatus() : Status::Unimplemented(), stream.Write({}));
   ASSERT_EQ(seekable ? OkStatus() : Status::Unimplemented(), stream.Seek(0));
 
+  // Check ReadV()/WriteV()
+  ASSERT_EQ(readable ? OkStatus() : Status::Unimplemented(),
+            stream.ReadV({}).status());
+  ASSERT_EQ(writable ? OkStatus() : Status::Unimplemented(), stream.WriteV({}));
+
   // Check ConservativeLimits()
   ASSERT_EQ(readable ? Stream::kUnlimited : 0, stream.ConservativeReadLimit());
   ASSERT_EQ(writable ? Stream::kUnlimited : 0, stream.ConservativeWriteLimit());
@@ -193,5 +201,121 @@ TEST(Stream, SeekableReaderWriter) {
   TestStreamImpl<TestSeekableReaderWriter, kReadable, kWritable, kSeekable>();
 }
 
+// Writer that records each call to DoWrite().
+class RecordingWriter : public NonSeekableWriter {
+ public:
+  ConstByteSpan data() const { return span(buffer_).first(size_); }
+  size_t writes() const { return writes_; }
+
+  void set_fail_after(size_t writes) { fail_after_ = writes; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    if (writes_ == fail_after_) {
+      return Status::ResourceExhausted();
+    }
+    std::memcpy(buffer_.data() + size_, data.data(), data.size());
+    size_ += data.size();
+    writes_ += 1;
+    return OkStatus();
+  }
+
+  std::array<std::byte, 64> buffer_;
+  size_t size_ = 0;
+  size_t writes_ = 0;
+  size_t fail_after_ = std::numeric_limits<size_t>::max();
+};
+
+// Reader that returns at most kMaxReadSize bytes from kReaderData per read.
+constexpr std::array<std::byte, 10> kReaderData = {
+    std::byte{0}, std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4},
+    std::byte{5}, std::byte{6}, std::byte{7}, std::byte{8}, std::byte{9},
+};
+
+class ShortReader : public NonSeekableReader {
+ public:
+  static constexpr size_t kMaxReadSize = 4;
+
+  size_t reads() const { return reads_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override {
+    if (offset_ == kReaderData.size()) {
+      return StatusWithSize::OutOfRange();
+    }
+    const size_t size =
+        std::min({dest.size(), kMaxReadSize, kReaderData.size() - offset_});
+    std::memcpy(dest.data(), kReaderData.data() + offset_, size);
+    offset_ += size;
+    reads_ += 1;
+    return StatusWithSize(size);
+  }
+
+  size_t offset_ = 0;
+  size_t reads_ = 0;
+};
+
+constexpr std::array<std::byte, 3> kHeader = {
+    std::byte{0xa}, std::byte{0xb}, std::byte{0xc}};
+constexpr std::array<std::byte, 5> kPayload = {
+    std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5}};
+
+TEST(Stream, WriteV_DefaultWritesEachNonEmptyBuffer) {
+  RecordingWriter writer;
+  const std::array<ConstByteSpan, 3> buffers = {
+      kHeader, ConstByteSpan(), kPayload};
+
+  ASSERT_EQ(writer.WriteV(buffers), OkStatus());
+  EXPECT_EQ(writer.writes(), 2u);
+  ASSERT_EQ(writer.data().size(), kHeader.size() + kPayload.size());
+  EXPECT_EQ(std::memcmp(writer.data().data(), kHeader.data(), kHeader.size()),
+            0);
+  EXPECT_EQ(std::memcmp(writer.data().data() + kHeader.size(),
+                        kPayload.data(),
+                        kPayload.size()),
+            0);
+}
+
+TEST(Stream, WriteV_DefaultStopsAtFirstError) {
+  RecordingWriter writer;
+  writer.set_fail_after(1);
+  const std::array<ConstByteSpan, 3> buffers = {kHeader, kPayload, kHeader};
+
+  EXPECT_EQ(writer.WriteV(buffers), Status::ResourceExhausted());
+  EXPECT_EQ(writer.writes(), 1u);
+  EXPECT_EQ(writer.data().size(), kHeader.size());
+}
+
+TEST(Stream, ReadV_DefaultFillsBuffersInOrder) {
+  ShortReader reader;
+  std::array<std::byte, 3> first{};
+  std::array<std::byte, 4> second{};
+  std::array<std::byte, 8> third{};
+  const std::array<ByteSpan, 3> buffers = {first, second, third};
+
+  // The second buffer is filled by one full read, the third by a short one.
+  StatusWithSize result = reader.ReadV(buffers);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), kReaderData.size());
+  EXPECT_EQ(reader.reads(), 3u);
+  EXPECT_EQ(std::memcmp(first.data(), kReaderData.data(), 3), 0);
+  EXPECT_EQ(std::memcmp(second.data(), kReaderData.data() + 3, 4), 0);
+  EXPECT_EQ(std::memcmp(third.data(), kReaderData.data() + 7, 3), 0);
+
+  EXPECT_EQ(reader.ReadV(buffers).status(), Status::OutOfRange());
+}
+
+TEST(Stream, ReadV_DefaultStopsAfterShortRead) {
+  ShortReader reader;
+  std::array<std::byte, 6> first{};
+  std::array<std::byte, 6> second{};
+  const std::array<ByteSpan, 2> buffers = {first, second};
+
+  StatusWithSize result = reader.ReadV(buffers);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), ShortReader::kMaxReadSize);
+  EXPECT_EQ(reader.reads(), 1u);
+}
+
 }  // namespace
 }  // namespace pw::stream
@@ -90,6 +90,144 @@ std::string ErrorMessage(ArgStatus status,
   return result;
 }
 
+void WriteText(DecodedTextOutput* output, std::string_view text) {
+  if (output != nullptr && !text.empty()) {
+    output->Write(text);
+  }
+}
+
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC(ignored, "-Wformat-nonliteral");
+
+// Formats a value with a conversion specifier and writes it to the output.
+// Returns false if the value could not be formatted.
+template <typename ArgumentType>
+bool WriteValue(DecodedTextOutput* output,
+                std::string_view spec,
+                ArgumentType value) {
+  if (output == nullptr) {
+    return true;
+  }
+
+  // snprintf requires a null-terminated format string. Specifiers are short,
+  // so only an unusually long one needs a std::string.
+  char short_format[32];
+  std::string long_format;
+  const char* format = short_format;
+
+  if (spec.size() < sizeof(short_format)) {
+    std::memcpy(short_format, spec.data(), spec.size());
+    short_format[spec.size()] = '\0';
+  } else {
+    long_format = spec;
+    format = long_format.c_str();
+  }
+
+  char buffer[256];
+  const int size = std::snprintf(buffer, sizeof(buffer), format, value);
+
+  if (size < 0) {
+    return false;
+  }
+
+  if (static_cast<size_t>(size) < sizeof(buffer)) {
+    output->Write(std::string_view(buffer, static_cast<size_t>(size)));
+    return true;
+  }
+
+  // The value did not fit in the buffer, which requires a very wide field.
+  std::string large_value(static_cast<size_t>(size) + 1, '\0');
+  std::snprintf(large_value.data(), large_value.size(), format, value);
+  large_value.pop_back();  // Remove the trailing \0.
+  output->Write(large_value);
+  return true;
+}
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
+// The result of decoding one argument with DecodeArgument().
+struct ArgumentResult {
+  size_t raw_size_bytes;
+  bool ok;
+};
+
+// Decodes an argument and writes its value to the output. This matches
+// StringSegment::Decode(), but does not write anything if decoding fails.
+ArgumentResult DecodeArgument(StringSegment::Type type,
+                              StringSegment::ArgSize local_size,
+                              std::string_view spec,
+                              span<const uint8_t> arguments,
+                              DecodedTextOutput* output) {
+  switch (type) {
+    case StringSegment::kString: {
+      if (arguments.empty()) {
+        return {0, false};
+      }
+
+      const bool truncated = (arguments[0] & 0x80u) != 0u;
+      const uint_fast8_t size = arguments[0] & 0x7Fu;
+
+      if (arguments.size() - 1 < size) {
+        return {arguments.size(), false};
+      }
+
+      // Strings are at most 127 bytes, followed by [...] if truncated.
+      char value[0x7F + sizeof("[...]")];
+      std::memcpy(value, arguments.data() + 1, size);
+      if (truncated) {
+        std::memcpy(value + size, "[...]", sizeof("[...]"));
+      } else {
+        value[size] = '\0';
+      }
+
+      const char* const string = value;
+      return {1u + size, WriteValue(output, spec, string)};
+    }
+    case StringSegment::kSignedInt:
+    case StringSegment::kUnsigned32:
+    case StringSegment::kUnsigned64: {
+      if (arguments.empty()) {
+        return {0, false};
+      }
+
+      int64_t value;
+      const size_t bytes = varint::Decode(as_bytes(arguments), &value);
+
+      if (bytes == 0u) {
+        return {std::min(varint::kMaxVarint64SizeBytes,
+                         static_cast<size_t>(arguments.size())),
+                false};
+      }
+
+      // Unsigned ints need to be masked to their bit width due to sign
+      // extension.
+      if (type == StringSegment::kUnsigned32) {
+        value &= 0xFFFFFFFFu;
+      }
+
+      if (local_size == StringSegment::k32Bit) {
+        return {bytes,
+                WriteValue(output, spec, static_cast<uint32_t>(value))};
+      }
+      return {bytes, WriteValue(output, spec, value)};
+    }
+    case StringSegment::kFloatingPoint: {
+      if (arguments.size() < sizeof(float)) {
+        return {0, false};
+      }
+
+      float value;
+      std::memcpy(&value, arguments.data(), sizeof(value));
+      return {sizeof(value), WriteValue(output, spec, value)};
+    }
+    case StringSegment::kLiteral:
+    case StringSegment::kPercent:
+      break;
+  }
+
+  return {0, false};
+}
+
 }  // namespace
 
 DecodedArg::DecodedArg(ArgStatus error,
@@ -102,9 +240,22 @@ DecodedArg::DecodedArg(ArgStatus error,
       status_(error) {}
 
 StringSegment StringSegment::ParseFormatSpec(const char* format) {
-  if (format[0] != '%' || format[1] == '\0') {
+  Type type;
+  ArgSize local_size;
+  const size_t length = ParseFormatSpecLength(format, type, local_size);
+
+  if (length == 0u) {
     return StringSegment();
   }
+  return {std::string_view(format, length), type, local_size};
+}
+
+size_t StringSegment::ParseFormatSpecLength(const char* format,
+                                            Type& type,
+                                            ArgSize& local_size) {
+  if (format[0] != '%' || format[1] == '\0') {
+    return 0;
+  }
 
   // Parse the format specifier.
   size_t i = 1;
@@ -128,7 +279,10 @@ StringSegment StringSegment::ParseFormatSpec(const char* format) {
   // Read the conversion specifier.
   const char spec = format[i];
 
-  Type type;
+  if (spec == '\0') {
+    return 0;  // The format string ended before the conversion specifier.
+  }
+
   if (spec == 's') {
     type = kString;
   } else if (spec == 'c' || spec == 'd' || spec == 'i') {
@@ -144,10 +298,11 @@ StringSegment StringSegment::ParseFormatSpec(const char* format) {
   } else if (spec == '%' && i == 1) {
     type = kPercent;
   } else {
-    return StringSegment();
+    return 0;
   }
 
-  return {std::string_view(format, i + 1), type, VarargSize(length, spec)};
+  local_size = VarargSize(length, spec);
+  return i + 1;
 }
 
 StringSegment::ArgSize StringSegment::VarargSize(std::array<char, 2> length,
@@ -357,4 +512,60 @@ DecodedFormatString FormatString::Format(span<const uint8_t> arguments) const {
   return DecodedFormatString(std::move(results), arguments.size());
 }
 
+FormatSummary FormatTo(const char* format,
+                       span<const uint8_t> arguments,
+                       DecodedTextOutput* output) {
+  FormatSummary summary;
+  const char* text_start = format;
+  bool skip = false;
+
+  while (format[0] != '\0') {
+    StringSegment::Type type;
+    StringSegment::ArgSize local_size;
+    const size_t spec_size =
+        StringSegment::ParseFormatSpecLength(format, type, local_size);
+
+    if (spec_size == 0u) {
+      format += 1;
+      continue;
+    }
+
+    // Write the text seen so far (if any).
+    WriteText(output, std::string_view(text_start, format - text_start));
+
+    const std::string_view spec(format, spec_size);
+    format += spec_size;
+    text_start = format;
+
+    if (type == StringSegment::kPercent) {
+      WriteText(output, "%");
+      continue;
+    }
+
+    summary.argument_count_ += 1;
+
+    if (!skip) {
+      const ArgumentResult result =
+          DecodeArgument(type, local_size, spec, arguments, output);
+      arguments = arguments.subspan(result.raw_size_bytes);
+
+      if (result.ok) {
+        continue;
+      }
+
+      // If an error occurred, skip decoding the remaining arguments.
+      skip = true;
+    }
+
+    // Arguments that fail to decode are written as their format specifiers.
+    summary.decoding_errors_ += 1;
+    WriteText(output, spec);
+  }
+
+  WriteText(output, std::string_view(text_start, format - text_start));
+
+  summary.remaining_bytes_ = arguments.size();
+  return summary;
+}
+
 }  // namespace pw::tokenizer
@@ -136,6 +136,75 @@ TEST(TokenizedStringDecode, MissingArguments_IsDecodeError) {
   EXPECT_EQ(result.decoding_errors(), 2u);
 }
 
+class StringOutput final : public DecodedTextOutput {
+ public:
+  void Write(std::string_view text) override { value.append(text); }
+
+  std::string value;
+};
+
+span<const uint8_t> AsArgs(std::string_view args) {
+  return span(reinterpret_cast<const uint8_t*>(args.data()), args.size());
+}
+
+TEST(FormatTo, MatchesFormatString) {
+  for (const auto& [format, expected, args] :
+       test::tokenized_string_decoding::kTestData) {
+    if (!FormatIsSupported(format)) {
+      continue;
+    }
+
+    const DecodedFormatString decoded = FormatString(format).Format(args);
+
+    StringOutput output;
+    const FormatSummary summary = FormatTo(format, AsArgs(args), &output);
+
+    ASSERT_EQ(output.value, decoded.value()) << format;
+    EXPECT_EQ(summary.remaining_bytes(), decoded.remaining_bytes());
+    EXPECT_EQ(summary.argument_count(), decoded.argument_count());
+    EXPECT_EQ(summary.decoding_errors(), decoded.decoding_errors());
+    EXPECT_EQ(summary.ok(), decoded.ok());
+  }
+}
+
+TEST(FormatTo, Errors_MatchFormatString) {
+  for (std::string_view args : {"\6\x89musketeer"sv,
+                                "\6\x0amusketeer"sv,
+                                "\x80"sv,
+                                "\x80\x80\x80\x80\x80\x80\x80\x80\x80\x80"sv,
+                                "\6\x05hello extra"sv,
+                                ""sv}) {
+    const DecodedFormatString decoded = kTwoArgs.Format(args);
+
+    StringOutput output;
+    const FormatSummary summary = FormatTo("The %d %s", AsArgs(args), &output);
+
+    EXPECT_EQ(output.value, decoded.value());
+    EXPECT_EQ(summary.remaining_bytes(), decoded.remaining_bytes());
+    EXPECT_EQ(summary.argument_count(), decoded.argument_count());
+    EXPECT_EQ(summary.decoding_errors(), decoded.decoding_errors());
+  }
+}
+
+TEST(FormatTo, NullOutput_OnlySummarizes) {
+  const FormatSummary summary =
+      FormatTo("%d%% of %s", AsArgs("\x02\3all"sv), nullptr);
+  EXPECT_TRUE(summary.ok());
+  EXPECT_EQ(summary.argument_count(), 2u);
+}
+
+TEST(FormatTo, WideField_WritesWholeValue) {
+  StringOutput output;
+  EXPECT_TRUE(FormatTo("%300d|", AsArgs("\x02"sv), &output).ok());
+  EXPECT_EQ(output.value, std::string(299, ' ') + "1|");
+}
+
+TEST(FormatTo, IncompleteSpecifier_IsLiteral) {
+  StringOutput output;
+  EXPECT_TRUE(FormatTo("100%l", {}, &output).ok());
+  EXPECT_EQ(output.value, "100%l");
+}
+
 TEST(VarintDecode, VarintDecodeTestCases) {
   const auto& test_data = test::varint_decoding::kTestData;
   static_assert(sizeof(test_data) / sizeof(*test_data) > 100u);
@@ -15,10 +15,12 @@
 #include "pw_tokenizer/detokenize.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 
 #include "pw_bytes/bit.h"
 #include "pw_bytes/endian.h"
+#include "pw_status/try.h"
 #include "pw_tokenizer/base64.h"
 #include "pw_tokenizer/internal/decode.h"
 #include "pw_tokenizer/nested_tokenization.h"
@@ -107,7 +109,12 @@ using DecodingResult = std::pair<DecodedFormatString, uint32_t>;
 // Determines if one result is better than the other if collisions occurred.
 // Returns true if lhs is preferred over rhs. This logic should match the
 // collision resolution logic in detokenize.py.
-bool IsBetterResult(const DecodingResult& lhs, const DecodingResult& rhs) {
+//
+// Results are either DecodedFormatStrings or FormatSummaries, paired with the
+// date removed.
+template <typename Result>
+bool IsBetterResult(const std::pair<Result, uint32_t>& lhs,
+                    const std::pair<Result, uint32_t>& rhs) {
   // Favor the result for which decoding succeeded.
   if (lhs.first.ok() != rhs.first.ok()) {
     return lhs.first.ok();
@@ -133,6 +140,30 @@ bool IsBetterResult(const DecodingResult& lhs, const DecodingResult& rhs) {
   return lhs.second > rhs.second;
 }
 
+// Writes decoded text to a stream::Writer. Stops writing after an error.
+class WriterOutput final : public DecodedTextOutput {
+ public:
+  explicit WriterOutput(stream::Writer& writer) : writer_(writer) {}
+
+  void Write(std::string_view text) override {
+    if (status_.ok() && !text.empty()) {
+      status_ = writer_.Write(text.data(), text.size());
+    }
+  }
+
+  // Returns the first error from the writer, if any.
+  Status status() const { return status_; }
+
+ private:
+  stream::Writer& writer_;
+  Status status_;
+};
+
+span<const uint8_t> Arguments(span<const uint8_t> encoded) {
+  return encoded.size() < sizeof(uint32_t) ? span<const uint8_t>()
+                                           : encoded.subspan(sizeof(uint32_t));
+}
+
 }  // namespace
 
 DetokenizedString::DetokenizedString(
@@ -146,7 +177,8 @@ DetokenizedString::DetokenizedString(
     results.push_back(DecodingResult{format.Format(arguments), date_removed});
   }
 
-  std::sort(results.begin(), results.end(), IsBetterResult);
+  std::sort(
+      results.begin(), results.end(), IsBetterResult<DecodedFormatString>);
 
   for (auto& result : results) {
     matches_.push_back(std::move(result.first));
@@ -183,12 +215,11 @@ DetokenizedString Detokenizer::Detokenize(
 
   const auto result = database_.find(token);
 
-  return DetokenizedString(
-      token,
-      result == database_.end() ? span<TokenizedStringEntry>()
-                                : span(result->second),
-      encoded.size() < sizeof(token) ? span<const uint8_t>()
-                                     : encoded.subspan(sizeof(token)));
+  return DetokenizedString(token,
+                           result == database_.end()
+                               ? span<TokenizedStringEntry>()
+                               : span(result->second),
+                           Arguments(encoded));
 }
 
 DetokenizedString Detokenizer::DetokenizeBase64Message(
@@ -204,4 +235,138 @@ std::string Detokenizer::DetokenizeBase64(std::string_view text) const {
   return nested_detokenizer.Flush();
 }
 
+StreamingDetokenizer::StreamingDetokenizer(const TokenDatabase& database) {
+  index_.reserve(database.size());
+  for (const auto& entry : database) {
+    index_.push_back(entry);
+  }
+
+  // Binary token databases are sorted by token, but check in case this one was
+  // not.
+  const auto by_token = [](const TokenDatabase::Entry& lhs,
+                           const TokenDatabase::Entry& rhs) {
+    return lhs.token < rhs.token;
+  };
+  if (!std::is_sorted(index_.begin(), index_.end(), by_token)) {
+    std::stable_sort(index_.begin(), index_.end(), by_token);
+  }
+}
+
+const TokenDatabase::Entry* StreamingDetokenizer::FindBestMatch(
+    span<const uint8_t> encoded,
+    span<const uint8_t>& arguments,
+    size_t& matches) const {
+  const uint32_t token = bytes::ReadInOrder<uint32_t>(
+      endian::little, encoded.data(), encoded.size());
+  arguments = Arguments(encoded);
+
+  const auto first = std::lower_bound(
+      index_.begin(),
+      index_.end(),
+      token,
+      [](const TokenDatabase::Entry& entry, uint32_t value) {
+        return entry.token < value;
+      });
+  const auto last = std::upper_bound(
+      first, index_.end(), token, [](uint32_t value, const auto& entry) {
+        return value < entry.token;
+      });
+
+  matches = static_cast<size_t>(last - first);
+  if (matches <= 1u) {
+    return matches == 0u ? nullptr : &*first;
+  }
+
+  // If the token collides, check each string to find the best result.
+  const TokenDatabase::Entry* best = nullptr;
+  std::pair<FormatSummary, uint32_t> best_result;
+
+  for (auto entry = first; entry != last; ++entry) {
+    std::pair<FormatSummary, uint32_t> result(
+        FormatTo(entry->string, arguments, nullptr), entry->date_removed);
+    if (best == nullptr || IsBetterResult(result, best_result)) {
+      best = &*entry;
+      best_result = result;
+    }
+  }
+  return best;
+}
+
+Status StreamingDetokenizer::Detokenize(span<const uint8_t> encoded,
+                                        stream::Writer& output) const {
+  // The token is missing from the encoded data; there is nothing to do.
+  if (encoded.empty()) {
+    return Status::NotFound();
+  }
+
+  span<const uint8_t> arguments;
+  size_t matches;
+  const TokenDatabase::Entry* entry =
+      FindBestMatch(encoded, arguments, matches);
+
+  if (entry == nullptr) {
+    return Status::NotFound();
+  }
+
+  WriterOutput writer(output);
+  const FormatSummary summary = FormatTo(entry->string, arguments, &writer);
+  PW_TRY(writer.status());
+
+  return summary.ok() && matches == 1u ? OkStatus() : Status::DataLoss();
+}
+
+Status StreamingDetokenizer::DetokenizeBase64(std::string_view text,
+                                              stream::Writer& output) const {
+  WriterOutput writer(output);
+  size_t text_start = 0;
+  size_t i = 0;
+
+  while (i < text.size()) {
+    if (text[i] != PW_TOKENIZER_NESTED_PREFIX) {
+      i += 1;
+      continue;
+    }
+
+    // A message is the prefix followed by any valid Base64 characters.
+    size_t message_end = i + 1;
+    while (message_end < text.size() &&
+           base64::IsValidChar(text[message_end])) {
+      message_end += 1;
+    }
+
+    writer.Write(text.substr(text_start, i - text_start));
+    DetokenizeBase64Message(text.substr(i, message_end - i), writer);
+    i = message_end;
+    text_start = message_end;
+  }
+
+  writer.Write(text.substr(text_start));
+  return writer.status();
+}
+
+void StreamingDetokenizer::DetokenizeBase64Message(
+    std::string_view message, DecodedTextOutput& output) const {
+  std::array<std::byte, kMaxBase64MessageSizeBytes> buffer;
+  const size_t size = PrefixedBase64Decode(message, buffer);
+
+  if (size != 0u) {
+    span<const uint8_t> arguments;
+    size_t matches;
+    const TokenDatabase::Entry* entry = FindBestMatch(
+        span(reinterpret_cast<const uint8_t*>(buffer.data()), size),
+        arguments,
+        matches);
+
+    // As in the Detokenizer, only replace messages with exactly one match that
+    // decodes successfully.
+    if (entry != nullptr && matches == 1u &&
+        FormatTo(entry->string, arguments, nullptr).ok()) {
+      FormatTo(entry->string, arguments, &output);
+      return;
+    }
+  }
+
+  output.Write(message);  // Keep the original if it doesn't decode.
+}
+
 }  // namespace pw::tokenizer
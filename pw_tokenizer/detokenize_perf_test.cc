@@ -0,0 +1,207 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares the throughput of the Detokenizer and StreamingDetokenizer for a
+// batch of tokenized log messages, in binary and in prefixed Base64 text.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "pw_assert/check.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_stream/null_stream.h"
+#include "pw_tokenizer/base64.h"
+#include "pw_tokenizer/detokenize.h"
+
+namespace pw::tokenizer {
+namespace {
+
+constexpr size_t kEntries = 10000;
+constexpr size_t kMessages = 256;
+
+// Format strings and encoded arguments for them.
+struct Format {
+  const char* string;
+  std::string_view arguments;
+};
+
+constexpr Format kFormats[] = {
+    {"Battery voltage %d mV, temperature %d C", "\xc0\x3e\x48"},
+    {"Connected to %s on channel %u", "\4wlan\x16"},
+    {"Flash write of %u bytes to sector %u failed: %s", "\x80\x40\x0e\4busy"},
+    {"Idle", ""},
+};
+
+uint32_t Token(size_t index) {
+  return static_cast<uint32_t>(index * 2654435761u);
+}
+
+void AppendUint32(std::vector<char>& data, uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    data.push_back(static_cast<char>(value >> shift));
+  }
+}
+
+// Builds a binary token database with kEntries strings, sorted by token.
+std::vector<char> MakeDatabase() {
+  std::vector<std::pair<uint32_t, const char*>> entries;
+  for (size_t i = 0; i < kEntries; ++i) {
+    entries.emplace_back(Token(i), kFormats[i % std::size(kFormats)].string);
+  }
+  std::sort(entries.begin(), entries.end());
+
+  std::vector<char> data = {'T', 'O', 'K', 'E', 'N', 'S', '\0', '\0'};
+  AppendUint32(data, kEntries);
+  AppendUint32(data, 0);
+
+  for (const auto& entry : entries) {
+    AppendUint32(data, entry.first);
+    AppendUint32(data, 0xFFFFFFFF);
+  }
+
+  for (const auto& entry : entries) {
+    const std::string_view format = entry.second;
+    data.insert(data.end(), format.begin(), format.end());
+    data.push_back('\0');
+  }
+  return data;
+}
+
+// Encodes a message for one of the database entries.
+std::string MakeMessage(size_t message) {
+  const size_t entry = message * (kEntries / kMessages);
+  const uint32_t token = Token(entry);
+
+  std::string encoded;
+  for (int shift = 0; shift < 32; shift += 8) {
+    encoded.push_back(static_cast<char>(token >> shift));
+  }
+  encoded.append(kFormats[entry % std::size(kFormats)].arguments);
+  return encoded;
+}
+
+struct Data {
+  Data()
+      : database(MakeDatabase()),
+        detokenizer(TokenDatabase::Create(database)),
+        streaming_detokenizer(TokenDatabase::Create(database)) {
+    PW_CHECK(TokenDatabase::Create(database).ok());
+
+    for (size_t i = 0; i < kMessages; ++i) {
+      messages.push_back(MakeMessage(i));
+
+      std::array<char, 64> base64;
+      const size_t size = PrefixedBase64Encode(
+          span(reinterpret_cast<const uint8_t*>(messages.back().data()),
+               messages.back().size()),
+          base64);
+      PW_CHECK_UINT_NE(size, 0);
+      base64_text.append("[log] ");
+      base64_text.append(base64.data(), size);
+      base64_text.append("\n");
+    }
+  }
+
+  std::vector<char> database;
+  Detokenizer detokenizer;
+  StreamingDetokenizer streaming_detokenizer;
+  std::vector<std::string> messages;
+  std::string base64_text;
+};
+
+const Data& GetData() {
+  static Data data;
+  return data;
+}
+
+void DetokenizeMessages(perf_test::State& state) {
+  const Data& data = GetData();
+  size_t bytes = 0;
+
+  while (state.KeepRunning()) {
+    for (const std::string& message : data.messages) {
+      const DetokenizedString result = data.detokenizer.Detokenize(message);
+      PW_CHECK(result.ok());
+      bytes += result.BestString().size();
+    }
+  }
+  PW_CHECK_UINT_NE(bytes, 0);
+}
+
+void StreamingDetokenizeMessages(perf_test::State& state) {
+  const Data& data = GetData();
+  stream::CountingNullStream output;
+
+  while (state.KeepRunning()) {
+    for (const std::string& message : data.messages) {
+      PW_CHECK_OK(data.streaming_detokenizer.Detokenize(message, output));
+    }
+  }
+  PW_CHECK_UINT_NE(output.bytes_written(), 0);
+}
+
+void DetokenizeBase64Text(perf_test::State& state) {
+  const Data& data = GetData();
+  size_t bytes = 0;
+
+  while (state.KeepRunning()) {
+    bytes += data.detokenizer.DetokenizeBase64(data.base64_text).size();
+  }
+  PW_CHECK_UINT_NE(bytes, 0);
+}
+
+void StreamingDetokenizeBase64Text(perf_test::State& state) {
+  const Data& data = GetData();
+  stream::CountingNullStream output;
+
+  while (state.KeepRunning()) {
+    PW_CHECK_OK(
+        data.streaming_detokenizer.DetokenizeBase64(data.base64_text, output));
+  }
+  PW_CHECK_UINT_NE(output.bytes_written(), 0);
+}
+
+void ConstructDetokenizer(perf_test::State& state) {
+  const TokenDatabase database = TokenDatabase::Create(GetData().database);
+
+  while (state.KeepRunning()) {
+    Detokenizer detokenizer(database);
+  }
+}
+
+void ConstructStreamingDetokenizer(perf_test::State& state) {
+  const TokenDatabase database = TokenDatabase::Create(GetData().database);
+
+  while (state.KeepRunning()) {
+    StreamingDetokenizer detokenizer(database);
+  }
+}
+
+PW_PERF_TEST(ConstructDetokenizer, ConstructDetokenizer);
+PW_PERF_TEST(ConstructStreamingDetokenizer, ConstructStreamingDetokenizer);
+PW_PERF_TEST(Detokenize256Messages, DetokenizeMessages);
+PW_PERF_TEST(StreamingDetokenize256Messages, StreamingDetokenizeMessages);
+PW_PERF_TEST(DetokenizeBase64_256Messages, DetokenizeBase64Text);
+PW_PERF_TEST(StreamingDetokenizeBase64_256Messages,
+             StreamingDetokenizeBase64Text);
+
+}  // namespace
+}  // namespace pw::tokenizer
@@ -17,6 +17,7 @@
 #include <string_view>
 
 #include "gtest/gtest.h"
+#include "pw_stream/memory_stream.h"
 
 namespace pw::tokenizer {
 namespace {
@@ -320,5 +321,144 @@ TEST_F(DetokenizeWithCollisions, Collision_TracksAllMatches) {
   EXPECT_EQ(result.matches().size(), 7u);
 }
 
+class StreamingDetokenize : public ::testing::Test {
+ protected:
+  StreamingDetokenize()
+      : basic_(TokenDatabase::Create<kBasicData>()),
+        with_args_(kWithArgs),
+        with_collisions_(kWithCollisions) {}
+
+  // Returns the text written by the last call.
+  std::string_view output() const {
+    return std::string_view(
+        reinterpret_cast<const char*>(writer_.WrittenData().data()),
+        writer_.WrittenData().size());
+  }
+
+  Status Detokenize(const StreamingDetokenizer& detok,
+                    std::string_view encoded) {
+    writer_.clear();
+    return detok.Detokenize(encoded, writer_);
+  }
+
+  Status DetokenizeBase64(const StreamingDetokenizer& detok,
+                          std::string_view text) {
+    writer_.clear();
+    return detok.DetokenizeBase64(text, writer_);
+  }
+
+  StreamingDetokenizer basic_;
+  StreamingDetokenizer with_args_;
+  StreamingDetokenizer with_collisions_;
+  stream::MemoryWriterBuffer<128> writer_;
+};
+
+TEST_F(StreamingDetokenize, IndexesEveryEntry) {
+  EXPECT_EQ(basic_.size(), 4u);
+  EXPECT_EQ(with_collisions_.size(), 15u);
+}
+
+TEST_F(StreamingDetokenize, NoFormatting) {
+  for (auto [data, expected] : TestCases(Case{"\1\0\0\0"sv, "One"},
+                                         Case{"\5\0\0\0"sv, "TWO"},
+                                         Case{"\xff\x00\x00\x00"sv, "333"},
+                                         Case{"\xff\xee\xee\xdd"sv, "FOUR"},
+                                         Case{"\1\0"sv, "One"})) {
+    EXPECT_EQ(OkStatus(), Detokenize(basic_, data));
+    EXPECT_EQ(output(), expected);
+  }
+}
+
+TEST_F(StreamingDetokenize, MissingToken_NotFound) {
+  EXPECT_EQ(Status::NotFound(), Detokenize(basic_, ""sv));
+  EXPECT_TRUE(output().empty());
+}
+
+TEST_F(StreamingDetokenize, UnknownToken_NotFound) {
+  EXPECT_EQ(Status::NotFound(), Detokenize(basic_, "\0\0\0\0"sv));
+  EXPECT_EQ(Status::NotFound(), Detokenize(basic_, "\x98\xba\xdc\xfe"sv));
+  EXPECT_TRUE(output().empty());
+}
+
+TEST_F(StreamingDetokenize, Base64_NoArguments) {
+  for (auto [data, expected] : TestCases(
+           Case{ONE, "One"},
+           Case{FOUR ONE ONE, "FOUROneOne"},
+           Case{ONE "\r\n" TWO "\r\n" THREE "\r\n" FOUR "\r\n",
+                "One\r\nTWO\r\n333\r\nFOUR\r\n"},
+           Case{"123" FOUR ", 56", "123FOUR, 56"},
+           Case{"12" THREE FOUR ", 56", "12333FOUR, 56"},
+           Case{"$0" ONE, "$0One"},
+           Case{"$/+7u3Q=", "$/+7u3Q="},  // incomplete message (missing "=")
+           Case{"$123456==" FOUR, "$123456==FOUR"},
+           Case{"$", "$"},
+           Case{"", ""})) {
+    EXPECT_EQ(OkStatus(), DetokenizeBase64(basic_, data));
+    EXPECT_EQ(output(), expected);
+  }
+}
+
+TEST_F(StreamingDetokenize, WithArgs_Successful) {
+  for (auto [data, expected] : TestCases(
+           Case{"\x0A\x0B\x0C\x0D\5force\4Luke"sv, "Use the force, Luke."},
+           Case{"\x0E\x0F\x00\x01\4\4them"sv, "Now there are 2 of them!"},
+           Case{"\xAA\xAA\xAA\xAA\xfc\x01"sv, "~!"},
+           Case{"\xCC\xCC\xCC\xCC\xfe\xff\x07"sv, "65535!"},
+           Case{"\xDD\xDD\xDD\xDD\xfe\xff\xff\xff\x1f"sv, "4294967295!"},
+           Case{"\xEE\xEE\xEE\xEE\xfe\xff\x07"sv, "65535!"})) {
+    EXPECT_EQ(OkStatus(), Detokenize(with_args_, data));
+    EXPECT_EQ(output(), expected);
+  }
+}
+
+TEST_F(StreamingDetokenize, WithArgs_Errors_DataLoss) {
+  EXPECT_EQ(Status::DataLoss(),
+            Detokenize(with_args_, "\x00\x00\x00\x00MORE data"sv));
+  EXPECT_EQ(output(), "");
+
+  EXPECT_EQ(Status::DataLoss(),
+            Detokenize(with_args_, "\x0A\x0B\x0C\x0D\5force"sv));
+  EXPECT_EQ(output(), "Use the force, %s.");
+
+  EXPECT_EQ(Status::DataLoss(),
+            Detokenize(with_args_, "\x0E\x0F\x00\x01\xFF"sv));
+  EXPECT_EQ(output(), "Now there are %d of %s!");
+}
+
+TEST_F(StreamingDetokenize, Collisions_MatchDetokenizer) {
+  const Detokenizer detok(kWithCollisions);
+
+  for (std::string_view data : {"\0\0\0\0"sv,
+                                "\0\0\0\0\x01"sv,
+                                "\0\0\0\0\x80"sv,
+                                "\0\0\0\0\4Hey!\x04"sv,
+                                "\0\0\0\0\x80\x80\x80\x80\x00"sv,
+                                "\0\0\0\0\x08?"sv,
+                                "\0\0\0\0\x01!\x01\x80"sv,
+                                "\xBB\xBB\xBB\xBB\x00"sv,
+                                "\xCC\xCC\xCC\xCC\2Yo\5?"sv,
+                                "\xDD\xDD\xDD\xDD\x01\x02\x01\x04\x05"sv,
+                                "\0\0\0\0\x01\x00\x01\x02"sv,
+                                "\xAA\xAA\xAA\xAA"sv}) {
+    // Colliding tokens are ambiguous, so they never decode successfully.
+    EXPECT_EQ(Status::DataLoss(), Detokenize(with_collisions_, data));
+    EXPECT_EQ(output(), detok.Detokenize(data).BestString());
+  }
+}
+
+TEST_F(StreamingDetokenize, Base64_Collision_KeepsOriginal) {
+  EXPECT_EQ(OkStatus(), DetokenizeBase64(with_collisions_, "$AAAAAA=="));
+  EXPECT_EQ(output(), "$AAAAAA==");
+}
+
+TEST_F(StreamingDetokenize, OutputFull_ReturnsWriterError) {
+  stream::MemoryWriterBuffer<8> small_writer;
+  EXPECT_EQ(Status::OutOfRange(),
+            with_args_.Detokenize("\x0A\x0B\x0C\x0D\5force\4Luke"sv,
+                                  small_writer));
+  EXPECT_EQ(Status::OutOfRange(),
+            basic_.DetokenizeBase64("123" FOUR ", 56", small_writer));
+}
+
 }  // namespace
 }  // namespace pw::tokenizer
@@ -22,6 +22,9 @@
 //   DetokenizedString result = detok.Detokenize(my_data);
 //   std::cout << result.BestString() << '\n';
 //
+// For high volumes of messages, the StreamingDetokenizer class reads the token
+// database in place and writes detokenized text to a pw::stream::Writer
+// without allocating.
 #pragma once
 
 #include <cstddef>
@@ -32,6 +35,8 @@
 #include <vector>
 
 #include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
 #include "pw_tokenizer/internal/decode.h"
 #include "pw_tokenizer/token_database.h"
 
@@ -105,4 +110,66 @@ class Detokenizer {
   std::unordered_map<uint32_t, std::vector<TokenizedStringEntry>> database_;
 };
 
+// Decodes and detokenizes strings from a TokenDatabase, writing the results to
+// a pw::stream::Writer. Unlike the Detokenizer, this class does not copy the
+// database or parse its format strings up front. It builds a compact index of
+// the database entries, sorted by token, in a single allocation. Format strings
+// are read from the database in place and parsed as messages are decoded.
+// Detokenizing a message does not allocate.
+//
+// Since strings are not copied, the database's memory (for example, a
+// memory-mapped database file) must outlive the StreamingDetokenizer.
+class StreamingDetokenizer {
+ public:
+  // Nested Base64 messages that decode to more than this many bytes are not
+  // detokenized.
+  static constexpr size_t kMaxBase64MessageSizeBytes = 256;
+
+  explicit StreamingDetokenizer(const TokenDatabase& database);
+
+  // Decodes and detokenizes the encoded message and writes the best match to
+  // the output. This writes the same string as
+  // Detokenizer::Detokenize(encoded).BestString().
+  //
+  // Returns:
+  //   OK - The message was detokenized successfully.
+  //   NOT_FOUND - The message was empty or its token is not in the database.
+  //       Nothing was written.
+  //   DATA_LOSS - The message did not decode cleanly or its token matched
+  //       multiple strings. The best match was written.
+  //   Any error from writing to the output.
+  Status Detokenize(span<const uint8_t> encoded, stream::Writer& output) const;
+
+  Status Detokenize(std::string_view encoded, stream::Writer& output) const {
+    return Detokenize(
+        span(reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size()),
+        output);
+  }
+
+  // Writes the text to the output with nested Base64 messages decoded in
+  // context. Messages that fail to decode are written as is. This writes the
+  // same string as Detokenizer::DetokenizeBase64(text).
+  //
+  // Returns OK or any error from writing to the output.
+  Status DetokenizeBase64(std::string_view text, stream::Writer& output) const;
+
+  // The number of entries in the index.
+  size_t size() const { return index_.size(); }
+
+ private:
+  // Finds the entry that best decodes the message, which must not be empty.
+  // Sets the message's arguments and the number of entries for its token.
+  // Returns nullptr if the token is not in the database.
+  const TokenDatabase::Entry* FindBestMatch(span<const uint8_t> encoded,
+                                            span<const uint8_t>& arguments,
+                                            size_t& matches) const;
+
+  // Writes a detokenized Base64 message, or the message itself if it does not
+  // decode successfully.
+  void DetokenizeBase64Message(std::string_view message,
+                               DecodedTextOutput& output) const;
+
+  std::vector<TokenDatabase::Entry> index_;
+};
+
 }  // namespace pw::tokenizer
@@ -123,11 +123,31 @@ class DecodedArg {
 // contains either literal text or a format specifier.
 class StringSegment {
  public:
+  enum Type {
+    kLiteral,
+    kPercent,  // %% format specifier
+    kString,
+    kSignedInt,
+    kUnsigned32,
+    kUnsigned64,
+    kFloatingPoint,
+  };
+
+  // Varargs-promoted size of args on this machine; only needed for ints or %p.
+  enum ArgSize : bool { k32Bit, k64Bit };
+
   // Parses a format specifier from the text and returns a StringSegment that
   // represents it. Returns an empty StringSegment if no valid format specifier
   // was found.
   static StringSegment ParseFormatSpec(const char* format);
 
+  // Parses a format specifier from the text without copying it. Returns the
+  // length of the specifier and sets its type and argument size, or returns 0
+  // if no valid format specifier was found.
+  static size_t ParseFormatSpecLength(const char* format,
+                                      Type& type,
+                                      ArgSize& local_size);
+
   // Creates a StringSegment that represents a piece of plain text.
   StringSegment(const std::string_view& text) : StringSegment(text, kLiteral) {}
 
@@ -143,19 +163,6 @@ class StringSegment {
   const std::string& text() const { return text_; }
 
  private:
-  enum Type {
-    kLiteral,
-    kPercent,  // %% format specifier
-    kString,
-    kSignedInt,
-    kUnsigned32,
-    kUnsigned64,
-    kFloatingPoint,
-  };
-
-  // Varargs-promoted size of args on this machine; only needed for ints or %p.
-  enum ArgSize : bool { k32Bit, k64Bit };
-
   template <typename T>
   static constexpr ArgSize VarargSize() {
     return sizeof(T) == sizeof(int64_t) ? k64Bit : k32Bit;
@@ -241,6 +248,47 @@ class FormatString {
   std::vector<StringSegment> segments_;
 };
 
+// Receives the text of a message decoded by FormatTo().
+class DecodedTextOutput {
+ public:
+  virtual void Write(std::string_view text) = 0;
+
+ protected:
+  ~DecodedTextOutput() = default;
+};
+
+// Summarizes a message decoded by FormatTo(). These values match the
+// corresponding functions of a DecodedFormatString for the same message.
+class FormatSummary {
+ public:
+  constexpr FormatSummary()
+      : remaining_bytes_(0), argument_count_(0), decoding_errors_(0) {}
+
+  bool ok() const { return remaining_bytes_ == 0u && decoding_errors_ == 0u; }
+
+  size_t remaining_bytes() const { return remaining_bytes_; }
+  size_t argument_count() const { return argument_count_; }
+  size_t decoding_errors() const { return decoding_errors_; }
+
+ private:
+  friend FormatSummary FormatTo(const char*,
+                                span<const uint8_t>,
+                                DecodedTextOutput*);
+
+  size_t remaining_bytes_;
+  size_t argument_count_;
+  size_t decoding_errors_;
+};
+
+// Decodes the arguments with a null-terminated printf-style format string and
+// writes the same text as FormatString(format).Format(arguments).value() to
+// the output. The format string is parsed as the message is decoded, and
+// nothing is allocated unless one formatted argument exceeds 255 characters.
+// If output is null, the message is only checked and summarized.
+FormatSummary FormatTo(const char* format,
+                       span<const uint8_t> arguments,
+                       DecodedTextOutput* output);
+
 PW_MODIFY_DIAGNOSTICS_PUSH();
 PW_MODIFY_DIAGNOSTIC(ignored, "-Wformat-nonliteral");
 // Implementation of DecodedArg::FromValue template function.
@@ -14,15 +14,36 @@
 
 #include "pw_transfer/internal/chunk.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "pw_assert/check.h"
 #include "pw_protobuf/decoder.h"
 #include "pw_protobuf/serialized_size.h"
 #include "pw_status/try.h"
+#include "pw_varint/varint.h"
 
 namespace pw::transfer::internal {
 
 namespace ProtoChunk = transfer::pwpb::Chunk;
 
+namespace {
+
+// Received ranges are encoded as a packed list of their start and end offsets.
+using EncodedRanges = std::array<uint32_t, Chunk::kMaxReceivedRanges * 2>;
+
+span<const uint32_t> EncodeRanges(span<const Chunk::Range> ranges,
+                                  EncodedRanges& encoded) {
+  size_t i = 0;
+  for (const Chunk::Range& range : ranges) {
+    encoded[i++] = range.start_offset;
+    encoded[i++] = range.end_offset;
+  }
+  return span(encoded).first(i);
+}
+
+}  // namespace
+
 Result<Chunk::Identifier> Chunk::ExtractIdentifier(ConstByteSpan message) {
   protobuf::Decoder decoder(message);
 
@@ -71,6 +92,13 @@ Result<Chunk::Identifier> Chunk::ExtractIdentifier(ConstByteSpan message) {
   return Status::DataLoss();
 }
 
+Chunk& Chunk::set_received_ranges(span<const Range> ranges) {
+  num_received_ranges_ =
+      static_cast<uint8_t>(std::min(ranges.size(), kMaxReceivedRanges));
+  std::copy_n(ranges.begin(), num_received_ranges_, received_ranges_.begin());
+  return *this;
+}
+
 Result<Chunk> Chunk::Parse(ConstByteSpan message) {
   protobuf::Decoder decoder(message);
   Status status;
@@ -182,6 +210,17 @@ Result<Chunk> Chunk::Parse(ConstByteSpan message) {
         chunk.desired_session_id_ = value;
         break;
 
+      case ProtoChunk::Fields::kSelectiveAck:
+        PW_TRY(decoder.ReadBool(&chunk.selective_ack_));
+        break;
+
+      case ProtoChunk::Fields::kReceivedRanges: {
+        ConstByteSpan packed;
+        PW_TRY(decoder.ReadBytes(&packed));
+        PW_TRY(chunk.ParseReceivedRanges(packed));
+        break;
+      }
+
         // Silently ignore any unrecognized fields.
     }
   }
@@ -210,6 +249,42 @@ Result<Chunk> Chunk::Parse(ConstByteSpan message) {
   return status;
 }
 
+Status Chunk::ParseReceivedRanges(ConstByteSpan packed) {
+  EncodedRanges values;
+  size_t num_values = 0;
+  uint32_t previous_end_offset = 0;
+
+  while (!packed.empty()) {
+    uint64_t value;
+    const size_t bytes = varint::Decode(packed, &value);
+    if (bytes == 0 || value > std::numeric_limits<uint32_t>::max()) {
+      return Status::DataLoss();
+    }
+    packed = packed.subspan(bytes);
+    values[num_values++] = static_cast<uint32_t>(value);
+
+    if (num_values < 2) {
+      continue;
+    }
+    num_values = 0;
+
+    const Range range{.start_offset = values[0], .end_offset = values[1]};
+    if (range.start_offset < previous_end_offset ||
+        range.start_offset >= range.end_offset) {
+      return Status::DataLoss();
+    }
+    previous_end_offset = range.end_offset;
+
+    // Drop ranges that don't fit. The transmitter resends their data.
+    if (num_received_ranges_ < kMaxReceivedRanges) {
+      received_ranges_[num_received_ranges_++] = range;
+    }
+  }
+
+  // Offsets must come in pairs.
+  return num_values == 0 ? OkStatus() : Status::DataLoss();
+}
+
 Result<ConstByteSpan> Chunk::Encode(ByteSpan buffer) const {
   PW_CHECK(protocol_version_ != ProtocolVersion::kUnknown,
            "Cannot encode a transfer chunk with an unknown protocol version");
@@ -236,6 +311,16 @@ Result<ConstByteSpan> Chunk::Encode(ByteSpan buffer) const {
     if (resource_id_.has_value()) {
       encoder.WriteResourceId(resource_id_.value()).IgnoreError();
     }
+
+    if (selective_ack_) {
+      encoder.WriteSelectiveAck(true).IgnoreError();
+    }
+
+    if (num_received_ranges_ != 0) {
+      EncodedRanges encoded;
+      encoder.WriteReceivedRanges(EncodeRanges(received_ranges(), encoded))
+          .IgnoreError();
+    }
   }
 
   // During the initial handshake, the chunk's configured protocol version is
@@ -330,6 +415,19 @@ size_t Chunk::EncodedSize() const {
       size += protobuf::SizeOfVarintField(ProtoChunk::Fields::kDesiredSessionId,
                                           desired_session_id_.value());
     }
+    if (selective_ack_) {
+      size += protobuf::SizeOfVarintField(ProtoChunk::Fields::kSelectiveAck,
+                                          true);
+    }
+    if (num_received_ranges_ != 0) {
+      EncodedRanges encoded;
+      size_t ranges_size = 0;
+      for (uint32_t value : EncodeRanges(received_ranges(), encoded)) {
+        ranges_size += varint::EncodedSize(value);
+      }
+      size += protobuf::SizeOfDelimitedField(
+          ProtoChunk::Fields::kReceivedRanges, ranges_size);
+    }
   }
 
   if (offset_ != 0) {
@@ -62,5 +62,52 @@ TEST(Chunk, EncodedSizeMatchesBuffer) {
   EXPECT_EQ(chunk.EncodedSize(), result->size_bytes());
 }
 
+TEST(Chunk, ReceivedRanges_EncodeAndParse) {
+  constexpr Chunk::Range kRanges[] = {{16, 24}, {200, 300}};
+  Chunk chunk(ProtocolVersion::kVersionTwo,
+              Chunk::Type::kParametersRetransmit);
+  chunk.set_session_id(42)
+      .set_offset(8)
+      .set_window_end_offset(400)
+      .set_selective_ack(true)
+      .set_received_ranges(kRanges);
+
+  std::array<std::byte, 64> buffer;
+  auto result = chunk.Encode(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(chunk.EncodedSize(), result->size_bytes());
+
+  Result<Chunk> parsed = Chunk::Parse(*result);
+  ASSERT_EQ(parsed.status(), OkStatus());
+  EXPECT_TRUE(parsed->selective_ack());
+  ASSERT_EQ(parsed->received_ranges().size(), 2u);
+  EXPECT_EQ(parsed->received_ranges()[0].start_offset, 16u);
+  EXPECT_EQ(parsed->received_ranges()[0].end_offset, 24u);
+  EXPECT_EQ(parsed->received_ranges()[1].start_offset, 200u);
+  EXPECT_EQ(parsed->received_ranges()[1].end_offset, 300u);
+}
+
+TEST(Chunk, ReceivedRanges_ExtraRangesAreDropped) {
+  constexpr Chunk::Range kRanges[] = {
+      {10, 20}, {30, 40}, {50, 60}, {70, 80}, {90, 100}};
+  Chunk chunk(ProtocolVersion::kVersionTwo,
+              Chunk::Type::kParametersRetransmit);
+  chunk.set_session_id(42).set_received_ranges(kRanges);
+  EXPECT_EQ(chunk.received_ranges().size(), Chunk::kMaxReceivedRanges);
+}
+
+TEST(Chunk, ReceivedRanges_Unordered_FailsToParse) {
+  // session_id: 42, received_ranges: [30, 40, 10, 20]
+  constexpr auto kMessage =
+      bytes::Array<0x60, 42, 0x82, 0x01, 4, 30, 40, 10, 20>();
+  EXPECT_EQ(Chunk::Parse(kMessage).status(), Status::DataLoss());
+}
+
+TEST(Chunk, ReceivedRanges_OddNumberOfOffsets_FailsToParse) {
+  // session_id: 42, received_ranges: [10, 20, 30]
+  constexpr auto kMessage = bytes::Array<0x60, 42, 0x82, 0x01, 3, 10, 20, 30>();
+  EXPECT_EQ(Chunk::Parse(kMessage).status(), Status::DataLoss());
+}
+
 }  // namespace
 }  // namespace pw::transfer::internal
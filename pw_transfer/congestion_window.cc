@@ -0,0 +1,120 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/congestion_window.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace pw::transfer::internal {
+namespace {
+
+// Bounds on how far the round trip time may rise above the smallest one seen
+// before slow start ends. The allowance is an eighth of the smallest round
+// trip time, so that jitter on fast links does not end slow start early.
+constexpr chrono::SystemClock::duration kMinRoundTripTimeIncrease =
+    chrono::SystemClock::for_at_least(std::chrono::milliseconds(4));
+constexpr chrono::SystemClock::duration kMaxRoundTripTimeIncrease =
+    chrono::SystemClock::for_at_least(std::chrono::milliseconds(16));
+
+}  // namespace
+
+void CongestionWindow::Reset() {
+  phase_ = Phase::kSlowStart;
+  size_bytes_ = 0;
+  slow_start_threshold_bytes_ = std::numeric_limits<uint32_t>::max();
+  bytes_since_increase_ = 0;
+  min_round_trip_time_ = std::nullopt;
+}
+
+void CongestionWindow::SetLimits(uint32_t chunk_size_bytes,
+                                 uint32_t max_size_bytes) {
+  chunk_size_bytes_ = std::max(chunk_size_bytes, uint32_t{1});
+  max_size_bytes_ = std::max(max_size_bytes, uint32_t{1});
+  set_size_bytes(size_bytes_ == 0 ? chunk_size_bytes_ : size_bytes_);
+}
+
+void CongestionWindow::OnDataReceived(uint32_t bytes) {
+  if (phase_ == Phase::kSlowStart) {
+    // Growing by the amount of data received doubles the window each round
+    // trip.
+    const uint64_t size_bytes = uint64_t{size_bytes_} + bytes;
+    if (size_bytes >= slow_start_threshold_bytes_) {
+      set_size_bytes(slow_start_threshold_bytes_);
+      phase_ = Phase::kCongestionAvoidance;
+    } else {
+      set_size_bytes(static_cast<uint32_t>(size_bytes));
+    }
+    return;
+  }
+
+  if (size_bytes_ == max_size_bytes_) {
+    bytes_since_increase_ = 0;
+    return;
+  }
+
+  // Grow by one chunk for every window of data received.
+  bytes_since_increase_ += bytes;
+  if (bytes_since_increase_ >= size_bytes_) {
+    bytes_since_increase_ -= size_bytes_;
+    set_size_bytes(size_bytes_ + chunk_size_bytes_);
+  }
+}
+
+void CongestionWindow::OnDataLost() {
+  slow_start_threshold_bytes_ = std::max(size_bytes_ / 2, chunk_size_bytes_);
+  set_size_bytes(slow_start_threshold_bytes_);
+  phase_ = Phase::kCongestionAvoidance;
+  bytes_since_increase_ = 0;
+}
+
+void CongestionWindow::OnTimeout() {
+  slow_start_threshold_bytes_ = std::max(size_bytes_ / 2, chunk_size_bytes_);
+  set_size_bytes(chunk_size_bytes_);
+  phase_ = size_bytes_ < slow_start_threshold_bytes_
+               ? Phase::kSlowStart
+               : Phase::kCongestionAvoidance;
+  bytes_since_increase_ = 0;
+}
+
+void CongestionWindow::OnRoundTrip(
+    chrono::SystemClock::duration round_trip_time) {
+  if (!min_round_trip_time_.has_value() ||
+      round_trip_time < *min_round_trip_time_) {
+    min_round_trip_time_ = round_trip_time;
+    return;
+  }
+
+  if (phase_ != Phase::kSlowStart) {
+    return;
+  }
+
+  const chrono::SystemClock::duration allowed_increase =
+      std::clamp(*min_round_trip_time_ / 8,
+                 kMinRoundTripTimeIncrease,
+                 kMaxRoundTripTimeIncrease);
+  if (round_trip_time > *min_round_trip_time_ + allowed_increase) {
+    slow_start_threshold_bytes_ = size_bytes_;
+    phase_ = Phase::kCongestionAvoidance;
+  }
+}
+
+void CongestionWindow::set_size_bytes(uint32_t size_bytes) {
+  size_bytes_ = std::clamp(size_bytes,
+                           std::min(chunk_size_bytes_, max_size_bytes_),
+                           max_size_bytes_);
+}
+
+}  // namespace pw::transfer::internal
@@ -0,0 +1,157 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/congestion_window.h"
+
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+namespace pw::transfer::internal {
+namespace {
+
+using Phase = CongestionWindow::Phase;
+
+constexpr uint32_t kChunkSize = 100;
+constexpr uint32_t kMaxSize = 1600;
+
+constexpr chrono::SystemClock::duration Milliseconds(int ms) {
+  return chrono::SystemClock::for_at_least(std::chrono::milliseconds(ms));
+}
+
+class CongestionWindowTest : public ::testing::Test {
+ protected:
+  CongestionWindowTest() {
+    window_.Reset();
+    window_.SetLimits(kChunkSize, kMaxSize);
+  }
+
+  CongestionWindow window_;
+};
+
+TEST_F(CongestionWindowTest, StartsWithOneChunkInSlowStart) {
+  EXPECT_EQ(window_.size_bytes(), kChunkSize);
+  EXPECT_EQ(window_.phase(), Phase::kSlowStart);
+}
+
+TEST_F(CongestionWindowTest, SlowStartDoublesEachWindow) {
+  window_.OnDataReceived(100);
+  EXPECT_EQ(window_.size_bytes(), 200u);
+  window_.OnDataReceived(200);
+  EXPECT_EQ(window_.size_bytes(), 400u);
+  window_.OnDataReceived(400);
+  EXPECT_EQ(window_.size_bytes(), 800u);
+  EXPECT_EQ(window_.phase(), Phase::kSlowStart);
+}
+
+TEST_F(CongestionWindowTest, DoesNotGrowPastMaximum) {
+  for (int i = 0; i < 10; ++i) {
+    window_.OnDataReceived(kMaxSize);
+  }
+  EXPECT_EQ(window_.size_bytes(), kMaxSize);
+}
+
+TEST_F(CongestionWindowTest, DataLostHalvesWindow) {
+  window_.OnDataReceived(700);
+  ASSERT_EQ(window_.size_bytes(), 800u);
+
+  window_.OnDataLost();
+  EXPECT_EQ(window_.size_bytes(), 400u);
+  EXPECT_EQ(window_.phase(), Phase::kCongestionAvoidance);
+
+  window_.OnDataLost();
+  EXPECT_EQ(window_.size_bytes(), 200u);
+}
+
+TEST_F(CongestionWindowTest, DataLostKeepsAtLeastOneChunk) {
+  window_.OnDataLost();
+  window_.OnDataLost();
+  EXPECT_EQ(window_.size_bytes(), kChunkSize);
+}
+
+TEST_F(CongestionWindowTest, CongestionAvoidanceGrowsOneChunkPerWindow) {
+  window_.OnDataReceived(700);
+  window_.OnDataLost();
+  ASSERT_EQ(window_.size_bytes(), 400u);
+
+  window_.OnDataReceived(300);
+  EXPECT_EQ(window_.size_bytes(), 400u);
+  window_.OnDataReceived(100);
+  EXPECT_EQ(window_.size_bytes(), 500u);
+
+  window_.OnDataReceived(500);
+  EXPECT_EQ(window_.size_bytes(), 600u);
+}
+
+TEST_F(CongestionWindowTest, TimeoutRestartsSlowStartUpToHalfWindow) {
+  window_.OnDataReceived(700);
+  ASSERT_EQ(window_.size_bytes(), 800u);
+
+  window_.OnTimeout();
+  EXPECT_EQ(window_.size_bytes(), kChunkSize);
+  EXPECT_EQ(window_.phase(), Phase::kSlowStart);
+
+  // Slow start ends at half of the window at the time of the timeout.
+  window_.OnDataReceived(100);
+  window_.OnDataReceived(200);
+  EXPECT_EQ(window_.size_bytes(), 400u);
+  EXPECT_EQ(window_.phase(), Phase::kCongestionAvoidance);
+}
+
+TEST_F(CongestionWindowTest, RisingRoundTripTimeEndsSlowStart) {
+  window_.OnRoundTrip(Milliseconds(100));
+  window_.OnDataReceived(100);
+  window_.OnRoundTrip(Milliseconds(110));
+  EXPECT_EQ(window_.phase(), Phase::kSlowStart);
+
+  window_.OnDataReceived(200);
+  window_.OnRoundTrip(Milliseconds(150));
+  EXPECT_EQ(window_.phase(), Phase::kCongestionAvoidance);
+  EXPECT_EQ(window_.size_bytes(), 400u);
+
+  // The window keeps growing, but more slowly.
+  window_.OnDataReceived(400);
+  EXPECT_EQ(window_.size_bytes(), 500u);
+}
+
+TEST_F(CongestionWindowTest, SmallRoundTripTimeJitterIsIgnored) {
+  window_.OnRoundTrip(Milliseconds(1));
+  window_.OnRoundTrip(Milliseconds(4));
+  EXPECT_EQ(window_.phase(), Phase::kSlowStart);
+}
+
+TEST_F(CongestionWindowTest, ResetRestartsFromOneChunk) {
+  window_.OnDataReceived(700);
+  window_.OnDataLost();
+  ASSERT_EQ(window_.phase(), Phase::kCongestionAvoidance);
+
+  window_.Reset();
+  window_.SetLimits(200, kMaxSize);
+  EXPECT_EQ(window_.size_bytes(), 200u);
+  EXPECT_EQ(window_.phase(), Phase::kSlowStart);
+}
+
+TEST_F(CongestionWindowTest, SetLimitsClampsWindow) {
+  window_.OnDataReceived(700);
+  ASSERT_EQ(window_.size_bytes(), 800u);
+
+  window_.SetLimits(kChunkSize, 500);
+  EXPECT_EQ(window_.size_bytes(), 500u);
+
+  window_.SetLimits(600, 500);
+  EXPECT_EQ(window_.size_bytes(), 500u);
+}
+
+}  // namespace
+}  // namespace pw::transfer::internal
@@ -16,6 +16,7 @@
 
 #include "pw_transfer/internal/context.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include "pw_assert/check.h"
@@ -84,7 +85,6 @@ void Context::HandleEvent(const Event& event) {
       return;
 
     case EventType::kSendStatusChunk:
-    case EventType::kAddTransferHandler:
     case EventType::kRemoveTransferHandler:
     case EventType::kTerminate:
       // These events are intended for the transfer thread and should never be
@@ -124,6 +124,7 @@ void Context::InitiateTransferAsClient() {
   Chunk start_chunk(desired_protocol_version_, Chunk::Type::kStart);
   start_chunk.set_desired_session_id(session_id_);
   start_chunk.set_resource_id(resource_id_);
+  start_chunk.set_selective_ack(SupportsSelectiveAck());
 
   if (type() == TransferType::kReceive) {
     // Parameters should still be set on the initial chunk for backwards
@@ -179,12 +180,22 @@ void Context::SendInitialLegacyTransmitChunk() {
 }
 
 void Context::UpdateTransferParameters() {
+  uint32_t window_size = max_parameters_->pending_bytes();
+  if (max_parameters_->adaptive_window()) {
+    congestion_window_.SetLimits(
+        MaxWriteChunkSize(max_parameters_->max_chunk_size_bytes(),
+                          rpc_writer_->channel_id()),
+        window_size);
+    window_size = congestion_window_.size_bytes();
+  }
+
   size_t pending_bytes =
-      std::min(max_parameters_->pending_bytes(),
+      std::min(window_size,
                static_cast<uint32_t>(writer().ConservativeWriteLimit()));
 
   window_size_ = pending_bytes;
   window_end_offset_ = offset_ + pending_bytes;
+  max_window_end_offset_ = std::max(max_window_end_offset_, window_end_offset_);
 
   max_chunk_size_bytes_ = MaxWriteChunkSize(
       max_parameters_->max_chunk_size_bytes(), rpc_writer_->channel_id());
@@ -198,8 +209,30 @@ void Context::SetTransferParameters(Chunk& parameters) {
 }
 
 void Context::UpdateAndSendTransferParameters(TransmitAction action) {
+  const uint32_t previous_window_end_offset = window_end_offset_;
   UpdateTransferParameters();
 
+  if (max_parameters_->adaptive_window()) {
+    // The transmitter continues from its current offset when extending the
+    // window, so the end of the window must not move back. The window can
+    // only shrink when the transmitter is told to retransmit.
+    if (action == TransmitAction::kExtend &&
+        window_end_offset_ < previous_window_end_offset) {
+      window_end_offset_ = previous_window_end_offset;
+    }
+
+    // Time the arrival of the first newly requested byte, if not already
+    // timing another.
+    const uint32_t requested_offset = action == TransmitAction::kExtend
+                                          ? previous_window_end_offset
+                                          : offset_;
+    if (!round_trip_start_.has_value() &&
+        requested_offset < window_end_offset_) {
+      round_trip_offset_ = requested_offset;
+      round_trip_start_ = chrono::SystemClock::now();
+    }
+  }
+
   PW_LOG_INFO("Transfer rate: %u B/s",
               static_cast<unsigned>(transfer_rate_.GetRateBytesPerSecond()));
 
@@ -225,6 +258,11 @@ void Context::SendTransferParameters(TransmitAction action) {
   parameters.set_session_id(session_id_);
   SetTransferParameters(parameters);
 
+  // Tell the transmitter which data it does not need to resend.
+  if (selective_ack() && type == Chunk::Type::kParametersRetransmit) {
+    parameters.set_received_ranges(reorder_buffer_.ranges());
+  }
+
   PW_LOG_DEBUG(
       "Transfer %u sending transfer parameters: "
       "offset=%u, window_end_offset=%u, max_chunk_size=%u",
@@ -296,6 +334,7 @@ void Context::Initialize(const NewTransferEvent& new_transfer) {
   offset_ = 0;
   window_size_ = 0;
   window_end_offset_ = 0;
+  max_window_end_offset_ = 0;
   max_chunk_size_bytes_ = new_transfer.max_parameters->max_chunk_size_bytes();
 
   max_parameters_ = new_transfer.max_parameters;
@@ -310,6 +349,13 @@ void Context::Initialize(const NewTransferEvent& new_transfer) {
   next_timeout_ = kNoTimeout;
 
   transfer_rate_.Reset();
+
+  congestion_window_.Reset();
+  round_trip_offset_ = 0;
+  round_trip_start_ = std::nullopt;
+
+  reorder_buffer_.Reset(0);
+  num_peer_received_ranges_ = 0;
 }
 
 void Context::HandleChunkEvent(const ChunkEvent& event) {
@@ -349,11 +395,18 @@ void Context::PerformInitialHandshake(const Chunk& chunk) {
     case Chunk::Type::kStart: {
       UpdateLocalProtocolConfigurationFromPeer(chunk);
 
+      // Use selective retransmission if both ends support it.
+      if (chunk.selective_ack() && SupportsSelectiveAck()) {
+        flags_ |= kFlagsSelectiveAck;
+      }
+
       // This cast is safe as we know we're running in a transfer server.
       uint32_t resource_id = static_cast<ServerContext&>(*this).handler()->id();
 
       Chunk start_ack(configured_protocol_version_, Chunk::Type::kStartAck);
-      start_ack.set_session_id(session_id_).set_resource_id(resource_id);
+      start_ack.set_session_id(session_id_)
+          .set_resource_id(resource_id)
+          .set_selective_ack(selective_ack());
 
       EncodeAndSendChunk(start_ack);
       break;
@@ -364,6 +417,11 @@ void Context::PerformInitialHandshake(const Chunk& chunk) {
     case Chunk::Type::kStartAck: {
       UpdateLocalProtocolConfigurationFromPeer(chunk);
 
+      // The server only sets selective_ack if the client did.
+      if (chunk.selective_ack() && SupportsSelectiveAck()) {
+        flags_ |= kFlagsSelectiveAck;
+      }
+
       Chunk start_ack_confirmation(configured_protocol_version_,
                                    Chunk::Type::kStartAckConfirmation);
       start_ack_confirmation.set_session_id(session_id_);
@@ -522,6 +580,12 @@ void Context::HandleTransferParametersUpdate(const Chunk& chunk) {
     }
 
     offset_ = chunk.offset();
+
+    if (selective_ack()) {
+      span<const Chunk::Range> ranges = chunk.received_ranges();
+      std::copy(ranges.begin(), ranges.end(), peer_received_ranges_.begin());
+      num_peer_received_ranges_ = static_cast<uint8_t>(ranges.size());
+    }
   }
 
   window_end_offset_ = chunk.window_end_offset();
@@ -550,6 +614,18 @@ void Context::HandleTransferParametersUpdate(const Chunk& chunk) {
 }
 
 void Context::TransmitNextChunk(bool retransmit_requested) {
+  if (num_peer_received_ranges_ != 0) {
+    const uint32_t offset = offset_;
+    SkipReceivedRanges();
+
+    if (offset_ != offset && offset_ >= window_end_offset_) {
+      // The receiver has the rest of the window.
+      set_transfer_state(TransferState::kWaiting);
+      SetTimeout(chunk_timeout_);
+      return;
+    }
+  }
+
   Chunk chunk(configured_protocol_version_, Chunk::Type::kData);
   chunk.set_session_id(session_id_);
   chunk.set_offset(offset_);
@@ -565,6 +641,12 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
   size_t max_bytes_to_send =
       std::min(window_end_offset_ - offset_, max_chunk_size_bytes_);
 
+  // Stop at the next data that the receiver already has.
+  if (num_peer_received_ranges_ != 0) {
+    max_bytes_to_send = std::min<size_t>(
+        max_bytes_to_send, peer_received_ranges_[0].start_offset - offset_);
+  }
+
   if (max_bytes_to_send < data_buffer.size()) {
     data_buffer = data_buffer.first(max_bytes_to_send);
   }
@@ -642,6 +724,35 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
   }
 }
 
+void Context::SkipReceivedRanges() {
+  const auto first = peer_received_ranges_.begin();
+  auto range = first;
+  const auto end = first + num_peer_received_ranges_;
+
+  for (; range != end && range->start_offset <= offset_; ++range) {
+    if (range->end_offset <= offset_) {
+      continue;
+    }
+
+    if (!reader().Seek(range->end_offset).ok()) {
+      // Without seeking, the data can't be skipped, so it is resent.
+      PW_LOG_DEBUG("Transfer %u cannot seek past received data; resending it",
+                   id_for_log());
+      num_peer_received_ranges_ = 0;
+      return;
+    }
+
+    PW_LOG_DEBUG("Transfer %u skipping received data at offset %u-%u",
+                 id_for_log(),
+                 static_cast<unsigned>(offset_),
+                 static_cast<unsigned>(range->end_offset));
+    offset_ = range->end_offset;
+  }
+
+  std::copy(range, end, first);
+  num_peer_received_ranges_ = static_cast<uint8_t>(end - range);
+}
+
 void Context::HandleReceiveChunk(const Chunk& chunk) {
   if (transfer_state_ == TransferState::kInitiating) {
     PerformInitialHandshake(chunk);
@@ -679,6 +790,11 @@ void Context::HandleReceiveChunk(const Chunk& chunk) {
 
     case TransferState::kRecovery:
       if (chunk.offset() != offset_) {
+        if (selective_ack()) {
+          // Keep data that arrives while waiting for the missing data.
+          StoreOutOfOrderData(chunk);
+        }
+
         if (last_chunk_offset_ == chunk.offset()) {
           PW_LOG_DEBUG(
               "Transfer %u received repeated offset %u; retry detected, "
@@ -720,6 +836,19 @@ void Context::HandleReceiveChunk(const Chunk& chunk) {
 
 void Context::HandleReceivedData(const Chunk& chunk) {
   if (chunk.offset() != offset_) {
+    // With selective retransmission, the transmitter may resend data that was
+    // already received, such as data that it sent before receiving a
+    // retransmit request. Ignore it.
+    if (selective_ack() &&
+        (chunk.offset() < offset_ ||
+         reorder_buffer_.Contains(chunk.offset(), chunk.payload().size()))) {
+      PW_LOG_DEBUG("Transfer %u ignoring repeated data at offset %u",
+                   id_for_log(),
+                   static_cast<unsigned>(chunk.offset()));
+      SetTimeout(chunk_timeout_);
+      return;
+    }
+
     // Bad offset; reset pending_bytes to send another parameters chunk.
     PW_LOG_DEBUG(
         "Transfer %u expected offset %u, received %u; entering recovery state",
@@ -730,11 +859,22 @@ void Context::HandleReceivedData(const Chunk& chunk) {
     set_transfer_state(TransferState::kRecovery);
     SetTimeout(chunk_timeout_);
 
+    if (selective_ack()) {
+      StoreOutOfOrderData(chunk);
+    }
+
+    // A chunk past the expected offset means that data was lost. Earlier
+    // chunks are duplicates, and say nothing about the link.
+    if (max_parameters_->adaptive_window() && chunk.offset() > offset_) {
+      congestion_window_.OnDataLost();
+      round_trip_start_ = std::nullopt;
+    }
+
     UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
     return;
   }
 
-  if (chunk.offset() + chunk.payload().size() > window_end_offset_) {
+  if (chunk.offset() + chunk.payload().size() > accepted_window_end_offset()) {
     // End the transfer, as this indicates a bug with the client implementation
     // where it doesn't respect pending_bytes. Trying to recover from here
     // could potentially result in an infinite transfer loop.
@@ -743,7 +883,7 @@ void Context::HandleReceivedData(const Chunk& chunk) {
         "for %u pending); terminating transfer.",
         id_for_log(),
         static_cast<unsigned>(chunk.payload().size()),
-        static_cast<unsigned>(window_end_offset_ - offset_));
+        static_cast<unsigned>(accepted_window_end_offset() - offset_));
     TerminateTransfer(Status::Internal());
     return;
   }
@@ -767,6 +907,16 @@ void Context::HandleReceivedData(const Chunk& chunk) {
     transfer_rate_.Update(chunk.payload().size());
   }
 
+  if (max_parameters_->adaptive_window()) {
+    if (round_trip_start_.has_value() &&
+        chunk.offset() + chunk.payload().size() > round_trip_offset_) {
+      congestion_window_.OnRoundTrip(chrono::SystemClock::now() -
+                                     *round_trip_start_);
+      round_trip_start_ = std::nullopt;
+    }
+    congestion_window_.OnDataReceived(chunk.payload().size());
+  }
+
   // When the client sets remaining_bytes to 0, it indicates completion of the
   // transfer. Acknowledge the completion through a status chunk and clean up.
   if (chunk.IsFinalTransmitChunk()) {
@@ -805,9 +955,35 @@ void Context::HandleReceivedData(const Chunk& chunk) {
     window_end_offset_ = chunk.window_end_offset();
   }
 
+  // Write any data that arrived out of order and now follows on.
+  if (selective_ack()) {
+    reorder_buffer_.Advance(offset_);
+
+    if (ConstByteSpan data = reorder_buffer_.ReadyData(); !data.empty()) {
+      if (Status status = writer().Write(data); !status.ok()) {
+        PW_LOG_ERROR(
+            "Transfer %u write of %u B of reordered data failed with status "
+            "%u; aborting with DATA_LOSS",
+            id_for_log(),
+            static_cast<unsigned>(data.size()),
+            status.code());
+        TerminateTransfer(Status::DataLoss());
+        return;
+      }
+
+      transfer_rate_.Update(data.size());
+      if (max_parameters_->adaptive_window()) {
+        congestion_window_.OnDataReceived(data.size());
+      }
+
+      offset_ += data.size();
+      reorder_buffer_.Advance(offset_);
+    }
+  }
+
   SetTimeout(chunk_timeout_);
 
-  if (offset_ == window_end_offset_) {
+  if (offset_ >= window_end_offset_) {
     // Received all pending data. Advance the transfer parameters.
     UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
     return;
@@ -825,6 +1001,22 @@ void Context::HandleReceivedData(const Chunk& chunk) {
   }
 }
 
+void Context::StoreOutOfOrderData(const Chunk& chunk) {
+  // The final chunk is not kept. The transmitter resends it, so the transfer
+  // completes only after all of its data is written.
+  if (chunk.offset() < offset_ || chunk.IsFinalTransmitChunk() ||
+      chunk.offset() + chunk.payload().size() > accepted_window_end_offset()) {
+    return;
+  }
+
+  if (!reorder_buffer_.Store(chunk.offset(), chunk.payload())) {
+    PW_LOG_DEBUG("Transfer %u has no space for %u B received at offset %u",
+                 id_for_log(),
+                 static_cast<unsigned>(chunk.payload().size()),
+                 static_cast<unsigned>(chunk.offset()));
+  }
+}
+
 void Context::HandleTerminatingChunk(const Chunk& chunk) {
   switch (chunk.type()) {
     case Chunk::Type::kCompletion:
@@ -1005,6 +1197,15 @@ void Context::Retry() {
         "Receive transfer %u timed out waiting for chunk; resending parameters",
         static_cast<unsigned>(session_id_));
 
+    if (max_parameters_->adaptive_window()) {
+      // A timeout indicates that the link is congested or lost its data, so
+      // restart with a small window.
+      congestion_window_.OnTimeout();
+      round_trip_start_ = std::nullopt;
+      UpdateAndSendTransferParameters(TransmitAction::kRetransmit);
+      return;
+    }
+
     SendTransferParameters(TransmitAction::kRetransmit);
     return;
   }
@@ -1044,7 +1245,8 @@ void Context::RetryHandshake() {
       // chunk, so we use the client's desired version instead.
       retry_chunk.set_protocol_version(desired_protocol_version_)
           .set_desired_session_id(session_id_)
-          .set_resource_id(resource_id_);
+          .set_resource_id(resource_id_)
+          .set_selective_ack(SupportsSelectiveAck());
       if (type() == TransferType::kReceive) {
         SetTransferParameters(retry_chunk);
       }
@@ -1052,7 +1254,8 @@ void Context::RetryHandshake() {
 
     case Chunk::Type::kStartAck:
       retry_chunk.set_session_id(session_id_)
-          .set_resource_id(static_cast<ServerContext&>(*this).handler()->id());
+          .set_resource_id(static_cast<ServerContext&>(*this).handler()->id())
+          .set_selective_ack(selective_ack());
       break;
 
     case Chunk::Type::kStartAckConfirmation:
@@ -1138,10 +1341,13 @@ void Context::LogTransferConfiguration() {
 
   PW_LOG_DEBUG(
       "Local transfer windowing configuration: "
-      "pending_bytes=%u, extend_window_divisor=%u, max_chunk_size_bytes=%u",
+      "pending_bytes=%u, extend_window_divisor=%u, max_chunk_size_bytes=%u, "
+      "adaptive_window=%d, reorder_buffer_size=%u",
       static_cast<unsigned>(max_parameters_->pending_bytes()),
       static_cast<unsigned>(max_parameters_->extend_window_divisor()),
-      static_cast<unsigned>(max_parameters_->max_chunk_size_bytes()));
+      static_cast<unsigned>(max_parameters_->max_chunk_size_bytes()),
+      static_cast<int>(max_parameters_->adaptive_window()),
+      static_cast<unsigned>(reorder_buffer_.capacity()));
 }
 
 }  // namespace pw::transfer::internal
@@ -0,0 +1,137 @@
+#!/usr/bin/env python3
+# Copyright 2023 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Benchmarks adaptive windowing in pw_transfer write transfers.
+
+Writes the same payload from the C++ client to the C++ server over links with
+simulated loss and delay, with the server's window either fixed at
+pending_bytes or adaptive up to pending_bytes. Logs the time taken by each
+transfer, and a summary once all of the transfers have run.
+
+Usage:
+
+   bazel run pw_transfer/integration_test:adaptive_window_test
+
+Command-line arguments must be provided after a double-dash:
+
+   bazel run pw_transfer/integration_test:adaptive_window_test -- \
+       --server-port 3318
+
+Which tests to run can be specified as command-line arguments:
+
+  bazel run pw_transfer/integration_test:adaptive_window_test -- \
+      AdaptiveWindowIntegrationTest.test_write_0_lossy_fixed
+
+"""
+
+import itertools
+import logging
+import random
+import sys
+import time
+from typing import Dict, Tuple
+
+from google.protobuf import text_format
+from parameterized import parameterized
+
+from pigweed.pw_transfer.integration_test import config_pb2
+from pigweed.pw_transfer.integration_test import test_fixture
+from test_fixture import TransferIntegrationTestHarness, TransferConfig
+
+_LOG = logging.getLogger('pw_transfer_adaptive_window_test')
+_LOG.level = logging.INFO
+_LOG.addHandler(logging.StreamHandler(sys.stdout))
+
+# Simulated link conditions, as the filters applied in each direction.
+_LINKS = {
+    'lossy': """
+        { hdlc_packetizer: {} },
+        { data_dropper: {rate: 0.05, seed: 1649963713563718435} }
+    """,
+    'delayed': """
+        { hdlc_packetizer: {} },
+        { rate_limiter: {rate: 100000} },
+        { delay: {delay: 0.05} }
+    """,
+    'lossy_delayed': """
+        { hdlc_packetizer: {} },
+        { data_dropper: {rate: 0.02, seed: 1649963713563718435} },
+        { rate_limiter: {rate: 100000} },
+        { delay: {delay: 0.05} }
+    """,
+}
+
+_WINDOW_MODES = ('fixed', 'adaptive')
+
+
+class AdaptiveWindowIntegrationTest(test_fixture.TransferIntegrationTest):
+    # Each set of transfer tests uses a different client/server port pair to
+    # allow tests to be run in parallel.
+    HARNESS_CONFIG = TransferIntegrationTestHarness.Config(
+        server_port=3318, client_port=3319
+    )
+
+    # Time taken by each transfer, keyed by link and window mode.
+    _durations: Dict[Tuple[str, str], float] = {}
+
+    @classmethod
+    def tearDownClass(cls):
+        for link in _LINKS:
+            results = ', '.join(
+                f'{mode} {cls._durations[(link, mode)]:.2f}s'
+                for mode in _WINDOW_MODES
+                if (link, mode) in cls._durations
+            )
+            _LOG.info('%s link: %s', link, results)
+
+    @parameterized.expand(itertools.product(_LINKS, _WINDOW_MODES))
+    def test_write(self, link, window_mode):
+        payload = random.Random(67336391945).randbytes(64 * 1024)
+        server_config = self.default_server_config()
+        server_config.adaptive_window = window_mode == 'adaptive'
+        config = TransferConfig(
+            server_config,
+            self.default_client_config(),
+            text_format.Parse(
+                f"""
+                client_filter_stack: [{_LINKS[link]}]
+                server_filter_stack: [{_LINKS[link]}]
+                """,
+                config_pb2.ProxyConfig(),
+            ),
+        )
+        resource_id = 12
+
+        start = time.monotonic()
+        self.do_single_write(
+            'cpp',
+            config,
+            resource_id,
+            payload,
+            permanent_resource_id=True,
+        )
+        duration = time.monotonic() - start
+
+        self._durations[(link, window_mode)] = duration
+        _LOG.info(
+            '%s link, %s window: %d bytes in %.2fs',
+            link,
+            window_mode,
+            len(payload),
+            duration,
+        )
+
+
+if __name__ == '__main__':
+    test_fixture.run_tests_for(AdaptiveWindowIntegrationTest)
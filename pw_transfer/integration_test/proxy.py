@@ -213,6 +213,44 @@ class RateLimiter(Filter):
         await self.send_data(data)
 
 
+class Delay(Filter):
+    """A filter which delays data by a fixed amount of time.
+
+    Unlike RateLimiter, this does not limit the transmission rate. Data keeps
+    flowing while earlier data is delayed, as on a link with a long propagation
+    delay.
+    """
+
+    def __init__(
+        self,
+        send_data: Callable[[bytes], Awaitable[None]],
+        name: str,
+        delay: float,
+    ):
+        super().__init__(send_data)
+        self._name = name
+        self._delay = delay
+        self._data_queue = asyncio.Queue()
+        self._delay_task = asyncio.create_task(self._delay_handler())
+
+        _LOG.info(f'{name} Delay initialized with delay {delay}s')
+
+    def __del__(self):
+        _LOG.info(f'{self._name} cleaning up delay task.')
+        self._delay_task.cancel()
+
+    async def _delay_handler(self):
+        """Async task that sends data once its delay has elapsed."""
+        while True:
+            send_time, data = await self._data_queue.get()
+            await asyncio.sleep(max(send_time - time.monotonic(), 0.0))
+            await self.send_data(data)
+
+    async def process(self, data: bytes) -> None:
+        # Queue data along with the time at which to send it.
+        await self._data_queue.put((time.monotonic() + self._delay, data))
+
+
 class DataTransposer(Filter):
     """A filter which occasionally transposes two chunks of data.
 
@@ -465,6 +503,8 @@ async def _handle_simplex_connection(
             )
         elif filter_name == "rate_limiter":
             filter_stack = RateLimiter(filter_stack, config.rate_limiter.rate)
+        elif filter_name == "delay":
+            filter_stack = Delay(filter_stack, name, config.delay.delay)
         elif filter_name == "data_transposer":
             transposer = config.data_transposer
             filter_stack = DataTransposer(
@@ -91,6 +91,29 @@ class ProxyTest(unittest.IsolatedAsyncioTestCase):
 
         self.assertEqual(sent_packets, [b'aaaaaaaaaa', b'bbbbbbbbbb'])
 
+    async def test_delay(self):
+        sent_packets: List[bytes] = []
+
+        # Async helper so Delay can await on it.
+        async def append(list: List[bytes], data: bytes):
+            list.append(data)
+
+        delay = proxy.Delay(
+            lambda data: append(sent_packets, data),
+            name="test",
+            delay=0.2,
+        )
+        await delay.process(b'aaaaaaaaaa')
+        await delay.process(b'bbbbbbbbbb')
+
+        # Nothing is sent until the delay has elapsed.
+        await asyncio.sleep(0.05)
+        self.assertEqual(sent_packets, [])
+
+        # Both packets are delayed by the same amount, not one after the other.
+        await asyncio.sleep(0.3)
+        self.assertEqual(sent_packets, [b'aaaaaaaaaa', b'bbbbbbbbbb'])
+
     async def test_server_failure(self):
         sent_packets: List[bytes] = []
 
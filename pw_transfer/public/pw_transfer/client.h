@@ -109,6 +109,14 @@ class Client {
     return OkStatus();
   }
 
+  // Enables or disables an adaptive window for read transfers. When enabled,
+  // the client starts by requesting one chunk at a time, and grows or shrinks
+  // the window, up to max_bytes_to_receive, based on the observed round trip
+  // time and data loss. This works with any server.
+  void set_adaptive_window(bool adaptive_window) {
+    max_parameters_.set_adaptive_window(adaptive_window);
+  }
+
   constexpr Status set_max_retries(uint32_t max_retries) {
     if (max_retries < 1 || max_retries > max_lifetime_retries_) {
       return Status::InvalidArgument();
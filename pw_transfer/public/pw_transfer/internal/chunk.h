@@ -13,10 +13,13 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <optional>
 
 #include "pw_bytes/span.h"
 #include "pw_result/result.h"
+#include "pw_span/span.h"
 #include "pw_transfer/internal/protocol.h"
 #include "pw_transfer/transfer.pwpb.h"
 
@@ -26,6 +29,16 @@ class Chunk {
  public:
   using Type = transfer::pwpb::Chunk::Type;
 
+  // A range of data, from start_offset up to but not including end_offset.
+  struct Range {
+    uint32_t start_offset;
+    uint32_t end_offset;
+  };
+
+  // The maximum number of received ranges stored in a chunk. Additional ranges
+  // in a parsed chunk are ignored.
+  static constexpr size_t kMaxReceivedRanges = 4;
+
   class Identifier {
    public:
     constexpr bool is_session() const { return type_ == kSession; }
@@ -140,6 +153,15 @@ class Chunk {
     return *this;
   }
 
+  constexpr Chunk& set_selective_ack(bool selective_ack) {
+    selective_ack_ = selective_ack;
+    return *this;
+  }
+
+  // Sets the ranges of data that a receiver already has, which must be sorted
+  // and must not overlap. Only the first kMaxReceivedRanges are used.
+  Chunk& set_received_ranges(span<const Range> ranges);
+
   // TODO(frolv): For some reason, the compiler complains if this setter is
   // marked constexpr. Leaving it off for now, but this should be investigated
   // and fixed.
@@ -186,6 +208,12 @@ class Chunk {
     return remaining_bytes_;
   }
 
+  constexpr bool selective_ack() const { return selective_ack_; }
+
+  span<const Range> received_ranges() const {
+    return span(received_ranges_).first(num_received_ranges_);
+  }
+
   constexpr ProtocolVersion protocol_version() const {
     return protocol_version_;
   }
@@ -266,10 +294,16 @@ class Chunk {
         remaining_bytes_(std::nullopt),
         status_(std::nullopt),
         type_(type),
-        protocol_version_(version) {}
+        protocol_version_(version),
+        selective_ack_(false),
+        received_ranges_{},
+        num_received_ranges_(0) {}
 
   constexpr Chunk() : Chunk(ProtocolVersion::kUnknown, std::nullopt) {}
 
+  // Decodes a packed received_ranges field into received_ranges_.
+  Status ParseReceivedRanges(ConstByteSpan packed);
+
   // Returns true if this chunk should write legacy protocol fields to the
   // serialized message.
   //
@@ -294,6 +328,9 @@ class Chunk {
   std::optional<Status> status_;
   std::optional<Type> type_;
   ProtocolVersion protocol_version_;
+  bool selective_ack_;
+  std::array<Range, kMaxReceivedRanges> received_ranges_;
+  uint8_t num_received_ranges_;
 };
 
 }  // namespace pw::transfer::internal
@@ -0,0 +1,92 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+#include "pw_chrono/system_clock.h"
+
+namespace pw::transfer::internal {
+
+// Adjusts the window of a receive transfer from the signals available to a
+// receiver: data arriving in order, data lost in flight, timeouts, and the
+// time taken for requested data to arrive.
+//
+// The window starts at one chunk and grows exponentially (slow start) until
+// data is lost or the round trip time rises well above the smallest one seen,
+// which indicates that the window is larger than the link can carry. It then
+// grows by about one chunk per window (congestion avoidance). Lost data halves
+// the window, and a timeout collapses it to one chunk and restarts slow start.
+//
+// Only the window that the receiver advertises changes, so this works with any
+// transmitter.
+class CongestionWindow {
+ public:
+  enum class Phase : uint8_t {
+    kSlowStart,
+    kCongestionAvoidance,
+  };
+
+  constexpr CongestionWindow()
+      : phase_(Phase::kSlowStart),
+        chunk_size_bytes_(1),
+        max_size_bytes_(1),
+        size_bytes_(0),
+        slow_start_threshold_bytes_(std::numeric_limits<uint32_t>::max()),
+        bytes_since_increase_(0),
+        min_round_trip_time_(std::nullopt) {}
+
+  // Starts a new transfer. The window is one chunk once SetLimits is called.
+  void Reset();
+
+  // Sets the chunk size and maximum window size, which may change over the
+  // course of a transfer. Must be called after Reset and before size_bytes.
+  void SetLimits(uint32_t chunk_size_bytes, uint32_t max_size_bytes);
+
+  // Grows the window after receiving data in order.
+  void OnDataReceived(uint32_t bytes);
+
+  // Halves the window after data was lost, i.e. a chunk arrived out of order.
+  void OnDataLost();
+
+  // Collapses the window to one chunk after no data arrived before a timeout.
+  void OnTimeout();
+
+  // Records the time between requesting data and receiving it. Leaves slow
+  // start if it is well above the smallest round trip time seen.
+  void OnRoundTrip(chrono::SystemClock::duration round_trip_time);
+
+  Phase phase() const { return phase_; }
+
+  // The number of bytes to request, between one chunk and the maximum.
+  uint32_t size_bytes() const { return size_bytes_; }
+
+ private:
+  void set_size_bytes(uint32_t size_bytes);
+
+  Phase phase_;
+  uint32_t chunk_size_bytes_;
+  uint32_t max_size_bytes_;
+  uint32_t size_bytes_;  // 0 until the limits are set.
+  uint32_t slow_start_threshold_bytes_;
+
+  // Bytes received in congestion avoidance since the window last grew.
+  uint32_t bytes_since_increase_;
+
+  std::optional<chrono::SystemClock::duration> min_round_trip_time_;
+};
+
+}  // namespace pw::transfer::internal
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cinttypes>
 #include <cstddef>
 #include <limits>
@@ -24,8 +25,10 @@
 #include "pw_status/status.h"
 #include "pw_stream/stream.h"
 #include "pw_transfer/internal/chunk.h"
+#include "pw_transfer/internal/congestion_window.h"
 #include "pw_transfer/internal/event.h"
 #include "pw_transfer/internal/protocol.h"
+#include "pw_transfer/internal/reorder_buffer.h"
 #include "pw_transfer/rate_estimate.h"
 
 namespace pw::transfer::internal {
@@ -39,7 +42,8 @@ class TransferParameters {
                                uint32_t extend_window_divisor)
       : pending_bytes_(pending_bytes),
         max_chunk_size_bytes_(max_chunk_size_bytes),
-        extend_window_divisor_(extend_window_divisor) {
+        extend_window_divisor_(extend_window_divisor),
+        adaptive_window_(false) {
     PW_ASSERT(pending_bytes > 0);
     PW_ASSERT(max_chunk_size_bytes > 0);
     PW_ASSERT(extend_window_divisor > 1);
@@ -61,10 +65,19 @@ class TransferParameters {
     extend_window_divisor_ = extend_window_divisor;
   }
 
+  // Whether receive transfers adjust their window to the observed round trip
+  // time and data loss, up to pending_bytes, instead of always requesting
+  // pending_bytes.
+  bool adaptive_window() const { return adaptive_window_; }
+  void set_adaptive_window(bool adaptive_window) {
+    adaptive_window_ = adaptive_window;
+  }
+
  private:
   uint32_t pending_bytes_;
   uint32_t max_chunk_size_bytes_;
   uint32_t extend_window_divisor_;
+  bool adaptive_window_;
 };
 
 // Information about a single transfer.
@@ -104,6 +117,14 @@ class Context {
   // Processes an event for this transfer.
   void HandleEvent(const Event& event);
 
+  // Sets the memory in which a receive transfer keeps data that arrives out of
+  // order. Selective retransmission is only offered to the peer if a buffer is
+  // set. Must not be called while the transfer is active.
+  void set_reorder_buffer(ByteSpan buffer) {
+    PW_DASSERT(!active());
+    reorder_buffer_.set_buffer(buffer);
+  }
+
  protected:
   ~Context() = default;
 
@@ -123,6 +144,7 @@ class Context {
         offset_(0),
         window_size_(0),
         window_end_offset_(0),
+        max_window_end_offset_(0),
         max_chunk_size_bytes_(std::numeric_limits<uint32_t>::max()),
         max_parameters_(nullptr),
         thread_(nullptr),
@@ -132,7 +154,11 @@ class Context {
         initial_chunk_timeout_(chrono::SystemClock::duration::zero()),
         interchunk_delay_(chrono::SystemClock::for_at_least(
             std::chrono::microseconds(kDefaultChunkDelayMicroseconds))),
-        next_timeout_(kNoTimeout) {}
+        next_timeout_(kNoTimeout),
+        round_trip_offset_(0),
+        round_trip_start_(std::nullopt),
+        peer_received_ranges_{},
+        num_peer_received_ranges_(0) {}
 
   constexpr TransferType type() const {
     return static_cast<TransferType>(flags_ & kFlagsType);
@@ -204,6 +230,17 @@ class Context {
     return static_cast<stream::Writer&>(*stream_);
   }
 
+  // Whether selective retransmission was negotiated with the peer.
+  bool selective_ack() const {
+    return (flags_ & kFlagsSelectiveAck) == kFlagsSelectiveAck;
+  }
+
+  // Whether this end of the transfer can use selective retransmission.
+  // Transmitters always can, while receivers need a reorder buffer.
+  bool SupportsSelectiveAck() const {
+    return type() == TransferType::kTransmit || reorder_buffer_.capacity() > 0;
+  }
+
   bool DataTransferComplete() const {
     return transfer_state_ == TransferState::kTerminating ||
            transfer_state_ == TransferState::kCompleted;
@@ -271,12 +308,27 @@ class Context {
   // Sends the next chunk in a transmit transfer, if any.
   void TransmitNextChunk(bool retransmit_requested);
 
+  // Moves the offset of a transmit transfer past any data that the receiver
+  // reported it already has.
+  void SkipReceivedRanges();
+
   // Processes a chunk in a receive transfer.
   void HandleReceiveChunk(const Chunk& chunk);
 
   // Processes a data chunk in a received while in the kWaiting state.
   void HandleReceivedData(const Chunk& chunk);
 
+  // Keeps the data of a chunk that arrived out of order in a receive transfer
+  // using selective retransmission, if there is space for it.
+  void StoreOutOfOrderData(const Chunk& chunk);
+
+  // The offset up to which a receive transfer accepts data. An adaptive window
+  // may have shrunk after the transmitter sent data for a larger one.
+  uint32_t accepted_window_end_offset() const {
+    return max_parameters_->adaptive_window() ? max_window_end_offset_
+                                              : window_end_offset_;
+  }
+
   // Sends the first chunk in a legacy transmit transfer.
   void SendInitialLegacyTransmitChunk();
 
@@ -340,6 +392,7 @@ class Context {
   static constexpr uint8_t kFlagsType = 1 << 0;
   static constexpr uint8_t kFlagsDataSent = 1 << 1;
   static constexpr uint8_t kFlagsContactMade = 1 << 2;
+  static constexpr uint8_t kFlagsSelectiveAck = 1 << 3;
 
   static constexpr uint32_t kDefaultChunkDelayMicroseconds = 2000;
 
@@ -377,6 +430,9 @@ class Context {
   uint32_t offset_;
   uint32_t window_size_;
   uint32_t window_end_offset_;
+  // The largest window end offset sent to the transmitter. An adaptive window
+  // may shrink below data that the transmitter already sent.
+  uint32_t max_window_end_offset_;
   uint32_t max_chunk_size_bytes_;
 
   const TransferParameters* max_parameters_;
@@ -403,6 +459,22 @@ class Context {
   chrono::SystemClock::time_point next_timeout_;
 
   RateEstimate transfer_rate_;
+
+  // Window of a receive transfer with an adaptive window.
+  CongestionWindow congestion_window_;
+
+  // When the window was last advanced, and the offset of the first newly
+  // requested byte, to measure the round trip time.
+  uint32_t round_trip_offset_;
+  std::optional<chrono::SystemClock::time_point> round_trip_start_;
+
+  // Data that a receive transfer received out of order.
+  ReorderBuffer reorder_buffer_;
+
+  // Data past the offset which the receiver of a transmit transfer already
+  // has, and which does not need to be sent.
+  std::array<Chunk::Range, Chunk::kMaxReceivedRanges> peer_received_ranges_;
+  uint8_t num_peer_received_ranges_;
 };
 
 }  // namespace pw::transfer::internal
@@ -55,8 +55,7 @@ enum class EventType {
   // transfer context's completion handler; it is for out-of-band termination.
   kSendStatusChunk,
 
-  // Manages the list of transfer handlers for a transfer service.
-  kAddTransferHandler,
+  // Ends any transfers using a transfer handler that is being removed.
   kRemoveTransferHandler,
 
   // For testing only: aborts the transfer thread.
@@ -123,7 +122,6 @@ struct Event {
     ChunkEvent chunk;
     EndTransferEvent end_transfer;
     SendStatusChunkEvent send_status_chunk;
-    Handler* add_transfer_handler;
     Handler* remove_transfer_handler;
   };
 };
@@ -0,0 +1,83 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_span/span.h"
+#include "pw_transfer/internal/chunk.h"
+
+namespace pw::transfer::internal {
+
+// Holds data that a receive transfer received out of order until the data
+// before it arrives, so that the transmitter does not have to resend it.
+//
+// Data is stored relative to the next offset that the receiver expects (the
+// base offset), so the size of the buffer limits how far past missing data a
+// chunk can be kept. Up to Chunk::kMaxReceivedRanges separate ranges of data
+// are kept, which is as many as a chunk can report to the transmitter.
+class ReorderBuffer {
+ public:
+  constexpr ReorderBuffer()
+      : buffer_(), base_offset_(0), ranges_{}, num_ranges_(0) {}
+
+  // Sets the memory in which to store data, discarding any stored data.
+  void set_buffer(ByteSpan buffer) {
+    buffer_ = buffer;
+    Reset(0);
+  }
+
+  size_t capacity() const { return buffer_.size(); }
+
+  // Discards all stored data, and sets the base offset.
+  void Reset(uint32_t base_offset) {
+    base_offset_ = base_offset;
+    num_ranges_ = 0;
+  }
+
+  bool empty() const { return num_ranges_ == 0; }
+
+  // The ranges of stored data, in increasing order. Adjacent ranges are
+  // merged.
+  span<const Chunk::Range> ranges() const {
+    return span(ranges_).first(num_ranges_);
+  }
+
+  // Returns true if all data from offset to offset + size is stored.
+  bool Contains(uint32_t offset, size_t size) const;
+
+  // Stores data received at an offset past the base offset. Returns false if
+  // the data extends past the end of the buffer, or would need too many
+  // ranges to track.
+  bool Store(uint32_t offset, ConstByteSpan data);
+
+  // Returns the data stored at the base offset, which the receiver can now
+  // write, or an empty span if there is none.
+  ConstByteSpan ReadyData() const;
+
+  // Moves the base offset forward after the receiver writes data, discarding
+  // stored data before the new base offset.
+  void Advance(uint32_t base_offset);
+
+ private:
+  ByteSpan buffer_;
+  uint32_t base_offset_;
+  std::array<Chunk::Range, Chunk::kMaxReceivedRanges> ranges_;
+  uint8_t num_ranges_;
+};
+
+}  // namespace pw::transfer::internal
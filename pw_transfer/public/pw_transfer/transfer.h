@@ -111,6 +111,14 @@ class TransferService : public pw_rpc::raw::Transfer::Service<TransferService> {
 
   void set_max_retries(uint8_t max_retries) { max_retries_ = max_retries; }
 
+  // Enables or disables an adaptive window for write transfers. When enabled,
+  // the service starts by requesting one chunk at a time, and grows or shrinks
+  // the window, up to max_pending_bytes, based on the observed round trip time
+  // and data loss. This works with any client.
+  void set_adaptive_window(bool adaptive_window) {
+    max_parameters_.set_adaptive_window(adaptive_window);
+  }
+
   Status set_extend_window_divisor(uint32_t extend_window_divisor) {
     if (extend_window_divisor <= 1) {
       return Status::InvalidArgument();
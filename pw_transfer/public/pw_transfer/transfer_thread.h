@@ -13,7 +13,10 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <utility>
 
 #include "pw_assert/assert.h"
 #include "pw_chrono/system_clock.h"
@@ -32,6 +35,10 @@
 #include "pw_transfer/internal/server_context.h"
 
 namespace pw::transfer {
+
+template <size_t, size_t, size_t, size_t>
+class ShardedThread;
+
 namespace internal {
 
 class TransferThread : public thread::ThreadCore {
@@ -40,11 +47,13 @@ class TransferThread : public thread::ThreadCore {
                  span<ServerContext> server_transfers,
                  ByteSpan chunk_buffer,
                  ByteSpan encode_buffer)
-      : client_transfers_(client_transfers),
-        server_transfers_(server_transfers),
-        next_session_id_(1),
-        chunk_buffer_(chunk_buffer),
-        encode_buffer_(encode_buffer) {}
+      : TransferThread(client_transfers,
+                       server_transfers,
+                       chunk_buffer,
+                       encode_buffer,
+                       /*primary=*/nullptr,
+                       /*shards=*/{},
+                       /*first_session_id=*/1) {}
 
   void StartClientTransfer(TransferType type,
                            ProtocolVersion version,
@@ -56,18 +65,22 @@ class TransferThread : public thread::ThreadCore {
                            chrono::SystemClock::duration initial_timeout,
                            uint8_t max_retries,
                            uint32_t max_lifetime_retries) {
-    StartTransfer(type,
-                  version,
-                  Context::kUnassignedSessionId,  // Assigned later.
-                  resource_id,
-                  /*raw_chunk=*/{},
-                  stream,
-                  max_parameters,
-                  std::move(on_completion),
-                  timeout,
-                  initial_timeout,
-                  max_retries,
-                  max_lifetime_retries);
+    // Client transfers are routed by resource ID. The shard assigns a session
+    // ID which routes back to it, so that chunks identified by either one
+    // reach the transfer.
+    ShardFor(resource_id)
+        .StartTransfer(type,
+                       version,
+                       Context::kUnassignedSessionId,  // Assigned later.
+                       resource_id,
+                       /*raw_chunk=*/{},
+                       stream,
+                       max_parameters,
+                       std::move(on_completion),
+                       timeout,
+                       initial_timeout,
+                       max_retries,
+                       max_lifetime_retries);
   }
 
   void StartServerTransfer(TransferType type,
@@ -79,18 +92,19 @@ class TransferThread : public thread::ThreadCore {
                            chrono::SystemClock::duration timeout,
                            uint8_t max_retries,
                            uint32_t max_lifetime_retries) {
-    StartTransfer(type,
-                  version,
-                  session_id,
-                  resource_id,
-                  raw_chunk,
-                  /*stream=*/nullptr,
-                  max_parameters,
-                  /*on_completion=*/nullptr,
-                  timeout,
-                  timeout,
-                  max_retries,
-                  max_lifetime_retries);
+    ShardFor(session_id)
+        .StartTransfer(type,
+                       version,
+                       session_id,
+                       resource_id,
+                       raw_chunk,
+                       /*stream=*/nullptr,
+                       max_parameters,
+                       /*on_completion=*/nullptr,
+                       timeout,
+                       timeout,
+                       max_retries,
+                       max_lifetime_retries);
   }
 
   void ProcessClientChunk(ConstByteSpan chunk) {
@@ -105,25 +119,33 @@ class TransferThread : public thread::ThreadCore {
                         uint32_t session_id,
                         ProtocolVersion version,
                         Status status) {
-    SendStatus(type == TransferType::kTransmit ? TransferStream::kServerRead
-                                               : TransferStream::kServerWrite,
-               session_id,
-               version,
-               status);
+    ShardFor(session_id)
+        .SendStatus(type == TransferType::kTransmit
+                        ? TransferStream::kServerRead
+                        : TransferStream::kServerWrite,
+                    session_id,
+                    version,
+                    status);
   }
 
   void EndClientTransfer(uint32_t session_id,
                          Status status,
                          bool send_status_chunk = false) {
-    EndTransfer(
-        EventType::kClientEndTransfer, session_id, status, send_status_chunk);
+    ShardFor(session_id)
+        .EndTransfer(EventType::kClientEndTransfer,
+                     session_id,
+                     status,
+                     send_status_chunk);
   }
 
   void EndServerTransfer(uint32_t session_id,
                          Status status,
                          bool send_status_chunk = false) {
-    EndTransfer(
-        EventType::kServerEndTransfer, session_id, status, send_status_chunk);
+    ShardFor(session_id)
+        .EndTransfer(EventType::kServerEndTransfer,
+                     session_id,
+                     status,
+                     send_status_chunk);
   }
 
   // Move the read/write streams on this thread instead of the transfer thread.
@@ -145,16 +167,9 @@ class TransferThread : public thread::ThreadCore {
     server_write_stream_ = std::move(write_stream);
   }
 
-  void AddTransferHandler(Handler& handler) {
-    TransferHandlerEvent(EventType::kAddTransferHandler, handler);
-  }
+  void AddTransferHandler(Handler& handler);
 
-  void RemoveTransferHandler(Handler& handler) {
-    TransferHandlerEvent(EventType::kRemoveTransferHandler, handler);
-    // Ensure this function blocks until the transfer handler is fully cleaned
-    // up.
-    WaitUntilEventIsProcessed();
-  }
+  void RemoveTransferHandler(Handler& handler);
 
   size_t max_chunk_size() const { return chunk_buffer_.size(); }
 
@@ -166,21 +181,56 @@ class TransferThread : public thread::ThreadCore {
   void WaitUntilEventIsProcessed() {
     next_event_ownership_.acquire();
     next_event_ownership_.release();
+    for (TransferThread& shard : shards_) {
+      shard.WaitUntilEventIsProcessed();
+    }
   }
 
   // For testing only: simulates a timeout event for a client transfer.
   void SimulateClientTimeout(uint32_t session_id) {
-    SimulateTimeout(EventType::kClientTimeout, session_id);
+    ShardFor(session_id).SimulateTimeout(EventType::kClientTimeout, session_id);
   }
 
   // For testing only: simulates a timeout event for a server transfer.
   void SimulateServerTimeout(uint32_t session_id) {
-    SimulateTimeout(EventType::kServerTimeout, session_id);
+    ShardFor(session_id).SimulateTimeout(EventType::kServerTimeout, session_id);
   }
 
  private:
   friend class Context;
 
+  template <size_t, size_t, size_t, size_t>
+  friend class transfer::ShardedThread;
+
+  // Constructs one shard of a transfer thread. The primary shard, which is
+  // passed the other shards, owns the RPC streams and transfer handlers, and
+  // routes events to the shard which runs their transfer.
+  TransferThread(span<ClientContext> client_transfers,
+                 span<ServerContext> server_transfers,
+                 ByteSpan chunk_buffer,
+                 ByteSpan encode_buffer,
+                 TransferThread* primary,
+                 span<TransferThread> shards,
+                 uint32_t first_session_id)
+      : primary_(primary != nullptr ? primary : this),
+        shards_(shards),
+        client_transfers_(client_transfers),
+        server_transfers_(server_transfers),
+        next_session_id_(first_session_id),
+        chunk_buffer_(chunk_buffer),
+        encode_buffer_(encode_buffer) {}
+
+  size_t num_shards() const { return shards_.size() + 1; }
+
+  // Returns the shard which runs the transfer with the specified session ID.
+  TransferThread& ShardFor(uint32_t session_id) {
+    if (shards_.empty()) {
+      return *this;
+    }
+    const size_t index = session_id % num_shards();
+    return index == 0 ? *this : shards_[index - 1];
+  }
+
   // Maximum amount of time between transfer thread runs.
   static constexpr chrono::SystemClock::duration kMaxTimeout =
       std::chrono::seconds(2);
@@ -240,13 +290,13 @@ class TransferThread : public thread::ThreadCore {
   rpc::Writer& stream_for(TransferStream stream) {
     switch (stream) {
       case TransferStream::kClientRead:
-        return client_read_stream_;
+        return primary_->client_read_stream_;
       case TransferStream::kClientWrite:
-        return client_write_stream_;
+        return primary_->client_write_stream_;
       case TransferStream::kServerRead:
-        return server_read_stream_;
+        return primary_->server_read_stream_;
       case TransferStream::kServerWrite:
-        return server_write_stream_;
+        return primary_->server_write_stream_;
     }
     // An unknown TransferStream value was passed, which means this function
     // was passed an invalid enum value.
@@ -283,13 +333,23 @@ class TransferThread : public thread::ThreadCore {
                    Status status,
                    bool send_status_chunk);
 
-  void TransferHandlerEvent(EventType type, Handler& handler);
+  void RemoveTransferHandlerEvent(Handler& handler);
+
+  void AcquireAllShards();
+  void ReleaseAllShards();
 
   void HandleEvent(const Event& event);
   Context* FindContextForEvent(const Event& event) const;
 
   void SendStatusChunk(const SendStatusChunkEvent& event);
 
+  // The shard which owns the RPC streams and transfer handlers, which is this
+  // thread unless it is one of the other shards of a ShardedThread.
+  TransferThread* primary_;
+
+  // The primary shard's other shards, if any.
+  span<TransferThread> shards_;
+
   sync::TimedThreadNotification event_notification_;
   sync::BinarySemaphore next_event_ownership_;
 
@@ -305,13 +365,15 @@ class TransferThread : public thread::ThreadCore {
   span<ServerContext> server_transfers_;
 
   // Identifier to use for the next started transfer, unique over the RPC
-  // channel between the transfer client and server.
+  // channel between the transfer client and server. Each shard assigns the IDs
+  // which route back to it.
   //
   // TODO(frolv): If we ever support changing the RPC channel, this should be
-  // reset to 1.
+  // reset to its first value.
   uint32_t next_session_id_;
 
-  // All registered transfer handlers.
+  // All registered transfer handlers. Only used by the primary shard, which
+  // only changes the list while it holds every shard's next event.
   IntrusiveList<Handler> handlers_;
 
   // Buffer in which chunk data is staged for CHUNK events.
@@ -326,19 +388,132 @@ class TransferThread : public thread::ThreadCore {
 
 using TransferThread = internal::TransferThread;
 
+// A transfer thread which runs up to kMaxConcurrentClientTransfers client and
+// kMaxConcurrentServerTransfers server transfers at once.
+//
+// If kReorderBufferSizeBytes is nonzero, each transfer has a buffer of that
+// size in which a receiver keeps data that arrives out of order, and offers
+// selective retransmission to its peer. Data up to kReorderBufferSizeBytes
+// past missing data is kept, and the transmitter only resends what is missing.
 template <size_t kMaxConcurrentClientTransfers,
-          size_t kMaxConcurrentServerTransfers>
+          size_t kMaxConcurrentServerTransfers,
+          size_t kReorderBufferSizeBytes = 0>
 class Thread final : public internal::TransferThread {
  public:
   Thread(ByteSpan chunk_buffer, ByteSpan encode_buffer)
       : internal::TransferThread(
-            client_contexts_, server_contexts_, chunk_buffer, encode_buffer) {}
+            client_contexts_, server_contexts_, chunk_buffer, encode_buffer) {
+    if constexpr (kReorderBufferSizeBytes > 0) {
+      auto buffer = reorder_buffers_.begin();
+      for (internal::ClientContext& context : client_contexts_) {
+        context.set_reorder_buffer(*buffer++);
+      }
+      for (internal::ServerContext& context : server_contexts_) {
+        context.set_reorder_buffer(*buffer++);
+      }
+    }
+  }
 
  private:
   std::array<internal::ClientContext, kMaxConcurrentClientTransfers>
       client_contexts_;
   std::array<internal::ServerContext, kMaxConcurrentServerTransfers>
       server_contexts_;
+  std::array<std::array<std::byte, kReorderBufferSizeBytes>,
+             kMaxConcurrentClientTransfers + kMaxConcurrentServerTransfers>
+      reorder_buffers_;
+};
+
+// A transfer thread which distributes transfers among kNumShards threads, each
+// of which runs up to kMaxConcurrentClientTransfers client and
+// kMaxConcurrentServerTransfers server transfers at once.
+//
+// Transfers are assigned to shards by session ID. Each shard has its own share
+// of the chunk and encode buffers, which are split evenly among the shards, so
+// an RPC thread can hand chunks for different transfers to different shards
+// without waiting for one to finish processing the last. Each shard must be run
+// on its own thread:
+//
+//   for (size_t i = 0; i < transfer_thread.num_shards(); ++i) {
+//     threads[i] = pw::thread::Thread(options, transfer_thread.shard(i));
+//   }
+//
+// kReorderBufferSizeBytes is as for Thread.
+template <size_t kNumShards,
+          size_t kMaxConcurrentClientTransfers,
+          size_t kMaxConcurrentServerTransfers,
+          size_t kReorderBufferSizeBytes = 0>
+class ShardedThread final : public internal::TransferThread {
+ public:
+  static_assert(kNumShards > 0);
+
+  ShardedThread(ByteSpan chunk_buffer, ByteSpan encode_buffer)
+      : ShardedThread(chunk_buffer,
+                      encode_buffer,
+                      std::make_index_sequence<kNumShards - 1>()) {}
+
+  static constexpr size_t num_shards() { return kNumShards; }
+
+  // Returns the shard to run on the thread with the specified index.
+  thread::ThreadCore& shard(size_t index) {
+    PW_ASSERT(index < kNumShards);
+    if (index == 0) {
+      return *this;
+    }
+    return shards_[index - 1];
+  }
+
+ private:
+  template <size_t... kIndices>
+  ShardedThread(ByteSpan chunk_buffer,
+                ByteSpan encode_buffer,
+                std::index_sequence<kIndices...>)
+      : internal::TransferThread(client_contexts_[0],
+                                 server_contexts_[0],
+                                 ShardBuffer(chunk_buffer, 0),
+                                 ShardBuffer(encode_buffer, 0),
+                                 /*primary=*/nullptr,
+                                 shards_,
+                                 /*first_session_id=*/kNumShards),
+        shards_{{internal::TransferThread(
+            client_contexts_[kIndices + 1],
+            server_contexts_[kIndices + 1],
+            ShardBuffer(chunk_buffer, kIndices + 1),
+            ShardBuffer(encode_buffer, kIndices + 1),
+            /*primary=*/this,
+            /*shards=*/{},
+            /*first_session_id=*/kIndices + 1)...}} {
+    if constexpr (kReorderBufferSizeBytes > 0) {
+      auto buffer = reorder_buffers_.begin();
+      for (auto& contexts : client_contexts_) {
+        for (internal::ClientContext& context : contexts) {
+          context.set_reorder_buffer(*buffer++);
+        }
+      }
+      for (auto& contexts : server_contexts_) {
+        for (internal::ServerContext& context : contexts) {
+          context.set_reorder_buffer(*buffer++);
+        }
+      }
+    }
+  }
+
+  static ByteSpan ShardBuffer(ByteSpan buffer, size_t index) {
+    const size_t size = buffer.size() / kNumShards;
+    return buffer.subspan(index * size, size);
+  }
+
+  std::array<std::array<internal::ClientContext, kMaxConcurrentClientTransfers>,
+             kNumShards>
+      client_contexts_;
+  std::array<std::array<internal::ServerContext, kMaxConcurrentServerTransfers>,
+             kNumShards>
+      server_contexts_;
+  std::array<std::array<std::byte, kReorderBufferSizeBytes>,
+             kNumShards * (kMaxConcurrentClientTransfers +
+                           kMaxConcurrentServerTransfers)>
+      reorder_buffers_;
+  std::array<internal::TransferThread, kNumShards - 1> shards_;
 };
 
 }  // namespace pw::transfer
@@ -0,0 +1,118 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/reorder_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw::transfer::internal {
+
+bool ReorderBuffer::Contains(uint32_t offset, size_t size) const {
+  for (const Chunk::Range& range : ranges()) {
+    if (range.start_offset <= offset && offset < range.end_offset) {
+      return size <= range.end_offset - offset;
+    }
+  }
+  return false;
+}
+
+bool ReorderBuffer::Store(uint32_t offset, ConstByteSpan data) {
+  if (offset <= base_offset_ || data.empty() ||
+      offset - base_offset_ > capacity() ||
+      data.size() > capacity() - (offset - base_offset_)) {
+    return false;
+  }
+
+  // Merge the new range with any ranges that it overlaps or touches.
+  Chunk::Range stored{
+      .start_offset = offset,
+      .end_offset = static_cast<uint32_t>(offset + data.size()),
+  };
+  std::array<Chunk::Range, Chunk::kMaxReceivedRanges> ranges;
+  size_t num_ranges = 0;
+  bool inserted = false;
+
+  for (const Chunk::Range& range : this->ranges()) {
+    if (range.end_offset < stored.start_offset) {
+      ranges[num_ranges++] = range;
+      continue;
+    }
+    if (range.start_offset <= stored.end_offset) {
+      stored.start_offset = std::min(stored.start_offset, range.start_offset);
+      stored.end_offset = std::max(stored.end_offset, range.end_offset);
+      continue;
+    }
+    if (!inserted) {
+      if (num_ranges == ranges.size()) {
+        return false;
+      }
+      ranges[num_ranges++] = stored;
+      inserted = true;
+    }
+    if (num_ranges == ranges.size()) {
+      return false;
+    }
+    ranges[num_ranges++] = range;
+  }
+
+  if (!inserted) {
+    if (num_ranges == ranges.size()) {
+      return false;
+    }
+    ranges[num_ranges++] = stored;
+  }
+
+  std::memcpy(
+      buffer_.data() + (offset - base_offset_), data.data(), data.size());
+  ranges_ = ranges;
+  num_ranges_ = static_cast<uint8_t>(num_ranges);
+  return true;
+}
+
+ConstByteSpan ReorderBuffer::ReadyData() const {
+  if (empty() || ranges_[0].start_offset != base_offset_) {
+    return {};
+  }
+  return buffer_.first(ranges_[0].end_offset - base_offset_);
+}
+
+void ReorderBuffer::Advance(uint32_t base_offset) {
+  if (base_offset <= base_offset_) {
+    return;
+  }
+
+  const uint32_t shift = base_offset - base_offset_;
+  base_offset_ = base_offset;
+
+  // Drop data before the new base offset.
+  size_t num_ranges = 0;
+  for (const Chunk::Range& range : ranges()) {
+    if (range.end_offset <= base_offset) {
+      continue;
+    }
+    ranges_[num_ranges] = range;
+    ranges_[num_ranges].start_offset =
+        std::max(range.start_offset, base_offset);
+    ++num_ranges;
+  }
+  num_ranges_ = static_cast<uint8_t>(num_ranges);
+
+  if (!empty()) {
+    const size_t size = ranges_[num_ranges_ - 1].end_offset - base_offset;
+    std::memmove(buffer_.data(), buffer_.data() + shift, size);
+  }
+}
+
+}  // namespace pw::transfer::internal
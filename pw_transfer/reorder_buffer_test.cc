@@ -0,0 +1,173 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/reorder_buffer.h"
+
+#include <array>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+namespace pw::transfer::internal {
+namespace {
+
+constexpr uint32_t kBaseOffset = 100;
+
+// Data whose bytes are the low bytes of their offsets.
+constexpr auto kData = [] {
+  std::array<std::byte, 256> data{};
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<std::byte>(i);
+  }
+  return data;
+}();
+
+ConstByteSpan DataAt(uint32_t offset, size_t size) {
+  return span(kData).subspan(offset % kData.size(), size);
+}
+
+class ReorderBufferTest : public ::testing::Test {
+ protected:
+  ReorderBufferTest() {
+    reorder_buffer_.set_buffer(buffer_);
+    reorder_buffer_.Reset(kBaseOffset);
+  }
+
+  bool Store(uint32_t offset, size_t size) {
+    return reorder_buffer_.Store(offset, DataAt(offset, size));
+  }
+
+  void ExpectRanges(std::initializer_list<Chunk::Range> expected) {
+    span<const Chunk::Range> ranges = reorder_buffer_.ranges();
+    ASSERT_EQ(ranges.size(), expected.size());
+    auto range = ranges.begin();
+    for (const Chunk::Range& expected_range : expected) {
+      EXPECT_EQ(range->start_offset, expected_range.start_offset);
+      EXPECT_EQ(range->end_offset, expected_range.end_offset);
+      ++range;
+    }
+  }
+
+  std::array<std::byte, 64> buffer_;
+  ReorderBuffer reorder_buffer_;
+};
+
+TEST_F(ReorderBufferTest, StartsEmpty) {
+  EXPECT_TRUE(reorder_buffer_.empty());
+  EXPECT_EQ(reorder_buffer_.capacity(), 64u);
+  EXPECT_TRUE(reorder_buffer_.ReadyData().empty());
+  EXPECT_FALSE(reorder_buffer_.Contains(kBaseOffset + 1, 1));
+}
+
+TEST_F(ReorderBufferTest, Store_TracksRanges) {
+  ASSERT_TRUE(Store(120, 8));
+  ASSERT_TRUE(Store(110, 4));
+  ExpectRanges({{110, 114}, {120, 128}});
+
+  EXPECT_TRUE(reorder_buffer_.Contains(120, 8));
+  EXPECT_TRUE(reorder_buffer_.Contains(122, 2));
+  EXPECT_FALSE(reorder_buffer_.Contains(112, 4));
+  EXPECT_FALSE(reorder_buffer_.Contains(116, 1));
+
+  // Nothing is ready until the data at the base offset arrives.
+  EXPECT_TRUE(reorder_buffer_.ReadyData().empty());
+}
+
+TEST_F(ReorderBufferTest, Store_MergesAdjacentAndOverlappingRanges) {
+  ASSERT_TRUE(Store(110, 4));
+  ASSERT_TRUE(Store(120, 4));
+  ASSERT_TRUE(Store(114, 4));
+  ExpectRanges({{110, 118}, {120, 124}});
+
+  ASSERT_TRUE(Store(116, 6));
+  ExpectRanges({{110, 124}});
+}
+
+TEST_F(ReorderBufferTest, Store_DataAtOrBeforeBaseOffset_Fails) {
+  EXPECT_FALSE(Store(kBaseOffset, 4));
+  EXPECT_FALSE(Store(kBaseOffset - 4, 4));
+  EXPECT_TRUE(reorder_buffer_.empty());
+}
+
+TEST_F(ReorderBufferTest, Store_PastEndOfBuffer_Fails) {
+  EXPECT_TRUE(Store(kBaseOffset + 60, 4));
+  EXPECT_FALSE(Store(kBaseOffset + 62, 4));
+  EXPECT_FALSE(Store(kBaseOffset + 100, 4));
+  ExpectRanges({{kBaseOffset + 60, kBaseOffset + 64}});
+}
+
+TEST_F(ReorderBufferTest, Store_TooManyRanges_Fails) {
+  ASSERT_TRUE(Store(110, 2));
+  ASSERT_TRUE(Store(120, 2));
+  ASSERT_TRUE(Store(130, 2));
+  ASSERT_TRUE(Store(140, 2));
+  EXPECT_FALSE(Store(150, 2));
+  EXPECT_FALSE(Store(105, 2));
+
+  // Data which extends an existing range does not need a new one.
+  EXPECT_TRUE(Store(142, 2));
+  ExpectRanges({{110, 112}, {120, 122}, {130, 132}, {140, 144}});
+}
+
+TEST_F(ReorderBufferTest, Advance_ReturnsDataFollowingBaseOffset) {
+  ASSERT_TRUE(Store(104, 8));
+  ASSERT_TRUE(Store(120, 4));
+
+  // Data up to 104 was written, so stored data follows on from it.
+  reorder_buffer_.Advance(104);
+  ConstByteSpan ready = reorder_buffer_.ReadyData();
+  ASSERT_EQ(ready.size(), 8u);
+  EXPECT_EQ(std::memcmp(ready.data(), DataAt(104, 8).data(), 8), 0);
+
+  reorder_buffer_.Advance(112);
+  EXPECT_TRUE(reorder_buffer_.ReadyData().empty());
+  ExpectRanges({{120, 124}});
+
+  // The remaining data was moved to the start of the buffer.
+  reorder_buffer_.Advance(120);
+  ready = reorder_buffer_.ReadyData();
+  ASSERT_EQ(ready.size(), 4u);
+  EXPECT_EQ(ready.data(), buffer_.data());
+  EXPECT_EQ(std::memcmp(ready.data(), DataAt(120, 4).data(), 4), 0);
+}
+
+TEST_F(ReorderBufferTest, Advance_IntoRange_TrimsIt) {
+  ASSERT_TRUE(Store(110, 10));
+  reorder_buffer_.Advance(114);
+  ExpectRanges({{114, 120}});
+
+  ConstByteSpan ready = reorder_buffer_.ReadyData();
+  ASSERT_EQ(ready.size(), 6u);
+  EXPECT_EQ(std::memcmp(ready.data(), DataAt(114, 6).data(), 6), 0);
+}
+
+TEST_F(ReorderBufferTest, Advance_PastAllData_Empties) {
+  ASSERT_TRUE(Store(110, 10));
+  reorder_buffer_.Advance(200);
+  EXPECT_TRUE(reorder_buffer_.empty());
+
+  // Data is stored relative to the new base offset.
+  EXPECT_TRUE(Store(260, 4));
+  EXPECT_FALSE(Store(270, 4));
+}
+
+TEST_F(ReorderBufferTest, Reset_DiscardsData) {
+  ASSERT_TRUE(Store(110, 10));
+  reorder_buffer_.Reset(0);
+  EXPECT_TRUE(reorder_buffer_.empty());
+  EXPECT_FALSE(reorder_buffer_.Contains(110, 10));
+}
+
+}  // namespace
+}  // namespace pw::transfer::internal
@@ -1610,6 +1610,336 @@ TEST_F(WriteTransferMaxBytes16, Service_SetMaxPendingBytes) {
   EXPECT_EQ(chunk.window_end_offset(), 8u + 12u);
 }
 
+class WriteTransferAdaptiveWindow : public WriteTransfer {
+ protected:
+  WriteTransferAdaptiveWindow() {
+    ctx_.service().set_adaptive_window(true);
+    // Limit chunks to 8 bytes of data, so that the window spans several.
+    ctx_.service().set_max_chunk_size_bytes(35);
+  }
+
+  // Starts a transfer and receives the first chunk, which grows the window
+  // from one chunk to two.
+  void StartAndReceiveFirstChunk() {
+    ctx_.SendClientStream(
+        EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kStart)
+                        .set_session_id(7)));
+    transfer_thread_.WaitUntilEventIsProcessed();
+
+    // The window starts at one chunk.
+    ASSERT_EQ(ctx_.total_responses(), 1u);
+    Chunk chunk = DecodeChunk(ctx_.responses().back());
+    ASSERT_EQ(chunk.max_chunk_size_bytes(), 8u);
+    EXPECT_EQ(chunk.window_end_offset(), 8u);
+
+    ctx_.SendClientStream<64>(
+        EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                        .set_session_id(7)
+                        .set_offset(0)
+                        .set_payload(span(kData).first(8))));
+    transfer_thread_.WaitUntilEventIsProcessed();
+
+    ASSERT_EQ(ctx_.total_responses(), 2u);
+    chunk = DecodeChunk(ctx_.responses().back());
+    EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+    EXPECT_EQ(chunk.offset(), 8u);
+    EXPECT_EQ(chunk.window_end_offset(), 8u + 16u);
+  }
+};
+
+TEST_F(WriteTransferAdaptiveWindow, WindowGrowsAsDataArrives) {
+  StartAndReceiveFirstChunk();
+
+  ctx_.SendClientStream<64>(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                      .set_session_id(7)
+                      .set_offset(8)
+                      .set_payload(span(kData).subspan(8, 8))));
+  ctx_.SendClientStream<64>(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                      .set_session_id(7)
+                      .set_offset(16)
+                      .set_payload(span(kData).subspan(16, 8))));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  // The window doubled again, but is limited by the space left in the writer.
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.offset(), 24u);
+  EXPECT_EQ(chunk.window_end_offset(), 32u);
+
+  ctx_.SendClientStream<64>(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                      .set_session_id(7)
+                      .set_offset(24)
+                      .set_payload(span(kData).subspan(24))
+                      .set_remaining_bytes(0)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  chunk = DecodeChunk(ctx_.responses().back());
+  ASSERT_TRUE(chunk.status().has_value());
+  EXPECT_EQ(chunk.status().value(), OkStatus());
+  EXPECT_TRUE(handler_.finalize_write_called);
+  EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
+}
+
+TEST_F(WriteTransferAdaptiveWindow, LostDataShrinksWindow) {
+  StartAndReceiveFirstChunk();
+
+  // Skip the chunk at offset 8, as if it were lost.
+  ctx_.SendClientStream<64>(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                      .set_session_id(7)
+                      .set_offset(16)
+                      .set_payload(span(kData).subspan(16, 8))));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.offset(), 8u);
+  EXPECT_EQ(chunk.window_end_offset(), 8u + 8u);
+}
+
+TEST_F(WriteTransferAdaptiveWindow, TimeoutShrinksWindow_AcceptsRequestedData) {
+  StartAndReceiveFirstChunk();
+
+  transfer_thread_.SimulateServerTimeout(7);
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.offset(), 8u);
+  EXPECT_EQ(chunk.window_end_offset(), 8u + 8u);
+
+  // Data sent for the window before the timeout is still accepted.
+  ctx_.SendClientStream<64>(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                      .set_session_id(7)
+                      .set_offset(8)
+                      .set_payload(span(kData).subspan(8, 16))));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 4u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.offset(), 24u);
+  EXPECT_EQ(chunk.window_end_offset(), 32u);
+  EXPECT_FALSE(handler_.finalize_write_called);
+}
+
+class WriteTransferSelectiveAck : public ::testing::Test {
+ protected:
+  WriteTransferSelectiveAck()
+      : buffer{},
+        handler_(7, buffer),
+        transfer_thread_(data_buffer_, encode_buffer_),
+        system_thread_(TransferThreadOptions(), transfer_thread_),
+        ctx_(transfer_thread_, 64, std::chrono::minutes(1)) {
+    ctx_.service().RegisterHandler(handler_);
+    ctx_.call();  // Open the write stream
+    transfer_thread_.WaitUntilEventIsProcessed();
+  }
+
+  ~WriteTransferSelectiveAck() override {
+    transfer_thread_.Terminate();
+    system_thread_.join();
+  }
+
+  // Runs the opening handshake, offering selective retransmission, and
+  // returns the server's initial transfer parameters.
+  Chunk StartTransfer() {
+    ctx_.SendClientStream(
+        EncodeChunk(Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStart)
+                        .set_desired_session_id(kArbitrarySessionId)
+                        .set_resource_id(7)
+                        .set_selective_ack(true)));
+    transfer_thread_.WaitUntilEventIsProcessed();
+
+    Chunk chunk = DecodeChunk(ctx_.responses().back());
+    EXPECT_EQ(chunk.type(), Chunk::Type::kStartAck);
+    EXPECT_TRUE(chunk.selective_ack());
+
+    ctx_.SendClientStream(EncodeChunk(
+        Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStartAckConfirmation)
+            .set_session_id(kArbitrarySessionId)));
+    transfer_thread_.WaitUntilEventIsProcessed();
+
+    return DecodeChunk(ctx_.responses().back());
+  }
+
+  void SendData(uint32_t offset, size_t size, bool final_chunk = false) {
+    Chunk chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kData);
+    chunk.set_session_id(kArbitrarySessionId)
+        .set_offset(offset)
+        .set_payload(span(kData).subspan(offset, size));
+    if (final_chunk) {
+      chunk.set_remaining_bytes(0);
+    }
+    ctx_.SendClientStream<64>(EncodeChunk(chunk));
+    transfer_thread_.WaitUntilEventIsProcessed();
+  }
+
+  std::array<std::byte, kData.size()> buffer;
+  SimpleWriteTransfer handler_;
+
+  Thread<1, 1, 32> transfer_thread_;
+  thread::Thread system_thread_;
+  std::array<std::byte, 64> data_buffer_;
+  std::array<std::byte, 64> encode_buffer_;
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Write) ctx_;
+};
+
+TEST_F(WriteTransferSelectiveAck, NotUsedUnlessClientOffersIt) {
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStart)
+                      .set_desired_session_id(kArbitrarySessionId)
+                      .set_resource_id(7)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kStartAck);
+  EXPECT_FALSE(chunk.selective_ack());
+}
+
+TEST_F(WriteTransferSelectiveAck, KeepsOutOfOrderData) {
+  Chunk chunk = StartTransfer();
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.window_end_offset(), 32u);
+
+  // Skip the data at offset 8, as if it were lost.
+  SendData(0, 8);
+  SendData(16, 8);
+
+  // The receiver asks for the missing data, and reports the data it has.
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.offset(), 8u);
+  ASSERT_EQ(chunk.received_ranges().size(), 1u);
+  EXPECT_EQ(chunk.received_ranges()[0].start_offset, 16u);
+  EXPECT_EQ(chunk.received_ranges()[0].end_offset, 24u);
+
+  // Data sent before the transmitter received the request is kept as well.
+  SendData(24, 8);
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+
+  // The missing data completes the window.
+  SendData(8, 8);
+  ASSERT_EQ(ctx_.total_responses(), 4u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.offset(), 32u);
+  EXPECT_TRUE(chunk.received_ranges().empty());
+
+  SendData(32, 0, /*final_chunk=*/true);
+  ASSERT_EQ(ctx_.total_responses(), 5u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kCompletion);
+  EXPECT_EQ(chunk.status(), OkStatus());
+  EXPECT_TRUE(handler_.finalize_write_called);
+  EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
+}
+
+TEST_F(WriteTransferSelectiveAck, IgnoresRepeatedData) {
+  StartTransfer();
+
+  SendData(0, 8);
+  SendData(16, 8);
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+
+  // Filling the gap leaves half of the window, so the receiver extends it.
+  SendData(8, 8);
+  ASSERT_EQ(ctx_.total_responses(), 4u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersContinue);
+  EXPECT_EQ(chunk.offset(), 24u);
+
+  // The transmitter resends data that the receiver already has, without
+  // causing another retransmit request.
+  SendData(16, 8);
+  SendData(8, 8);
+  ASSERT_EQ(ctx_.total_responses(), 4u);
+
+  SendData(24, 8);
+  ASSERT_EQ(ctx_.total_responses(), 5u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.offset(), 32u);
+  EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
+}
+
+TEST_F(WriteTransferSelectiveAck, TimeoutResendsReceivedRanges) {
+  StartTransfer();
+
+  SendData(0, 8);
+  SendData(16, 8);
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+
+  transfer_thread_.SimulateServerTimeout(kArbitrarySessionId);
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 4u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+  EXPECT_EQ(chunk.offset(), 8u);
+  ASSERT_EQ(chunk.received_ranges().size(), 1u);
+  EXPECT_EQ(chunk.received_ranges()[0].start_offset, 16u);
+  EXPECT_EQ(chunk.received_ranges()[0].end_offset, 24u);
+}
+
+TEST_F(ReadTransfer, Version2_SelectiveAck_SkipsReceivedData) {
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStart)
+                      .set_desired_session_id(kArbitrarySessionId)
+                      .set_resource_id(3)
+                      .set_selective_ack(true)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  // The transmitter always supports selective retransmission.
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.type(), Chunk::Type::kStartAck);
+  EXPECT_TRUE(chunk.selective_ack());
+
+  rpc::test::WaitForPackets(ctx_.output(), 2, [this] {
+    ctx_.SendClientStream(EncodeChunk(
+        Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStartAckConfirmation)
+            .set_session_id(kArbitrarySessionId)
+            .set_window_end_offset(16)
+            .set_max_chunk_size_bytes(8)
+            .set_offset(0)));
+    transfer_thread_.WaitUntilEventIsProcessed();
+  });
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+
+  // Ask for the data from offset 8, reporting that the data at offset 16 was
+  // already received.
+  constexpr Chunk::Range kReceived[] = {{16, 24}};
+  rpc::test::WaitForPackets(ctx_.output(), 2, [this, &kReceived] {
+    ctx_.SendClientStream(EncodeChunk(
+        Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kParametersRetransmit)
+            .set_session_id(kArbitrarySessionId)
+            .set_window_end_offset(32)
+            .set_max_chunk_size_bytes(8)
+            .set_offset(8)
+            .set_received_ranges(kReceived)));
+    transfer_thread_.WaitUntilEventIsProcessed();
+  });
+  ASSERT_EQ(ctx_.total_responses(), 5u);
+
+  Chunk c1 = DecodeChunk(ctx_.responses()[3]);
+  EXPECT_EQ(c1.offset(), 8u);
+  ASSERT_EQ(c1.payload().size(), 8u);
+  EXPECT_EQ(std::memcmp(c1.payload().data(), kData.data() + 8, 8), 0);
+
+  Chunk c2 = DecodeChunk(ctx_.responses()[4]);
+  EXPECT_EQ(c2.offset(), 24u);
+  ASSERT_EQ(c2.payload().size(), 8u);
+  EXPECT_EQ(std::memcmp(c2.payload().data(), kData.data() + 24, 8), 0);
+}
+
 TEST_F(ReadTransfer, Version2_SimpleTransfer) {
   ctx_.SendClientStream(
       EncodeChunk(Chunk(ProtocolVersion::kVersionTwo, Chunk::Type::kStart)
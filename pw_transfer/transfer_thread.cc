@@ -16,6 +16,8 @@
 
 #include "pw_transfer/transfer_thread.h"
 
+#include <limits>
+
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
 #include "pw_transfer/internal/chunk.h"
@@ -26,6 +28,10 @@ PW_MODIFY_DIAGNOSTIC(ignored, "-Wmissing-field-initializers");
 namespace pw::transfer::internal {
 
 void TransferThread::Terminate() {
+  for (TransferThread& shard : shards_) {
+    shard.Terminate();
+  }
+
   next_event_ownership_.acquire();
   next_event_.type = EventType::kTerminate;
   event_notification_.release();
@@ -98,6 +104,44 @@ chrono::SystemClock::time_point TransferThread::GetNextTransferTimeout() const {
   return timeout;
 }
 
+void TransferThread::AddTransferHandler(Handler& handler) {
+  AcquireAllShards();
+  handlers_.push_front(handler);
+  ReleaseAllShards();
+}
+
+void TransferThread::RemoveTransferHandler(Handler& handler) {
+  AcquireAllShards();
+  handlers_.remove(handler);
+  ReleaseAllShards();
+
+  // End any transfers that are using the handler.
+  RemoveTransferHandlerEvent(handler);
+  for (TransferThread& shard : shards_) {
+    shard.RemoveTransferHandlerEvent(handler);
+  }
+
+  // Ensure this function blocks until the transfer handler is fully cleaned up.
+  WaitUntilEventIsProcessed();
+}
+
+// Transfer handlers are looked up when transfers are started, while holding the
+// next event of the shard which runs the transfer. Holding every shard's next
+// event ensures that no shard is starting a transfer.
+void TransferThread::AcquireAllShards() {
+  next_event_ownership_.acquire();
+  for (TransferThread& shard : shards_) {
+    shard.next_event_ownership_.acquire();
+  }
+}
+
+void TransferThread::ReleaseAllShards() {
+  for (TransferThread& shard : shards_) {
+    shard.next_event_ownership_.release();
+  }
+  next_event_ownership_.release();
+}
+
 void TransferThread::StartTransfer(
     TransferType type,
     ProtocolVersion version,
@@ -154,17 +198,18 @@ void TransferThread::StartTransfer(
   if (is_client_transfer) {
     next_event_.new_transfer.stream = stream;
     next_event_.new_transfer.rpc_writer = &static_cast<rpc::Writer&>(
-        type == TransferType::kTransmit ? client_write_stream_
-                                        : client_read_stream_);
+        type == TransferType::kTransmit ? primary_->client_write_stream_
+                                        : primary_->client_read_stream_);
   } else {
-    auto handler = std::find_if(handlers_.begin(),
-                                handlers_.end(),
+    IntrusiveList<Handler>& handlers = primary_->handlers_;
+    auto handler = std::find_if(handlers.begin(),
+                                handlers.end(),
                                 [&](auto& h) { return h.id() == resource_id; });
-    if (handler != handlers_.end()) {
+    if (handler != handlers.end()) {
       next_event_.new_transfer.handler = &*handler;
       next_event_.new_transfer.rpc_writer = &static_cast<rpc::Writer&>(
-          type == TransferType::kTransmit ? server_read_stream_
-                                          : server_write_stream_);
+          type == TransferType::kTransmit ? primary_->server_read_stream_
+                                          : primary_->server_write_stream_);
     } else {
       // No handler exists for the transfer: return a NOT_FOUND.
       next_event_.type = EventType::kSendStatusChunk;
@@ -195,20 +240,25 @@ void TransferThread::ProcessChunk(EventType type, ConstByteSpan chunk) {
     return;
   }
 
-  // Block until the last event has been processed.
-  next_event_ownership_.acquire();
+  // The chunk is copied into the buffer of the shard which runs its transfer,
+  // as it is only valid until this returns. Other shards are free to process
+  // events meanwhile.
+  TransferThread& shard = ShardFor(identifier->value());
 
-  std::memcpy(chunk_buffer_.data(), chunk.data(), chunk.size());
+  // Block until the shard's last event has been processed.
+  shard.next_event_ownership_.acquire();
 
-  next_event_.type = type;
-  next_event_.chunk = {
+  std::memcpy(shard.chunk_buffer_.data(), chunk.data(), chunk.size());
+
+  shard.next_event_.type = type;
+  shard.next_event_.chunk = {
       .context_identifier = identifier->value(),
       .match_resource_id = identifier->is_legacy(),
-      .data = chunk_buffer_.data(),
+      .data = shard.chunk_buffer_.data(),
       .size = chunk.size(),
   };
 
-  event_notification_.release();
+  shard.event_notification_.release();
 }
 
 void TransferThread::SendStatus(TransferStream stream,
@@ -246,16 +296,12 @@ void TransferThread::EndTransfer(EventType type,
   event_notification_.release();
 }
 
-void TransferThread::TransferHandlerEvent(EventType type, Handler& handler) {
+void TransferThread::RemoveTransferHandlerEvent(Handler& handler) {
   // Block until the last event has been processed.
   next_event_ownership_.acquire();
 
-  next_event_.type = type;
-  if (type == EventType::kAddTransferHandler) {
-    next_event_.add_transfer_handler = &handler;
-  } else {
-    next_event_.remove_transfer_handler = &handler;
-  }
+  next_event_.type = EventType::kRemoveTransferHandler;
+  next_event_.remove_transfer_handler = &handler;
 
   event_notification_.release();
 }
@@ -289,7 +335,10 @@ void TransferThread::HandleEvent(const internal::Event& event) {
         });
       }
 
-      // Cancel/Finish streams.
+      // Cancel/Finish streams, which belong to the primary shard.
+      if (primary_ != this) {
+        return;
+      }
       client_read_stream_.Cancel().IgnoreError();
       client_write_stream_.Cancel().IgnoreError();
       server_read_stream_.Finish(Status::Aborted()).IgnoreError();
@@ -300,10 +349,6 @@ void TransferThread::HandleEvent(const internal::Event& event) {
       SendStatusChunk(event.send_status_chunk);
       break;
 
-    case EventType::kAddTransferHandler:
-      handlers_.push_front(*event.add_transfer_handler);
-      return;
-
     case EventType::kRemoveTransferHandler:
       for (ServerContext& server_context : server_transfers_) {
         if (server_context.handler() == event.remove_transfer_handler) {
@@ -318,7 +363,6 @@ void TransferThread::HandleEvent(const internal::Event& event) {
           });
         }
       }
-      handlers_.remove(*event.remove_transfer_handler);
       return;
 
     case EventType::kNewClientTransfer:
@@ -402,7 +446,6 @@ Context* TransferThread::FindContextForEvent(
                                           event.end_transfer.session_id);
 
     case EventType::kSendStatusChunk:
-    case EventType::kAddTransferHandler:
     case EventType::kRemoveTransferHandler:
     case EventType::kTerminate:
     default:
@@ -433,9 +476,16 @@ void TransferThread::SendStatusChunk(
 
 // Should only be called with the `next_event_ownership_` lock held.
 uint32_t TransferThread::AssignSessionId() {
-  uint32_t session_id = next_session_id_++;
-  if (session_id == 0) {
-    session_id = next_session_id_++;
+  // Shards assign every num_shards-th ID, so that each ID routes back to the
+  // shard which assigned it. No shard assigns 0.
+  const uint32_t num_shards = static_cast<uint32_t>(primary_->num_shards());
+  const uint32_t session_id = next_session_id_;
+
+  if (session_id > std::numeric_limits<uint32_t>::max() - num_shards) {
+    const uint32_t index = session_id % num_shards;
+    next_session_id_ = index == 0 ? num_shards : index;
+  } else {
+    next_session_id_ += num_shards;
   }
   return session_id;
 }
@@ -0,0 +1,196 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how quickly a transfer client receives data for 16 concurrent read
+// transfers when its transfer thread is split into 1 to 8 shards. Four threads
+// hand the transfer thread data chunks, as the RPC threads for several links
+// would. Packets sent by the client are discarded.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#include "pw_assert/check.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc/client.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/yield.h"
+#include "pw_thread_stl/options.h"
+#include "pw_transfer/internal/chunk.h"
+#include "pw_transfer/transfer.raw_rpc.pb.h"
+#include "pw_transfer/transfer_thread.h"
+
+namespace pw::transfer {
+namespace {
+
+using internal::Chunk;
+
+constexpr size_t kTransfers = 16;
+constexpr size_t kFeeders = 4;
+constexpr size_t kMaxShards = 8;
+constexpr size_t kTransferSize = 4096;
+constexpr size_t kChunkDataSize = 256;
+constexpr size_t kChunksPerTransfer = kTransferSize / kChunkDataSize;
+constexpr size_t kMaxChunkSize = 512;
+constexpr uint32_t kChannelId = 1;
+constexpr auto kTimeout = std::chrono::seconds(10);
+
+class DiscardingOutput final : public rpc::ChannelOutput {
+ public:
+  DiscardingOutput() : ChannelOutput("DiscardingOutput") {}
+
+ private:
+  Status Send(span<const std::byte>) override { return OkStatus(); }
+};
+
+struct Context {
+  Context()
+      : channels{rpc::Channel::Create<kChannelId>(&output)}, client(channels) {}
+
+  DiscardingOutput output;
+  std::array<rpc::Channel, 1> channels;
+  rpc::Client client;
+};
+
+Context& GetContext() {
+  static Context context;
+  return context;
+}
+
+struct EncodedChunk {
+  ConstByteSpan data() const { return span(buffer).first(size); }
+
+  std::array<std::byte, kMaxChunkSize> buffer;
+  size_t size;
+};
+
+// Legacy data chunks for every transfer. Legacy transfers use their resource
+// ID as their session ID, which is 1 + the transfer's index.
+std::array<std::array<EncodedChunk, kChunksPerTransfer>, kTransfers>
+    encoded_chunks;
+
+void EncodeChunks() {
+  static const std::array<std::byte, kChunkDataSize> payload{};
+  for (size_t i = 0; i < kTransfers; ++i) {
+    for (size_t j = 0; j < kChunksPerTransfer; ++j) {
+      const uint32_t offset = j * kChunkDataSize;
+      Chunk chunk(ProtocolVersion::kLegacy, Chunk::Type::kData);
+      chunk.set_session_id(i + 1).set_offset(offset).set_payload(payload);
+      if (j == kChunksPerTransfer - 1) {
+        chunk.set_remaining_bytes(0);
+      }
+      const Result<ConstByteSpan> encoded =
+          chunk.Encode(encoded_chunks[i][j].buffer);
+      PW_CHECK_OK(encoded.status());
+      encoded_chunks[i][j].size = encoded->size();
+    }
+  }
+}
+
+// Hands the transfer thread one chunk of each of a feeder's transfers at a
+// time, until all of their data is sent.
+void FeedChunks(internal::TransferThread& transfer_thread, size_t feeder) {
+  constexpr size_t kTransfersPerFeeder = kTransfers / kFeeders;
+  for (size_t j = 0; j < kChunksPerTransfer; ++j) {
+    for (size_t i = feeder * kTransfersPerFeeder;
+         i < (feeder + 1) * kTransfersPerFeeder;
+         ++i) {
+      transfer_thread.ProcessClientChunk(encoded_chunks[i][j].data());
+    }
+  }
+}
+
+struct Counts {
+  std::atomic<size_t> running = 0;
+  std::atomic<size_t> failed = 0;
+};
+
+std::array<std::byte, kMaxShards * kMaxChunkSize> chunk_buffer;
+std::array<std::byte, kMaxShards * kMaxChunkSize> encode_buffer;
+std::array<stream::MemoryWriterBuffer<kTransferSize>, kTransfers> writers;
+
+template <size_t kShards>
+void ReceiveData(perf_test::State& state) {
+  static_assert(kShards <= kMaxShards && kTransfers % kShards == 0);
+  EncodeChunks();
+
+  ShardedThread<kShards, kTransfers / kShards, 0> transfer_thread(
+      ByteSpan(chunk_buffer).first(kShards * kMaxChunkSize),
+      ByteSpan(encode_buffer).first(kShards * kMaxChunkSize));
+  std::array<thread::Thread, kShards> shard_threads;
+  for (size_t i = 0; i < kShards; ++i) {
+    shard_threads[i] =
+        thread::Thread(thread::stl::Options(), transfer_thread.shard(i));
+  }
+
+  rpc::RawClientReaderWriter read_stream =
+      pw_rpc::raw::Transfer::Read(GetContext().client, kChannelId);
+  transfer_thread.SetClientReadStream(read_stream);
+
+  const internal::TransferParameters max_parameters(
+      kTransferSize, transfer_thread.max_chunk_size(), /*divisor=*/2);
+
+  Counts counts;
+  while (state.KeepRunning()) {
+    counts.running = kTransfers;
+    for (size_t i = 0; i < kTransfers; ++i) {
+      writers[i].clear();
+      transfer_thread.StartClientTransfer(
+          internal::TransferType::kReceive,
+          ProtocolVersion::kLegacy,
+          /*resource_id=*/i + 1,
+          &writers[i],
+          max_parameters,
+          [&counts](Status status) {
+            if (!status.ok()) {
+              counts.failed.fetch_add(1);
+            }
+            counts.running.fetch_sub(1);
+          },
+          kTimeout,
+          kTimeout,
+          /*max_retries=*/3,
+          /*max_lifetime_retries=*/10);
+    }
+
+    std::array<std::thread, kFeeders> feeders;
+    for (size_t i = 0; i < kFeeders; ++i) {
+      feeders[i] = std::thread(FeedChunks, std::ref(transfer_thread), i);
+    }
+    for (std::thread& feeder : feeders) {
+      feeder.join();
+    }
+    while (counts.running.load() > 0) {
+      this_thread::yield();
+    }
+  }
+
+  PW_CHECK_UINT_EQ(counts.failed.load(), 0);
+
+  transfer_thread.Terminate();
+  for (thread::Thread& thread : shard_threads) {
+    thread.join();
+  }
+}
+
+PW_PERF_TEST(TransferThread1Shard, ReceiveData<1>);
+PW_PERF_TEST(TransferThread2Shards, ReceiveData<2>);
+PW_PERF_TEST(TransferThread4Shards, ReceiveData<4>);
+PW_PERF_TEST(TransferThread8Shards, ReceiveData<8>);
+
+}  // namespace
+}  // namespace pw::transfer
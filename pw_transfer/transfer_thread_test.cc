@@ -349,5 +349,169 @@ TEST_F(TransferThreadTest, VersionTwo_NoHandler) {
   transfer_thread_.RemoveTransferHandler(handler);
 }
 
+class ShardedTransferThreadTest : public ::testing::Test {
+ public:
+  ShardedTransferThreadTest()
+      : ctx_(transfer_thread_, 512),
+        max_parameters_(chunk_buffer_.size() / 2,
+                        chunk_buffer_.size() / 2,
+                        cfg::kDefaultExtendWindowDivisor),
+        transfer_thread_(chunk_buffer_, encode_buffer_),
+        system_threads_{
+            thread::Thread(TransferThreadOptions(), transfer_thread_.shard(0)),
+            thread::Thread(TransferThreadOptions(), transfer_thread_.shard(1)),
+        } {}
+
+  ~ShardedTransferThreadTest() override {
+    transfer_thread_.Terminate();
+    for (thread::Thread& thread : system_threads_) {
+      thread.join();
+    }
+  }
+
+ protected:
+  void StartReadTransfer(uint32_t session_id) {
+    transfer_thread_.StartServerTransfer(
+        internal::TransferType::kTransmit,
+        ProtocolVersion::kLegacy,
+        session_id,
+        session_id,
+        EncodeChunk(
+            Chunk(ProtocolVersion::kLegacy, Chunk::Type::kParametersRetransmit)
+                .set_session_id(session_id)
+                .set_window_end_offset(8)
+                .set_max_chunk_size_bytes(8)
+                .set_offset(0)),
+        max_parameters_,
+        kNeverTimeout,
+        3,
+        10);
+  }
+
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Read) ctx_;
+
+  std::array<std::byte, 128> chunk_buffer_;
+  std::array<std::byte, 128> encode_buffer_;
+
+  rpc::RawClientTestContext<> rpc_client_context_;
+  internal::TransferParameters max_parameters_;
+
+  transfer::ShardedThread<2, 1, 1> transfer_thread_;
+
+  std::array<thread::Thread, 2> system_threads_;
+};
+
+TEST_F(ShardedTransferThreadTest, SplitsBuffersBetweenShards) {
+  EXPECT_EQ(transfer_thread_.num_shards(), 2u);
+  EXPECT_EQ(transfer_thread_.max_chunk_size(), 64u);
+}
+
+TEST_F(ShardedTransferThreadTest, RunsTransfersOnEachShard) {
+  auto reader_writer = ctx_.reader_writer();
+  transfer_thread_.SetServerReadStream(reader_writer);
+
+  SimpleReadTransfer handler3(3, kData);
+  SimpleReadTransfer handler4(4, kData);
+  SimpleReadTransfer handler5(5, kData);
+  transfer_thread_.AddTransferHandler(handler3);
+  transfer_thread_.AddTransferHandler(handler4);
+  transfer_thread_.AddTransferHandler(handler5);
+
+  // Each shard has a context for one server transfer, so transfers 3 and 4 run
+  // at once on different shards. Transfer 5 routes to the same shard as 3.
+  StartReadTransfer(3);
+  StartReadTransfer(4);
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  EXPECT_TRUE(handler3.prepare_read_called);
+  EXPECT_TRUE(handler4.prepare_read_called);
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+
+  StartReadTransfer(5);
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  EXPECT_FALSE(handler5.prepare_read_called);
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  Chunk chunk = DecodeChunk(ctx_.response());
+  EXPECT_EQ(chunk.session_id(), 5u);
+  ASSERT_TRUE(chunk.status().has_value());
+  EXPECT_EQ(chunk.status().value(), Status::ResourceExhausted());
+
+  // Chunks are routed to the shard running their transfer.
+  transfer_thread_.ProcessServerChunk(EncodeChunk(
+      Chunk(ProtocolVersion::kLegacy, Chunk::Type::kParametersRetransmit)
+          .set_session_id(4)
+          .set_window_end_offset(16)
+          .set_max_chunk_size_bytes(8)
+          .set_offset(8)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 4u);
+  chunk = DecodeChunk(ctx_.response());
+  EXPECT_EQ(chunk.session_id(), 4u);
+  EXPECT_EQ(chunk.offset(), 8u);
+  EXPECT_EQ(chunk.payload().size(), 8u);
+
+  // Removing the handlers ends the transfers on both shards.
+  transfer_thread_.RemoveTransferHandler(handler3);
+  transfer_thread_.RemoveTransferHandler(handler4);
+  transfer_thread_.RemoveTransferHandler(handler5);
+
+  EXPECT_TRUE(handler3.finalize_read_called);
+  EXPECT_EQ(handler3.finalize_read_status, Status::Aborted());
+  EXPECT_TRUE(handler4.finalize_read_called);
+  EXPECT_EQ(handler4.finalize_read_status, Status::Aborted());
+}
+
+TEST_F(ShardedTransferThreadTest, AssignsSessionIdsWhichRouteToTheShard) {
+  rpc::RawClientReaderWriter read_stream = pw_rpc::raw::Transfer::Read(
+      rpc_client_context_.client(), rpc_client_context_.channel().id());
+  transfer_thread_.SetClientReadStream(read_stream);
+
+  stream::MemoryWriterBuffer<16> buffer3;
+  stream::MemoryWriterBuffer<16> buffer4;
+
+  transfer_thread_.StartClientTransfer(internal::TransferType::kReceive,
+                                       ProtocolVersion::kVersionTwo,
+                                       3,
+                                       &buffer3,
+                                       max_parameters_,
+                                       [](Status) {},
+                                       kNeverTimeout,
+                                       kNeverTimeout,
+                                       3,
+                                       10);
+  transfer_thread_.StartClientTransfer(internal::TransferType::kReceive,
+                                       ProtocolVersion::kVersionTwo,
+                                       4,
+                                       &buffer4,
+                                       max_parameters_,
+                                       [](Status) {},
+                                       kNeverTimeout,
+                                       kNeverTimeout,
+                                       3,
+                                       10);
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  auto payloads =
+      rpc_client_context_.output().payloads<pw_rpc::raw::Transfer::Read>();
+  ASSERT_EQ(payloads.size(), 2u);
+
+  // The start chunks may be sent in either order.
+  uint32_t session_ids[2];
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    Chunk chunk = DecodeChunk(payloads[i]);
+    ASSERT_TRUE(chunk.desired_session_id().has_value());
+    ASSERT_TRUE(chunk.resource_id().has_value());
+    EXPECT_EQ(chunk.desired_session_id().value() % 2,
+              chunk.resource_id().value() % 2);
+    session_ids[i] = chunk.desired_session_id().value();
+  }
+  EXPECT_NE(session_ids[0], session_ids[1]);
+
+  transfer_thread_.EndClientTransfer(session_ids[0], Status::Cancelled());
+  transfer_thread_.EndClientTransfer(session_ids[1], Status::Cancelled());
+}
+
 }  // namespace
 }  // namespace pw::transfer::test
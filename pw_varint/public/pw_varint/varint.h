@@ -110,6 +110,16 @@ size_t pw_varint_Decode64(const void* input,
                           size_t input_size_bytes,
                           uint64_t* output);
 
+/// Decodes consecutive LEB128-encoded integers to `uint64_t`s, until
+/// `output_count` values are decoded or the input ends or holds an invalid
+/// varint. Sets `bytes_read` to the number of bytes the decoded values occupy.
+/// @returns the number of values decoded
+size_t pw_varint_DecodeMany64(const void* input,
+                              size_t input_size_bytes,
+                              uint64_t* output,
+                              size_t output_count,
+                              size_t* bytes_read);
+
 /// Decodes one byte of an LEB128-encoded integer to a `uint32_t`.
 /// @returns true if there is more data to decode (top bit is set).
 static inline bool pw_varint_DecodeOneByte32(uint8_t byte,
@@ -304,6 +314,26 @@ inline size_t Decode(const span<const std::byte>& input, uint64_t* value) {
   return pw_varint_Decode64(input.data(), input.size(), value);
 }
 
+/// Decodes consecutive varints from the start of `input` into `output`, in
+/// fewer steps per value than calling `Decode` for each one. Values are not
+/// ZigZag decoded.
+///
+/// Decoding stops when `output` is full, at the end of `input`, or at a varint
+/// that is truncated or longer than 10 bytes. If `output` is not full and
+/// fewer than 10 bytes remain in `input` after `bytes_read`, the data ends in
+/// the middle of a varint, which may continue in data that is not yet
+/// available. Otherwise, the varint after `bytes_read` is invalid.
+///
+/// @param[out] bytes_read Set to the number of bytes the decoded values occupy
+///
+/// @returns the number of values decoded
+inline size_t DecodeMany(span<const std::byte> input,
+                         span<uint64_t> output,
+                         size_t* bytes_read) {
+  return pw_varint_DecodeMany64(
+      input.data(), input.size(), output.data(), output.size(), bytes_read);
+}
+
 /// Describes a custom varint format.
 enum class Format {
   kZeroTerminatedLeastSignificant = PW_VARINT_ZERO_TERMINATED_LEAST_SIGNIFICANT,
@@ -17,6 +17,12 @@
 #include <algorithm>
 #include <cstddef>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace pw {
 namespace varint {
 namespace {
@@ -29,8 +35,135 @@ inline bool LeastSignificant(pw_varint_Format format) {
   return (static_cast<unsigned>(format) & 0b01) == 0;
 }
 
+constexpr uint64_t kContinuationBits = 0x8080808080808080u;
+
+uint64_t LoadLittleEndian64(const uint8_t* bytes) {
+  uint64_t word = 0;
+  for (size_t i = 0; i < sizeof(word); ++i) {
+    word |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+  }
+  return word;
+}
+
+// Combines the low 7 bits of the first size bytes of a little-endian word into
+// one value. size must be from 1 to 8.
+uint64_t CombineSevenBitGroups(uint64_t word, size_t size) {
+  if (size < sizeof(word)) {
+    word &= (uint64_t{1} << (8 * size)) - 1;
+  }
+  word &= ~kContinuationBits;
+
+  // Close the gaps left by the continuation bits: first within each 16-bit
+  // lane, then each 32-bit lane, then the whole word.
+  word = ((word & 0x7f007f007f007f00u) >> 1) | (word & 0x007f007f007f007fu);
+  word = ((word & 0x3fff00003fff0000u) >> 2) | (word & 0x00003fff00003fffu);
+  word = ((word & 0x0fffffff00000000u) >> 4) | (word & 0x000000000fffffffu);
+  return word;
+}
+
+// Decodes 16 single-byte varints at once if the 16 bytes at input all are.
+// Returns false otherwise, or if there is no vector support.
+bool DecodeSixteenSingleBytes(const uint8_t* input, uint64_t* output) {
+#if defined(__SSE2__)
+  const __m128i bytes =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+  if (_mm_movemask_epi8(bytes) != 0) {
+    return false;
+  }
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i halves[] = {_mm_unpacklo_epi8(bytes, zero),
+                            _mm_unpackhi_epi8(bytes, zero)};
+  for (const __m128i& half : halves) {
+    const __m128i quarters[] = {_mm_unpacklo_epi16(half, zero),
+                                _mm_unpackhi_epi16(half, zero)};
+    for (const __m128i& quarter : quarters) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+                       _mm_unpacklo_epi32(quarter, zero));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 2),
+                       _mm_unpackhi_epi32(quarter, zero));
+      output += 4;
+    }
+  }
+  return true;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const uint8x16_t bytes = vld1q_u8(input);
+  if (vmaxvq_u8(bytes) >= 0x80u) {
+    return false;
+  }
+  const uint16x8_t halves[] = {vmovl_u8(vget_low_u8(bytes)),
+                               vmovl_high_u8(bytes)};
+  for (const uint16x8_t& half : halves) {
+    const uint32x4_t quarters[] = {vmovl_u16(vget_low_u16(half)),
+                                   vmovl_high_u16(half)};
+    for (const uint32x4_t& quarter : quarters) {
+      vst1q_u64(output, vmovl_u32(vget_low_u32(quarter)));
+      vst1q_u64(output + 2, vmovl_high_u32(quarter));
+      output += 4;
+    }
+  }
+  return true;
+#else
+  static_cast<void>(input);
+  static_cast<void>(output);
+  return false;
+#endif  // defined(__SSE2__)
+}
+
 }  // namespace
 
+extern "C" size_t pw_varint_DecodeMany64(const void* input,
+                                         size_t input_size_bytes,
+                                         uint64_t* output,
+                                         size_t output_count,
+                                         size_t* bytes_read) {
+  const uint8_t* const bytes = static_cast<const uint8_t*>(input);
+  size_t position = 0;
+  size_t count = 0;
+
+  while (count < output_count) {
+    const size_t remaining = input_size_bytes - position;
+
+    if (remaining >= 16 && output_count - count >= 16 &&
+        DecodeSixteenSingleBytes(&bytes[position], &output[count])) {
+      position += 16;
+      count += 16;
+      continue;
+    }
+
+    // Find the end of the next varint from the continuation bits of a word.
+    // Varints longer than a word are decoded a byte at a time below.
+    if (remaining >= sizeof(uint64_t)) {
+      const uint64_t word = LoadLittleEndian64(&bytes[position]);
+      const uint64_t last_bytes = ~word & kContinuationBits;
+
+      if (last_bytes == kContinuationBits && output_count - count >= 8) {
+        for (size_t i = 0; i < 8; ++i) {
+          output[count++] = bytes[position++];
+        }
+        continue;
+      }
+      if (last_bytes != 0u) {
+        const size_t size =
+            static_cast<size_t>(cpp20::countr_zero(last_bytes)) / 8 + 1;
+        output[count++] = CombineSevenBitGroups(word, size);
+        position += size;
+        continue;
+      }
+    }
+
+    const size_t size =
+        pw_varint_Decode64(&bytes[position], remaining, &output[count]);
+    if (size == 0u) {
+      break;
+    }
+    position += size;
+    count += 1;
+  }
+
+  *bytes_read = position;
+  return count;
+}
+
 extern "C" size_t pw_varint_EncodeCustom(uint64_t integer,
                                          void* output,
                                          size_t output_size,
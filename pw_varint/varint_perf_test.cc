@@ -0,0 +1,125 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares decoding a packed run of 1024 varints with DecodeMany against
+// calling Decode for each value. Small values are typical of deltas and enums;
+// large values are typical of timestamps and hashes.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/check.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+#include "pw_varint/varint.h"
+
+namespace pw::varint {
+namespace {
+
+constexpr size_t kValues = 1024;
+
+enum class Sizes {
+  kSingleByte,  // Values from 0 to 127
+  kMixed,       // Mostly one or two bytes, with some up to 10 bytes
+  kLarge,       // Values from 5 to 8 bytes
+};
+
+struct Encoded {
+  std::array<std::byte, kValues * kMaxVarint64SizeBytes> buffer;
+  span<const std::byte> data;
+};
+
+const Encoded& Encode(Sizes sizes) {
+  static std::array<Encoded, 3> encoded = [] {
+    std::array<Encoded, 3> all;
+    for (size_t i = 0; i < all.size(); ++i) {
+      Encoded& e = all[i];
+      uint32_t random = 1;
+      size_t size = 0;
+      for (size_t value = 0; value < kValues; ++value) {
+        random = random * 1103515245u + 12345u;
+        uint64_t integer = random >> 8;
+        switch (static_cast<Sizes>(i)) {
+          case Sizes::kSingleByte:
+            integer &= 0x7f;
+            break;
+          case Sizes::kMixed:
+            integer >>= (random >> 28) % 8 == 0 ? 0 : 10;
+            integer <<= (random >> 24) % 16 == 0 ? 40 : 0;
+            break;
+          case Sizes::kLarge:
+            integer <<= 5 + (random >> 27) % 28;
+            break;
+        }
+        size += varint::Encode(integer, span(e.buffer).subspan(size));
+      }
+      e.data = span(e.buffer).first(size);
+    }
+    return all;
+  }();
+  return encoded[static_cast<size_t>(sizes)];
+}
+
+// Keeps the results live so the decoding is not optimized out.
+volatile uint64_t result_sink;
+
+void DecodeOneAtATime(perf_test::State& state, Sizes sizes) {
+  const span<const std::byte> data = Encode(sizes).data;
+
+  uint64_t result = 0;
+  size_t decoded = 0;
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < data.size();) {
+      uint64_t value;
+      const size_t size = Decode(data.subspan(i), &value);
+      result ^= value;
+      i += size;
+      decoded += 1;
+    }
+  }
+  PW_CHECK_UINT_NE(decoded, 0);
+  result_sink = result;
+}
+
+void DecodeManyAtATime(perf_test::State& state, Sizes sizes) {
+  const span<const std::byte> data = Encode(sizes).data;
+
+  uint64_t result = 0;
+  size_t decoded = 0;
+  while (state.KeepRunning()) {
+    std::array<uint64_t, 32> values;
+    for (size_t i = 0; i < data.size();) {
+      size_t size;
+      const size_t count = DecodeMany(data.subspan(i), values, &size);
+      for (size_t j = 0; j < count; ++j) {
+        result ^= values[j];
+      }
+      i += size;
+      decoded += count;
+    }
+  }
+  PW_CHECK_UINT_NE(decoded, 0);
+  result_sink = result;
+}
+
+PW_PERF_TEST(DecodeSingleByteValues, DecodeOneAtATime, Sizes::kSingleByte);
+PW_PERF_TEST(DecodeManySingleByteValues, DecodeManyAtATime, Sizes::kSingleByte);
+PW_PERF_TEST(DecodeMixedValues, DecodeOneAtATime, Sizes::kMixed);
+PW_PERF_TEST(DecodeManyMixedValues, DecodeManyAtATime, Sizes::kMixed);
+PW_PERF_TEST(DecodeLargeValues, DecodeOneAtATime, Sizes::kLarge);
+PW_PERF_TEST(DecodeManyLargeValues, DecodeManyAtATime, Sizes::kLarge);
+
+}  // namespace
+}  // namespace pw::varint
@@ -14,6 +14,7 @@
 
 #include "pw_varint/varint.h"
 
+#include <array>
 #include <cinttypes>
 #include <cstdint>
 #include <cstring>
@@ -729,6 +730,133 @@ TEST(VarintDecode, DecodeSigned64_MultiByte_C) {
   EXPECT_EQ(value, std::numeric_limits<int64_t>::max());
 }
 
+// Checks that DecodeMany decodes the same values as calling Decode for each.
+void DecodeManyMatchesDecode(span<const std::byte> input) {
+  std::array<uint64_t, 64> values;
+  size_t bytes_read = 1234;
+  const size_t count = DecodeMany(input, values, &bytes_read);
+
+  size_t position = 0;
+  size_t expected_count = 0;
+  while (expected_count < values.size()) {
+    uint64_t value;
+    const size_t size = Decode(input.subspan(position), &value);
+    if (size == 0u) {
+      break;
+    }
+    ASSERT_EQ(values[expected_count], value) << "value " << expected_count;
+    position += size;
+    expected_count += 1;
+  }
+
+  EXPECT_EQ(count, expected_count);
+  EXPECT_EQ(bytes_read, position);
+}
+
+// Encodes a repeating sequence of values of every size into the buffer.
+span<const std::byte> EncodeMixedSizes(span<std::byte> buffer) {
+  size_t size = 0;
+  for (uint64_t i = 0; size + kMaxVarint64SizeBytes <= buffer.size(); ++i) {
+    const unsigned bits = static_cast<unsigned>((i * 7) % 65);
+    const uint64_t value =
+        bits == 0u ? 0u : std::numeric_limits<uint64_t>::max() >> (64 - bits);
+    size += Encode(value, buffer.subspan(size));
+  }
+  return buffer.first(size);
+}
+
+// Like MakeBuffer, but for longer strings of varints.
+template <size_t kStringSize>
+span<const std::byte> StringBytes(const char (&data)[kStringSize]) {
+  return as_bytes(span(data).first(kStringSize - 1));
+}
+
+TEST(VarintDecodeMany, Empty) {
+  std::array<uint64_t, 4> values;
+  size_t bytes_read = 1234;
+  EXPECT_EQ(DecodeMany(span<const std::byte>(), values, &bytes_read), 0u);
+  EXPECT_EQ(bytes_read, 0u);
+}
+
+TEST(VarintDecodeMany, SingleBytes) {
+  std::array<std::byte, 100> input;
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<std::byte>(i);
+  }
+
+  std::array<uint64_t, 100> values;
+  size_t bytes_read = 0;
+  ASSERT_EQ(DecodeMany(input, values, &bytes_read), 100u);
+  EXPECT_EQ(bytes_read, 100u);
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], i);
+  }
+}
+
+TEST(VarintDecodeMany, MixedSizes) {
+  std::array<std::byte, 512> buffer;
+  const span<const std::byte> input = EncodeMixedSizes(buffer);
+
+  // Start at every offset to cover values at every alignment and reads that
+  // end in the middle of a value.
+  for (size_t offset = 0; offset < input.size(); ++offset) {
+    DecodeManyMatchesDecode(input.subspan(offset));
+    DecodeManyMatchesDecode(input.first(offset));
+  }
+}
+
+TEST(VarintDecodeMany, StopsWhenOutputIsFull) {
+  std::array<std::byte, 32> input{};
+  input[3] = std::byte{0x80};
+  input[4] = std::byte{0x01};
+
+  std::array<uint64_t, 4> values;
+  size_t bytes_read = 0;
+  ASSERT_EQ(DecodeMany(input, values, &bytes_read), 4u);
+  EXPECT_EQ(bytes_read, 5u);
+  EXPECT_EQ(values[3], 128u);
+
+  ASSERT_EQ(DecodeMany(input, span(values).first(0), &bytes_read), 0u);
+  EXPECT_EQ(bytes_read, 0u);
+}
+
+TEST(VarintDecodeMany, StopsAtTruncatedValue) {
+  const auto input = MakeBuffer("\x01\x02\x80\x80");
+  std::array<uint64_t, 4> values;
+  size_t bytes_read = 0;
+  ASSERT_EQ(DecodeMany(input, values, &bytes_read), 2u);
+  EXPECT_EQ(bytes_read, 2u);
+  EXPECT_EQ(values[0], 1u);
+  EXPECT_EQ(values[1], 2u);
+}
+
+TEST(VarintDecodeMany, StopsAtValueLongerThanTenBytes) {
+  const span<const std::byte> input = StringBytes(
+      "\x7f\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01\x00\x00\x00");
+  std::array<uint64_t, 4> values;
+  size_t bytes_read = 0;
+  ASSERT_EQ(DecodeMany(input, values, &bytes_read), 1u);
+  EXPECT_EQ(bytes_read, 1u);
+  EXPECT_EQ(values[0], 0x7fu);
+}
+
+TEST(VarintDecodeMany, LargestValues) {
+  const span<const std::byte> input = StringBytes(
+      "\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01"
+      "\xff\xff\xff\xff\xff\xff\xff\x7f"
+      "\xff\xff\xff\xff\xff\xff\xff\xff\x7f");
+  std::array<uint64_t, 4> values;
+  size_t bytes_read = 0;
+  ASSERT_EQ(DecodeMany(input, values, &bytes_read), 3u);
+  EXPECT_EQ(bytes_read, 27u);
+  EXPECT_EQ(values[0], std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(values[1], (uint64_t{1} << 56) - 1);
+  EXPECT_EQ(values[2], (uint64_t{1} << 63) - 1);
+}
+
+FUZZ_TEST(VarintDecodeMany, DecodeManyMatchesDecode)
+    .WithDomains(fuzzer::VectorOf<256>(fuzzer::Arbitrary<std::byte>()));
+
 TEST(Varint, ZigZagEncode_Int8) {
   EXPECT_EQ(ZigZagEncode(int8_t(0)), uint8_t(0));
   EXPECT_EQ(ZigZagEncode(int8_t(-1)), uint8_t(1));
@@ -0,0 +1,240 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "pw_containers/inline_deque.h"
+#include "pw_metric/metric.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread_core.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::work_queue {
+
+/// A `pw::work_queue::WorkQueue` that runs its work on several worker threads.
+///
+/// **Scheduling**: Each worker has its own queue, so pushing and running work
+/// only contends with the workers that share the queue. Work items are
+/// distributed round-robin across the workers. A worker that runs out of work
+/// steals work from the queues of the other workers before it goes to sleep,
+/// so a long running work item does not hold up the work queued behind it.
+///
+/// **Ordered work**: Work items pushed with the same affinity key always run on
+/// the same worker, one at a time, in the order in which they were pushed.
+/// They are never stolen. Work items without an affinity key may run in any
+/// order, and concurrently with each other.
+///
+/// **Queue sizing**: Each worker's queue holds a fixed number of work items,
+/// set through the templated `pw::work_queue::WorkQueuePoolWithBuffer`. A work
+/// item without an affinity key is only rejected once all of the queues are
+/// full.
+///
+/// **Cooperative thread cancellation**: Each worker is a
+/// `pw::thread::ThreadCore` which should be executed as its own thread, see
+/// `worker()`. `RequestStop()` stops all of the workers, and should be invoked
+/// before joining the threads. Once a stop has been requested the pool will no
+/// longer accept further work.
+///
+/// The entire API is thread-safe and interrupt-safe.
+class WorkQueuePool {
+ public:
+  class Worker;
+
+  WorkQueuePool(const WorkQueuePool&) = delete;
+  WorkQueuePool& operator=(const WorkQueuePool&) = delete;
+
+  /// Enqueues a `work_item` for execution by any of the workers.
+  ///
+  /// @param[in] work_item The entry to enqueue.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - Success. Entry was enqueued for execution.
+  /// * @pw_status{FAILED_PRECONDITION} - The pool is shutting down.
+  ///   Entries are no longer permitted.
+  /// * @pw_status{RESOURCE_EXHAUSTED} - All of the workers' queues are full.
+  ///   Entry was not enqueued.
+  Status PushWork(WorkItem&& work_item);
+
+  /// Enqueues a `work_item` for execution after all of the work items that
+  /// were pushed with the same `affinity_key`.
+  ///
+  /// @param[in] affinity_key Selects the worker that runs the entry.
+  ///
+  /// @param[in] work_item The entry to enqueue.
+  ///
+  /// @returns
+  /// * @pw_status{OK} - Success. Entry was enqueued for execution.
+  /// * @pw_status{FAILED_PRECONDITION} - The pool is shutting down.
+  ///   Entries are no longer permitted.
+  /// * @pw_status{RESOURCE_EXHAUSTED} - The queue of the worker for the
+  ///   `affinity_key` is full. Entry was not enqueued.
+  Status PushWork(uint32_t affinity_key, WorkItem&& work_item);
+
+  /// Queues work for execution by any of the workers. Crashes if the work
+  /// cannot be queued due to full queues or stopped workers.
+  ///
+  /// @param[in] work_item The entry to enqueue.
+  ///
+  /// @pre
+  /// * The queues must not overflow, i.e. be full.
+  /// * The pool must not have been requested to stop, i.e. it must
+  ///   not be in the process of shutting down.
+  void CheckPushWork(WorkItem&& work_item);
+
+  /// Queues work for execution after all of the work items that were pushed
+  /// with the same `affinity_key`. Crashes if the work cannot be queued due to
+  /// a full queue or a stopped worker.
+  ///
+  /// @param[in] affinity_key Selects the worker that runs the entry.
+  ///
+  /// @param[in] work_item The entry to enqueue.
+  ///
+  /// @pre
+  /// * The queue must not overflow, i.e. be full.
+  /// * The pool must not have been requested to stop, i.e. it must
+  ///   not be in the process of shutting down.
+  void CheckPushWork(uint32_t affinity_key, WorkItem&& work_item);
+
+  /// Locks the queues to prevent further work enqueing, finishes outstanding
+  /// work, then shuts down the worker threads.
+  ///
+  /// The `WorkQueuePool` cannot be resumed after stopping because the
+  /// `ThreadCore` threads return and may be joined. The `WorkQueuePool` must
+  /// be reconstructed for re-use after the threads have been joined.
+  void RequestStop();
+
+  /// Returns the number of workers in the pool.
+  size_t num_workers() const { return workers_.size(); }
+
+  /// Returns the `pw::thread::ThreadCore` of a worker, to be run as its own
+  /// thread.
+  thread::ThreadCore& worker(size_t index);
+
+  /// Returns the metrics of the pool, which has a child group with the queue
+  /// watermarks of each worker.
+  metric::Group& metrics() { return metrics_; }
+
+ protected:
+  // A queued work item, and whether it may run on a worker other than the one
+  // it was queued for.
+  struct QueuedWork {
+    WorkItem work_item;
+    bool stealable;
+  };
+
+  // The workers are not accessed until the pool has been constructed.
+  explicit WorkQueuePool(span<Worker> workers) : workers_(workers) {}
+
+ private:
+  // Removes a work item from the given worker's queue, or if it is empty,
+  // steals a work item from another worker.
+  std::optional<WorkItem> TakeWork(size_t index);
+
+  // Wakes up a sleeping worker, if there is one, to steal work.
+  void WakeIdleWorker(size_t index);
+
+  span<Worker> workers_;
+  std::atomic<size_t> next_worker_{0};
+
+  PW_METRIC_GROUP(metrics_, "pw::work_queue::WorkQueuePool");
+};
+
+/// A worker thread of a `pw::work_queue::WorkQueuePool`.
+class WorkQueuePool::Worker : public thread::ThreadCore {
+ public:
+  Worker(WorkQueuePool& pool,
+         size_t index,
+         InlineDeque<QueuedWork>& queue,
+         size_t queue_capacity)
+      : pool_(pool), index_(index), stop_requested_(false), queue_(queue) {
+    min_queue_remaining_.Set(static_cast<uint32_t>(queue_capacity));
+    pool_.metrics_.Add(metrics_);
+  }
+
+  Worker(const Worker&) = delete;
+  Worker& operator=(const Worker&) = delete;
+
+ private:
+  friend class WorkQueuePool;
+
+  void Run() override PW_LOCKS_EXCLUDED(lock_);
+
+  Status Push(WorkItem&& work_item, bool stealable) PW_LOCKS_EXCLUDED(lock_);
+
+  // Removes the oldest work item from the queue.
+  std::optional<WorkItem> PopFront() PW_LOCKS_EXCLUDED(lock_);
+
+  // Removes a work item that may run on another worker from either end of the
+  // queue.
+  std::optional<WorkItem> Steal() PW_LOCKS_EXCLUDED(lock_);
+
+  void RequestStop() PW_LOCKS_EXCLUDED(lock_);
+
+  // Returns true if a stop was requested and all queued work has run.
+  bool Stopped() PW_LOCKS_EXCLUDED(lock_);
+
+  // Wakes up the worker if it is idle. Returns false if it was not idle.
+  bool Wake();
+
+  WorkQueuePool& pool_;
+  const size_t index_;
+
+  sync::InterruptSpinLock lock_;
+  bool stop_requested_ PW_GUARDED_BY(lock_);
+  InlineDeque<QueuedWork>& queue_ PW_GUARDED_BY(lock_);
+
+  // Set while the worker has found no work and is about to sleep. Pushes check
+  // it after queueing work, so the worker is either woken up or finds the work
+  // when it checks again.
+  std::atomic<bool> idle_{false};
+  sync::ThreadNotification work_notification_;
+
+  PW_METRIC_GROUP(metrics_, "worker");
+  PW_METRIC(metrics_, max_queue_used_, "max_queue_used", 0u);
+  PW_METRIC(metrics_, min_queue_remaining_, "min_queue_remaining", 0u);
+};
+
+template <size_t kWorkers, size_t kWorkQueueEntriesPerWorker>
+class WorkQueuePoolWithBuffer : public WorkQueuePool {
+ public:
+  WorkQueuePoolWithBuffer()
+      : WorkQueuePoolWithBuffer(std::make_index_sequence<kWorkers>()) {}
+
+ private:
+  static_assert(kWorkers > 0);
+
+  template <size_t... kIndices>
+  WorkQueuePoolWithBuffer(std::index_sequence<kIndices...>)
+      : WorkQueuePool(workers_),
+        workers_{{Worker(*this,
+                         kIndices,
+                         queues_[kIndices],
+                         kWorkQueueEntriesPerWorker)...}} {}
+
+  std::array<InlineDeque<QueuedWork, kWorkQueueEntriesPerWorker>, kWorkers>
+      queues_;
+  std::array<Worker, kWorkers> workers_;
+};
+
+}  // namespace pw::work_queue
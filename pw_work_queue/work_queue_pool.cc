@@ -0,0 +1,190 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/work_queue_pool.h"
+
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::work_queue {
+
+Status WorkQueuePool::PushWork(WorkItem&& work_item) {
+  const size_t first =
+      next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+
+  // Fall back to the next workers if the first worker's queue is full.
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    const Status status =
+        workers_[(first + i) % workers_.size()].Push(std::move(work_item),
+                                                     /*stealable=*/true);
+    if (!status.IsResourceExhausted()) {
+      return status;
+    }
+  }
+  return Status::ResourceExhausted();
+}
+
+Status WorkQueuePool::PushWork(uint32_t affinity_key, WorkItem&& work_item) {
+  return workers_[affinity_key % workers_.size()].Push(std::move(work_item),
+                                                       /*stealable=*/false);
+}
+
+void WorkQueuePool::CheckPushWork(WorkItem&& work_item) {
+  PW_CHECK_OK(PushWork(std::move(work_item)),
+              "Failed to push work item into the work queue pool");
+}
+
+void WorkQueuePool::CheckPushWork(uint32_t affinity_key, WorkItem&& work_item) {
+  PW_CHECK_OK(PushWork(affinity_key, std::move(work_item)),
+              "Failed to push work item into the work queue pool");
+}
+
+void WorkQueuePool::RequestStop() {
+  for (Worker& worker : workers_) {
+    worker.RequestStop();
+  }
+}
+
+thread::ThreadCore& WorkQueuePool::worker(size_t index) {
+  PW_CHECK_UINT_LT(index, workers_.size());
+  return workers_[index];
+}
+
+std::optional<WorkItem> WorkQueuePool::TakeWork(size_t index) {
+  std::optional<WorkItem> work_item = workers_[index].PopFront();
+  for (size_t i = 1; i < workers_.size() && !work_item.has_value(); ++i) {
+    work_item = workers_[(index + i) % workers_.size()].Steal();
+  }
+  return work_item;
+}
+
+void WorkQueuePool::WakeIdleWorker(size_t index) {
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    if (workers_[(index + i) % workers_.size()].Wake()) {
+      return;
+    }
+  }
+}
+
+void WorkQueuePool::Worker::Run() {
+  while (true) {
+    std::optional<WorkItem> work_item = pool_.TakeWork(index_);
+    if (!work_item.has_value()) {
+      // Check for work again after announcing that this worker is idle, so
+      // that work pushed in the meantime is either found or wakes it up.
+      idle_.store(true);
+      work_item = pool_.TakeWork(index_);
+      if (!work_item.has_value()) {
+        // Return once stopped and all of the work has run. Work that remains
+        // in other workers' queues is run by those workers.
+        if (Stopped()) {
+          return;
+        }
+        work_notification_.acquire();
+        idle_.store(false);
+        continue;
+      }
+      idle_.store(false);
+    }
+
+    PW_CHECK(*work_item != nullptr);
+    (*work_item)();
+  }
+}
+
+Status WorkQueuePool::Worker::Push(WorkItem&& work_item, bool stealable) {
+  {
+    std::lock_guard lock(lock_);
+
+    if (stop_requested_) {
+      // Entries are not permitted to be enqueued once stop has been requested.
+      return Status::FailedPrecondition();
+    }
+
+    if (queue_.full()) {
+      return Status::ResourceExhausted();
+    }
+
+    queue_.push_back(QueuedWork{std::move(work_item), stealable});
+
+    // Update the watermarks for the queue.
+    const uint32_t queue_entries = queue_.size();
+    if (queue_entries > max_queue_used_.value()) {
+      max_queue_used_.Set(queue_entries);
+    }
+    const uint32_t queue_remaining = queue_.max_size() - queue_entries;
+    if (queue_remaining < min_queue_remaining_.value()) {
+      min_queue_remaining_.Set(queue_remaining);
+    }
+  }  // Release lock before calling .release() on the semaphore.
+
+  // If this worker is busy, wake up another one to steal the work.
+  if (!Wake() && stealable) {
+    pool_.WakeIdleWorker(index_);
+  }
+  return OkStatus();
+}
+
+std::optional<WorkItem> WorkQueuePool::Worker::PopFront() {
+  std::lock_guard lock(lock_);
+  if (queue_.empty()) {
+    return std::nullopt;
+  }
+  std::optional<WorkItem> work_item(std::move(queue_.front().work_item));
+  queue_.pop_front();
+  return work_item;
+}
+
+std::optional<WorkItem> WorkQueuePool::Worker::Steal() {
+  std::lock_guard lock(lock_);
+  if (queue_.empty()) {
+    return std::nullopt;
+  }
+
+  // Prefer the oldest work item, but skip over ordered work at the front.
+  std::optional<WorkItem> work_item;
+  if (queue_.front().stealable) {
+    work_item.emplace(std::move(queue_.front().work_item));
+    queue_.pop_front();
+  } else if (queue_.back().stealable) {
+    work_item.emplace(std::move(queue_.back().work_item));
+    queue_.pop_back();
+  }
+  return work_item;
+}
+
+void WorkQueuePool::Worker::RequestStop() {
+  {
+    std::lock_guard lock(lock_);
+    stop_requested_ = true;
+  }  // Release lock before calling .release() on the semaphore.
+  work_notification_.release();
+}
+
+bool WorkQueuePool::Worker::Stopped() {
+  std::lock_guard lock(lock_);
+  return stop_requested_ && queue_.empty();
+}
+
+bool WorkQueuePool::Worker::Wake() {
+  // Only wake a worker once, so that each push wakes a different worker.
+  if (!idle_.load() || !idle_.exchange(false)) {
+    return false;
+  }
+  work_notification_.release();
+  return true;
+}
+
+}  // namespace pw::work_queue
@@ -0,0 +1,112 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures the throughput of a WorkQueue and of WorkQueuePools with different
+// numbers of workers. A single thread pushes 10k small work items, as a
+// network or logging front end might, and waits for all of them to run.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/check.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/yield.h"
+#include "pw_thread_stl/options.h"
+#include "pw_work_queue/work_queue.h"
+#include "pw_work_queue/work_queue_pool.h"
+
+namespace pw::work_queue {
+namespace {
+
+constexpr int kWorkItems = 10000;
+constexpr size_t kEntriesPerWorker = 64;
+
+struct Context {
+  std::atomic<int> remaining{0};
+  std::atomic<uint32_t> result{0};
+  sync::ThreadNotification done;
+};
+
+// A few hundred nanoseconds of work.
+void DoWork(Context& context) {
+  auto value = static_cast<uint32_t>(
+      context.remaining.load(std::memory_order_relaxed));
+  for (int i = 0; i < 256; ++i) {
+    value = value * 1103515245u + 12345u;
+  }
+  context.result.fetch_add(value, std::memory_order_relaxed);
+  if (context.remaining.fetch_sub(1) == 1) {
+    context.done.release();
+  }
+}
+
+// Pushes all of the work, retrying while the queues are full, then waits for
+// it to run.
+template <typename Queue>
+void PushAll(Queue& queue, Context& context) {
+  context.remaining = kWorkItems;
+  for (int i = 0; i < kWorkItems; ++i) {
+    while (queue.PushWork([&context] { DoWork(context); })
+               .IsResourceExhausted()) {
+      this_thread::yield();
+    }
+  }
+  context.done.acquire();
+}
+
+void WorkQueueThroughput(perf_test::State& state) {
+  static WorkQueueWithBuffer<kEntriesPerWorker> work_queue;
+  Context context;
+  thread::Thread thread(thread::stl::Options(), work_queue);
+
+  while (state.KeepRunning()) {
+    PushAll(work_queue, context);
+  }
+
+  work_queue.RequestStop();
+  thread.join();
+}
+
+template <size_t kWorkers>
+void PoolThroughput(perf_test::State& state) {
+  static WorkQueuePoolWithBuffer<kWorkers, kEntriesPerWorker> pool;
+  Context context;
+  std::array<thread::Thread, kWorkers> threads;
+  for (size_t i = 0; i < kWorkers; ++i) {
+    threads[i] = thread::Thread(thread::stl::Options(), pool.worker(i));
+  }
+
+  while (state.KeepRunning()) {
+    PushAll(pool, context);
+  }
+
+  pool.RequestStop();
+  for (thread::Thread& thread : threads) {
+    thread.join();
+  }
+  PW_CHECK_UINT_NE(context.result.load(), 0);
+}
+
+PW_PERF_TEST(WorkQueue10kItems, WorkQueueThroughput);
+PW_PERF_TEST(WorkQueuePool10kItems1Worker, PoolThroughput<1>);
+PW_PERF_TEST(WorkQueuePool10kItems2Workers, PoolThroughput<2>);
+PW_PERF_TEST(WorkQueuePool10kItems4Workers, PoolThroughput<4>);
+PW_PERF_TEST(WorkQueuePool10kItems8Workers, PoolThroughput<8>);
+
+}  // namespace
+}  // namespace pw::work_queue
@@ -0,0 +1,221 @@
+// Copyright 2023 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/work_queue_pool.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_sync/timed_thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/yield.h"
+#include "pw_work_queue/test_thread.h"
+
+namespace pw::work_queue {
+namespace {
+
+constexpr chrono::SystemClock::duration kTimeout =
+    chrono::SystemClock::for_at_least(std::chrono::seconds(10));
+
+// Runs each of the pool's workers in its own thread.
+template <size_t kWorkers>
+class WorkerThreads {
+ public:
+  explicit WorkerThreads(WorkQueuePool& pool) : pool_(pool) {
+    for (size_t i = 0; i < kWorkers; ++i) {
+      threads_[i] =
+          thread::Thread(test::WorkQueueThreadOptions(), pool.worker(i));
+    }
+  }
+
+  ~WorkerThreads() {
+    pool_.RequestStop();
+    for (thread::Thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+ private:
+  WorkQueuePool& pool_;
+  std::array<thread::Thread, kWorkers> threads_;
+};
+
+TEST(WorkQueuePool, RunsAllWork) {
+  struct {
+    std::atomic<int> counter = 0;
+    sync::ThreadNotification done;
+  } context;
+  constexpr int kWorkItems = 1000;
+
+  WorkQueuePoolWithBuffer<4, 8> pool;
+  {
+    WorkerThreads<4> threads(pool);
+    for (int i = 0; i < kWorkItems; ++i) {
+      // Retry while the queues are full.
+      while (pool.PushWork([&context] {
+               if (++context.counter == kWorkItems) {
+                 context.done.release();
+               }
+             }).IsResourceExhausted()) {
+        this_thread::yield();
+      }
+    }
+    context.done.acquire();
+  }
+
+  EXPECT_EQ(context.counter, kWorkItems);
+}
+
+TEST(WorkQueuePool, SameAffinityKeyRunsInOrder) {
+  constexpr uint32_t kKeys = 5;
+  constexpr int kWorkItemsPerKey = 200;
+  // Static, so that the work items only need to capture the key and index.
+  static struct {
+    std::array<int, kKeys> next{};
+    std::atomic<int> out_of_order = 0;
+    std::atomic<int> remaining = kKeys * kWorkItemsPerKey;
+    sync::ThreadNotification done;
+  } context;
+
+  WorkQueuePoolWithBuffer<3, 4> pool;
+  {
+    WorkerThreads<3> threads(pool);
+    for (int i = 0; i < kWorkItemsPerKey; ++i) {
+      for (uint32_t key = 0; key < kKeys; ++key) {
+        // Interleave work without an affinity key, which may be stolen.
+        while (pool.PushWork([] {}).IsResourceExhausted()) {
+          this_thread::yield();
+        }
+        while (pool.PushWork(key, [key, i] {
+                     if (context.next[key]++ != i) {
+                       context.out_of_order++;
+                     }
+                     if (--context.remaining == 0) {
+                       context.done.release();
+                     }
+                   }).IsResourceExhausted()) {
+          this_thread::yield();
+        }
+      }
+    }
+    context.done.acquire();
+  }
+
+  EXPECT_EQ(context.out_of_order, 0);
+  for (int next : context.next) {
+    EXPECT_EQ(next, kWorkItemsPerKey);
+  }
+}
+
+TEST(WorkQueuePool, IdleWorkersStealWork) {
+  constexpr int kWorkItems = 20;
+  struct {
+    sync::ThreadNotification blocker_started;
+    sync::ThreadNotification unblock;
+    std::atomic<int> remaining = kWorkItems;
+    sync::TimedThreadNotification done;
+  } context;
+
+  WorkQueuePoolWithBuffer<2, kWorkItems> pool;
+  WorkerThreads<2> threads(pool);
+
+  // Keep worker 0 busy, while half of the work is queued behind it.
+  ASSERT_EQ(OkStatus(), pool.PushWork(0, [&context] {
+    context.blocker_started.release();
+    context.unblock.acquire();
+  }));
+  context.blocker_started.acquire();
+
+  for (int i = 0; i < kWorkItems; ++i) {
+    ASSERT_EQ(OkStatus(), pool.PushWork([&context] {
+      if (--context.remaining == 0) {
+        context.done.release();
+      }
+    }));
+  }
+
+  EXPECT_TRUE(context.done.try_acquire_for(kTimeout));
+  context.unblock.release();
+}
+
+TEST(WorkQueuePool, OrderedWorkIsNotStolen) {
+  struct {
+    sync::ThreadNotification blocker_started;
+    sync::ThreadNotification unblock;
+    std::atomic<bool> ran = false;
+    sync::TimedThreadNotification done;
+  } context;
+
+  WorkQueuePoolWithBuffer<2, 4> pool;
+  {
+    WorkerThreads<2> threads(pool);
+
+    ASSERT_EQ(OkStatus(), pool.PushWork(1, [&context] {
+      context.blocker_started.release();
+      context.unblock.acquire();
+    }));
+    context.blocker_started.acquire();
+
+    ASSERT_EQ(OkStatus(), pool.PushWork(1, [&context] {
+      context.ran = true;
+      context.done.release();
+    }));
+
+    // Worker 0 is idle, but must not run the work queued for worker 1.
+    EXPECT_FALSE(context.done.try_acquire_for(
+        chrono::SystemClock::for_at_least(std::chrono::milliseconds(50))));
+    EXPECT_FALSE(context.ran);
+
+    context.unblock.release();
+    EXPECT_TRUE(context.done.try_acquire_for(kTimeout));
+  }
+  EXPECT_TRUE(context.ran);
+}
+
+TEST(WorkQueuePool, FullQueues) {
+  int counter = 0;
+  WorkQueuePoolWithBuffer<2, 2> pool;
+
+  // Work for a full worker goes to another worker, until all are full.
+  EXPECT_EQ(OkStatus(), pool.PushWork(0, [&counter] { counter++; }));
+  EXPECT_EQ(OkStatus(), pool.PushWork(0, [&counter] { counter++; }));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            pool.PushWork(0, [&counter] { counter++; }));
+  EXPECT_EQ(OkStatus(), pool.PushWork([&counter] { counter++; }));
+  EXPECT_EQ(OkStatus(), pool.PushWork([&counter] { counter++; }));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            pool.PushWork([&counter] { counter++; }));
+
+  // Queued work still runs after a stop is requested.
+  pool.RequestStop();
+  EXPECT_EQ(Status::FailedPrecondition(),
+            pool.PushWork([&counter] { counter++; }));
+  EXPECT_EQ(Status::FailedPrecondition(),
+            pool.PushWork(1, [&counter] { counter++; }));
+
+  // Run the workers one at a time, so that the counter is not shared.
+  for (size_t i = 0; i < pool.num_workers(); ++i) {
+    thread::Thread(test::WorkQueueThreadOptions(), pool.worker(i)).join();
+  }
+  EXPECT_EQ(counter, 4);
+}
+
+}  // namespace
+}  // namespace pw::work_queue